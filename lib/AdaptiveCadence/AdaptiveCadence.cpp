@@ -0,0 +1,72 @@
+#include "AdaptiveCadence.h"
+#include <math.h>
+
+static const uint8_t DIVISORS_OF_60[] = { 60, 30, 20, 15, 12, 10, 6, 5, 4, 3, 2, 1 }; // Longest first
+
+uint8_t cadenceIntervalMinutes(float volatility, const AdaptiveCadenceConfig& config) {
+    float t = (volatility - config.stableUvPerHour) / (config.volatileUvPerHour - config.stableUvPerHour);
+    if (!(t > 0.0f)) t = 0.0f; // Also catches NaN
+    if (t > 1.0f) t = 1.0f;
+    float targetMin = config.maxIntervalMin - t * (config.maxIntervalMin - config.minIntervalMin);
+    for (uint8_t step : DIVISORS_OF_60) {
+        if (step <= targetMin && step >= config.minIntervalMin && step <= config.maxIntervalMin) return step;
+    }
+    uint8_t interval = 60;
+    for (uint8_t step : DIVISORS_OF_60) {
+        if (step >= config.minIntervalMin) interval = step;
+    }
+    return interval;
+}
+
+CadenceDecision cadenceDecide(const float* uv, const int* hours, const float* previousUV, const int* previousHours, int count,
+                              const AdaptiveCadenceConfig& config) {
+    CadenceDecision decision = { 0.0f, 0.0f, -1.0f, 0 };
+    for (int i = 0; i + 1 < count && i < 3; ++i) {
+        float d = fabsf(uv[i + 1] - uv[i]);
+        if (d > decision.slope) decision.slope = d;
+    }
+    if (previousUV && previousHours) {
+        for (int i = 0; i < count; ++i) {
+            for (int j = 0; j < count; ++j) {
+                if (previousHours[j] == hours[i] && previousUV[j] >= 0.0f) {
+                    float d = fabsf(previousUV[j] - uv[i]);
+                    if (d > decision.revision) decision.revision = d;
+                    if (i == 0) decision.shownError = d; // The value that was on screen for the current hour
+                    break;
+                }
+            }
+        }
+    }
+    float volatility = decision.slope > decision.revision ? decision.slope : decision.revision;
+    decision.intervalMin = cadenceIntervalMinutes(volatility, config);
+    return decision;
+}
+
+uint8_t cadenceUpdatesPerHour(uint8_t intervalMin, uint8_t configuredUpdatesPerHour) {
+    if (intervalMin == 0) return configuredUpdatesPerHour;
+    uint8_t adaptive = 60 / intervalMin;
+    if (adaptive < 1) adaptive = 1;
+    return adaptive < configuredUpdatesPerHour ? adaptive : configuredUpdatesPerHour;
+}
+
+void cadenceDayReset(CadenceDayStats& stats) {
+    stats = CadenceDayStats{ -1, 0, 0, 0.0f, 0.0f, 0 };
+}
+
+void cadenceDayRecord(CadenceDayStats& stats, int dayOfYear, float shownError) {
+    if (stats.dayOfYear != dayOfYear) {
+        bool nextDay = stats.dayOfYear >= 0 && (dayOfYear == stats.dayOfYear + 1 || (dayOfYear == 0 && stats.dayOfYear >= 364));
+        stats.fetchesYesterday = nextDay ? stats.fetchesToday : 0;
+        stats.fetchesToday = 0;
+        stats.shownErrorSum = 0.0f;
+        stats.shownErrorMax = 0.0f;
+        stats.shownErrorCount = 0;
+        stats.dayOfYear = (int16_t)dayOfYear;
+    }
+    if (stats.fetchesToday < UINT16_MAX) stats.fetchesToday++;
+    if (shownError >= 0.0f) {
+        stats.shownErrorSum += shownError;
+        if (shownError > stats.shownErrorMax) stats.shownErrorMax = shownError;
+        stats.shownErrorCount++;
+    }
+}
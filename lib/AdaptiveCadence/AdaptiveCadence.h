@@ -0,0 +1,56 @@
+#ifndef ADAPTIVE_CADENCE_H
+#define ADAPTIVE_CADENCE_H
+
+#include <stdint.h>
+
+// Adaptive refresh cadence: after each fetch, the next interval follows how fast the forecast moves
+// (slope over the next hours) and how much it was revised since the previous fetch, interpolated
+// between the bounds and snapped to a divisor of 60 so the slot grid of lib/SlotScheduler holds.
+// Also the per-day record of fetches and of the error of the UV that was on screen. The firmware
+// keeps the state in RTC memory and does the locking; this only does the arithmetic.
+
+struct AdaptiveCadenceConfig {
+    uint8_t minIntervalMin;   // Shortest interval, used at/above volatileUvPerHour
+    uint8_t maxIntervalMin;   // Longest interval, used at/below stableUvPerHour
+    float volatileUvPerHour;
+    float stableUvPerHour;
+};
+
+struct CadenceDecision {
+    float slope;          // Largest UV change between consecutive hours over the next 3 hours
+    float revision;       // Largest change of an hour's UV since the previous forecast
+    float shownError;     // |previous - fresh| for the current hour, -1 without a previous value
+    uint8_t intervalMin;
+};
+
+// Fetch counts and shown-UV error per local day. Kept across deep sleep in RTC memory.
+struct CadenceDayStats {
+    int16_t dayOfYear;        // -1 until the first fetch
+    uint16_t fetchesToday;
+    uint16_t fetchesYesterday; // 0 unless the previous counted day was reached
+    float shownErrorSum;      // Over the fetches that had a previous value for the current hour
+    float shownErrorMax;
+    uint16_t shownErrorCount;
+};
+
+// Interval for a volatility (UV per hour): linear from max at stableUvPerHour down to min at
+// volatileUvPerHour, then the longest divisor of 60 within [min, max] not above that. When no divisor
+// fits under the target, the shortest divisor not below min (never faster than min).
+uint8_t cadenceIntervalMinutes(float volatility, const AdaptiveCadenceConfig& config);
+
+// Decision for a fresh forecast of count hours (uv[i] for local hour hours[i]). previousUV and
+// previousHours are the last API forecast, or nullptr when there was none; negative previous values
+// are placeholders and do not count as revisions.
+CadenceDecision cadenceDecide(const float* uv, const int* hours, const float* previousUV, const int* previousHours, int count,
+                              const AdaptiveCadenceConfig& config);
+
+// Updates per hour for an interval, never above the mode's configured rate. 0 keeps the configured rate.
+uint8_t cadenceUpdatesPerHour(uint8_t intervalMin, uint8_t configuredUpdatesPerHour);
+
+void cadenceDayReset(CadenceDayStats& stats);
+
+// Counts one fetch on dayOfYear and its shown error (negative: none). A new day moves today's count
+// to yesterday's, or clears it when days were skipped.
+void cadenceDayRecord(CadenceDayStats& stats, int dayOfYear, float shownError);
+
+#endif // ADAPTIVE_CADENCE_H
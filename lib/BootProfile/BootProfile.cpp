@@ -0,0 +1,47 @@
+#include "BootProfile.h"
+#include <stdio.h>
+
+uint8_t bootProfileOrder(const int64_t* stepUs, uint8_t count, uint8_t* orderOut) {
+    uint8_t reached = 0;
+    for (uint8_t step = 0; step < count && step < BOOT_PROFILE_MAX_STEPS; ++step) {
+        if (stepUs[step] <= 0) continue;
+        uint8_t j = reached++;
+        while (j > 0 && stepUs[orderOut[j - 1]] > stepUs[step]) { // Strict: ties stay in step order
+            orderOut[j] = orderOut[j - 1];
+            --j;
+        }
+        orderOut[j] = step;
+    }
+    return reached;
+}
+
+size_t bootProfileFormat(const int64_t* stepUs, const char* const* names, uint8_t count, char* out, size_t size) {
+    uint8_t order[BOOT_PROFILE_MAX_STEPS];
+    uint8_t reached = bootProfileOrder(stepUs, count, order);
+    size_t length = 0;
+    int64_t previousUs = 0;
+    for (uint8_t i = 0; i < reached; ++i) {
+        int64_t endUs = stepUs[order[i]];
+        int n = snprintf(out + (length < size ? length : size), length < size ? size - length : 0, " %s +%.1f@%.1f",
+                         names[order[i]], (endUs - previousUs) / 1000.0f, endUs / 1000.0f);
+        if (n > 0) length += (size_t)n;
+        previousUs = endUs;
+    }
+    int n = snprintf(out + (length < size ? length : size), length < size ? size - length : 0, " ms");
+    if (n > 0) length += (size_t)n;
+    return length;
+}
+
+void runningMeanAdd(RunningMean& mean, uint32_t value) {
+    if (mean.count == UINT16_MAX || mean.sum > UINT32_MAX - value) {
+        mean.sum /= 2;
+        mean.count /= 2;
+        if (mean.sum > UINT32_MAX - value) { mean.sum = 0; mean.count = 0; } // One sample near 2^32: start over
+    }
+    mean.sum += value;
+    mean.count++;
+}
+
+uint32_t runningMeanValue(const RunningMean& mean) {
+    return mean.count ? mean.sum / mean.count : 0;
+}
@@ -0,0 +1,30 @@
+#ifndef BOOT_PROFILE_H
+#define BOOT_PROFILE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Boot critical-path profile: the firmware stamps the end of each setup() step (us since app start,
+// 0 = not reached) and this orders and prints them, plus the running means it keeps in RTC memory
+// across wakes. No clock or serial access here.
+
+#define BOOT_PROFILE_MAX_STEPS 16
+
+// Indices of the reached steps in the order they finished; equal stamps keep step order. Returns how
+// many were written to orderOut (at most count, which must not exceed BOOT_PROFILE_MAX_STEPS).
+uint8_t bootProfileOrder(const int64_t* stepUs, uint8_t count, uint8_t* orderOut);
+
+// " name +duration@end" for each reached step, in ms with one decimal, followed by " ms". Truncated
+// to size like snprintf; returns the length it would have had.
+size_t bootProfileFormat(const int64_t* stepUs, const char* const* names, uint8_t count, char* out, size_t size);
+
+// Sum and count of a per-wake figure. When either would overflow both are halved first, so the mean
+// keeps following new samples instead of wrapping to garbage after ~65k wakes.
+struct RunningMean {
+    uint32_t sum;
+    uint16_t count;
+};
+void runningMeanAdd(RunningMean& mean, uint32_t value);
+uint32_t runningMeanValue(const RunningMean& mean); // 0 without samples
+
+#endif // BOOT_PROFILE_H
@@ -0,0 +1,62 @@
+#include "ButtonGesture.h"
+
+static GestureStep gestureStep(GestureTimerAction timer, uint32_t timerPeriodMs = 0) {
+    GestureStep step = { false, BUTTON_EVENT_SHORT, 0, timer, timerPeriodMs };
+    return step;
+}
+
+static GestureStep gestureEmit(ButtonEventType type, uint32_t timestampMs, GestureTimerAction timer, uint32_t timerPeriodMs = 0) {
+    GestureStep step = { true, type, timestampMs, timer, timerPeriodMs };
+    return step;
+}
+
+void gestureReset(GestureState& state, bool pressedNow) {
+    state.pressStartMs = 0;
+    state.stablePressed = pressedNow;
+    state.pressSeen = false;
+    state.longFired = false;
+    state.clickCount = 0;
+}
+
+GestureStep gestureOnDebounced(GestureState& state, bool pressed, uint32_t edgeMs, uint32_t nowMs, bool detectDouble, const ButtonTiming& timing) {
+    if (pressed == state.stablePressed) return gestureStep(GESTURE_TIMER_KEEP); // Bounce that settled back
+
+    state.stablePressed = pressed;
+    if (pressed) {
+        state.pressSeen = true;
+        state.longFired = false;
+        state.pressStartMs = edgeMs;
+        uint32_t elapsed = nowMs - edgeMs;
+        uint32_t untilLong = (elapsed < timing.longPressMs) ? (timing.longPressMs - elapsed) : 1;
+        return gestureStep(GESTURE_TIMER_ARM, untilLong);
+    }
+
+    if (!state.pressSeen) return gestureStep(GESTURE_TIMER_KEEP);
+    state.pressSeen = false;
+    if (state.longFired) {
+        state.clickCount = 0;
+        return gestureStep(GESTURE_TIMER_STOP);
+    }
+    if (!detectDouble) {
+        return gestureEmit(BUTTON_EVENT_SHORT, state.pressStartMs, GESTURE_TIMER_STOP);
+    }
+    if (++state.clickCount >= 2) {
+        state.clickCount = 0;
+        return gestureEmit(BUTTON_EVENT_DOUBLE, state.pressStartMs, GESTURE_TIMER_STOP);
+    }
+    return gestureStep(GESTURE_TIMER_ARM, timing.doubleClickWindowMs);
+}
+
+GestureStep gestureOnTimer(GestureState& state, bool holdRepeat, const ButtonTiming& timing) {
+    if (state.stablePressed) {
+        ButtonEventType type = state.longFired ? BUTTON_EVENT_HOLD_REPEAT : BUTTON_EVENT_LONG;
+        state.longFired = true;
+        state.clickCount = 0;
+        return gestureEmit(type, state.pressStartMs, holdRepeat ? GESTURE_TIMER_ARM : GESTURE_TIMER_KEEP, timing.holdRepeatMs);
+    }
+    if (state.clickCount == 1) {
+        state.clickCount = 0;
+        return gestureEmit(BUTTON_EVENT_SHORT, state.pressStartMs, GESTURE_TIMER_KEEP);
+    }
+    return gestureStep(GESTURE_TIMER_KEEP);
+}
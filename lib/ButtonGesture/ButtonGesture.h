@@ -0,0 +1,45 @@
+#ifndef BUTTON_GESTURE_H
+#define BUTTON_GESTURE_H
+
+#include <stdint.h>
+
+// Per-button gesture recognizer behind the firmware's button engine. It sees only debounced level
+// changes and expiries of one one-shot gesture timer; the caller owns the timers and the event
+// queue, so the same code runs under FreeRTOS and in the native edge-sequence tests.
+
+enum ButtonEventType : uint8_t { BUTTON_EVENT_SHORT, BUTTON_EVENT_LONG, BUTTON_EVENT_DOUBLE, BUTTON_EVENT_HOLD_REPEAT };
+
+struct ButtonTiming {
+    uint16_t longPressMs;
+    uint16_t doubleClickWindowMs; // A short press on a detectDouble button is reported this late
+    uint16_t holdRepeatMs;
+};
+
+enum GestureTimerAction : uint8_t { GESTURE_TIMER_KEEP, GESTURE_TIMER_STOP, GESTURE_TIMER_ARM };
+
+// Result of one step: at most one event, plus what to do with the gesture timer.
+struct GestureStep {
+    bool emit;
+    ButtonEventType type;
+    uint32_t timestampMs;        // Press start of the gesture
+    GestureTimerAction timer;
+    uint32_t timerPeriodMs;      // Only for GESTURE_TIMER_ARM
+};
+
+struct GestureState {
+    uint32_t pressStartMs;
+    bool stablePressed;
+    bool pressSeen;              // Ignore a release whose press happened before boot (e.g. ext0 wake)
+    bool longFired;
+    uint8_t clickCount;
+};
+
+void gestureReset(GestureState& state, bool pressedNow);
+
+// The debounce period after the last edge has passed and the pin reads `pressed`.
+GestureStep gestureOnDebounced(GestureState& state, bool pressed, uint32_t edgeMs, uint32_t nowMs, bool detectDouble, const ButtonTiming& timing);
+
+// Long-press threshold, hold-repeat tick or expiry of the double-click window.
+GestureStep gestureOnTimer(GestureState& state, bool holdRepeat, const ButtonTiming& timing);
+
+#endif // BUTTON_GESTURE_H
@@ -0,0 +1,76 @@
+#include "DayForecast.h"
+#include <math.h>
+
+void monotoneCubicQuarterHours(const float* hourlyKnots, uint8_t* quarterOut) {
+    float delta[23], slope[24];
+    for (int k = 0; k < 23; ++k) delta[k] = hourlyKnots[k + 1] - hourlyKnots[k];
+    slope[0] = delta[0];
+    slope[23] = delta[22];
+    for (int k = 1; k < 23; ++k) slope[k] = (delta[k - 1] * delta[k] <= 0.0f) ? 0.0f : (delta[k - 1] + delta[k]) / 2.0f;
+    for (int k = 0; k < 23; ++k) {
+        if (delta[k] == 0.0f) {
+            slope[k] = slope[k + 1] = 0.0f;
+            continue;
+        }
+        float a = slope[k] / delta[k], b = slope[k + 1] / delta[k];
+        float magnitude = a * a + b * b;
+        if (magnitude > 9.0f) {
+            float tau = 3.0f / sqrtf(magnitude);
+            slope[k] = tau * a * delta[k];
+            slope[k + 1] = tau * b * delta[k];
+        }
+    }
+    for (int q = 0; q < UV_QUARTER_SAMPLES; ++q) {
+        int k = q / 4;
+        float uv;
+        if (k >= 23) {
+            uv = hourlyKnots[23]; // 23:15-23:45 have no next knot
+        } else {
+            float t = (q % 4) / 4.0f, t2 = t * t, t3 = t2 * t;
+            uv = (2 * t3 - 3 * t2 + 1) * hourlyKnots[k] + (t3 - 2 * t2 + t) * slope[k]
+               + (-2 * t3 + 3 * t2) * hourlyKnots[k + 1] + (t3 - t2) * slope[k + 1];
+        }
+        float scaled = uv * UV_QUARTER_SCALE + 0.5f;
+        quarterOut[q] = scaled <= 0.0f ? 0 : (scaled >= 255.0f ? 255 : (uint8_t)scaled);
+    }
+}
+
+void buildDayUvAnalytics(const float* hourlyKnots, DayForecast* day) {
+    for (int level = 0; level < WHO_UV_LEVEL_COUNT; ++level) {
+        day->hoursAtOrAbove[level] = 0;
+        int8_t next = -1;
+        for (int h = 23; h >= 0; --h) {
+            if (hourlyKnots[h] >= WHO_UV_THRESHOLDS[level]) {
+                day->hoursAtOrAbove[level] |= 1UL << h;
+                next = h;
+            }
+            day->nextHourAtOrAbove[level][h] = next;
+        }
+    }
+    for (int h = 0; h < 24; ++h) { // Insertion sort; strict comparison keeps earlier hours first on ties
+        int j = h;
+        while (j > 0 && hourlyKnots[day->hoursByUv[j - 1]] < hourlyKnots[h]) {
+            day->hoursByUv[j] = day->hoursByUv[j - 1];
+            --j;
+        }
+        day->hoursByUv[j] = h;
+    }
+    day->peakHour = day->hoursByUv[0];
+    float scaledPeak = hourlyKnots[day->peakHour] * UV_QUARTER_SCALE + 0.5f;
+    day->peakUV = scaledPeak >= 255.0f ? 255 : (uint8_t)scaledPeak;
+}
+
+int uvNextHourAtOrAbove(const DayForecast& day, uint8_t level, int fromHour) {
+    if (day.dayOfYear < 0 || level >= WHO_UV_LEVEL_COUNT || fromHour < 0 || fromHour > 23) return -1;
+    return day.nextHourAtOrAbove[level][fromHour];
+}
+
+int uvWindowEndHour(const DayForecast& day, uint8_t level, int startHour) {
+    uint32_t run = ~(day.hoursAtOrAbove[level] >> startHour);
+    return startHour + (run ? __builtin_ctz(run) : 32 - startHour);
+}
+
+int dayQuarterIndex(const DayForecast& day, int firstForecastHour, const struct tm& localNow) {
+    if (day.dayOfYear < 0 || localNow.tm_yday != day.dayOfYear || firstForecastHour != localNow.tm_hour) return -1;
+    return localNow.tm_hour * 4 + localNow.tm_min / 15;
+}
@@ -0,0 +1,48 @@
+#ifndef DAY_FORECAST_H
+#define DAY_FORECAST_H
+
+#include <stdint.h>
+#include <time.h>
+
+// Whole-day products of the Open-Meteo parse: quarter-hour samples and peak/threshold analytics,
+// precomputed once per fetch from the day's 24 hourly values so renderer and scheduler queries are
+// table lookups. The firmware walks the JSON and hands the knots in; everything here is pure.
+
+#define UV_QUARTER_SAMPLES 96              // One sample per 15 min of the local day
+#define UV_QUARTER_SCALE 10                // Fixed point: tenths of a UV index step, uint8_t saturates at 25.5
+#define WHO_UV_LEVEL_COUNT 4
+const float WHO_UV_THRESHOLDS[WHO_UV_LEVEL_COUNT] = { 3.0f, 6.0f, 8.0f, 11.0f }; // Lower bounds of the WHO bands below
+const char* const WHO_UV_LEVEL_NAMES[WHO_UV_LEVEL_COUNT] = { "moderate", "high", "very high", "extreme" };
+#define WHO_UV_LEVEL_HIGH 1                // "high": the band whose next window the display announces
+static_assert(WHO_UV_LEVEL_HIGH < WHO_UV_LEVEL_COUNT, "WHO_UV_LEVEL_HIGH indexes WHO_UV_THRESHOLDS");
+
+struct DayForecast {
+    int16_t dayOfYear;                                 // Local day this describes; -1 if not from a parsed payload
+    uint8_t uvQuarter[UV_QUARTER_SAMPLES];             // UV_QUARTER_SCALE fixed point
+    uint8_t peakUV;                                    // Highest hourly UV, UV_QUARTER_SCALE fixed point
+    int8_t peakHour;
+    uint32_t hoursAtOrAbove[WHO_UV_LEVEL_COUNT];       // Bit h set when UV at hour h >= WHO_UV_THRESHOLDS[level]
+    int8_t nextHourAtOrAbove[WHO_UV_LEVEL_COUNT][24];  // First hour >= h in that set, -1 if none
+    uint8_t hoursByUv[24];                             // Hours by UV, highest first (earlier hour first on ties)
+};
+
+// Fritsch-Carlson monotone cubic through the 24 hourly knots (UV at HH:00), sampled every 15 min.
+// Unlike a plain cubic spline it cannot overshoot between knots, so no negative UV at dawn or a
+// peak above the forecast maximum.
+void monotoneCubicQuarterHours(const float* hourlyKnots, uint8_t* quarterOut);
+
+// Peak, WHO threshold sets with their next-hour tables, and the hours sorted by UV. O(24^2) worst
+// case once per fetch; every query after that is O(1).
+void buildDayUvAnalytics(const float* hourlyKnots, DayForecast* day);
+
+// e.g. "next hour with UV >= 6": -1 if none left today.
+int uvNextHourAtOrAbove(const DayForecast& day, uint8_t level, int fromHour);
+
+// Exclusive end hour of the run of at/above-threshold hours that starts at startHour.
+int uvWindowEndHour(const DayForecast& day, uint8_t level, int startHour);
+
+// Quarter of the local day for the "now" bar, or -1 when the samples are not for localNow's day or
+// the hourly forecast on screen does not start at the current hour.
+int dayQuarterIndex(const DayForecast& day, int firstForecastHour, const struct tm& localNow);
+
+#endif // DAY_FORECAST_H
@@ -0,0 +1,31 @@
+#include "EnergyProfile.h"
+
+void energyAttributeOther(uint32_t* phaseUs, int64_t awakeUs, const EnergyModel& model) {
+    uint64_t attributedUs = 0;
+    for (uint8_t i = 0; i < model.phaseCount; ++i) if (i != model.otherPhase) attributedUs += phaseUs[i];
+    phaseUs[model.otherPhase] = (awakeUs > (int64_t)attributedUs) ? (uint32_t)(awakeUs - attributedUs) : 0;
+}
+
+float energyCycleMAh(const uint32_t* phaseUs, uint32_t sleepSeconds, const EnergyModel& model, uint16_t* phaseMsOut) {
+    float mAs = 0.0f;
+    for (uint8_t i = 0; i < model.phaseCount; ++i) {
+        uint32_t ms = phaseUs[i] / 1000;
+        phaseMsOut[i] = ms > 0xFFFF ? 0xFFFF : (uint16_t)ms;
+        mAs += model.phaseCurrentMA[i] * (phaseUs[i] / 1000000.0f);
+    }
+    mAs += model.deepSleepCurrentMA * sleepSeconds;
+    return mAs / 3600.0f;
+}
+
+float energyPhaseMAh(uint16_t phaseMs, uint8_t phase, const EnergyModel& model) {
+    return model.phaseCurrentMA[phase] * phaseMs / 3600000.0f;
+}
+
+uint8_t energyRingSlot(uint8_t next, uint8_t n, uint8_t size) {
+    return (uint8_t)((next + size - 1 - n % size) % size);
+}
+
+void energyRingPush(uint8_t& next, uint8_t& count, uint8_t size) {
+    next = (uint8_t)((next + 1) % size);
+    if (count < size) count++;
+}
@@ -0,0 +1,32 @@
+#ifndef ENERGY_PROFILE_H
+#define ENERGY_PROFILE_H
+
+#include <stdint.h>
+
+// Per-cycle energy estimate: the firmware times each wake cycle's phases (us) and this turns them into
+// the record kept in its RTC ring buffer, phase time x phase current plus the deep sleep that followed,
+// and walks the ring newest first. No clock or serial access here.
+
+struct EnergyModel {
+    const float* phaseCurrentMA;  // Board draw per phase
+    uint8_t phaseCount;
+    uint8_t otherPhase;           // Takes the awake time no other phase accounts for
+    float deepSleepCurrentMA;
+};
+
+// Sets phaseUs[otherPhase] to awakeUs less the other phases, 0 when they add up to more.
+void energyAttributeOther(uint32_t* phaseUs, int64_t awakeUs, const EnergyModel& model);
+
+// mAh of the awake phases and the following deep sleep. Writes each phase in ms to phaseMsOut,
+// saturating at 65535; the estimate uses the unsaturated time.
+float energyCycleMAh(const uint32_t* phaseUs, uint32_t sleepSeconds, const EnergyModel& model, uint16_t* phaseMsOut);
+
+// mAh of one phase of a kept record.
+float energyPhaseMAh(uint16_t phaseMs, uint8_t phase, const EnergyModel& model);
+
+// Ring buffer of size slots whose next write goes to next: the slot of the n-th newest record
+// (0: newest), and the step after a write.
+uint8_t energyRingSlot(uint8_t next, uint8_t n, uint8_t size);
+void energyRingPush(uint8_t& next, uint8_t& count, uint8_t size);
+
+#endif // ENERGY_PROFILE_H
@@ -0,0 +1,137 @@
+#include "EventTelemetry.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+const char* const TELEMETRY_EVENT_NAMES[TELEMETRY_EVENT_COUNT] = {
+    "gap", "wake", "wifi_ms", "http_geo", "http_uv", "bytes_geo", "bytes_uv", "render_ms", "sleep_min", "bench"
+};
+
+void telemetryReset(TelemetryLog& log) {
+    log.next = 0;
+    log.count = 0;
+    log.lastEpoch = 0;
+}
+
+static void telemetryPush(TelemetryLog& log, uint16_t deltaSec, uint16_t payload, uint8_t event) {
+    TelemetryRecord& record = log.records[log.next];
+    record.deltaSec = deltaSec;
+    record.payload = payload;
+    record.event = event;
+    log.next = (log.next + 1) % TELEMETRY_LOG_RECORDS;
+    if (log.count < TELEMETRY_LOG_RECORDS) log.count++;
+}
+
+void telemetryAppend(TelemetryLog& log, uint32_t nowSec, TelemetryEvent event, uint16_t payload) {
+    // Unknown or stepped-back time: 0. So is the first known time, which has nothing to measure from.
+    uint32_t delta = (log.lastEpoch && nowSec > log.lastEpoch) ? nowSec - log.lastEpoch : 0;
+    if (delta > 0xFFFF) {
+        telemetryPush(log, (uint16_t)delta, (uint16_t)(delta >> 16), TELEMETRY_EVENT_TIME_GAP);
+        delta = 0;
+    }
+    telemetryPush(log, (uint16_t)delta, payload, event);
+    if (nowSec > log.lastEpoch) log.lastEpoch = nowSec;
+}
+
+uint16_t telemetrySaturate(int64_t value) {
+    return value < 0 ? 0 : (value > 0xFFFE ? 0xFFFE : (uint16_t)value);
+}
+
+uint16_t telemetrySigned(int32_t value) {
+    if (value < INT16_MIN) value = INT16_MIN;
+    if (value > INT16_MAX) value = INT16_MAX;
+    return (uint16_t)(int16_t)value;
+}
+
+int32_t telemetryPayloadValue(const TelemetryRecord& record) {
+    bool isSigned = (record.event == TELEMETRY_EVENT_HTTP_GEO || record.event == TELEMETRY_EVENT_HTTP_UV);
+    return isSigned ? (int32_t)(int16_t)record.payload : (int32_t)record.payload;
+}
+
+uint32_t telemetryRecordDeltaSec(const TelemetryRecord& record) {
+    return record.deltaSec + (record.event == TELEMETRY_EVENT_TIME_GAP ? ((uint32_t)record.payload << 16) : 0);
+}
+
+const TelemetryRecord& telemetryRecordAt(const TelemetryLog& log, uint16_t i) {
+    uint16_t first = (log.next + TELEMETRY_LOG_RECORDS - log.count) % TELEMETRY_LOG_RECORDS;
+    return log.records[(first + i) % TELEMETRY_LOG_RECORDS];
+}
+
+uint32_t telemetryOldestEpoch(const TelemetryLog& log) {
+    uint32_t span = 0; // Seconds from the oldest record to the newest
+    for (uint16_t i = 1; i < log.count; ++i) span += telemetryRecordDeltaSec(telemetryRecordAt(log, i));
+    return log.lastEpoch - span;
+}
+
+size_t telemetryFormatHeader(const TelemetryLog& log, char* out, size_t size) {
+    int n = snprintf(out, size, "TLM v1 records=%u last_epoch=%lu", (unsigned)log.count, (unsigned long)log.lastEpoch);
+    return n < 0 ? 0 : (size_t)n;
+}
+
+size_t telemetryFormatRecord(const TelemetryRecord& record, char* out, size_t size) {
+    int n = snprintf(out, size, "%02X%02X%02X%02X%02X", record.deltaSec & 0xFF, record.deltaSec >> 8, record.payload & 0xFF,
+                     record.payload >> 8, record.event);
+    return n < 0 ? 0 : (size_t)n;
+}
+
+size_t telemetryFormatEntry(uint32_t epoch, const TelemetryRecord& record, char* out, size_t size) {
+    char when[24] = "-";
+    time_t t = epoch;
+    struct tm tmUtc;
+    if (epoch > 1600000000 && gmtime_r(&t, &tmUtc)) strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", &tmUtc);
+    const char* name = record.event < TELEMETRY_EVENT_COUNT ? TELEMETRY_EVENT_NAMES[record.event] : "?";
+    int n = snprintf(out, size, "%10lu %-20s %-10s %ld", (unsigned long)epoch, when, name, (long)telemetryPayloadValue(record));
+    return n < 0 ? 0 : (size_t)n;
+}
+
+static int hexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+// Ten hex digits, as telemetryFormatRecord() writes them.
+static bool telemetryParseRecord(const char* text, TelemetryRecord& record) {
+    uint8_t bytes[TELEMETRY_RECORD_HEX_CHARS / 2];
+    for (int i = 0; i < TELEMETRY_RECORD_HEX_CHARS / 2; ++i) {
+        int high = hexDigit(text[2 * i]);
+        int low = high < 0 ? -1 : hexDigit(text[2 * i + 1]); // Stops at the string's end
+        if (high < 0 || low < 0) return false;
+        bytes[i] = (uint8_t)(high << 4 | low);
+    }
+    record.deltaSec = (uint16_t)(bytes[0] | bytes[1] << 8);
+    record.payload = (uint16_t)(bytes[2] | bytes[3] << 8);
+    record.event = bytes[4];
+    return true;
+}
+
+bool telemetryParseDump(const char* text, TelemetryLog& log) {
+    telemetryReset(log);
+    unsigned records = 0;
+    unsigned long lastEpoch = 0;
+    bool headerSeen = false;
+    for (const char* line = text; line && *line; line = strchr(line, '\n') ? strchr(line, '\n') + 1 : nullptr) {
+        if (!headerSeen) {
+            if (sscanf(line, "TLM v1 records=%u last_epoch=%lu", &records, &lastEpoch) == 2) {
+                if (records > TELEMETRY_LOG_RECORDS) return false;
+                headerSeen = true;
+            }
+            continue;
+        }
+        if (strncmp(line, "TLM ", 4) != 0) continue;
+        const char* p = line + 4;
+        while (*p && *p != '\n' && *p != '\r') {
+            if (*p == ' ') {
+                p++;
+                continue;
+            }
+            TelemetryRecord record;
+            if (log.count >= records || !telemetryParseRecord(p, record)) return false;
+            telemetryPush(log, record.deltaSec, record.payload, record.event);
+            p += TELEMETRY_RECORD_HEX_CHARS;
+        }
+    }
+    log.lastEpoch = (uint32_t)lastEpoch;
+    return headerSeen && log.count == records;
+}
@@ -0,0 +1,80 @@
+#ifndef EVENT_TELEMETRY_H
+#define EVENT_TELEMETRY_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Compact binary event log kept in RTC slow memory, so LPM wakes with no serial listener still leave a
+// trace. Each record stores the seconds since the previous record; the epoch of the newest record is
+// kept alongside, and readers walk back from it. Gaps over 65535 s get a TIME_GAP record of their own.
+// The firmware supplies the time and the locking; this does the record layout, the dump text and its
+// parser (so an archived "tlm" dump can be decoded off the device). No clock or serial access here.
+
+#define TELEMETRY_LOG_RECORDS 256   // Fixed-size records kept in RTC memory (5 bytes of data each)
+#define TELEMETRY_RECORD_HEX_CHARS 10
+
+enum TelemetryEvent : uint8_t {
+    TELEMETRY_EVENT_TIME_GAP,      // deltaSec = low 16 bits of the gap, payload = high 16 bits
+    TELEMETRY_EVENT_WAKE,          // esp_sleep_wakeup_cause_t
+    TELEMETRY_EVENT_WIFI_CONNECT,  // ms to connected, 0xFFFF = all networks failed
+    TELEMETRY_EVENT_HTTP_GEO,      // HTTP status, negative HttpReaderError codes as int16
+    TELEMETRY_EVENT_HTTP_UV,
+    TELEMETRY_EVENT_PAYLOAD_GEO,   // Response bytes, saturating
+    TELEMETRY_EVENT_PAYLOAD_UV,
+    TELEMETRY_EVENT_RENDER,        // displayInfo() ms
+    TELEMETRY_EVENT_SLEEP,         // Deep sleep minutes requested
+    TELEMETRY_EVENT_BENCH,         // Written by the "bench" command, payload = sequence
+    TELEMETRY_EVENT_COUNT
+};
+extern const char* const TELEMETRY_EVENT_NAMES[TELEMETRY_EVENT_COUNT];
+
+struct TelemetryRecord {
+    uint16_t deltaSec;   // Seconds since the previous record
+    uint16_t payload;
+    uint8_t event;       // TelemetryEvent
+};
+
+// Ring of the last TELEMETRY_LOG_RECORDS records; next is the slot the following record takes.
+struct TelemetryLog {
+    TelemetryRecord records[TELEMETRY_LOG_RECORDS];
+    uint16_t next;
+    uint16_t count;
+    uint32_t lastEpoch;  // Epoch of the newest record (0 while time was never known)
+};
+
+void telemetryReset(TelemetryLog& log);
+
+// Hot path: a few stores, no allocation, no libc calls. nowSec is 0 while the time is unknown; unknown
+// or stepped-back time, and the first known time after a reset, log a delta of 0. A gap over 0xFFFF s
+// writes a TIME_GAP record first.
+void telemetryAppend(TelemetryLog& log, uint32_t nowSec, TelemetryEvent event, uint16_t payload);
+
+// Payload conventions: counts and durations saturate at 0xFFFE (0xFFFF is left for "failed"); HTTP
+// results are stored as int16 so negative HttpReaderError codes survive.
+uint16_t telemetrySaturate(int64_t value);
+uint16_t telemetrySigned(int32_t value);
+int32_t telemetryPayloadValue(const TelemetryRecord& record); // Sign-extended for the HTTP events
+
+// Seconds a record adds to the walk: deltaSec, plus the high bits a TIME_GAP carries.
+uint32_t telemetryRecordDeltaSec(const TelemetryRecord& record);
+
+// i-th oldest record (0 .. count-1).
+const TelemetryRecord& telemetryRecordAt(const TelemetryLog& log, uint16_t i);
+
+// Epoch of the oldest record, walking back from lastEpoch through the deltas of the newer ones.
+uint32_t telemetryOldestEpoch(const TelemetryLog& log);
+
+// Dump text, as printed by the "tlm" command: a header line, then the records oldest first as hex
+// (deltaSec, payload little-endian, then event), 16 per "TLM " line. The formatters truncate like
+// snprintf and return the length they would have had.
+size_t telemetryFormatHeader(const TelemetryLog& log, char* out, size_t size);
+size_t telemetryFormatRecord(const TelemetryRecord& record, char* out, size_t size);
+// One decoded record: epoch, UTC time when the epoch is plausible, event name, payload value.
+size_t telemetryFormatEntry(uint32_t epoch, const TelemetryRecord& record, char* out, size_t size);
+
+// Parses a dump back into log (records oldest first). Unrelated lines in between are skipped, so a
+// whole serial capture can be fed in. Returns false without a header, on a malformed record, or when
+// the record count does not match the header.
+bool telemetryParseDump(const char* text, TelemetryLog& log);
+
+#endif // EVENT_TELEMETRY_H
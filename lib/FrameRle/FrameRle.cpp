@@ -0,0 +1,52 @@
+#include "FrameRle.h"
+#include <string.h>
+
+int frameRlePaletteIndex(uint16_t* palette, uint16_t& paletteSize, uint16_t color) {
+    for (int i = paletteSize - 1; i >= 0; --i) { // Recent colours are likelier
+        if (palette[i] == color) return i;
+    }
+    if (paletteSize >= FRAME_RLE_MAX_COLORS) return -1;
+    palette[paletteSize] = color;
+    return paletteSize++;
+}
+
+// End of the run starting at i: equal pixels, at most FRAME_RLE_MAX_RUN of them.
+static uint32_t runEnd(const uint16_t* pixels, uint32_t pixelCount, uint32_t i) {
+    uint32_t end = i + 1;
+    while (end < pixelCount && pixels[end] == pixels[i] && end - i < FRAME_RLE_MAX_RUN) end++;
+    return end;
+}
+
+bool frameRleScan(const uint16_t* pixels, uint32_t pixelCount, FrameRleScan& scan) {
+    scan.paletteSize = 0;
+    scan.runCount = 0;
+    for (uint32_t i = 0; i < pixelCount; i = runEnd(pixels, pixelCount, i), ++scan.runCount) {
+        if (frameRlePaletteIndex(scan.palette, scan.paletteSize, pixels[i]) < 0) return false;
+    }
+    return true;
+}
+
+size_t frameRleBytes(const FrameRleScan& scan) {
+    return scan.paletteSize * sizeof(uint16_t) + scan.runCount * sizeof(FrameRleRun);
+}
+
+FrameRle frameRleEncode(const uint16_t* pixels, uint32_t pixelCount, const FrameRleScan& scan, void* block, bool swapPalette) {
+    FrameRle frame;
+    frame.palette = (uint16_t*)block;
+    frame.runs = (FrameRleRun*)(frame.palette + scan.paletteSize);
+    frame.paletteSize = scan.paletteSize;
+    frame.runCount = scan.runCount;
+    memcpy(frame.palette, scan.palette, scan.paletteSize * sizeof(uint16_t));
+    uint16_t lookupSize = scan.paletteSize; // Every colour is present: lookups never append
+    uint32_t run = 0;
+    for (uint32_t i = 0; i < pixelCount; ++run) {
+        uint32_t end = runEnd(pixels, pixelCount, i);
+        frame.runs[run].length = (uint8_t)(end - i);
+        frame.runs[run].colorIndex = (uint8_t)frameRlePaletteIndex(frame.palette, lookupSize, pixels[i]);
+        i = end;
+    }
+    if (swapPalette) {
+        for (uint16_t i = 0; i < frame.paletteSize; ++i) frame.palette[i] = (uint16_t)((frame.palette[i] >> 8) | (frame.palette[i] << 8));
+    }
+    return frame;
+}
@@ -0,0 +1,48 @@
+#ifndef FRAME_RLE_H
+#define FRAME_RLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Palette + run-length encoding of 16 bpp frames for the UI page cache. A page uses a few text colours
+// plus the UV ramp, so a frame is kept as its palette (at most 256 colours) and 2-byte runs of up to
+// 255 pixels: glyph-heavy pages come to 10-20 KB instead of the 64,800 B of a 240x135 sprite.
+// Encoding is two passes: frameRleScan() sizes the result, frameRleEncode() fills a block of exactly
+// frameRleBytes() that the caller allocated.
+
+#define FRAME_RLE_MAX_COLORS 256
+#define FRAME_RLE_MAX_RUN 255
+
+struct FrameRleRun {
+    uint8_t length;       // 1-FRAME_RLE_MAX_RUN pixels
+    uint8_t colorIndex;
+};
+
+struct FrameRle {
+    uint16_t* palette;    // Start of the caller's block: palette, then the runs
+    FrameRleRun* runs;
+    uint16_t paletteSize;
+    uint32_t runCount;
+};
+
+// First pass: the frame's colours in order of appearance and its run count.
+struct FrameRleScan {
+    uint16_t palette[FRAME_RLE_MAX_COLORS];
+    uint16_t paletteSize;
+    uint32_t runCount;
+};
+
+// Index of color in the palette, appended if new; -1 once the palette is full.
+int frameRlePaletteIndex(uint16_t* palette, uint16_t& paletteSize, uint16_t color);
+
+// Fills scan; false if the frame has more than FRAME_RLE_MAX_COLORS colours.
+bool frameRleScan(const uint16_t* pixels, uint32_t pixelCount, FrameRleScan& scan);
+
+// Bytes of the encoded frame: palette plus runs.
+size_t frameRleBytes(const FrameRleScan& scan);
+
+// Second pass into block (frameRleBytes(scan) bytes, 2-byte aligned). swapPalette stores the palette
+// byte-swapped: TFT_eSprite keeps its pixels in panel byte order, pushBlock() takes plain RGB565.
+FrameRle frameRleEncode(const uint16_t* pixels, uint32_t pixelCount, const FrameRleScan& scan, void* block, bool swapPalette);
+
+#endif // FRAME_RLE_H
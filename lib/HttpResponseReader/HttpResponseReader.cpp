@@ -0,0 +1,121 @@
+#include "HttpResponseReader.h"
+#include <esp_heap_caps.h>
+#include <limits.h>
+
+const char* httpHeaderValue(const char* line, const char* name) {
+    size_t nameLength = strlen(name);
+    if (strncasecmp(line, name, nameLength) != 0 || line[nameLength] != ':') return nullptr;
+    const char* value = line + nameLength + 1;
+    while (*value == ' ' || *value == '\t') value++;
+    return value;
+}
+
+int HttpResponseReader::get(const char* request, size_t requestLength, uint32_t timeoutMs) {
+    requestStartMs = phaseStartMs = millis();
+    phaseDeadlineMs = timeoutMs;
+    heapBefore = heapLowest = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    if (!client.connected()) return HTTP_READER_ERROR_CONNECTION_REFUSED;
+    if (client.write((const uint8_t*)request, requestLength) != requestLength) return HTTP_READER_ERROR_SEND_FAILED;
+
+    char line[HTTP_HEADER_LINE_BYTES];
+    size_t headBudget = HTTP_HEAD_MAX_BYTES;
+    int length = readLine(line, sizeof(line), headBudget);
+    int status = (length > 9 && strncmp(line, "HTTP/1.", 7) == 0 && line[8] == ' ') ? atoi(line + 9) : 0;
+    if (length >= 0 && status <= 0) return HTTP_READER_ERROR_NO_HTTP_SERVER;
+    while (length > 0) {
+        length = readLine(line, sizeof(line), headBudget);
+        const char* value;
+        if ((value = httpHeaderValue(line, "Content-Length"))) {
+            // Negative or overflowing lengths are refused as too large
+            unsigned long long declared = (*value == '-') ? ULLONG_MAX : strtoull(value, nullptr, 10);
+            contentLength = declared > INT32_MAX ? INT32_MAX : (int32_t)declared;
+        }
+        else if ((value = httpHeaderValue(line, "Content-Type"))) jsonType = strstr(value, "json") != nullptr;
+        else if ((value = httpHeaderValue(line, "Content-Encoding"))) identityEncoding = strcasecmp(value, "identity") == 0;
+        else if ((value = httpHeaderValue(line, "Transfer-Encoding"))) chunked = strstr(value, "chunked") != nullptr;
+    }
+    if (length < 0) {
+        if (timedOut) return HTTP_READER_ERROR_READ_TIMEOUT;
+        return lineTooLong ? HTTP_READER_ERROR_HEAD_TOO_LARGE : HTTP_READER_ERROR_CONNECTION_LOST;
+    }
+    if (chunked) contentLength = -1; // Transfer-Encoding wins over a stray Content-Length
+    return status;
+}
+
+DeserializationError HttpResponseReader::parseJson(JsonDocument& doc, size_t maxBytes, uint32_t deadlineMs) {
+    readResult = RESPONSE_READ_OK;
+    if (!jsonType) readResult = RESPONSE_READ_BAD_TYPE;
+    else if (!identityEncoding) readResult = RESPONSE_READ_BAD_ENCODING;
+    else if (contentLength > (int32_t)maxBytes) readResult = RESPONSE_READ_TOO_LARGE;
+    if (readResult != RESPONSE_READ_OK) return DeserializationError::EmptyInput;
+    this->maxBytes = maxBytes;
+    remaining = contentLength > 0 ? (uint32_t)contentLength : 0;
+    phaseStartMs = millis();
+    phaseDeadlineMs = deadlineMs;
+    DeserializationError error = deserializeJson(doc, *this);
+    if (overflowed) readResult = RESPONSE_READ_TOO_LARGE;
+    else if (timedOut) readResult = RESPONSE_READ_TIMEOUT;
+    else if (failed) readResult = RESPONSE_READ_FAILED;
+    return error;
+}
+
+// Next byte off the socket; -1 once the peer has closed and the buffer is drained, or the deadline passed.
+// The deadline is checked on every refill, so a peer that never lets the socket run dry is cut off too.
+int HttpResponseReader::nextRawByte() {
+    while (bufferPos >= bufferLength) {
+        if (closed || timedOut) return -1;
+        if (millis() - phaseStartMs > phaseDeadlineMs) { timedOut = true; return -1; }
+        int n = client.read(buffer, sizeof(buffer));
+        if (n > 0) {
+            bufferPos = 0;
+            bufferLength = (size_t)n;
+            uint32_t freeHeap = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+            if (freeHeap < heapLowest) heapLowest = freeHeap;
+            break;
+        }
+        if (!client.connected() && client.available() <= 0) { closed = true; return -1; }
+        delay(1);
+    }
+    return buffer[bufferPos++];
+}
+
+// One head or chunk-size line without its CRLF, truncated to size - 1. Every byte read, the LF included,
+// comes off rawBudget. Returns its length, -1 if cut off or once the budget runs out.
+int HttpResponseReader::readLine(char* line, size_t size, size_t& rawBudget) {
+    size_t length = 0;
+    for (int c = nextRawByte();; c = nextRawByte()) {
+        if (c < 0) return -1;
+        if (rawBudget == 0) { lineTooLong = true; return -1; }
+        rawBudget--;
+        if (c == '\n') break;
+        if (c != '\r' && length < size - 1) line[length++] = (char)c;
+    }
+    line[length] = '\0';
+    return (int)length;
+}
+
+// Body bytes with the chunk framing removed; -1 at the end of the body or once it is cut off.
+int HttpResponseReader::nextBodyByte() {
+    if (ended) return -1;
+    if (!chunked && contentLength >= 0 && remaining == 0) { ended = true; return -1; }
+    if (chunked && remaining == 0) {
+        char line[16];
+        char* sizeEnd = line;
+        size_t lineBudget = HTTP_HEADER_LINE_BYTES; // Size and any extensions; a line past this is not framing
+        bool framed = !chunkOpen || readLine(line, sizeof(line), lineBudget) == 0; // CRLF closing the previous chunk's data
+        if (framed && readLine(line, sizeof(line), lineBudget) > 0) remaining = strtoul(line, &sizeEnd, 16);
+        if (sizeEnd == line) { failed = true; ended = true; return -1; }
+        if (remaining == 0) { ended = true; return -1; } // Last chunk; trailers are left unread
+        chunkOpen = true;
+    }
+    int c = nextRawByte();
+    if (c < 0) {
+        if (chunked || contentLength >= 0) failed = true; // Only a read-to-close body may end on close
+        ended = true;
+        return -1;
+    }
+    if (bodyBytes >= maxBytes) { overflowed = true; ended = true; return -1; }
+    bodyBytes++;
+    if (chunked || contentLength >= 0) remaining--;
+    return c;
+}
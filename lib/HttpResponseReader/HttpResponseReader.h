@@ -0,0 +1,89 @@
+#ifndef HTTP_RESPONSE_READER_H
+#define HTTP_RESPONSE_READER_H
+
+#include <Arduino.h>
+#include <Client.h>
+#include <ArduinoJson.h>
+
+// Lean HTTP/1.1 GET for the firmware's two fixed endpoints on a raw WiFiClient/WiFiClientSecure. The
+// request goes out as prebuilt bytes, only the status line and the Content-Length, -Type, -Encoding and
+// Transfer-Encoding headers are looked at, and the body is de-chunked through a fixed buffer straight
+// into deserializeJson(): no URL, header or body Strings, and nothing beyond the document is allocated.
+
+#define HTTP_READ_BUFFER_BYTES 256                 // Socket reads between the TLS/TCP client and the JSON parser
+#define HTTP_HEADER_LINE_BYTES 96                  // Longer header lines are truncated; only short ones are looked at
+const size_t HTTP_HEAD_MAX_BYTES = 4096;           // Status line and headers; a longer head fails get() unread
+const uint32_t RESPONSE_READ_DEADLINE_MS = 20000;  // Whole-body deadline; the request's own timeout only covers the head
+
+// Negative results of get(). Numerically HTTPClient's HTTPC_ERROR_* codes, so telemetry reads as before.
+enum HttpReaderError : int {
+    HTTP_READER_ERROR_CONNECTION_REFUSED = -1,
+    HTTP_READER_ERROR_SEND_FAILED = -2,
+    HTTP_READER_ERROR_CONNECTION_LOST = -5,
+    HTTP_READER_ERROR_NO_HTTP_SERVER = -7,
+    HTTP_READER_ERROR_HEAD_TOO_LARGE = -8, // HTTPC_ERROR_TOO_LESS_RAM
+    HTTP_READER_ERROR_READ_TIMEOUT = -11
+};
+const int HTTP_STATUS_OK = 200;
+
+enum ResponseReadResult : uint8_t {
+    RESPONSE_READ_OK, RESPONSE_READ_BAD_TYPE, RESPONSE_READ_TOO_LARGE, RESPONSE_READ_TIMEOUT, RESPONSE_READ_FAILED,
+    RESPONSE_READ_BAD_ENCODING
+};
+const char* const RESPONSE_READ_RESULT_NAMES[] = { "ok", "not JSON", "too large", "too slow", "read failed", "compressed" };
+
+// Value of a "Name: value" header line when the name matches (case-insensitive), else nullptr.
+const char* httpHeaderValue(const char* line, const char* name);
+
+class HttpResponseReader : public Stream {
+public:
+    explicit HttpResponseReader(Client& client) : client(client) { setTimeout(0); } // Stream::timedRead() must not spin at end of body
+
+    // Writes the prebuilt request and reads the response head. Returns the HTTP status, or a negative
+    // HttpReaderError. The client must already be connected (TLS is set up by the caller).
+    int get(const char* request, size_t requestLength, uint32_t timeoutMs);
+
+    // Parses the body of a 200 response into doc as it arrives. Non-JSON types, compressed bodies and a
+    // declared length over maxBytes are refused unread; a body that outgrows maxBytes or deadlineMs is
+    // cut off (and fails to parse). readResult says why.
+    DeserializationError parseJson(JsonDocument& doc, size_t maxBytes, uint32_t deadlineMs = RESPONSE_READ_DEADLINE_MS);
+
+    int available() override { return peeked >= 0 ? 1 : (int)(bufferLength - bufferPos); }
+    int read() override { int c = peek(); peeked = -1; return c; }
+    int peek() override { if (peeked < 0) peeked = nextBodyByte(); return peeked; }
+    size_t write(uint8_t) override { return 0; }
+    uint32_t elapsedMs() const { return millis() - requestStartMs; }
+    uint32_t heapPeakBytes() const { return heapBefore > heapLowest ? heapBefore - heapLowest : 0; } // Sampled per socket read
+    ResponseReadResult readResult = RESPONSE_READ_OK;
+    size_t bodyBytes = 0;
+
+private:
+    int nextRawByte();
+    int readLine(char* line, size_t size, size_t& rawBudget);
+    int nextBodyByte();
+    Client& client;
+    uint8_t buffer[HTTP_READ_BUFFER_BYTES];
+    size_t bufferPos = 0;
+    size_t bufferLength = 0;
+    int peeked = -1;
+    uint32_t requestStartMs = 0;
+    uint32_t phaseStartMs = 0;    // Head, then body: each has its own deadline
+    uint32_t phaseDeadlineMs = 0;
+    uint32_t heapBefore = 0;
+    uint32_t heapLowest = 0;
+    int32_t contentLength = -1;   // -1: not sent (read to close, or chunked)
+    uint32_t remaining = 0;       // Bytes left of the declared length or of the current chunk
+    size_t maxBytes = 0;
+    bool chunked = false;
+    bool jsonType = true;         // Content-Type absent or JSON
+    bool identityEncoding = true; // Content-Encoding absent or identity
+    bool chunkOpen = false;       // A chunk's data was read; its CRLF comes before the next size line
+    bool ended = false;
+    bool closed = false;
+    bool timedOut = false;
+    bool lineTooLong = false;     // A head or chunk-size line ran past its raw byte budget
+    bool overflowed = false;
+    bool failed = false;
+};
+
+#endif // HTTP_RESPONSE_READER_H
@@ -0,0 +1,80 @@
+#include "LocationResolver.h"
+#include <math.h>
+#include <string.h>
+
+void locationReset(LocationState& state) {
+    memset(&state, 0, sizeof(state));
+    state.decision = LOCATION_SOURCE_SECRETS;
+}
+
+float locationIpConfidence(const LocationState& state, uint32_t now, const LocationConfig& config) {
+    if (state.ipFix.epoch == 0) return 0.0f;
+    uint32_t age = (now > state.ipFix.epoch) ? now - state.ipFix.epoch : 0;
+    return config.ipConfidence * exp2f(-(float)age / config.ipHalfLifeSec);
+}
+
+LocationSource locationDecide(LocationState& state, uint32_t now, const LocationConfig& config) {
+    if (now == 0 || now >= state.decisionUntil) {
+        bool useIp = locationIpConfidence(state, now, config) > config.secretsConfidence;
+        state.decision = useIp ? LOCATION_SOURCE_IP : LOCATION_SOURCE_SECRETS;
+        // IP holds until the kept fix decays past the secrets; secrets hold until a new fix arrives
+        state.decisionUntil = useIp
+            ? state.ipFix.epoch + (uint32_t)(config.ipHalfLifeSec * log2f(config.ipConfidence / config.secretsConfidence))
+            : UINT32_MAX;
+    }
+    if (state.decision != LOCATION_SOURCE_IP) return LOCATION_SOURCE_SECRETS;
+    bool fresh = now == 0 || now - state.ipFix.epoch < config.ipRefreshSec;
+    return fresh ? LOCATION_SOURCE_IP : LOCATION_SOURCE_CACHED;
+}
+
+uint32_t locationBackoffSec(uint8_t failures, const LocationConfig& config) {
+    if (failures == 0) return 0;
+    uint8_t doublings = (failures - 1 < 16) ? failures - 1 : 16;
+    uint64_t backoff = (uint64_t)config.retryMinSec << doublings;
+    return backoff < config.retryMaxSec ? (uint32_t)backoff : config.retryMaxSec;
+}
+
+void locationLookupSucceeded(LocationState& state, float latitude, float longitude, const char* label, uint32_t now) {
+    state.ipFix.latitude = latitude;
+    state.ipFix.longitude = longitude;
+    state.ipFix.epoch = now ? now : 1;
+    strncpy(state.ipFix.label, label, sizeof(state.ipFix.label) - 1);
+    state.ipFix.label[sizeof(state.ipFix.label) - 1] = '\0';
+    state.failures = 0;
+    state.retryEpoch = 0;
+    state.retryWaitSec = 0;
+    state.decisionUntil = 0;
+}
+
+void locationLookupFailed(LocationState& state, uint32_t now, const LocationConfig& config) {
+    if (state.failures < UINT8_MAX) state.failures++;
+    uint32_t backoff = locationBackoffSec(state.failures, config);
+    state.retryEpoch = now ? now + backoff : 0;
+    state.retryWaitSec = now ? 0 : backoff;
+}
+
+void locationRetryElapse(LocationState& state, uint32_t elapsedSec, uint32_t now) {
+    if (state.retryEpoch != 0 || state.failures == 0) return;
+    state.retryWaitSec = (state.retryWaitSec > elapsedSec) ? state.retryWaitSec - elapsedSec : 0;
+    if (now != 0) {
+        state.retryEpoch = now + state.retryWaitSec;
+        state.retryWaitSec = 0;
+    }
+}
+
+uint32_t locationLookupDueInSec(const LocationState& state, uint32_t now, const LocationConfig& config) {
+    uint32_t due = 0;
+    if (state.ipFix.epoch != 0) {
+        if (now == 0) return UINT32_MAX;
+        uint32_t refreshAt = state.ipFix.epoch + config.ipRefreshSec;
+        due = (refreshAt > now) ? refreshAt - now : 0;
+    }
+    if (state.failures > 0) {
+        uint32_t wait;
+        if (state.retryEpoch == 0) wait = state.retryWaitSec;
+        else if (now != 0) wait = (state.retryEpoch > now) ? state.retryEpoch - now : 0;
+        else wait = locationBackoffSec(state.failures, config); // The time was lost since: wait a full backoff
+        if (wait > due) due = wait;
+    }
+    return due;
+}
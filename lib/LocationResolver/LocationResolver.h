@@ -0,0 +1,68 @@
+#ifndef LOCATION_RESOLVER_H
+#define LOCATION_RESOLVER_H
+
+#include <stdint.h>
+
+// Location decision between the configured (secrets) position and IP geolocation fixes. An IP fix
+// starts above the secrets' confidence and decays with age, so the decision only changes when a fix
+// arrives, the pin is toggled, or the kept fix decays past the secrets: it is cached until then.
+// Failed lookups back off exponentially and leave the decision alone. While the time is unknown the
+// backoff is kept as seconds still to wait, counted down by the caller on monotonic time, and moved
+// onto the epoch once the time is known. The firmware does the lookups, the clock and the timer;
+// this only does the arithmetic. No clock or network access here.
+
+#define LOCATION_LABEL_CHARS 32   // "IP: <city>"; also the size of the location line kept in RTC memory
+
+enum LocationSource : uint8_t { LOCATION_SOURCE_SECRETS, LOCATION_SOURCE_IP, LOCATION_SOURCE_CACHED };
+
+struct LocationConfig {
+    float secretsConfidence;
+    float ipConfidence;        // A fresh IP fix
+    uint32_t ipHalfLifeSec;    // A kept fix loses half its confidence per half-life
+    uint32_t ipRefreshSec;     // Fixes younger than this are reused without a lookup
+    uint32_t retryMinSec;      // First retry after a failed lookup, doubling per failure...
+    uint32_t retryMaxSec;      // ...up to this
+};
+
+struct LocationFix {
+    float latitude;
+    float longitude;
+    uint32_t epoch;            // 0: never; 1: taken while the time was unknown
+    char label[LOCATION_LABEL_CHARS];
+};
+
+// Kept across deep sleep in RTC memory.
+struct LocationState {
+    LocationFix ipFix;
+    uint8_t failures;          // Consecutive failed lookups
+    uint32_t retryEpoch;       // Next lookup after a failure; 0 while retryWaitSec holds it instead
+    uint32_t retryWaitSec;     // Backoff left, while the time is unknown
+    uint8_t decision;          // LOCATION_SOURCE_SECRETS or _IP (the kept fix)
+    uint32_t decisionUntil;    // The decision holds before this epoch; 0 = recompute
+};
+
+void locationReset(LocationState& state);
+
+// Confidence of the kept fix, 0 without one. An unknown now (0) counts as age 0.
+float locationIpConfidence(const LocationState& state, uint32_t now, const LocationConfig& config);
+
+// Recomputes the decision when it is due (time unknown, or past decisionUntil) and returns the source
+// to use: SECRETS, IP for a fix younger than ipRefreshSec, CACHED for an older one.
+LocationSource locationDecide(LocationState& state, uint32_t now, const LocationConfig& config);
+
+// Wait after `failures` consecutive failed lookups: retryMinSec doubling per failure, up to retryMaxSec.
+uint32_t locationBackoffSec(uint8_t failures, const LocationConfig& config);
+
+// now is 0 while the time is unknown.
+void locationLookupSucceeded(LocationState& state, float latitude, float longitude, const char* label, uint32_t now);
+void locationLookupFailed(LocationState& state, uint32_t now, const LocationConfig& config);
+
+// Counts a relative backoff down by monotonic seconds, and moves what is left onto the epoch once now
+// is known (non-zero). An epoch deadline is left alone.
+void locationRetryElapse(LocationState& state, uint32_t elapsedSec, uint32_t now);
+
+// Seconds until the next lookup is due: 0 when due, UINT32_MAX while a fix exists but the time is
+// unknown (it cannot age, so there is nothing to refresh yet). A pending backoff always holds.
+uint32_t locationLookupDueInSec(const LocationState& state, uint32_t now, const LocationConfig& config);
+
+#endif // LOCATION_RESOLVER_H
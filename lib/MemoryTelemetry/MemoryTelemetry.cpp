@@ -0,0 +1,55 @@
+#include "MemoryTelemetry.h"
+
+float memoryFragmentationRatio(uint32_t freeHeap, uint32_t largestBlock) {
+    return freeHeap ? (float)largestBlock / freeHeap : 1.0f;
+}
+
+bool memoryStackLow(const MemorySample& sample, const MemoryTrendConfig& config) {
+    return (sample.loopStackFree && sample.loopStackFree < config.stackWarnBytes) ||
+           (sample.networkStackFree && sample.networkStackFree < config.stackWarnBytes);
+}
+
+MemoryTrend memoryTrendEvaluate(const MemoryTrendPoint* points, uint8_t count, const MemorySample& latest,
+                                const MemoryTrendConfig& config) {
+    MemoryTrend trend = { 0, 1.0f, 1.0f, 0.0f };
+    if (count > 0 && memoryStackLow(latest, config)) trend.flags |= MEMORY_TREND_LOW_STACK;
+    if (count < config.minSamples || count < 2) return trend;
+
+    float ratioSum[2] = {0.0f, 0.0f};
+    double meanT = 0.0, meanHeap = 0.0;
+    for (uint8_t i = 0; i < count; ++i) {
+        ratioSum[i >= count / 2] += memoryFragmentationRatio(points[i].freeHeap, points[i].largestBlock);
+        meanT += points[i].uptimeSec;
+        meanHeap += points[i].freeHeap;
+    }
+    trend.olderRatio = ratioSum[0] / (count / 2);
+    trend.newerRatio = ratioSum[1] / (count - count / 2);
+    if (trend.newerRatio < config.fragWarnRatio && trend.olderRatio - trend.newerRatio >= config.fragTrendDrop) {
+        trend.flags |= MEMORY_TREND_FRAGMENTING;
+    }
+
+    meanT /= count;
+    meanHeap /= count;
+    double covariance = 0.0, variance = 0.0;
+    for (uint8_t i = 0; i < count; ++i) {
+        covariance += (points[i].uptimeSec - meanT) * (points[i].freeHeap - meanHeap);
+        variance += (points[i].uptimeSec - meanT) * (points[i].uptimeSec - meanT);
+    }
+    uint32_t spanSec = points[count - 1].uptimeSec - points[0].uptimeSec;
+    if (variance > 0.0) trend.bytesPerHour = (float)(covariance / variance * 3600.0);
+    if (spanSec >= config.leakMinSpanSec && trend.bytesPerHour < -config.leakWarnBytesPerHour) {
+        trend.flags |= MEMORY_TREND_LEAKING;
+    }
+    return trend;
+}
+
+void memorySiteRecord(MemorySiteStats& stats, const MemorySample& before, const MemorySample& after) {
+    int32_t delta = (int32_t)after.freeHeap - (int32_t)before.freeHeap;
+    stats.calls++;
+    stats.deltaSum += delta;
+    if (delta < stats.deltaWorst) stats.deltaWorst = delta;
+}
+
+int32_t memorySiteMeanDelta(const MemorySiteStats& stats) {
+    return stats.calls ? (int32_t)(stats.deltaSum / (int64_t)stats.calls) : 0;
+}
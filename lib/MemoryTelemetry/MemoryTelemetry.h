@@ -0,0 +1,63 @@
+#ifndef MEMORY_TELEMETRY_H
+#define MEMORY_TELEMETRY_H
+
+#include <stdint.h>
+
+// Heap and stack trend judgement: the firmware samples the heap and the task stacks around each
+// fetch, render and persistence call and keeps the history; this scores fragmentation (largest
+// block / free heap, older half of the history against the newer), the free-heap slope over uptime,
+// the stack headroom, and the per-call-site heap deltas. No heap or RTOS access here.
+
+enum MemoryTrendFlag : uint8_t { MEMORY_TREND_FRAGMENTING = 1, MEMORY_TREND_LEAKING = 2, MEMORY_TREND_LOW_STACK = 4 };
+
+struct MemoryTrendConfig {
+    uint8_t minSamples;               // History needed before fragmentation and leaks are judged
+    float fragWarnRatio;              // Largest block / free heap below this is fragmented...
+    float fragTrendDrop;              // ...if it also fell this much from the older to the newer half
+    int32_t leakWarnBytesPerHour;     // Free heap shrinking faster than this is leaking...
+    uint32_t leakMinSpanSec;          // ...once the history spans at least this long
+    uint32_t stackWarnBytes;          // Stack headroom below this is low
+};
+
+struct MemorySample {
+    uint32_t freeHeap;
+    uint32_t largestBlock;       // Largest single allocation that would still succeed
+    uint32_t minFreeHeap;        // Lowest free heap since boot
+    uint16_t loopStackFree;      // Stack high-water marks (least headroom ever), bytes; 0 if the task is unknown
+    uint16_t networkStackFree;
+};
+
+// The post-call fields of one history entry, oldest first.
+struct MemoryTrendPoint {
+    uint32_t uptimeSec;
+    uint32_t freeHeap;
+    uint32_t largestBlock;
+};
+
+struct MemoryTrend {
+    uint8_t flags;               // MemoryTrendFlag
+    float olderRatio;            // Mean largest block / free heap of the older half (1 before minSamples)...
+    float newerRatio;            // ...and of the newer half
+    float bytesPerHour;          // Least-squares slope of free heap over uptime (0 before minSamples)
+};
+
+// Largest block / free heap: 1 is one contiguous free region; an empty heap counts as 1.
+float memoryFragmentationRatio(uint32_t freeHeap, uint32_t largestBlock);
+
+// Either task below stackWarnBytes of headroom; an unknown task (0) is not judged.
+bool memoryStackLow(const MemorySample& sample, const MemoryTrendConfig& config);
+
+// latest is the newest post-call sample, for the stack check; count 0 judges nothing.
+MemoryTrend memoryTrendEvaluate(const MemoryTrendPoint* points, uint8_t count, const MemorySample& latest,
+                                const MemoryTrendConfig& config);
+
+// Per call site: heap after - before, summed, and the low-water mark of that delta (largest drop).
+struct MemorySiteStats {
+    uint32_t calls;
+    int64_t deltaSum;
+    int32_t deltaWorst;
+};
+void memorySiteRecord(MemorySiteStats& stats, const MemorySample& before, const MemorySample& after);
+int32_t memorySiteMeanDelta(const MemorySiteStats& stats); // 0 without calls
+
+#endif // MEMORY_TELEMETRY_H
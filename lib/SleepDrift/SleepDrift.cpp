@@ -0,0 +1,45 @@
+#include "SleepDrift.h"
+#include <math.h>
+
+bool sleepDriftMeasurable(uint64_t programmedUs, int64_t actualUs) {
+    return actualUs > 0 && programmedUs >= SLEEP_DRIFT_MIN_SLEEP_SEC * 1000000ULL;
+}
+
+float sleepDriftUpdate(float& correction, uint64_t programmedUs, int64_t actualUs, bool* applied) {
+    float measured = (float)((double)programmedUs / (double)actualUs);
+    bool plausible = fabsf(measured - 1.0f) <= SLEEP_DRIFT_MAX_CORRECTION;
+    if (plausible) {
+        correction += SLEEP_DRIFT_EMA_ALPHA * (measured - correction);
+        correction = fminf(fmaxf(correction, 1.0f - SLEEP_DRIFT_MAX_CORRECTION), 1.0f + SLEEP_DRIFT_MAX_CORRECTION);
+    }
+    if (applied) *applied = plausible;
+    return measured;
+}
+
+void slotAccuracyReset(SlotAccuracyLog& log) {
+    for (int i = 0; i < SLOT_ACCURACY_DAYS; ++i) log.days[i] = SlotAccuracyDay{ -1, 0, 0, 0.0f, 0.0f, 0, 0, 0 };
+    log.next = 0;
+}
+
+SlotAccuracyDay& slotAccuracyDay(SlotAccuracyLog& log, int dayOfYear) {
+    uint8_t last = (log.next + SLOT_ACCURACY_DAYS - 1) % SLOT_ACCURACY_DAYS;
+    if (log.days[last].dayOfYear != dayOfYear) {
+        last = log.next;
+        log.next = (log.next + 1) % SLOT_ACCURACY_DAYS;
+        log.days[last] = SlotAccuracyDay{ (int16_t)dayOfYear, 0, 0, 0.0f, 0.0f, 0, 0, 0 };
+    }
+    return log.days[last];
+}
+
+const SlotAccuracyDay& slotAccuracyNewest(const SlotAccuracyLog& log, int n) {
+    return log.days[(log.next + SLOT_ACCURACY_DAYS - 1 - n % SLOT_ACCURACY_DAYS) % SLOT_ACCURACY_DAYS];
+}
+
+void slotAccuracyRecord(SlotAccuracyDay& day, float errorSec, uint32_t intervalSec) {
+    float absError = fabsf(errorSec);
+    day.wakes++;
+    if (absError <= SLOT_HIT_TOLERANCE_SEC) day.hits++;
+    day.absErrorSumSec += absError;
+    if (absError > day.maxAbsErrorSec) day.maxAbsErrorSec = absError;
+    if (intervalSec > 0 && errorSec > (float)intervalSec) day.missedSlots += (uint16_t)(errorSec / intervalSec); // Overslept whole slots
+}
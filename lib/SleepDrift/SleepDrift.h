@@ -0,0 +1,56 @@
+#ifndef SLEEP_DRIFT_H
+#define SLEEP_DRIFT_H
+
+#include <stdint.h>
+
+// Deep-sleep timer drift: the factor the next sleep duration is scaled by, learned from programmed vs
+// NTP-measured sleeps, and the per-day slot accuracy summary kept in RTC memory. The firmware does
+// the clock reads and localtime; this only does the arithmetic.
+
+const float SLEEP_DRIFT_EMA_ALPHA = 0.3f;         // Weight of the newest measurement in the correction factor
+const float SLEEP_DRIFT_MAX_CORRECTION = 0.10f;   // Clamp the factor to 1 +/- this (the slow clock is off by a few %)
+const uint32_t SLEEP_DRIFT_MIN_SLEEP_SEC = 300;   // Shorter sleeps are too coarse to calibrate on 1 s NTP/epoch steps
+const uint32_t SLOT_HIT_TOLERANCE_SEC = 10;       // |wake - slot| within this counts as an on-slot wake
+#define SLOT_ACCURACY_DAYS 7                      // Daily slot-hit summaries kept in RTC memory
+
+// A sleep counts once it ran forward and was programmed for at least SLEEP_DRIFT_MIN_SLEEP_SEC.
+bool sleepDriftMeasurable(uint64_t programmedUs, int64_t actualUs);
+
+// Folds programmed/actual into correction (EMA, clamped to 1 +/- SLEEP_DRIFT_MAX_CORRECTION) and
+// returns the measured factor. A factor off by more than the clamp is not drift (a manual clock
+// change, a missed sync) and leaves correction alone; *applied says which.
+float sleepDriftUpdate(float& correction, uint64_t programmedUs, int64_t actualUs, bool* applied = nullptr);
+
+// Per-day LPM summary: wake counts, awake time and missed slots, so a multi-day run on the bench
+// can be read back over serial instead of being watched.
+struct SlotAccuracyDay {
+    int16_t dayOfYear;      // -1 for an unused entry
+    uint16_t wakes;         // NTP-verified timer wakes
+    uint16_t hits;          // ... within SLOT_HIT_TOLERANCE_SEC of their slot
+    float absErrorSumSec;
+    float maxAbsErrorSec;
+    uint16_t cycles;        // Awake periods that ended in deep sleep
+    uint32_t awakeMs;       // ... and their total length
+    uint16_t missedSlots;   // Slots overslept or whose fetch got no API data
+};
+
+// Ring of the last SLOT_ACCURACY_DAYS days; next is the entry the following new day takes.
+struct SlotAccuracyLog {
+    SlotAccuracyDay days[SLOT_ACCURACY_DAYS];
+    uint8_t next;
+};
+
+void slotAccuracyReset(SlotAccuracyLog& log);
+
+// Entry for dayOfYear, starting a new one (and dropping the oldest) when it differs from the newest.
+SlotAccuracyDay& slotAccuracyDay(SlotAccuracyLog& log, int dayOfYear);
+
+// n-th newest entry (0: today); dayOfYear is -1 if unused.
+const SlotAccuracyDay& slotAccuracyNewest(const SlotAccuracyLog& log, int n);
+
+// One verified wake errorSec after its slot. intervalSec is the slot interval the sleep was scheduled
+// under (the fetch after the wake may already have changed the cadence); a wake later than whole
+// intervals counts those slots as missed.
+void slotAccuracyRecord(SlotAccuracyDay& day, float errorSec, uint32_t intervalSec);
+
+#endif // SLEEP_DRIFT_H
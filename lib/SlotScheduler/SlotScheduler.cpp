@@ -0,0 +1,42 @@
+#include "SlotScheduler.h"
+
+int32_t daysFromCivil(int year, int month, int day) {
+    year -= (month <= 2) ? 1 : 0;
+    const int32_t era = (year >= 0 ? year : year - 399) / 400;
+    const int32_t yoe = year - era * 400;
+    const int32_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const int32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+int32_t localUtcOffsetSeconds(const struct tm& localTimeInfo, time_t epoch) {
+    int64_t localAsUtc = (int64_t)daysFromCivil(localTimeInfo.tm_year + 1900, localTimeInfo.tm_mon + 1, localTimeInfo.tm_mday) * 86400LL
+                       + localTimeInfo.tm_hour * 3600 + localTimeInfo.tm_min * 60 + localTimeInfo.tm_sec;
+    return (int32_t)(localAsUtc - (int64_t)epoch);
+}
+
+RefreshSlot nextRefreshSlot(time_t nowEpoch, int32_t utcOffsetSec, uint8_t updatesPerHour, uint8_t targetStartMinute, bool checkDueNow) {
+    const int32_t intervalSec = (60 / updatesPerHour) * 60;
+    const int32_t slotsSpanSec = (int32_t)updatesPerHour * intervalSec; // <= 3600
+
+    // Position of "now" relative to the first slot of its slot-hour, in local seconds.
+    int64_t rel = (int64_t)nowEpoch + utcOffsetSec - (int64_t)targetStartMinute * 60;
+    int64_t hourIndex = rel / 3600;
+    if (rel < 0 && rel % 3600 != 0) hourIndex -= 1; // floor division
+    int32_t intoHourSec = (int32_t)(rel - hourIndex * 3600); // 0..3599
+
+    int32_t lastSlotOffsetSec, nextSlotOffsetSec;
+    if (intoHourSec < slotsSpanSec) {
+        lastSlotOffsetSec = (intoHourSec / intervalSec) * intervalSec;
+        nextSlotOffsetSec = lastSlotOffsetSec + intervalSec;
+        if (nextSlotOffsetSec >= slotsSpanSec) nextSlotOffsetSec = 3600; // first slot of the next hour
+    } else { // Tail gap after the last slot of the hour (updatesPerHour does not divide 60)
+        lastSlotOffsetSec = slotsSpanSec - intervalSec;
+        nextSlotOffsetSec = 3600;
+    }
+
+    RefreshSlot slot;
+    slot.nextSlotEpoch = nowEpoch + (nextSlotOffsetSec - intoHourSec);
+    slot.dueNow = checkDueNow && (intoHourSec - lastSlotOffsetSec) < SLOT_DUE_WINDOW_SEC;
+    return slot;
+}
@@ -0,0 +1,32 @@
+#ifndef SLOT_SCHEDULER_H
+#define SLOT_SCHEDULER_H
+
+#include <stdint.h>
+#include <time.h>
+
+// Refresh-slot arithmetic shared by the firmware and the native test suites. No libc time calls:
+// the caller converts "now" once and passes the local UTC offset that was in effect.
+
+struct RefreshSlot {
+    time_t nextSlotEpoch; // First slot strictly after now
+    bool dueNow;          // A slot passed less than SLOT_DUE_WINDOW_SEC ago
+};
+
+const int32_t SLOT_DUE_WINDOW_SEC = 30;
+
+// Days since 1970-01-01 for a proleptic Gregorian date (month 1-12). Integer-only, no libc calls.
+int32_t daysFromCivil(int year, int month, int day);
+
+// Local UTC offset (seconds) implied by a broken-down local time and its epoch.
+// Whatever DST state libc applied is already baked into the tm fields.
+int32_t localUtcOffsetSeconds(const struct tm& localTimeInfo, time_t epoch);
+
+// Closed-form slot search. Slots for local hour H are at H:targetStartMinute + i*intervalMinutes
+// (i < updatesPerHour). Since updatesPerHour * intervalMinutes <= 60, the last slot of hour H always
+// precedes the first slot of hour H+1, so the next slot falls out of one division on epoch seconds
+// instead of a mktime() per candidate. Day/month rollover comes for free, and a DST shift of whole
+// hours leaves the minute-of-hour grid untouched.
+// Expects updatesPerHour in 1..60 and targetStartMinute in 0..59 (the caller validates and logs).
+RefreshSlot nextRefreshSlot(time_t nowEpoch, int32_t utcOffsetSec, uint8_t updatesPerHour, uint8_t targetStartMinute, bool checkDueNow);
+
+#endif // SLOT_SCHEDULER_H
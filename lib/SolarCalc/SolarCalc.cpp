@@ -0,0 +1,51 @@
+#include "SolarCalc.h"
+#include <math.h>
+
+SolarEvents calculateSolarEvents(time_t aroundEpoch, float latitude, float longitude) {
+    const double DEG = M_PI / 180.0;
+    SolarEvents events = {0, 0, SOLAR_DAY_NORMAL};
+
+    double daysSinceJ2000 = ((double)aroundEpoch / 86400.0 + 2440587.5) - 2451545.0;
+    double meanSolarNoon = round(daysSinceJ2000 - 0.0009 + longitude / 360.0) + 0.0009 - longitude / 360.0;
+    double meanAnomaly = fmod(357.5291 + 0.98560028 * meanSolarNoon, 360.0);
+    double center = 1.9148 * sin(meanAnomaly * DEG) + 0.0200 * sin(2 * meanAnomaly * DEG) + 0.0003 * sin(3 * meanAnomaly * DEG);
+    double eclipticLon = fmod(meanAnomaly + center + 180.0 + 102.9372, 360.0);
+    double transit = meanSolarNoon + 0.0053 * sin(meanAnomaly * DEG) - 0.0069 * sin(2 * eclipticLon * DEG);
+    double sinDecl = sin(eclipticLon * DEG) * sin(23.4397 * DEG);
+    double cosDecl = cos(asin(sinDecl));
+    double cosHourAngle = (sin(-0.833 * DEG) - sin(latitude * DEG) * sinDecl) / (cos(latitude * DEG) * cosDecl);
+
+    if (cosHourAngle < -1.0) { events.dayType = SOLAR_DAY_POLAR_DAY; return events; }
+    if (cosHourAngle > 1.0) { events.dayType = SOLAR_DAY_POLAR_NIGHT; return events; }
+
+    double hourAngleDays = acos(cosHourAngle) / DEG / 360.0;
+    events.sunriseEpoch = (time_t)llround((transit - hourAngleDays + 2451545.0 - 2440587.5) * 86400.0);
+    events.sunsetEpoch = (time_t)llround((transit + hourAngleDays + 2451545.0 - 2440587.5) * 86400.0);
+    return events;
+}
+
+// Sleep through a polar night in fixed steps, but never past the first dawn after it: the day the
+// sun comes back can have well under an hour of daylight.
+static time_t polarNightWake(time_t candidateEpoch, float latitude, float longitude, const NightSkipConfig& config) {
+    time_t recheckEpoch = candidateEpoch + config.polarNightRecheckHours * 3600L;
+    SolarEvents next = calculateSolarEvents(candidateEpoch + 86400L, latitude, longitude);
+    if (next.dayType != SOLAR_DAY_NORMAL) return recheckEpoch;
+    time_t nextDayStart = next.sunriseEpoch - config.sunriseLeadMinutes * 60L;
+    return (nextDayStart > candidateEpoch && nextDayStart < recheckEpoch) ? nextDayStart : recheckEpoch;
+}
+
+time_t nightSkipTarget(time_t candidateEpoch, float latitude, float longitude, const NightSkipConfig& config) {
+    SolarEvents today = calculateSolarEvents(candidateEpoch, latitude, longitude);
+    if (today.dayType == SOLAR_DAY_POLAR_DAY) return 0;
+    if (today.dayType == SOLAR_DAY_POLAR_NIGHT) return polarNightWake(candidateEpoch, latitude, longitude, config);
+
+    time_t dayStart = today.sunriseEpoch - config.sunriseLeadMinutes * 60L;
+    time_t dayEnd = today.sunsetEpoch + config.sunsetGraceMinutes * 60L;
+    if (candidateEpoch >= dayStart && candidateEpoch <= dayEnd) return 0;
+    if (candidateEpoch < dayStart) return dayStart;
+
+    SolarEvents tomorrow = calculateSolarEvents(candidateEpoch + 86400L, latitude, longitude);
+    if (tomorrow.dayType == SOLAR_DAY_POLAR_DAY) return 0; // Entering midnight sun, no night to skip
+    if (tomorrow.dayType == SOLAR_DAY_POLAR_NIGHT) return polarNightWake(candidateEpoch, latitude, longitude, config);
+    return tomorrow.sunriseEpoch - config.sunriseLeadMinutes * 60L;
+}
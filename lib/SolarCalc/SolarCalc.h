@@ -0,0 +1,29 @@
+#ifndef SOLAR_CALC_H
+#define SOLAR_CALC_H
+
+#include <stdint.h>
+#include <time.h>
+
+enum SolarDayType : uint8_t { SOLAR_DAY_NORMAL, SOLAR_DAY_POLAR_DAY, SOLAR_DAY_POLAR_NIGHT };
+struct SolarEvents {
+    time_t sunriseEpoch; // UTC epoch, only valid for SOLAR_DAY_NORMAL
+    time_t sunsetEpoch;
+    SolarDayType dayType;
+};
+
+struct NightSkipConfig {
+    uint16_t sunriseLeadMinutes;     // Daylight starts this long before sunrise
+    uint16_t sunsetGraceMinutes;     // ...and ends this long after sunset
+    uint16_t polarNightRecheckHours; // Sleep length when the sun does not rise at all
+};
+
+// Sunrise/sunset via the standard sunrise equation (NOAA simplified, ~1 min accuracy).
+// Returns the events of the solar day whose transit (local solar noon) is nearest to aroundEpoch.
+// Runs once per scheduling decision, so double precision is fine despite being soft-float on ESP32.
+SolarEvents calculateSolarEvents(time_t aroundEpoch, float latitude, float longitude);
+
+// If candidateEpoch falls in the night window of its solar day, return the first daylight
+// moment after it (sunrise minus lead). Returns 0 when the candidate is already in daylight.
+time_t nightSkipTarget(time_t candidateEpoch, float latitude, float longitude, const NightSkipConfig& config);
+
+#endif // SOLAR_CALC_H
@@ -0,0 +1,34 @@
+#include "TextFit.h"
+
+int font2Advance(char c) {
+    uint8_t code = (uint8_t)c;
+    return FONT2_ADVANCE[(code > 31 && code < 128) ? code - 32 : 0];
+}
+
+int font2TextWidth(const String& text) {
+    int width = 0;
+    for (unsigned int i = 0; i < text.length(); ++i) width += font2Advance(text[i]);
+    return width;
+}
+
+String fitTextToWidth(const String& text, int maxWidth) {
+    int width = 0;
+    unsigned int cut = 0; // Prefix length that fits alongside the ellipsis
+    for (unsigned int i = 0; i < text.length(); ++i) {
+        width += font2Advance(text[i]);
+        if (width + FONT2_ELLIPSIS_WIDTH <= maxWidth) cut = i + 1;
+        if (width > maxWidth) return (FONT2_ELLIPSIS_WIDTH <= maxWidth) ? text.substring(0, cut) + "..." : String();
+    }
+    return text;
+}
+
+OverlayTextBudgets overlayTextBudgets(int panelWidth) {
+    OverlayTextBudgets budgets;
+    budgets.line = panelWidth - 2 * OVERLAY_TEXT_PADDING;
+    budgets.updateTime = budgets.line * 45 / 100;
+    return budgets;
+}
+
+int overlayRemainingWidth(int lineWidth, const String& otherText) {
+    return lineWidth - font2TextWidth(otherText) - 2 * OVERLAY_TEXT_PADDING;
+}
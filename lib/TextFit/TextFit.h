@@ -0,0 +1,35 @@
+#ifndef TEXT_FIT_H
+#define TEXT_FIT_H
+
+#include <Arduino.h>
+
+// Fits the overlay and status text to pixel widths with font 2's advance table, without asking the
+// display driver, plus the pixel budget of each fitted field on a panel of a given width.
+
+// Advance widths in px of font 2 (TFT_eSPI Fonts/Font16.c, text size 1) for chars 32-127, the font of
+// the overlay and status text. Characters outside the range draw and measure as a space.
+const uint8_t FONT2_ADVANCE[96] = {
+    6, 3, 4, 9, 8, 9, 9, 3,  7, 7, 8, 6, 3, 6, 5, 7,  8, 8, 8, 8, 8, 8, 8, 8,  8, 8, 3, 3, 6, 6, 6, 8,
+    9, 8, 8, 8, 8, 8, 8, 8,  8, 4, 8, 8, 7, 10, 8, 8, 8, 8, 8, 8, 8, 8, 8, 10, 8, 8, 8, 4, 7, 4, 7, 9,
+    4, 7, 7, 7, 7, 7, 6, 7,  7, 4, 5, 6, 4, 8, 7, 8,  7, 8, 6, 6, 5, 7, 8, 8,  6, 7, 7, 5, 3, 5, 8, 6
+};
+const int FONT2_ELLIPSIS_WIDTH = 3 * 5; // "..."
+const int OVERLAY_TEXT_PADDING = 4;     // Panel edge to text, and between texts sharing a line
+
+int font2Advance(char c);
+int font2TextWidth(const String& text);
+
+// One pass over the string: returns it unchanged if it fits in maxWidth px of font 2, otherwise its
+// longest prefix that still fits with "..." appended (empty if not even that fits).
+String fitTextToWidth(const String& text, int maxWidth);
+
+struct OverlayTextBudgets {
+    int line;        // Full-width lines: location, day peak, text pages, displayMessage()
+    int updateTime;  // Right end of the overlay's second line: up to 45 % of it
+};
+OverlayTextBudgets overlayTextBudgets(int panelWidth);
+
+// What a line of lineWidth px leaves for one text once another (already fitted) shares it.
+int overlayRemainingWidth(int lineWidth, const String& otherText);
+
+#endif // TEXT_FIT_H
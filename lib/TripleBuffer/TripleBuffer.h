@@ -0,0 +1,33 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <stdint.h>
+#include <atomic>
+
+// Lock-free single-producer/single-consumer triple buffer. The producer fills its back buffer and
+// swaps it into the middle slot; the consumer swaps the middle slot for its front buffer only when
+// it holds something new. Neither side waits, and the reader always sees a complete snapshot.
+template <typename T>
+class TripleBuffer {
+public:
+    T& back() { return buffers[backIndex]; }                    // Producer only
+    void publish() {
+        backIndex = middle.exchange(backIndex | FRESH_BIT, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+    bool pending() const { return middle.load(std::memory_order_acquire) & FRESH_BIT; }
+    bool acquire() {                                            // Consumer only; true if front changed
+        if (!pending()) return false;
+        frontIndex = middle.exchange(frontIndex, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+    const T& front() const { return buffers[frontIndex]; }      // Consumer only
+private:
+    static const uint8_t INDEX_MASK = 0x03;
+    static const uint8_t FRESH_BIT = 0x04;
+    T buffers[3] = {};
+    std::atomic<uint8_t> middle{1};
+    uint8_t backIndex = 0;
+    uint8_t frontIndex = 2;
+};
+
+#endif // TRIPLE_BUFFER_H
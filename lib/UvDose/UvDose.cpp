@@ -0,0 +1,46 @@
+#include "UvDose.h"
+#include <math.h>
+
+float uvDoseMedSed(uint8_t skinType) {
+    return MED_SED_BY_SKIN_TYPE[(skinType < 1 ? 1 : (skinType > 6 ? 6 : skinType)) - 1];
+}
+
+void uvDoseLoadForecast(UvDoseModel& model, const float* uv, const int* hours) {
+    model.loaded = hours[0] >= 0 && hours[0] <= 23;
+    model.knot0Hour = hours[0];
+    for (int i = 0; i < UV_DOSE_KNOTS; ++i) {
+        model.knotUV[i] = (uv[i] > 0.0f && hours[i] >= 0) ? uv[i] : 0.0f;
+        model.prefixSed[i] = (i == 0) ? 0.0f
+            : model.prefixSed[i - 1] + SED_PER_UVI_MINUTE * 30.0f * (model.knotUV[i - 1] + model.knotUV[i]);
+    }
+    model.burnEndMinute = 0;
+}
+
+float uvDoseMinuteOf(const UvDoseModel& model, const struct tm& localNow) {
+    int hours = (localNow.tm_hour - model.knot0Hour + 24) % 24;
+    if (hours > 18) hours -= 24;
+    return hours * 60.0f + localNow.tm_min + localNow.tm_sec / 60.0f;
+}
+
+float uvDoseSedAt(const UvDoseModel& model, float minute) {
+    const float horizon = 60.0f * (UV_DOSE_KNOTS - 1);
+    if (minute <= 0.0f) return 0.0f;
+    if (minute >= horizon) return model.prefixSed[UV_DOSE_KNOTS - 1];
+    int k = (int)(minute / 60.0f);
+    float x = minute - 60.0f * k;
+    float a = model.knotUV[k], b = model.knotUV[k + 1];
+    return model.prefixSed[k] + SED_PER_UVI_MINUTE * (a * x + (b - a) * x * x / 120.0f);
+}
+
+UvBurnEstimate uvDoseTimeToBurn(UvDoseModel& model, float nowMinute, float medSed) {
+    UvBurnEstimate estimate = { -1, 0 };
+    if (!model.loaded) return estimate;
+    const int32_t horizon = 60 * (UV_DOSE_KNOTS - 1);
+    float target = uvDoseSedAt(model, nowMinute) + medSed;
+    int32_t start = (int32_t)ceilf(nowMinute);
+    if (model.burnEndMinute < start) model.burnEndMinute = start;
+    while (model.burnEndMinute < horizon && uvDoseSedAt(model, model.burnEndMinute) < target) model.burnEndMinute++;
+    if (uvDoseSedAt(model, model.burnEndMinute) >= target) estimate.burnMinutes = (int32_t)(model.burnEndMinute - nowMinute + 0.5f);
+    estimate.horizonMinutes = (nowMinute < horizon) ? (int32_t)(horizon - nowMinute) : 0;
+    return estimate;
+}
@@ -0,0 +1,48 @@
+#ifndef UV_DOSE_H
+#define UV_DOSE_H
+
+#include <stdint.h>
+#include <time.h>
+
+// Erythemal dose engine behind the dose line and the stats page. UV between the forecast's hourly knots
+// is linear, so the dose from knot 0 to any minute is closed-form: the prefix of whole segments plus a
+// partial trapezoid. A tick integrates the time since the previous tick in O(1), and time-to-burn is a
+// two-pointer search whose end only moves forward while the same forecast is loaded (the dose target
+// D(now) + MED never decreases).
+
+const int UV_DOSE_KNOTS = 6;                     // HOURLY_FORECAST_COUNT in main.cpp
+const float SED_PER_UVI_MINUTE = 0.015f;         // 1 UVI = 25 mW/m^2 erythemal, so 1.5 J/m^2 per minute
+// Minimal erythemal dose per Fitzpatrick type, in SED (1 SED = 100 J/m^2 erythemally weighted)
+const float MED_SED_BY_SKIN_TYPE[6] = { 2.0f, 2.5f, 3.5f, 4.5f, 6.0f, 10.0f };
+const char* const FITZPATRICK_TYPE_NAMES[6] = { "I", "II", "III", "IV", "V", "VI" };
+
+struct UvDoseModel {
+    bool loaded;
+    int8_t knot0Hour;                           // Local hour of knot 0; knot i sits at minute 60 * i
+    float knotUV[UV_DOSE_KNOTS];
+    float prefixSed[UV_DOSE_KNOTS];             // Dose from knot 0 to knot i
+    int32_t burnEndMinute;                      // Two-pointer end of the time-to-burn search
+};
+
+struct UvBurnEstimate {
+    int32_t burnMinutes;    // Exposure from now that adds one MED; -1 if not reached within the forecast
+    int32_t horizonMinutes; // Forecast left from now
+};
+
+// MED of a Fitzpatrick type (1..6, clamped).
+float uvDoseMedSed(uint8_t skinType);
+
+// O(UV_DOSE_KNOTS), once per new forecast. Hours of -1 (placeholders) count as no UV.
+void uvDoseLoadForecast(UvDoseModel& model, const float* uv, const int* hours);
+
+// Minutes from knot 0 to localNow; negative while knot 0 is still ahead.
+float uvDoseMinuteOf(const UvDoseModel& model, const struct tm& localNow);
+
+// Dose in SED from knot 0 to the given minute, flat outside the forecast.
+float uvDoseSedAt(const UvDoseModel& model, float minute);
+
+// Time until one more MED from nowMinute. Amortised O(1) over the ticks of one forecast: calls must
+// come with non-decreasing nowMinute until the next uvDoseLoadForecast().
+UvBurnEstimate uvDoseTimeToBurn(UvDoseModel& model, float nowMinute, float medSed);
+
+#endif // UV_DOSE_H
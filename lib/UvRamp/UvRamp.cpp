@@ -0,0 +1,31 @@
+#include "UvRamp.h"
+
+// Spelled out in macro expansions rather than built in a loop so it stays a constant initializer
+// under the core's gnu++11.
+#define UV_RAMP_2(i) uvRampEntry(i), uvRampEntry((i) + 1)
+#define UV_RAMP_8(i) UV_RAMP_2(i), UV_RAMP_2((i) + 2), UV_RAMP_2((i) + 4), UV_RAMP_2((i) + 6)
+#define UV_RAMP_32(i) UV_RAMP_8(i), UV_RAMP_8((i) + 8), UV_RAMP_8((i) + 16), UV_RAMP_8((i) + 24)
+const uint16_t UV_RAMP[UV_RAMP_STEPS] = { UV_RAMP_32(0), UV_RAMP_32(32), UV_RAMP_32(64), UV_RAMP_32(96) };
+static_assert(UV_RAMP_STEPS == 128, "UV_RAMP_32 expansions above assume 128 steps");
+
+static uint16_t rowColor(const UvRampBar& bar, int row) {
+    uint64_t index = ((uint64_t)row * bar.stepPerRow) >> 16; // 64-bit: tall bars over a short full scale
+    return UV_RAMP[index < UV_RAMP_STEPS ? index : UV_RAMP_STEPS - 1];
+}
+
+void uvRampBarBegin(UvRampBar& bar, int height, int fullScaleHeight) {
+    bar.height = (height > 0 && fullScaleHeight > 0) ? (int16_t)height : 0;
+    bar.row = 0;
+    bar.stepPerRow = fullScaleHeight > 0 ? ((uint32_t)(UV_RAMP_STEPS - 1) << 16) / (uint32_t)fullScaleHeight : 0;
+}
+
+bool uvRampBarNext(UvRampBar& bar, UvRampRun& run) {
+    if (bar.row >= bar.height) return false;
+    run.firstRow = bar.row;
+    run.color = rowColor(bar, bar.row);
+    int row = bar.row + 1;
+    while (row < bar.height && rowColor(bar, row) == run.color) row++;
+    run.rows = (int16_t)(row - bar.row);
+    bar.row = (int16_t)row;
+    return true;
+}
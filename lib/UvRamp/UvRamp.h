@@ -0,0 +1,58 @@
+#ifndef UV_RAMP_H
+#define UV_RAMP_H
+
+#include <stdint.h>
+
+// Gradient fill for the UV bars: a WHO-scale RGB565 colour table built by the compiler, and the row
+// runs one bar is drawn as. The caller issues one fillRect per run: the green base (UV <= 1) and the
+// red cap are one fill each, the blend in between one row-high fill per colour change, which is
+// about one per row for bars shorter than UV_RAMP_STEPS px.
+
+#define UV_GRAPH_FULL_SCALE 8                      // UV at full bar height (integer: the colour ramp is built from it)
+#define UV_RAMP_STEPS 128                          // Ramp rows from baseline to full scale (>= usual bar height in px)
+
+// Stops, native RGB565: TFT_eSPI swaps to panel byte order itself, so a pre-swapped table would be
+// swapped twice.
+const uint16_t UV_RAMP_GREEN = 0x07E0;
+const uint16_t UV_RAMP_YELLOW = 0xFFE0;
+const uint16_t UV_RAMP_ORANGE = 0xFC60;
+const uint16_t UV_RAMP_RED = 0xF800;
+
+// Per-channel blend of two RGB565 colours, t in 0..256.
+constexpr uint16_t rgb565Lerp(uint16_t a, uint16_t b, uint32_t t) {
+    return (uint16_t)((((((a >> 11) & 0x1F) * (256 - t) + ((b >> 11) & 0x1F) * t) >> 8) << 11) |
+                      (((((a >> 5) & 0x3F) * (256 - t) + ((b >> 5) & 0x3F) * t) >> 8) << 5) |
+                      ((((a & 0x1F) * (256 - t) + (b & 0x1F) * t) >> 8)));
+}
+// WHO scale colour at a UV (in UV * 256): stops at UV 1 (green), 4 (yellow), 6.5 (orange) and full
+// scale (red), blended linearly between them.
+constexpr uint16_t uvRampColorAt(uint32_t uv256) {
+    return uv256 <= 256 ? UV_RAMP_GREEN
+         : uv256 <= 1024 ? rgb565Lerp(UV_RAMP_GREEN, UV_RAMP_YELLOW, (uv256 - 256) * 256 / 768)
+         : uv256 <= 1664 ? rgb565Lerp(UV_RAMP_YELLOW, UV_RAMP_ORANGE, (uv256 - 1024) * 256 / 640)
+         : uv256 < UV_GRAPH_FULL_SCALE * 256 ? rgb565Lerp(UV_RAMP_ORANGE, UV_RAMP_RED, (uv256 - 1664) * 256 / (UV_GRAPH_FULL_SCALE * 256 - 1664))
+         : UV_RAMP_RED;
+}
+constexpr uint16_t uvRampEntry(uint32_t i) { return uvRampColorAt(i * UV_GRAPH_FULL_SCALE * 256 / (UV_RAMP_STEPS - 1)); }
+
+// Entry i is uvRampEntry(i), evaluated at compile time into flash.
+extern const uint16_t UV_RAMP[UV_RAMP_STEPS];
+
+// Rows firstRow..firstRow + rows - 1 above the baseline share one colour.
+struct UvRampRun {
+    int16_t firstRow;
+    int16_t rows;
+    uint16_t color;
+};
+
+// Walks one bar from the baseline up. Row r takes entry r * (UV_RAMP_STEPS - 1) / fullScaleHeight
+// (16.16 fixed point, clamped to the last entry), so a colour sits at the same height in every bar.
+struct UvRampBar {
+    int16_t height;
+    int16_t row;          // First row of the next run
+    uint32_t stepPerRow;
+};
+void uvRampBarBegin(UvRampBar& bar, int height, int fullScaleHeight); // Empty if either is <= 0
+bool uvRampBarNext(UvRampBar& bar, UvRampRun& run);                   // False once the bar is done
+
+#endif // UV_RAMP_H
@@ -2,21 +2,136 @@
 #include <SPI.h>
 #include <TFT_eSPI.h>
 #include <WiFi.h>
-#include <HTTPClient.h>
+#include <WiFiClientSecure.h>
 #include <ArduinoJson.h>
 #include <EEPROM.h> // Added for EEPROM
+#include <esp_pm.h>
+#include <esp_heap_caps.h>
+#include <driver/gpio.h>
+#include <freertos/queue.h>
+#include <freertos/timers.h>
+#include <esp_sntp.h>
+#include <sys/time.h>
+#include <atomic>
+#include <SlotScheduler.h>
+#include <AdaptiveCadence.h>
+#include <SolarCalc.h>
+#include <ButtonGesture.h>
+#include <TripleBuffer.h>
+#include <HttpResponseReader.h>
+#include <UvDose.h>
+#include <DayForecast.h>
+#include <BootProfile.h>
+#include <UvRamp.h>
+#include <TextFit.h>
+#include <FrameRle.h>
+#include <SleepDrift.h>
+#include <EventTelemetry.h>
+#include <LocationResolver.h>
+#include <EnergyProfile.h>
+#include <MemoryTelemetry.h>
 #include "secrets.h" // Your secrets
 
 // --- Configuration ---
-String openMeteoUrl = "https://api.open-meteo.com/v1/forecast";
+#define OPEN_METEO_HOST "api.open-meteo.com" // Pre-connected so the TLS handshake is profiled on its own
+#define IP_GEO_HOST "ip-api.com"
+#define HTTP_REQUEST_TAIL "User-Agent: uv-monitor\r\nAccept: application/json\r\nAccept-Encoding: identity\r\nConnection: close\r\n\r\n"
+// Request bytes for both endpoints are fixed at compile time; only the coordinates are filled in per fetch
+const char OPEN_METEO_REQUEST_FORMAT[] = "GET /v1/forecast?latitude=%.4f&longitude=%.4f&hourly=uv_index&forecast_days=1&timezone=auto HTTP/1.1\r\n"
+                                         "Host: " OPEN_METEO_HOST "\r\n" HTTP_REQUEST_TAIL;
+const char IP_GEO_REQUEST[] = "GET /json/?fields=status,message,lat,lon,city HTTP/1.1\r\nHost: " IP_GEO_HOST "\r\n" HTTP_REQUEST_TAIL;
 const int WIFI_CONNECTION_TIMEOUT_MS = 15000;
 const unsigned long SCREEN_ON_DURATION_LPM_MS = 30 * 1000; // 30 second screen on time in LPM
+const uint32_t WIFI_RECONNECT_INTERVAL_MS = 60 * 1000;      // Offline retry period in normal mode
+const uint32_t SCHEDULER_RETRY_MS = 10 * 1000;              // Retry period while no wall-clock time is available
 
 // --- New Scheduling Configuration ---
 const byte REFRESH_TARGET_MINUTE = 2;         // Base minute of the hour for the first refresh slot (0-59)
 const byte UPDATES_PER_HOUR_NORMAL_MODE = 4;  // e.g., 4 for every 15 mins, 2 for every 30 mins, 1 for hourly
 const byte UPDATES_PER_HOUR_LPM = 1;          // e.g., 1 for hourly (at REFRESH_TARGET_MINUTE)
 
+// --- Night Skip Configuration ---
+const bool SKIP_NIGHT_UPDATES = true;         // Skip refresh slots between sunset and sunrise (UV is zero)
+const uint16_t SUNRISE_LEAD_MINUTES = 15;     // Wake this many minutes before sunrise for the first fetch of the day
+const uint16_t SUNSET_GRACE_MINUTES = 30;     // Keep refreshing this many minutes after sunset
+const uint16_t POLAR_NIGHT_RECHECK_HOURS = 12; // Sleep length when the sun does not rise at all
+const NightSkipConfig NIGHT_SKIP_CONFIG = {SUNRISE_LEAD_MINUTES, SUNSET_GRACE_MINUTES, POLAR_NIGHT_RECHECK_HOURS};
+
+// --- Quarter-Hour Forecast Configuration ---
+const bool QUARTER_HOUR_FORECAST = true;   // "Now" bar shows the current 15 min, interpolated from the day's hourly data
+
+// --- Location Resolver Configuration ---
+const float LOCATION_CONFIDENCE_SECRETS = 0.5f;       // Configured home position: right unless the device travels
+const float LOCATION_CONFIDENCE_IP = 0.8f;            // Fresh city-level IP fix
+const uint32_t LOCATION_IP_HALF_LIFE_SEC = 24 * 3600; // A kept IP fix loses half its confidence per day
+const uint32_t LOCATION_IP_REFRESH_SEC = 3600;        // IP fixes younger than this are reused without a lookup
+const uint32_t LOCATION_IP_RETRY_MIN_SEC = 15 * 60;   // First retry after a failed lookup, doubling per failure...
+const uint32_t LOCATION_IP_RETRY_MAX_SEC = 6 * 3600;  // ...up to this
+
+// --- Adaptive Cadence Configuration ---
+const bool ADAPTIVE_CADENCE_ENABLED = true;        // Stretch the refresh interval when the forecast is stable
+const byte ADAPTIVE_MIN_INTERVAL_MINUTES = 15;     // Shortest interval (never faster than the mode's UPDATES_PER_HOUR_*)
+const byte ADAPTIVE_MAX_INTERVAL_MINUTES = 60;     // Longest interval on stable days
+const float ADAPTIVE_VOLATILE_UV_PER_HOUR = 1.0f;  // Volatility at/above which the minimum interval is used
+const float ADAPTIVE_STABLE_UV_PER_HOUR = 0.2f;    // Volatility at/below which the maximum interval is used
+
+// --- UV Dose Configuration ---
+const byte FITZPATRICK_SKIN_TYPE = 2;            // 1 (always burns) .. 6 (never burns)
+const uint32_t UV_DOSE_TICK_MS = 60 * 1000;
+
+// --- Idle Power Configuration ---
+const uint32_t IDLE_MAX_BLOCK_MS = 1000;      // Longest idle block in loop(); deadlines are re-checked at least this often
+const int PM_MAX_CPU_FREQ_MHZ = 240;
+const int PM_MIN_CPU_FREQ_MHZ = 80;           // 80 MHz keeps APB (SPI/UART clocks) constant under DFS
+
+// --- Energy Profiler Configuration ---
+#define ENERGY_LOG_CYCLES 32             // Wake cycles kept in the RTC ring buffer
+const float DEEP_SLEEP_CURRENT_MA = 0.15f; // Board draw while in deep sleep (regulator + RTC)
+
+// --- Boot Pipeline Configuration ---
+const bool PIPELINED_BOOT = true; // Start WiFi association before serial/display/state init on wakes that fetch
+const bool LAZY_DISPLAY_INIT = true; // Bring the display controller up on first use, not in setup(): timer wakes never do
+
+// --- Sleep Drift Configuration ---
+// Correction factor and slot accuracy constants live in lib/SleepDrift
+const uint32_t NTP_SYNC_WAIT_MS = 3000;           // Max wait for the SNTP reply before scheduling the next LPM sleep
+const uint32_t EARLY_WAKE_GUARD_SEC = 120;        // An early wake this close to its slot counts as that slot
+
+// --- Response Limits Configuration ---
+const size_t GEO_RESPONSE_MAX_BYTES = 1024;        // ip-api.com with the requested fields answers in ~100 bytes
+const size_t UV_RESPONSE_MAX_BYTES = 8192;         // Open-Meteo hourly uv_index for one day is ~1.2 KB
+
+// --- UI Pages Configuration ---
+const size_t PAGE_MEMORY_BUDGET_BYTES = 96 * 1024; // Render sprite (64,800 B at 240x135) plus encoded frames; least recently shown evicted first
+
+// --- Display Power Configuration ---
+const uint32_t ST7789_SLEEP_SETTLE_US = 120000;          // SLPOUT to DISPON or SLPIN, SLPIN to SLPOUT (datasheet)
+const uint32_t ST7789_COMMAND_GUARD_US = 5000;           // SLPIN/SLPOUT to any other command
+const unsigned long LPM_SCREEN_IDLE_LEAD_MS = 10 * 1000; // End of an LPM screen-on window spent in 8-colour idle mode
+#define DISPLAY_POWER_TRACE_ENTRIES 16                   // Controller power commands kept for the "disp" command
+
+// --- Graph Configuration ---
+const bool GRADIENT_UV_BARS = true;                // Bars blend through the WHO scale bottom to top; false: flat category colour
+static_assert(UV_RAMP_GREEN == TFT_GREEN && UV_RAMP_YELLOW == TFT_YELLOW && UV_RAMP_RED == TFT_RED, "lib/UvRamp stops follow TFT_eSPI's colours");
+
+// --- Benchmark Configuration ---
+const uint16_t BENCH_SCHEDULER_ITERATIONS = 20;   // Passes over the representative time set
+const uint16_t BENCH_SCHEDULER_TIMES = 4 * 96;    // Times in one pass (benchSchedulerPass())
+const uint16_t BENCH_PARSE_ITERATIONS = 20;
+const uint16_t BENCH_RENDER_ITERATIONS = 10;
+
+// --- Event Telemetry Configuration ---
+const uint16_t BENCH_TELEMETRY_EVENTS = 16;          // telemetryLog() calls timed by the "bench" command
+
+// --- Memory Telemetry Configuration ---
+#define MEMORY_HISTORY_SAMPLES 48                    // Before/after pairs kept in RAM, oldest overwritten
+const uint8_t MEMORY_TREND_MIN_SAMPLES = 12;         // History needed before trends are judged
+const float MEMORY_FRAG_WARN_RATIO = 0.5f;           // Largest free block / free heap below this is fragmented...
+const float MEMORY_FRAG_TREND_DROP = 0.1f;           // ...if it also fell this much from the older to the newer half
+const int32_t MEMORY_LEAK_WARN_BYTES_PER_HOUR = 512; // Post-call free heap shrinking faster than this is flagged
+const uint32_t MEMORY_LEAK_MIN_SPAN_SEC = 3600;      // ...once the history spans at least this long
+const uint32_t MEMORY_STACK_WARN_BYTES = 512;        // Task stack headroom below this is flagged
+
 // --- EEPROM Configuration ---
 #define EEPROM_SIZE 1          // Size for EEPROM (1 byte for LPM flag)
 #define LPM_FLAG_EEPROM_ADDR 0 // EEPROM address for LPM flag
@@ -34,41 +149,182 @@ const byte UPDATES_PER_HOUR_LPM = 1;          // e.g., 1 for hourly (at REFRESH_
 
 // --- Global Variables ---
 TFT_eSPI tft = TFT_eSPI();
+TFT_eSprite pageSprite = TFT_eSprite(&tft); // Full-screen render target of the UI pages, see pageSpriteBegin()
+
+
+// Fetch results: written by the network task (setup() before it starts); the loop renders them from
+// ForecastSnapshot and only reads them directly while no network job is in flight.
 String lastUpdateTimeStr = "Never";
-float deviceLatitude = MY_LATITUDE;
+float deviceLatitude = MY_LATITUDE;  // Other tasks read these through readDeviceCoordinates()
 float deviceLongitude = MY_LONGITUDE;
+portMUX_TYPE deviceCoordinatesMux = portMUX_INITIALIZER_UNLOCKED;
 String locationDisplayStr = "Initializing...";
-bool useGpsFromSecrets = false;
+bool useGpsFromSecrets = false;  // User pin (long press in the overlay); failures no longer set it
 
 const int HOURLY_FORECAST_COUNT = 6;
 float hourlyUV[HOURLY_FORECAST_COUNT];
 int forecastHours[HOURLY_FORECAST_COUNT];
 
+DayForecast dayForecast = { -1 };
+
 // Display State & Update Control
 bool showInfoOverlay = false;
-bool force_display_update = true;
-bool dataJustFetched = false;
-unsigned long lastDataFetchAttemptMs = 0; // Still used for WiFi reconnect timing if disconnected
-bool isConnectingToWiFi = false;
+std::atomic<bool> force_display_update{true}; // Set from the network task, consumed by the UI loop
+std::atomic<bool> dataJustFetched{false};
+std::atomic<bool> isConnectingToWiFi{false};
 
 // --- LPM State Variables ---
-bool isLowPowerModeActive = false;
-unsigned long screenActiveUntilMs = 0;
-bool temporaryScreenWakeupActive = false;
-
-// --- Button Handling Variables ---
-uint32_t button_info_last_press_time = 0;
-bool button_info_last_state = HIGH;
-uint32_t button_info_press_start_time = 0;
-bool button_info_is_held = false;
+std::atomic<bool> isLowPowerModeActive{false};        // Set by the loop, read by the network task as well
+std::atomic<bool> temporaryScreenWakeupActive{false};
+
+// --- Forecast Snapshot Exchange ---
+// Snapshots and status messages cross from the network task to the loop through lib/TripleBuffer.
+
+// Everything the renderer shows from a fetch; the network task owns the globals it is built from.
+struct ForecastSnapshot {
+    float hourlyUV[HOURLY_FORECAST_COUNT];
+    int forecastHours[HOURLY_FORECAST_COUNT];
+    char lastUpdateTimeStr[16];
+    char locationDisplayStr[LOCATION_LABEL_CHARS];
+    uint8_t locationSource;     // LocationSource
+    DayForecast day;
+    uint32_t sequence;
+};
+// --- UI Pages ---
+// The second button's short press steps through the pages. A page is drawn into a full-screen sprite,
+// encoded into a heap cache (see lib/FrameRle) and shown from there with a single address window. The
+// sprite is allocated once, when the display comes up, and kept for the wake; cached frames may use
+// what it leaves of PAGE_MEMORY_BUDGET_BYTES. Each page declares the inputs it draws from; its cached
+// frame is reused while their stamps are unchanged.
+enum UiPage : uint8_t { UI_PAGE_FORECAST, UI_PAGE_DAY, UI_PAGE_STATS, UI_PAGE_NETWORK, UI_PAGE_COUNT };
+enum PageInput : uint8_t {
+    PAGE_INPUT_FORECAST,  // Snapshot sequence: forecast, day analytics, update time, location
+    PAGE_INPUT_QUARTER,   // Wall-clock quarter hour ("now" bar and marker, stats times)
+    PAGE_INPUT_OVERLAY,   // Info overlay toggle
+    PAGE_INPUT_LINK,      // WiFi up/connecting and SSID
+    PAGE_INPUT_SIGNAL,    // RSSI (3 dB steps), local IP, IP lookup failures
+    PAGE_INPUT_DOSE,      // Dose so far and time to burn
+    PAGE_INPUT_LPM,
+    PAGE_INPUT_COUNT
+};
+struct UiPageDef {
+    const char* name;
+    uint8_t inputs;       // Bit per PageInput
+    void (*render)(TFT_eSPI& gfx, const ForecastSnapshot& view); // Onto a black target
+};
+struct PageCacheEntry {
+    FrameRle frame;       // One allocation at frame.palette; nullptr if not cached
+    size_t bytes;
+    uint32_t inputKey;
+    uint32_t lastShown;   // pageCacheClock when last shown, for LRU eviction
+};
+PageCacheEntry pageCache[UI_PAGE_COUNT] = {};
+size_t pageCacheBytes = 0;
+uint32_t pageCacheClock = 0;
+uint32_t pageCacheHits = 0;
+uint32_t pageCacheMisses = 0;
+uint32_t pageCacheEvictions = 0;
+uint32_t pageCacheUncached = 0; // Renders that could not be kept (over budget or no heap), or drawn without a sprite
+size_t pageMemoryBudget = PAGE_MEMORY_BUDGET_BYTES; // "pages <bytes>" lowers it for this wake
+UiPage uiPage = UI_PAGE_FORECAST;
+
+// A displayMessage() issued on the network task, drawn by the UI loop.
+struct StatusMessage {
+    char line1[40];
+    char line2[40];
+    int color;
+};
+TripleBuffer<ForecastSnapshot> forecastSnapshots;
+TripleBuffer<StatusMessage> statusMessages;
+uint32_t forecastSnapshotSequence = 0;
+
+// --- Network Task ---
+// Fetches and reconnects run on core 0 (next to the WiFi stack); UI, buttons and render stay in the
+// Arduino loop task on core 1. setup() still fetches inline before the task exists.
+enum NetworkJobType : uint8_t { NETWORK_JOB_FETCH, NETWORK_JOB_RECONNECT, NETWORK_JOB_IP_LOOKUP };
+struct NetworkJob {
+    NetworkJobType type;
+    bool silent;
+    bool toggleLocation;   // Flip useGpsFromSecrets before fetching (the network task owns it and the resolver)
+};
+const uint32_t NETWORK_TASK_STACK_BYTES = 10240; // TLS handshake + HTTP client
+const BaseType_t NETWORK_TASK_CORE = 0;
+QueueHandle_t networkJobQueue = NULL;
+TaskHandle_t networkTaskHandle = NULL;
+std::atomic<bool> networkJobDone{false};
+NetworkJobType pendingNetworkJob = NETWORK_JOB_FETCH;
+
+// --- Timer Wheel ---
+// Three-level hierarchical wheel on a 1 s monotonic tick (esp_timer, so NTP steps of the wall clock
+// don't move deadlines). Level n has 64 slots of 64^n s, for a 72 h horizon; schedule/cancel are O(1)
+// list operations and a timer cascades one level down when its coarse slot comes up.
+#define WHEEL_LEVELS 3
+#define WHEEL_SLOT_BITS 6
+#define WHEEL_SLOTS (1 << WHEEL_SLOT_BITS)
+enum WheelTimerId : uint8_t { TIMER_FETCH, TIMER_SCREEN_TIMEOUT, TIMER_RECONNECT, TIMER_DOSE_TICK, TIMER_QUARTER_REDRAW, TIMER_SCREEN_IDLE,
+                             TIMER_IP_LOOKUP, TIMER_COUNT };
+struct WheelTimer {
+    uint32_t expiryTick;
+    int8_t prev, next;     // Slot list links, -1 terminated
+    int8_t level;          // -1 while not armed
+    uint8_t slot;
+};
+WheelTimer wheelTimers[TIMER_COUNT];
+int8_t wheelSlotHead[WHEEL_LEVELS][WHEEL_SLOTS];
+uint32_t wheelTick = 0;      // Last processed tick
+uint8_t wheelFiredMask = 0;  // Bit per WheelTimerId, consumed by runStateMachine()
+
+// --- Device State Machine ---
+enum DeviceState : uint8_t { STATE_NORMAL_IDLE, STATE_FETCHING, STATE_LPM_SCREEN_ON, STATE_LPM_SLEEPING, STATE_OFFLINE };
+const char* const DEVICE_STATE_NAMES[] = { "NormalIdle", "Fetching", "LpmScreenOn", "LpmSleeping", "Offline" };
+DeviceState deviceState = STATE_NORMAL_IDLE;
+bool fetchOverdue = false;   // A fetch slot passed while Offline; served on reconnect
+DeviceState fetchResumeState = STATE_NORMAL_IDLE;
+bool fetchRescheduleAfter = false; // Compute the next slot once the in-flight fetch completes
+
+// --- Button Engine ---
+// Edges are timestamped in a GPIO ISR, debounced in a FreeRTOS timer callback and turned into
+// gesture events (lib/ButtonGesture) on a queue that loop() drains. Buttons are table-driven: add a
+// row to BUTTONS.
+enum ButtonId : uint8_t { BUTTON_ID_INFO, BUTTON_ID_LP_TOGGLE, BUTTON_COUNT };
+
+struct ButtonConfig {
+    uint8_t pin;
+    bool detectDouble;     // Short press is delayed by DOUBLE_CLICK_WINDOW_MS to tell it from a double
+    bool holdRepeat;       // Emit HOLD_REPEAT every HOLD_REPEAT_MS after LONG while still held
+};
+struct ButtonEvent {
+    uint8_t button;
+    ButtonEventType type;
+    uint32_t timestampMs;  // Debounced edge time from the ISR
+};
+struct ButtonRuntime {
+    TimerHandle_t debounceTimer;
+    TimerHandle_t gestureTimer;  // Long-press, hold-repeat and double-click window, one phase at a time
+    volatile uint32_t lastEdgeMs;
+    GestureState gesture;
+};
 
-uint32_t button_lp_last_press_time = 0;
-bool button_lp_last_state = HIGH;
-uint32_t button_lp_press_start_time = 0;
-bool button_lp_is_held = false;
+const ButtonConfig BUTTONS[BUTTON_COUNT] = {
+    { BUTTON_INFO_PIN,      true,  false },
+    { BUTTON_LP_TOGGLE_PIN, false, false },
+};
+ButtonRuntime buttonRuntime[BUTTON_COUNT];
+QueueHandle_t buttonEventQueue = NULL;
 
 const uint16_t DEBOUNCE_TIME_MS = 50;
 const uint16_t LONG_PRESS_TIME_MS = 1000;
+// A short press on a detectDouble button (INFO) is only reported once this window has passed
+// without a second press, so the overlay toggle lags the release by up to 300 ms. Clear
+// detectDouble in BUTTONS to get immediate short presses at the cost of the double-click refresh.
+const uint16_t DOUBLE_CLICK_WINDOW_MS = 300;
+const uint16_t HOLD_REPEAT_MS = 300;
+const ButtonTiming BUTTON_TIMING = { LONG_PRESS_TIME_MS, DOUBLE_CLICK_WINDOW_MS, HOLD_REPEAT_MS };
+const uint8_t BUTTON_EVENT_QUEUE_LENGTH = 8;
+
+// --- Idle / Light Sleep Variables ---
+TaskHandle_t loopTaskHandle = NULL;
+bool autoLightSleepEnabled = false;
 
 // --- RTC Memory Variables ---
 RTC_DATA_ATTR uint32_t rtc_magic_cookie = 0;
@@ -76,13 +332,214 @@ RTC_DATA_ATTR bool rtc_hasValidData = false;
 RTC_DATA_ATTR float rtc_hourlyUV[HOURLY_FORECAST_COUNT];
 RTC_DATA_ATTR int rtc_forecastHours[HOURLY_FORECAST_COUNT];
 RTC_DATA_ATTR char rtc_lastUpdateTimeStr_char[16];
-RTC_DATA_ATTR char rtc_locationDisplayStr_char[32];
+RTC_DATA_ATTR char rtc_locationDisplayStr_char[LOCATION_LABEL_CHARS];
+RTC_DATA_ATTR uint8_t rtc_locationSource = 0;       // LocationSource behind rtc_locationDisplayStr_char
 RTC_DATA_ATTR float rtc_deviceLatitude = MY_LATITUDE;
 RTC_DATA_ATTR float rtc_deviceLongitude = MY_LONGITUDE;
 RTC_DATA_ATTR bool rtc_useGpsFromSecretsGlobal = false;
+RTC_DATA_ATTR DayForecast rtc_dayForecast = { -1 };
+
+// Adaptive cadence state and its per-day trade-off tracking, updated by the network task after each
+// fetch. The loop schedules from the interval alone, read under adaptiveCadenceMux.
+RTC_DATA_ATTR byte rtc_adaptiveIntervalMin = ADAPTIVE_MIN_INTERVAL_MINUTES;
+RTC_DATA_ATTR bool rtc_lastFetchFromApi = false;   // Previous forecast is real API data, usable for revision deltas
+RTC_DATA_ATTR CadenceDayStats rtc_cadenceDay = { -1 };
+RTC_DATA_ATTR CadenceDecision rtc_lastCadence = { 0.0f, 0.0f, -1.0f, 0 }; // The last fetch's inputs, for the "cadence" command
+const AdaptiveCadenceConfig ADAPTIVE_CADENCE = { ADAPTIVE_MIN_INTERVAL_MINUTES, ADAPTIVE_MAX_INTERVAL_MINUTES,
+                                                 ADAPTIVE_VOLATILE_UV_PER_HOUR, ADAPTIVE_STABLE_UV_PER_HOUR };
+portMUX_TYPE adaptiveCadenceMux = portMUX_INITIALIZER_UNLOCKED;
 
 #define RTC_MAGIC_VALUE 0xDEADBEEF
 
+// --- Location Resolver ---
+// Each fetch takes its coordinates from the cached decision of lib/LocationResolver: the secrets
+// position or the IP fix kept in RTC memory. Lookups are their own job, armed on TIMER_IP_LOOKUP for
+// when the kept fix is due for a refresh or the backoff after a failure has passed; wakes that never
+// reach the timer wheel (power-on, LPM timer wakes) look up inline before their fetch when one is due.
+const char* const LOCATION_SOURCE_TAGS[] = { "Sec", "IP", "Cached" };
+const LocationConfig LOCATION_CONFIG = { LOCATION_CONFIDENCE_SECRETS, LOCATION_CONFIDENCE_IP, LOCATION_IP_HALF_LIFE_SEC,
+                                         LOCATION_IP_REFRESH_SEC, LOCATION_IP_RETRY_MIN_SEC, LOCATION_IP_RETRY_MAX_SEC };
+RTC_DATA_ATTR LocationState rtc_location = {};
+LocationSource locationSource = LOCATION_SOURCE_SECRETS; // Network task
+bool locationForceIpLookup = false;                      // Set when the pin is released
+uint32_t locationRetryTick = 0;                          // wheelNowTick() the relative backoff was last counted down at
+
+// --- Energy Profiler ---
+// Each wake cycle (boot to deep sleep in LPM, fetch to rendered frame in normal mode) is split into
+// phases. Phase time x ENERGY_PHASE_CURRENT_MA gives a per-cycle mAh estimate (lib/EnergyProfile)
+// kept in RTC memory.
+enum EnergyPhase : uint8_t {
+    ENERGY_PHASE_BOOT, ENERGY_PHASE_TFT_INIT, ENERGY_PHASE_WIFI_ASSOC, ENERGY_PHASE_DHCP, ENERGY_PHASE_NTP,
+    ENERGY_PHASE_GEOLOCATION, ENERGY_PHASE_TLS, ENERGY_PHASE_UV_FETCH, ENERGY_PHASE_PARSE, ENERGY_PHASE_RENDER,
+    ENERGY_PHASE_SLEEP_ENTRY, ENERGY_PHASE_OTHER, ENERGY_PHASE_COUNT
+};
+const char* const ENERGY_PHASE_NAMES[ENERGY_PHASE_COUNT] = {
+    "boot", "tft", "assoc", "dhcp", "ntp", "geo", "tls", "uv", "parse", "render", "sleep", "other"
+};
+// Typical ESP32 module + ST7789 draw per phase in mA; adjust to measured values for the board
+const float ENERGY_PHASE_CURRENT_MA[ENERGY_PHASE_COUNT] = {
+    45.0f, 55.0f, 130.0f, 110.0f, 100.0f, 110.0f, 140.0f, 110.0f, 50.0f, 60.0f, 45.0f, 50.0f
+};
+const EnergyModel ENERGY_MODEL = { ENERGY_PHASE_CURRENT_MA, ENERGY_PHASE_COUNT, ENERGY_PHASE_OTHER, DEEP_SLEEP_CURRENT_MA };
+
+struct EnergyCycleRecord {
+    uint32_t startEpoch;                       // 0 if time was not known
+    uint32_t sleepSeconds;                     // Deep sleep that followed the cycle (0 in normal mode)
+    float mAh;                                 // Awake phases + following deep sleep
+    uint16_t phaseMs[ENERGY_PHASE_COUNT];      // Saturates at 65535 ms
+    uint8_t wakeCause;                         // esp_sleep_wakeup_cause_t
+};
+RTC_DATA_ATTR EnergyCycleRecord rtc_energyLog[ENERGY_LOG_CYCLES];
+RTC_DATA_ATTR uint8_t rtc_energyLogNext = 0;
+RTC_DATA_ATTR uint8_t rtc_energyLogCount = 0;
+
+// --- Sleep Drift Compensation ---
+// The deep sleep timer and the RTC-kept system time both run off the 150 kHz slow clock, so drift is
+// only visible against NTP. After a timer wake the first SNTP sync gives the true wake epoch; the ratio
+// of programmed to actual sleep becomes a correction factor applied to the next sleep duration.
+RTC_DATA_ATTR float rtc_sleepDriftCorrection = 1.0f;
+RTC_DATA_ATTR bool rtc_sleepStartVerified = false; // Sleep start epoch below came from NTP-synced time
+RTC_DATA_ATTR int64_t rtc_sleepStartEpochUs = 0;
+RTC_DATA_ATTR uint64_t rtc_programmedSleepUs = 0;  // Duration handed to the timer, after correction
+RTC_DATA_ATTR uint32_t rtc_targetWakeEpoch = 0;    // Slot the sleep was aimed at
+RTC_DATA_ATTR uint16_t rtc_sleepSlotIntervalSec = 0; // Slot interval in force when the sleep was scheduled
+RTC_DATA_ATTR SlotAccuracyLog rtc_slotAccuracy;      // Per-day LPM summary (see lib/SleepDrift)
+
+volatile bool ntpSyncedThisBoot = false;   // Set from the SNTP callback (lwIP task)
+volatile int64_t ntpSyncEpochUs = 0;       // True epoch at the moment of the sync...
+volatile int64_t ntpSyncBootUs = 0;        // ...and esp_timer_get_time() at the same moment
+
+// Phases are timed on the loop (render, sleep entry) and the network task (WiFi, TLS, ...); the cycle
+// and its totals are shared. energyPhaseStartUs[] entries belong to the task that runs the phase.
+bool energyCycleOpen = false;
+int64_t energyCycleStartUs = 0;
+uint8_t energyCycleWakeCause = 0;
+uint32_t energyPhaseUs[ENERGY_PHASE_COUNT];
+int64_t energyPhaseStartUs[ENERGY_PHASE_COUNT];
+portMUX_TYPE energyMux = portMUX_INITIALIZER_UNLOCKED;
+volatile int64_t wifiStaConnectedUs = 0;   // Set from the WiFi event task, splits association from DHCP
+
+// --- Boot Pipeline ---
+const char* const WIFI_SSIDS[] = {
+    WIFI_SSID_1,
+    WIFI_SSID_2
+    #if defined(WIFI_SSID_3)
+    , WIFI_SSID_3
+    #endif
+    #if defined(WIFI_SSID_4)
+    , WIFI_SSID_4
+    #endif
+};
+const char* const WIFI_PASSWORDS[] = {
+    WIFI_PASS_1,
+    WIFI_PASS_2
+    #if defined(WIFI_SSID_3)
+    , WIFI_PASS_3
+    #endif
+    #if defined(WIFI_SSID_4)
+    , WIFI_PASS_4
+    #endif
+};
+const int WIFI_NETWORK_COUNT = sizeof(WIFI_SSIDS) / sizeof(WIFI_SSIDS[0]);
+
+bool bootPipelined = false;           // This boot started association ahead of display/state init
+bool wifiEarlyAssocPending = false;   // Association to the first configured SSID is in flight, not yet awaited
+int64_t wifiEarlyAssocStartUs = 0;
+bool bootFetchTimingPending = true;   // Cleared by the first fetch of setup(), or at the end of setup()
+bool bootCachedFrameHeld = false;     // The cached forecast stays on screen; fetch progress goes to serial only
+// Wake-to-fetch-complete time per ordering, [0] sequential / [1] pipelined, for A/B comparison
+RTC_DATA_ATTR RunningMean rtc_bootToFetchMs[2] = {};
+
+// --- Boot Profiler ---
+// Timestamps the end of each setup() step in us since the app started (esp_timer starts after the ROM
+// and second-stage bootloader, which the app cannot see). The profile is printed when setup() hands
+// over to loop() or puts the device back to sleep. Timer wakes are also averaged in RTC memory split
+// by whether the display was brought up, so the cost of initialising it shows as awake ms per wake.
+enum BootStep : uint8_t {
+    BOOT_STEP_WIFI_KICK, BOOT_STEP_SERIAL, BOOT_STEP_EEPROM, BOOT_STEP_PINS, BOOT_STEP_WAKE_LOG,
+    BOOT_STEP_STATE_LOAD, BOOT_STEP_DOSE, BOOT_STEP_DISPLAY, BOOT_STEP_FETCH, BOOT_STEP_SCHEDULE,
+    BOOT_STEP_DONE, BOOT_STEP_COUNT
+};
+const char* const BOOT_STEP_NAMES[BOOT_STEP_COUNT] = {
+    "wifi_kick", "serial", "eeprom", "pins", "wake_log", "state", "dose", "display", "fetch", "schedule", "done"
+};
+static_assert(BOOT_STEP_COUNT <= BOOT_PROFILE_MAX_STEPS, "lib/BootProfile orders at most BOOT_PROFILE_MAX_STEPS steps");
+int64_t bootStepUs[BOOT_STEP_COUNT];  // 0: step not reached this boot
+bool bootProfileOpen = true;          // Until setup() finishes or sleeps
+bool displayReady = false;            // tft.init() has run this boot
+RTC_DATA_ATTR uint32_t rtc_displayInitUs = 0;               // Cost of the last tft.init() + setup
+// Timer wake to deep sleep, [0] display initialised / [1] display left untouched
+RTC_DATA_ATTR RunningMean rtc_timerWakeAwakeMs[2] = {};
+
+// --- Display Power ---
+// Between LPM screen-on windows the ST7789 is put in sleep-in (oscillator and charge pumps stopped,
+// GRAM and registers kept) with its reset and chip-select lines held through deep sleep, so the next
+// button wake only needs SLPOUT instead of a reset and the full init sequence. SLPOUT is sent early in
+// setup() and its 120 ms settle runs while state is restored and the frame drawn into GRAM; DISPON and
+// the backlight follow once the frame is ready. Every power command goes through one function that
+// applies the datasheet spacing and keeps a trace of what was sent and how long it had to wait.
+enum DisplayPowerState : uint8_t {
+    DISPLAY_POWER_UNKNOWN,   // Not configured this power cycle (or not known to be)
+    DISPLAY_POWER_SLEEP,     // Configured, in sleep-in
+    DISPLAY_POWER_WAKING,    // SLPOUT sent, DISPON pending
+    DISPLAY_POWER_ON,
+    DISPLAY_POWER_IDLE       // On, 8-colour idle mode
+};
+const char* const DISPLAY_POWER_NAMES[] = { "unknown", "sleep", "waking", "on", "idle" };
+struct DisplayPowerTraceEntry {
+    uint32_t atUs;           // esp_timer when sent
+    uint32_t waitedUs;       // Held back by the spacing rules
+    uint8_t command;
+};
+DisplayPowerState displayPowerState = DISPLAY_POWER_UNKNOWN;
+int64_t displaySleepEdgeUs = 0;        // Last SLPIN/SLPOUT this boot (a wake's SLPOUT can go out at 0 us)
+uint8_t displaySleepEdgeCommand = 0;   // 0 if none yet
+bool displayShowPending = false;       // turnScreenOn() ran, backlight waits for a drawn frame
+DisplayPowerTraceEntry displayPowerTrace[DISPLAY_POWER_TRACE_ENTRIES];
+uint8_t displayPowerTraceNext = 0;
+uint8_t displayPowerTraceCount = 0;
+uint32_t displayWakeOverlapUs = 0;     // Last wake: SLPOUT to frame ready, spent on other work...
+uint32_t displayWakeBlockedUs = 0;     // ...and what was left of the settle time, waited before DISPON
+RTC_DATA_ATTR bool rtc_displayAsleep = false; // Controller configured and in sleep-in across the deep sleep
+
+// --- UV Dose Engine ---
+// The model (lib/UvDose) follows the forecast on screen; the day's total lives in RTC memory.
+static_assert(UV_DOSE_KNOTS == HOURLY_FORECAST_COUNT, "lib/UvDose is sized for the hourly forecast");
+UvDoseModel uvDose = {};
+int32_t uvDoseBurnMinutes = -1;      // Exposure from now that adds one MED; -1 if not reached within the forecast
+int32_t uvDoseHorizonMinutes = 0;    // Forecast left from now
+RTC_DATA_ATTR float rtc_doseTodaySed = 0.0f;     // Ambient erythemal dose since local midnight
+RTC_DATA_ATTR int16_t rtc_doseDayOfYear = -1;
+RTC_DATA_ATTR uint32_t rtc_doseLastEpoch = 0;    // Dose is integrated up to this time
+
+// --- Event Telemetry ---
+// Records and their layout live in lib/EventTelemetry; the log itself stays in RTC memory.
+RTC_DATA_ATTR TelemetryLog rtc_telemetry;
+volatile int64_t telemetryEpochOffsetUs = 0; // Wall clock minus esp_timer_get_time(); 0 until the time is known
+portMUX_TYPE telemetryMux = portMUX_INITIALIZER_UNLOCKED;
+
+// --- Memory Telemetry ---
+// Heap and stack samples taken before and after each fetch, render and persistence call. The history
+// shows whether String/JsonDocument churn is eating the heap (leak) or splitting it (fragmentation);
+// lib/MemoryTelemetry judges it.
+enum MemorySite : uint8_t { MEMORY_SITE_FETCH, MEMORY_SITE_RENDER, MEMORY_SITE_PERSIST, MEMORY_SITE_COUNT };
+const char* const MEMORY_SITE_NAMES[MEMORY_SITE_COUNT] = { "fetch", "render", "persist" };
+const MemoryTrendConfig MEMORY_TREND_CONFIG = { MEMORY_TREND_MIN_SAMPLES, MEMORY_FRAG_WARN_RATIO, MEMORY_FRAG_TREND_DROP,
+                                                MEMORY_LEAK_WARN_BYTES_PER_HOUR, MEMORY_LEAK_MIN_SPAN_SEC, MEMORY_STACK_WARN_BYTES };
+struct MemoryHistoryEntry {
+    uint32_t uptimeSec;
+    MemorySample before;
+    MemorySample after;
+    uint8_t site;                // MemorySite
+};
+MemoryHistoryEntry memoryHistory[MEMORY_HISTORY_SAMPLES];
+uint8_t memoryHistoryNext = 0;
+uint8_t memoryHistoryCount = 0;
+MemorySiteStats memorySiteStats[MEMORY_SITE_COUNT];
+uint8_t memoryTrendFlags = 0;
+// Fetch and most persistence calls run on the network task, rendering on the loop task
+portMUX_TYPE memoryTelemetryMux = portMUX_INITIALIZER_UNLOCKED;
+
 // --- Global variables for Scheduling ---
 unsigned long nextUpdateEpochNormalMode = 0; // Stores the epoch time for the next scheduled update in normal mode
 unsigned long nextUpdateEpochLpm = 0;        // Stores the epoch time for the next scheduled update in LPM
@@ -92,47 +549,321 @@ unsigned long nextUpdateEpochLpm = 0;        // Stores the epoch time for the ne
 void turnScreenOn();
 void turnScreenOff();
 void savePersistentState();
+void saveForecastState();
 void loadPersistentState();
+void setDeviceCoordinates(float latitude, float longitude);
+void readDeviceCoordinates(float& latitude, float& longitude);
 
 struct NextUpdateTimeDetails {
     uint64_t sleepDurationUs;
     time_t nextUpdateEpoch;
     bool updateNow;
 };
+
 NextUpdateTimeDetails calculateNextUpdateTimeDetails(const struct tm& currentTimeInfo, byte updatesPerHour, byte targetStartMinute, bool isNormalModeCheck);
 void enterDeepSleep(uint64_t duration_us, bool alsoEnableButtonWake);
 void printWakeupReason();
 
+byte adaptiveUpdatesPerHour(byte configuredUpdatesPerHour);
+uint32_t locationNow();
+bool locationLookupIp(bool silent);
+void locationLookupIfDue(bool silent);
+void locationRetryCountDown();
+void armLocationLookup();
+LocationSource resolveLocation(bool online, bool silent);
+void dumpLocationResolver();
+void updateAdaptiveCadence(const float* previousUV, const int* previousHours, const struct tm& nowInfo);
+void dumpAdaptiveCadence();
+
+void energyCycleBegin(uint8_t wakeCause, int64_t startUs);
+void energyPhaseBegin(EnergyPhase phase);
+void energyPhaseEnd(EnergyPhase phase);
+void energyPhaseAdd(EnergyPhase phase, int64_t durationUs);
+void energyCycleCommit(uint32_t sleepSeconds);
+void onWiFiStaConnected(arduino_event_id_t event);
+void dumpEnergyLog(int cycles);
+void handleSerialCommands();
+
+void onNtpTimeSynced(struct timeval* tv);
+bool waitForNtpSync(uint32_t timeoutMs);
+void updateSleepDriftCalibration(esp_sleep_wakeup_cause_t wakeupReason);
+SlotAccuracyDay& slotAccuracyOn(time_t epoch);
+void dumpSlotAccuracy();
+
+void beginEarlyWiFiAssociation();
+void recordBootToFetchTime();
+void dumpBootTiming();
+void bootProfileMark(BootStep step);
+void bootProfileFinish(bool sleeping);
+void displayBegin();
+void displayPowerBegin(esp_sleep_wakeup_cause_t wakeCause);
+void displayPowerCommand(uint8_t command);
+void displayPowerWake();
+void displayPowerShow();
+void displayPowerSleep();
+void displayPowerIdle(bool idle);
+void displayPowerHoldForDeepSleep();
+void dumpDisplayPower();
+
+
+float uvDoseMedSed();
+void uvDoseIntegrate(time_t now, const struct tm& localNow);
+void uvDoseTick();
+String uvDoseBurnText();
+void dumpUvDose();
+
+void telemetryClockBegin();
+void telemetryLog(TelemetryEvent event, uint16_t payload);
+void dumpTelemetryLog();
+
+MemorySample memorySample();
+void memoryRecord(MemorySite site, const MemorySample& before);
+uint8_t memoryEvaluateTrends(float* olderRatio, float* newerRatio, float* bytesPerHour);
+void dumpMemoryTelemetry();
+
+String buildOpenMeteoBenchPayload(int days);
+uint32_t benchSchedulerPass();
+uint32_t benchParsePass(const String& payload);
+uint32_t benchIpGeoPass();
+void benchRenderPass(TFT_eSprite& frame);
+void runBenchmarks();
+
 void initializeForecastData(bool updateRTC = false);
 void connectToWiFi(bool silent);
-bool fetchLocationFromIp(bool silent);
+bool fetchLocationFromIp(bool silent, LocationFix& fix);
 bool fetchUVData(bool silent);
+enum HourlyParseResult : uint8_t { HOURLY_PARSE_OK, HOURLY_PARSE_NO_START, HOURLY_PARSE_MISSING };
+HourlyParseResult extractHourlyForecast(JsonDocument& doc, int currentHourLocal, float* uvOut, int* hoursOut);
+bool extractDayForecast(JsonDocument& doc, DayForecast* dayOut);
+String dayPeakText(const DayForecast& day);
+void dumpDayForecast();
+int currentQuarterIndex(const ForecastSnapshot& view);
+uint32_t msUntilNextQuarterHour();
 
 void displayMessage(String msg_line1, String msg_line2 = "", int color = TFT_WHITE, bool allowDisplay = true);
 void displayInfo();
-void drawForecastGraph(int start_y_offset);
+void drawForecastGraph(TFT_eSPI& gfx, int start_y_offset);
+void fillUvGradientBar(TFT_eSPI& gfx, int x, int baselineY, int width, int height, int fullScaleHeight);
+extern const UiPageDef UI_PAGES[UI_PAGE_COUNT];
+void renderForecastPage(TFT_eSPI& gfx, const ForecastSnapshot& view);
+void renderDayPage(TFT_eSPI& gfx, const ForecastSnapshot& view);
+void renderStatsPage(TFT_eSPI& gfx, const ForecastSnapshot& view);
+void renderNetworkPage(TFT_eSPI& gfx, const ForecastSnapshot& view);
+void drawPageLine(TFT_eSPI& gfx, int line, const String& text, uint16_t color);
+uint32_t pageInputStamp(PageInput input, const ForecastSnapshot& view);
+uint32_t pageInputKey(const UiPageDef& page, const ForecastSnapshot& view);
+size_t pageSpriteBytes();
+bool pageSpriteBegin();
+void pageCacheSetBudget(size_t bytes);
+size_t pageFrameBudgetBytes();
+void pageCacheDrop(PageCacheEntry& entry);
+bool pageCacheEvictOldest(int keepPage);
+bool pageCacheStore(UiPage page, TFT_eSprite& frame, uint32_t inputKey);
+void pageCacheBlit(const PageCacheEntry& entry);
+void uiPageDraw(UiPage page, const ForecastSnapshot& view);
+void dumpPageCache();
+void buttonEngineBegin();
+bool buttonEngineNextEvent(ButtonEvent* event);
 void handle_buttons();
-void performDataFetchSequence(bool silent);
+void performDataFetchSequence(bool silent, bool lookupIfDue = false);
+void configureIdlePowerManagement();
+void idleUntilNextEvent();
+
+uint32_t wheelNowTick();
+void timerWheelInit();
+void timerWheelSchedule(WheelTimerId id, uint32_t delayMs);
+void timerWheelCancel(WheelTimerId id);
+bool timerWheelArmed(WheelTimerId id);
+uint32_t timerWheelRemainingMs(WheelTimerId id);
+uint32_t timerWheelMsUntilNext();
+void timerWheelAdvance();
+
+void setDeviceState(DeviceState next);
+void deviceStateBegin();
+void runStateMachine();
+void runFetch(bool silent, bool rescheduleAfter, bool toggleLocation = false);
+NextUpdateTimeDetails scheduleNextFetch(bool isNormalModeCheck);
+void armFetchTimer(time_t nextEpoch);
+void extendLpmScreenOn();
+void settleNormalModeState();
+void enterLpmSleep();
+
+void publishForecastSnapshot();
+void applyOfflineForecastPlaceholder();
+void networkTask(void* param);
+void networkTaskBegin();
+bool postNetworkJob(NetworkJobType type, bool silent, bool toggleLocation = false);
+void onNetworkJobDone();
 
 // --- Screen Control Functions ---
+// The controller keeps its registers through deep sleep (only the ESP32 sleeps), so a wake that
+// leaves the screen off doesn't need to reset and reprogram it. TFT_eSPI's init() always resets the
+// panel before its controller sequence and has no bus-only entry point, so that branch replicates the
+// bus half of init() from TFT_eSPI 2.5.43: the pins of the private TFT_eSPI::initBus() and the
+// spi.begin() of its first-boot block. The version is pinned in platformio.ini and checked here.
+#define TFT_ESPI_REPLICATED_VERSION "2.5.43"
+constexpr bool sameText(const char* a, const char* b) { return *a == *b && (*a == '\0' || sameText(a + 1, b + 1)); }
+static_assert(sameText(TFT_ESPI_VERSION, TFT_ESPI_REPLICATED_VERSION),
+              "displayBegin() replicates TFT_eSPI 2.5.43's initBus(): re-check it against the new release");
+
+void displayBegin() {
+    if (displayReady) return;
+    int64_t startUs = esp_timer_get_time();
+    energyPhaseBegin(ENERGY_PHASE_TFT_INIT);
+    if (displayPowerState == DISPLAY_POWER_SLEEP) { // Asleep since an earlier wake: bus only, no reset
+        pinMode(TFT_CS, OUTPUT); // initBus(), set up before the holds are released so RST and CS never float
+        digitalWrite(TFT_CS, HIGH);
+        pinMode(TFT_DC, OUTPUT);
+        digitalWrite(TFT_DC, HIGH);
+        pinMode(TFT_RST, OUTPUT);
+        digitalWrite(TFT_RST, HIGH);
+        gpio_hold_dis((gpio_num_t)TFT_RST);
+        gpio_hold_dis((gpio_num_t)TFT_CS);
+        TFT_eSPI::getSPIinstance().begin(TFT_SCLK, TFT_MISO, TFT_MOSI, -1); // init()'s first-boot block
+        tft.setRotation(1); // The interface takes commands in sleep-in
+    } else {
+        tft.init();
+        tft.setRotation(1);
+        digitalWrite(TFT_BL_PIN, LOW); // init() lights it; displayPowerShow() does once a frame is drawn
+        displayPowerState = DISPLAY_POWER_ON;
+        rtc_displayInitUs = (uint32_t)(esp_timer_get_time() - startUs);
+    }
+    tft.setTextDatum(MC_DATUM);
+    pageSpriteBegin(); // Size follows the rotation
+    energyPhaseEnd(ENERGY_PHASE_TFT_INIT);
+    displayReady = true;
+    bootProfileMark(BOOT_STEP_DISPLAY);
+}
+
+// The backlight comes on with the next drawn frame (displayMessage()/displayInfo(), or loop()).
 void turnScreenOn() {
     #if DEBUG_LPM
     Serial.println("Screen ON");
     #endif
-    digitalWrite(TFT_BL_PIN, HIGH);
-    tft.writecommand(TFT_DISPON);
+    displayPowerWake();
+    if (displayPowerState == DISPLAY_POWER_WAKING) { // GRAM writes need the 5 ms command guard
+        int64_t guardEndUs = displaySleepEdgeUs + ST7789_COMMAND_GUARD_US;
+        int64_t nowUs = esp_timer_get_time();
+        if (nowUs < guardEndUs) delayMicroseconds((uint32_t)(guardEndUs - nowUs));
+    }
+    displayShowPending = true;
 }
 
 void turnScreenOff() {
     #if DEBUG_LPM
     Serial.println("Screen OFF");
     #endif
+    displayPowerSleep();
+}
+
+// --- Display Power Functions ---
+void displayPowerBegin(esp_sleep_wakeup_cause_t wakeCause) {
+    bool slept = wakeCause != ESP_SLEEP_WAKEUP_UNDEFINED && rtc_magic_cookie == RTC_MAGIC_VALUE && rtc_displayAsleep;
+    displayPowerState = slept ? DISPLAY_POWER_SLEEP : DISPLAY_POWER_UNKNOWN;
+}
+
+// Spacing after the last SLPIN/SLPOUT: 120 ms before the opposite sleep command or DISPON after
+// SLPOUT, 5 ms before anything else. Commands that come too early wait for it instead of failing.
+void displayPowerCommand(uint8_t command) {
+    uint32_t waitedUs = 0;
+    if (displaySleepEdgeCommand != 0) {
+        bool settle = ((command == TFT_SLPIN || command == TFT_SLPOUT) && command != displaySleepEdgeCommand) ||
+                      (command == TFT_DISPON && displaySleepEdgeCommand == TFT_SLPOUT);
+        int64_t earliestUs = displaySleepEdgeUs + (settle ? ST7789_SLEEP_SETTLE_US : ST7789_COMMAND_GUARD_US);
+        int64_t nowUs = esp_timer_get_time();
+        if (nowUs < earliestUs) {
+            waitedUs = (uint32_t)(earliestUs - nowUs);
+            delay(waitedUs / 1000);
+            delayMicroseconds(waitedUs % 1000);
+        }
+    }
+    tft.writecommand(command);
+    int64_t sentUs = esp_timer_get_time();
+    if (command == TFT_SLPIN || command == TFT_SLPOUT) {
+        displaySleepEdgeUs = sentUs;
+        displaySleepEdgeCommand = command;
+    }
+    DisplayPowerTraceEntry& entry = displayPowerTrace[displayPowerTraceNext];
+    entry.atUs = (uint32_t)sentUs;
+    entry.waitedUs = waitedUs;
+    entry.command = command;
+    displayPowerTraceNext = (displayPowerTraceNext + 1) % DISPLAY_POWER_TRACE_ENTRIES;
+    if (displayPowerTraceCount < DISPLAY_POWER_TRACE_ENTRIES) displayPowerTraceCount++;
+}
+
+void displayPowerWake() {
+    displayBegin(); // Full init (ends on) when the controller's state is unknown
+    if (displayPowerState == DISPLAY_POWER_SLEEP) {
+        displayPowerCommand(TFT_SLPOUT);
+        displayPowerState = DISPLAY_POWER_WAKING;
+    } else if (displayPowerState == DISPLAY_POWER_IDLE) {
+        displayPowerIdle(false);
+    }
+}
+
+// Called once a frame is in GRAM.
+void displayPowerShow() {
+    if (!displayShowPending) return;
+    displayShowPending = false;
+    if (displayPowerState == DISPLAY_POWER_WAKING) {
+        int64_t readyUs = esp_timer_get_time();
+        displayWakeOverlapUs = (uint32_t)(readyUs - displaySleepEdgeUs);
+        displayPowerCommand(TFT_DISPON);
+        displayWakeBlockedUs = (uint32_t)(esp_timer_get_time() - readyUs);
+        displayPowerState = DISPLAY_POWER_ON;
+    }
+    digitalWrite(TFT_BL_PIN, HIGH);
+}
+
+void displayPowerSleep() {
     digitalWrite(TFT_BL_PIN, LOW);
-    tft.writecommand(TFT_DISPOFF);
+    displayShowPending = false;
+    if (displayPowerState == DISPLAY_POWER_UNKNOWN || displayPowerState == DISPLAY_POWER_SLEEP) return;
+    if (displayPowerState == DISPLAY_POWER_IDLE) displayPowerCommand(ST7789_IDMOFF); // Wake up in full colour
+    displayPowerCommand(TFT_DISPOFF);
+    displayPowerCommand(TFT_SLPIN);
+    displayPowerState = DISPLAY_POWER_SLEEP;
+}
+
+void displayPowerIdle(bool idle) {
+    if (idle && displayPowerState == DISPLAY_POWER_ON) {
+        displayPowerCommand(ST7789_IDMON);
+        displayPowerState = DISPLAY_POWER_IDLE;
+    } else if (!idle && displayPowerState == DISPLAY_POWER_IDLE) {
+        displayPowerCommand(ST7789_IDMOFF);
+        displayPowerState = DISPLAY_POWER_ON;
+    }
+}
+
+// Digital pads float in deep sleep; a low on RST would reset the controller out of sleep-in.
+void displayPowerHoldForDeepSleep() {
+    rtc_displayAsleep = (displayPowerState == DISPLAY_POWER_SLEEP);
+    if (!rtc_displayAsleep) return;
+    gpio_hold_en((gpio_num_t)TFT_RST);
+    gpio_hold_en((gpio_num_t)TFT_CS);
+    gpio_deep_sleep_hold_en();
+}
+
+void dumpDisplayPower() {
+    Serial.printf("Display: %s%s, bus %s\n", DISPLAY_POWER_NAMES[displayPowerState],
+                  displayShowPending ? " (frame pending)" : "", displayReady ? "up" : "not started");
+    Serial.printf("  last wake: %.1f ms of settle overlapped, %.1f ms waited before DISPON\n",
+                  displayWakeOverlapUs / 1000.0f, displayWakeBlockedUs / 1000.0f);
+    int start = (displayPowerTraceNext + DISPLAY_POWER_TRACE_ENTRIES - displayPowerTraceCount) % DISPLAY_POWER_TRACE_ENTRIES;
+    uint32_t previousUs = 0;
+    for (int n = 0; n < displayPowerTraceCount; ++n) {
+        const DisplayPowerTraceEntry& entry = displayPowerTrace[(start + n) % DISPLAY_POWER_TRACE_ENTRIES];
+        Serial.printf("  %10.1f ms  cmd 0x%02X  +%.1f ms  waited %.1f ms\n", entry.atUs / 1000.0f, entry.command,
+                      n ? (entry.atUs - previousUs) / 1000.0f : 0.0f, entry.waitedUs / 1000.0f);
+        previousUs = entry.atUs;
+    }
 }
 
 // --- EEPROM & RTC Memory Functions ---
+// Settings the loop owns (the LPM flag). The fetch results are saved by saveForecastState() on the
+// network task, which owns them, at the end of each job.
 void savePersistentState() {
+    MemorySample memoryBefore = memorySample();
     #if DEBUG_PERSISTENCE
     Serial.println("PERSISTENCE SAVE: Attempting to save state...");
     Serial.printf("PERSISTENCE SAVE: Saving isLowPowerModeActive = %s to EEPROM Addr %d\n", isLowPowerModeActive ? "true" : "false", LPM_FLAG_EEPROM_ADDR);
@@ -148,6 +879,17 @@ void savePersistentState() {
         #endif
     }
 
+    rtc_magic_cookie = RTC_MAGIC_VALUE;
+    #if DEBUG_PERSISTENCE
+    Serial.printf("PERSISTENCE SAVE (RTC part): HasValidData: %s, UseGPSSecrets: %s\n", rtc_hasValidData ? "Yes" : "No", rtc_useGpsFromSecretsGlobal ? "Yes" : "No");
+    #endif
+    memoryRecord(MEMORY_SITE_PERSIST, memoryBefore);
+}
+
+// Copies the working forecast, location and location pin to RTC memory. Runs on the network task, or
+// on the loop while no job is in flight (deep sleep entry).
+void saveForecastState() {
+    MemorySample memoryBefore = memorySample();
     rtc_magic_cookie = RTC_MAGIC_VALUE;
     rtc_useGpsFromSecretsGlobal = useGpsFromSecrets;
 
@@ -160,12 +902,12 @@ void savePersistentState() {
         rtc_lastUpdateTimeStr_char[sizeof(rtc_lastUpdateTimeStr_char) - 1] = '\0';
         strncpy(rtc_locationDisplayStr_char, locationDisplayStr.c_str(), sizeof(rtc_locationDisplayStr_char) - 1);
         rtc_locationDisplayStr_char[sizeof(rtc_locationDisplayStr_char) - 1] = '\0';
+        rtc_locationSource = locationSource;
         rtc_deviceLatitude = deviceLatitude;
         rtc_deviceLongitude = deviceLongitude;
+        rtc_dayForecast = dayForecast;
     }
-    #if DEBUG_PERSISTENCE
-    Serial.printf("PERSISTENCE SAVE (RTC part): HasValidData: %s, UseGPSSecrets: %s\n", rtc_hasValidData ? "Yes" : "No", rtc_useGpsFromSecretsGlobal ? "Yes" : "No");
-    #endif
+    memoryRecord(MEMORY_SITE_PERSIST, memoryBefore);
 }
 
 void loadPersistentState() {
@@ -197,8 +939,9 @@ void loadPersistentState() {
             }
             lastUpdateTimeStr = String(rtc_lastUpdateTimeStr_char);
             locationDisplayStr = String(rtc_locationDisplayStr_char);
-            deviceLatitude = rtc_deviceLatitude;
-            deviceLongitude = rtc_deviceLongitude;
+            locationSource = rtc_locationSource <= LOCATION_SOURCE_CACHED ? (LocationSource)rtc_locationSource : LOCATION_SOURCE_SECRETS;
+            setDeviceCoordinates(rtc_deviceLatitude, rtc_deviceLongitude);
+            dayForecast = rtc_dayForecast;
             dataJustFetched = true;
             #if DEBUG_PERSISTENCE
             Serial.println("PERSISTENCE LOAD: Valid data loaded from RTC.");
@@ -222,10 +965,30 @@ void loadPersistentState() {
         strncpy(rtc_locationDisplayStr_char, "Initializing...", sizeof(rtc_locationDisplayStr_char)-1);
         rtc_locationDisplayStr_char[sizeof(rtc_locationDisplayStr_char)-1] = '\0';
         locationDisplayStr = "Initializing...";
+        rtc_locationSource = LOCATION_SOURCE_SECRETS;
+        locationSource = LOCATION_SOURCE_SECRETS;
         rtc_deviceLatitude = MY_LATITUDE;
         rtc_deviceLongitude = MY_LONGITUDE;
-        deviceLatitude = MY_LATITUDE;
-        deviceLongitude = MY_LONGITUDE;
+        setDeviceCoordinates(MY_LATITUDE, MY_LONGITUDE);
+        rtc_adaptiveIntervalMin = ADAPTIVE_MIN_INTERVAL_MINUTES;
+        rtc_lastFetchFromApi = false;
+        cadenceDayReset(rtc_cadenceDay);
+        rtc_lastCadence = { 0.0f, 0.0f, -1.0f, 0 };
+        rtc_energyLogNext = 0;
+        rtc_energyLogCount = 0;
+        rtc_sleepDriftCorrection = 1.0f;
+        rtc_sleepStartVerified = false;
+        rtc_sleepSlotIntervalSec = 0;
+        slotAccuracyReset(rtc_slotAccuracy);
+        for (int i = 0; i < 2; ++i) { rtc_bootToFetchMs[i] = {}; rtc_timerWakeAwakeMs[i] = {}; }
+        rtc_displayInitUs = 0;
+        rtc_displayAsleep = false;
+        telemetryReset(rtc_telemetry);
+        rtc_doseTodaySed = 0.0f;
+        rtc_doseDayOfYear = -1;
+        rtc_doseLastEpoch = 0;
+        rtc_dayForecast.dayOfYear = -1;
+        locationReset(rtc_location);
         rtc_magic_cookie = RTC_MAGIC_VALUE;
     }
     #if DEBUG_LPM
@@ -236,7 +999,24 @@ void loadPersistentState() {
     #endif
 }
 
+// The network task writes the pair as the location resolves; the loop's night skip reads it.
+void setDeviceCoordinates(float latitude, float longitude) {
+    portENTER_CRITICAL(&deviceCoordinatesMux);
+    deviceLatitude = latitude;
+    deviceLongitude = longitude;
+    portEXIT_CRITICAL(&deviceCoordinatesMux);
+}
+
+void readDeviceCoordinates(float& latitude, float& longitude) {
+    portENTER_CRITICAL(&deviceCoordinatesMux);
+    latitude = deviceLatitude;
+    longitude = deviceLongitude;
+    portEXIT_CRITICAL(&deviceCoordinatesMux);
+}
+
 // --- Scheduling and Deep Sleep Functions ---
+// Slot grid arithmetic lives in lib/SlotScheduler (host-tested); this wrapper validates the
+// configuration, converts "now" once and layers the night skip on top.
 NextUpdateTimeDetails calculateNextUpdateTimeDetails(const struct tm& currentTimeInfo, byte updatesPerHour, byte targetStartMinute, bool isNormalModeCheck) {
     NextUpdateTimeDetails result;
     result.sleepDurationUs = 15 * 60 * 1000000ULL; 
@@ -258,116 +1038,26 @@ NextUpdateTimeDetails calculateNextUpdateTimeDetails(const struct tm& currentTim
         targetStartMinute = 0;
     }
 
-    int intervalMinutes = (updatesPerHour > 0) ? (60 / updatesPerHour) : 60; 
-    if (intervalMinutes == 0 && updatesPerHour > 0) intervalMinutes = 1; 
+    RefreshSlot slot = nextRefreshSlot(nowEpoch, localUtcOffsetSeconds(currentTimeInfo, nowEpoch), updatesPerHour, targetStartMinute, isNormalModeCheck);
+    result.nextUpdateEpoch = slot.nextSlotEpoch;
+    result.updateNow = slot.dueNow;
 
-    time_t foundNextEpoch = 0;
-
-    for (int h_offset = 0; h_offset < 2; ++h_offset) {
-        for (int i = 0; i < updatesPerHour; ++i) {
-            struct tm candidateTimeStruct = currentTimeInfo;
-            candidateTimeStruct.tm_hour = currentTimeInfo.tm_hour + h_offset;
-            candidateTimeStruct.tm_min = targetStartMinute + (i * intervalMinutes);
-            candidateTimeStruct.tm_sec = 0;
-
-            time_t candidateEpoch = mktime(&candidateTimeStruct);
-
-            if (candidateEpoch > nowEpoch) {
-                if (foundNextEpoch == 0 || candidateEpoch < foundNextEpoch) {
-                    foundNextEpoch = candidateEpoch;
-                }
-            } else if (isNormalModeCheck && (candidateEpoch == nowEpoch || (nowEpoch - candidateEpoch < intervalMinutes * 60 && nowEpoch - candidateEpoch < 30 ) )) {
-                result.updateNow = true;
-            }
+    // Night skip: no slot is due or scheduled between sunset and sunrise, one sleep covers the night.
+    if (SKIP_NIGHT_UPDATES) {
+        float latitude, longitude;
+        readDeviceCoordinates(latitude, longitude);
+        if (result.updateNow && nightSkipTarget(nowEpoch, latitude, longitude, NIGHT_SKIP_CONFIG) != 0) {
+            result.updateNow = false;
         }
-        if (foundNextEpoch != 0 && !result.updateNow) {
-            break;
-        }
-        if (foundNextEpoch != 0 && result.updateNow && foundNextEpoch > nowEpoch) {
-            break; 
+        time_t daylightEpoch = nightSkipTarget(result.nextUpdateEpoch, latitude, longitude, NIGHT_SKIP_CONFIG);
+        if (daylightEpoch > result.nextUpdateEpoch) {
+            #if DEBUG_SCHEDULING
+            Serial.printf("SCHED: Slot %lu is at night, deferring to %lu.\n", (unsigned long)result.nextUpdateEpoch, (unsigned long)daylightEpoch);
+            #endif
+            result.nextUpdateEpoch = daylightEpoch;
         }
     }
-
-    if (result.updateNow && isNormalModeCheck) {
-        if (foundNextEpoch == 0 || foundNextEpoch <= nowEpoch) {
-            struct tm nextSlotTimeCalc = currentTimeInfo;
-            time_t tempNowPlusInterval = nowEpoch + (intervalMinutes * 60);
-            nextSlotTimeCalc = *localtime(&tempNowPlusInterval); 
-            
-            bool slotFoundForNext = false;
-            for(int h_calc = 0; h_calc < 2; ++h_calc) {
-                for (int i_calc = 0; i_calc < updatesPerHour; ++i_calc) {
-                    struct tm tempCalc = currentTimeInfo; 
-                    tempCalc.tm_hour = nextSlotTimeCalc.tm_hour + h_calc; 
-                    tempCalc.tm_min = targetStartMinute + (i_calc * intervalMinutes);
-                    tempCalc.tm_sec = 0;
-                    time_t calcEpoch = mktime(&tempCalc);
-                    if (calcEpoch > nowEpoch) {
-                         if (foundNextEpoch == 0 || calcEpoch < foundNextEpoch || (foundNextEpoch <= nowEpoch && calcEpoch > foundNextEpoch) ){
-                            foundNextEpoch = calcEpoch;
-                            slotFoundForNext = true;
-                         }
-                    }
-                }
-                if(slotFoundForNext && (foundNextEpoch > nowEpoch)) break;
-            }
-             if (!slotFoundForNext || foundNextEpoch <= nowEpoch) { 
-                struct tm fallbackNext = currentTimeInfo;
-                fallbackNext.tm_hour +=1;
-                fallbackNext.tm_min = targetStartMinute;
-                fallbackNext.tm_sec = 0;
-                foundNextEpoch = mktime(&fallbackNext);
-                if (foundNextEpoch <= nowEpoch) { 
-                    fallbackNext.tm_mday +=1; 
-                    mktime(&fallbackNext); 
-                    foundNextEpoch = mktime(&fallbackNext);
-                }
-             }
-        }
-        result.nextUpdateEpoch = foundNextEpoch;
-        result.sleepDurationUs = 0; 
-    } else if (foundNextEpoch != 0) {
-        result.nextUpdateEpoch = foundNextEpoch;
-        result.sleepDurationUs = (uint64_t)difftime(result.nextUpdateEpoch, nowEpoch) * 1000000ULL;
-    } else {
-        struct tm fallbackTime = currentTimeInfo;
-        fallbackTime.tm_hour += 1;
-        fallbackTime.tm_min = targetStartMinute;
-        fallbackTime.tm_sec = 0;
-        result.nextUpdateEpoch = mktime(&fallbackTime);
-        if (result.nextUpdateEpoch <= nowEpoch) { 
-            fallbackTime.tm_mday +=1; 
-            mktime(&fallbackTime); 
-            result.nextUpdateEpoch = mktime(&fallbackTime);
-        }
-        result.sleepDurationUs = (uint64_t)difftime(result.nextUpdateEpoch, nowEpoch) * 1000000ULL;
-        #if DEBUG_SCHEDULING
-        Serial.println("SCHED WARN: No specific update slot found in 2h search, defaulting to next available target minute.");
-        #endif
-    }
-    
-    if (result.sleepDurationUs == 0 && !result.updateNow && result.nextUpdateEpoch == nowEpoch) { 
-        #if DEBUG_SCHEDULING
-        Serial.println("SCHED ERR: Calculated sleep duration is 0 when not updating now and nextEpoch is now. Advancing to next interval.");
-        #endif
-        result.nextUpdateEpoch = nowEpoch + (uint64_t)intervalMinutes * 60;
-        result.sleepDurationUs = (uint64_t)intervalMinutes * 60 * 1000000ULL;
-    }
-    if (result.sleepDurationUs == 0 && !result.updateNow) { 
-         result.sleepDurationUs = (uint64_t)intervalMinutes * 60 * 1000000ULL;
-         if(result.sleepDurationUs == 0) result.sleepDurationUs = 60 * 60 * 1000000ULL; 
-         result.nextUpdateEpoch = nowEpoch + (result.sleepDurationUs / 1000000ULL);
-    }
-    
-    uint64_t practicalMaxSleepUs = 3LL * 60 * 60 * 1000000; 
-    if (!isNormalModeCheck && result.sleepDurationUs > practicalMaxSleepUs) { 
-        #if DEBUG_SCHEDULING
-        Serial.printf("SCHED WARN: LPM Sleep duration %llu us too long. Capping to ~%d min.\n", result.sleepDurationUs, intervalMinutes > 0 ? intervalMinutes : 60);
-        #endif
-        result.sleepDurationUs = (uint64_t)(intervalMinutes > 0 ? intervalMinutes : 60) * 60 * 1000000ULL;
-        if(result.sleepDurationUs == 0 || result.sleepDurationUs > practicalMaxSleepUs) result.sleepDurationUs = 60*60*1000000ULL;
-        result.nextUpdateEpoch = nowEpoch + (result.sleepDurationUs / 1000000ULL);
-    }
+    result.sleepDurationUs = result.updateNow ? 0 : (uint64_t)(result.nextUpdateEpoch - nowEpoch) * 1000000ULL;
 
     #if DEBUG_SCHEDULING
         char timeBuff[30], nextTimeBuff[30];
@@ -376,20 +1066,770 @@ NextUpdateTimeDetails calculateNextUpdateTimeDetails(const struct tm& currentTim
         strftime(nextTimeBuff, sizeof(nextTimeBuff), "%F %T", localtime(&net_debug));
         Serial.printf("SCHED: Now: %s, TargetStartMin: %d, Updates/Hr: %d, isNormalChk: %d\n", timeBuff, targetStartMinute, updatesPerHour, isNormalModeCheck);
         Serial.printf("SCHED: Result: updateNow: %s, nextEpoch: %lu (%s), sleepUs: %llu (%.2f min)\n",
-                      result.updateNow ? "Y" : "N", (unsigned long)result.nextUpdateEpoch, nextTimeBuff, result.sleepDurationUs, (double)result.sleepDurationUs / 60000000.0);
+                      result.updateNow ? "Y" : "N", (unsigned long)result.nextUpdateEpoch, nextTimeBuff, (unsigned long long)result.sleepDurationUs, (double)result.sleepDurationUs / 60000000.0);
     #endif
     return result;
 }
 
+// --- Adaptive Cadence Functions ---
+// Effective updates/hour for a mode: the adaptive interval can only slow a mode down, never
+// exceed its configured UPDATES_PER_HOUR_* rate. Intervals are divisors of 60 so the slot grid holds.
+byte adaptiveUpdatesPerHour(byte configuredUpdatesPerHour) {
+    portENTER_CRITICAL(&adaptiveCadenceMux);
+    byte intervalMin = rtc_adaptiveIntervalMin;
+    portEXIT_CRITICAL(&adaptiveCadenceMux);
+    return ADAPTIVE_CADENCE_ENABLED ? cadenceUpdatesPerHour(intervalMin, configuredUpdatesPerHour) : configuredUpdatesPerHour;
+}
+
+// Derives the next interval from the fresh forecast against the previous one (lib/AdaptiveCadence),
+// then records fetches/day and the error of what was shown.
+void updateAdaptiveCadence(const float* previousUV, const int* previousHours, const struct tm& nowInfo) {
+    #if DEBUG_SCHEDULING
+    if (rtc_cadenceDay.dayOfYear >= 0 && rtc_cadenceDay.dayOfYear != nowInfo.tm_yday) {
+        Serial.printf("ADAPTIVE: Day summary: %u fetches, shown-UV error avg %.2f max %.2f\n", rtc_cadenceDay.fetchesToday,
+                      rtc_cadenceDay.shownErrorCount ? rtc_cadenceDay.shownErrorSum / rtc_cadenceDay.shownErrorCount : 0.0f,
+                      rtc_cadenceDay.shownErrorMax);
+    }
+    #endif
+    CadenceDecision decision = cadenceDecide(hourlyUV, forecastHours, rtc_lastFetchFromApi ? previousUV : nullptr,
+                                             rtc_lastFetchFromApi ? previousHours : nullptr, HOURLY_FORECAST_COUNT, ADAPTIVE_CADENCE);
+    cadenceDayRecord(rtc_cadenceDay, nowInfo.tm_yday, decision.shownError);
+    rtc_lastCadence = decision;
+    rtc_lastFetchFromApi = true;
+    portENTER_CRITICAL(&adaptiveCadenceMux);
+    rtc_adaptiveIntervalMin = decision.intervalMin;
+    portEXIT_CRITICAL(&adaptiveCadenceMux);
+
+    #if DEBUG_SCHEDULING
+    Serial.printf("ADAPTIVE: slope %.2f, revision %.2f -> interval %u min. Fetches today %u (yesterday %u)\n",
+                  decision.slope, decision.revision, decision.intervalMin, rtc_cadenceDay.fetchesToday, rtc_cadenceDay.fetchesYesterday);
+    #endif
+}
+
+// The cadence trade-off: the interval and what set it at the last fetch, and per day how many fetches
+// it cost against how far the UV on screen was from the next fresh value.
+void dumpAdaptiveCadence() {
+    const CadenceDayStats& day = rtc_cadenceDay;
+    Serial.printf("CADENCE: %s, interval %u min (bounds %u-%u)", ADAPTIVE_CADENCE_ENABLED ? "adaptive" : "fixed",
+                  rtc_adaptiveIntervalMin, ADAPTIVE_MIN_INTERVAL_MINUTES, ADAPTIVE_MAX_INTERVAL_MINUTES);
+    if (rtc_lastCadence.intervalMin) Serial.printf(", last fetch: slope %.2f, revision %.2f UV/h", rtc_lastCadence.slope, rtc_lastCadence.revision);
+    Serial.println();
+    if (day.dayOfYear < 0) {
+        Serial.println("No API fetch counted yet.");
+        return;
+    }
+    Serial.printf("yday %d: %u fetches (yesterday %u)", day.dayOfYear, day.fetchesToday, day.fetchesYesterday);
+    if (day.shownErrorCount) {
+        Serial.printf(", shown-UV error avg %.2f max %.2f over %u", day.shownErrorSum / day.shownErrorCount, day.shownErrorMax,
+                      day.shownErrorCount);
+    }
+    Serial.println();
+}
+
+// --- UV Dose Functions ---
+float uvDoseMedSed() {
+    return uvDoseMedSed(FITZPATRICK_SKIN_TYPE);
+}
+
+// Adds the dose since rtc_doseLastEpoch under the loaded forecast; any gap (deep sleep, missed ticks)
+// costs the same as one minute.
+void uvDoseIntegrate(time_t now, const struct tm& localNow) {
+    if (rtc_doseDayOfYear != localNow.tm_yday) { // New local day: start from midnight
+        rtc_doseDayOfYear = localNow.tm_yday;
+        rtc_doseTodaySed = 0.0f;
+        rtc_doseLastEpoch = (uint32_t)(now - (localNow.tm_hour * 3600 + localNow.tm_min * 60 + localNow.tm_sec));
+    }
+    if (rtc_doseLastEpoch != 0 && (uint32_t)now > rtc_doseLastEpoch && uvDose.loaded) {
+        float t = uvDoseMinuteOf(uvDose, localNow);
+        rtc_doseTodaySed += uvDoseSedAt(uvDose, t) - uvDoseSedAt(uvDose, t - ((uint32_t)now - rtc_doseLastEpoch) / 60.0f);
+    }
+    rtc_doseLastEpoch = (uint32_t)now;
+}
+
+// Runs on the UI loop: every UV_DOSE_TICK_MS, before each frame and before deep sleep. Also the
+// forecast snapshot consumer's acquire point, so the model always matches what is on screen.
+void uvDoseTick() {
+    bool fresh = forecastSnapshots.acquire();
+    time_t now = time(nullptr);
+    bool timeKnown = now > 1600000000;
+    struct tm localNow;
+    if (timeKnown) localtime_r(&now, &localNow);
+    if (fresh) {
+        force_display_update = true;
+        if (timeKnown) uvDoseIntegrate(now, localNow); // Close out the old forecast first
+        const ForecastSnapshot& snap = forecastSnapshots.front();
+        uvDoseLoadForecast(uvDose, snap.hourlyUV, snap.forecastHours);
+    }
+    if (!timeKnown) return;
+    uvDoseIntegrate(now, localNow);
+
+    UvBurnEstimate burn = uvDoseTimeToBurn(uvDose, uvDoseMinuteOf(uvDose, localNow), uvDoseMedSed());
+    uvDoseBurnMinutes = burn.burnMinutes;
+    uvDoseHorizonMinutes = burn.horizonMinutes;
+}
+
+String uvDoseBurnText() {
+    String type = String("(") + FITZPATRICK_TYPE_NAMES[constrain(FITZPATRICK_SKIN_TYPE, 1, 6) - 1] + ")";
+    if (uvDoseBurnMinutes >= 0) return "Burn " + String(uvDoseBurnMinutes) + "m " + type;
+    if (uvDoseHorizonMinutes >= 60) return "Burn >" + String(uvDoseHorizonMinutes / 60) + "h " + type;
+    return "Burn -- " + type;
+}
+
+void dumpUvDose() {
+    uvDoseTick();
+    Serial.printf("Skin type %s, MED %.1f SED | dose today %.2f SED (%.0f%% of MED)\n",
+                  FITZPATRICK_TYPE_NAMES[constrain(FITZPATRICK_SKIN_TYPE, 1, 6) - 1], uvDoseMedSed(),
+                  rtc_doseTodaySed, rtc_doseTodaySed * 100.0f / uvDoseMedSed());
+    if (!uvDose.loaded) {
+        Serial.println("No forecast loaded.");
+        return;
+    }
+    Serial.printf("Forecast from %02d:00, %d min left | time to burn: ", uvDose.knot0Hour, uvDoseHorizonMinutes);
+    if (uvDoseBurnMinutes >= 0) Serial.printf("%d min\n", uvDoseBurnMinutes);
+    else Serial.println("not reached within forecast");
+}
+
+// --- Location Resolver Functions ---
+uint32_t locationNow() {
+    time_t nowTime = time(nullptr);
+    return nowTime > 1600000000 ? (uint32_t)nowTime : 0; // 0: time unknown
+}
+
+// One lookup, recorded in rtc_location. The coordinates in use only change with the next resolveLocation().
+bool locationLookupIp(bool silent) {
+    if (!silent) displayMessage("Fetching IP Location...", "", TFT_SKYBLUE, true);
+    LocationFix fix;
+    energyPhaseBegin(ENERGY_PHASE_GEOLOCATION);
+    bool found = fetchLocationFromIp(silent, fix);
+    energyPhaseEnd(ENERGY_PHASE_GEOLOCATION);
+    uint32_t now = locationNow();
+    if (found) {
+        locationLookupSucceeded(rtc_location, fix.latitude, fix.longitude, fix.label, now);
+    } else {
+        locationLookupFailed(rtc_location, now, LOCATION_CONFIG);
+        Serial.printf("IP Geolocation failed (%u in a row), next attempt in %lu s.\n", rtc_location.failures,
+                      (unsigned long)locationLookupDueInSec(rtc_location, now, LOCATION_CONFIG));
+    }
+    return found;
+}
+
+// For the inline fetches of setup(), which run before the timer wheel: not pinned, online, and the
+// pin was just released or a lookup is due.
+void locationLookupIfDue(bool silent) {
+    if (useGpsFromSecrets || WiFi.status() != WL_CONNECTED) return;
+    locationRetryCountDown();
+    if (!locationForceIpLookup && locationLookupDueInSec(rtc_location, locationNow(), LOCATION_CONFIG) > 0) return;
+    locationForceIpLookup = false;
+    locationLookupIp(silent);
+}
+
+// A backoff set while the time was unknown is counted down on the wake's monotonic clock, and moves
+// onto the epoch once NTP has synced. setup() counts the deep sleep before it in on timer wakes.
+void locationRetryCountDown() {
+    uint32_t tick = wheelNowTick();
+    locationRetryElapse(rtc_location, tick - locationRetryTick, locationNow());
+    locationRetryTick = tick;
+}
+
+// Loop side, after every network job and when the state machine starts: arms TIMER_IP_LOOKUP for the
+// next due lookup, or cancels it while pinned or while nothing can be due before the time is known.
+void armLocationLookup() {
+    if (useGpsFromSecrets) {
+        timerWheelCancel(TIMER_IP_LOOKUP);
+        return;
+    }
+    locationRetryCountDown();
+    uint32_t dueInSec = locationForceIpLookup ? 0 : locationLookupDueInSec(rtc_location, locationNow(), LOCATION_CONFIG);
+    if (dueInSec == UINT32_MAX) timerWheelCancel(TIMER_IP_LOOKUP);
+    else timerWheelSchedule(TIMER_IP_LOOKUP, (dueInSec < UINT32_MAX / 1000 ? dueInSec : UINT32_MAX / 1000) * 1000);
+}
+
+// Runs on the network task once per fetch cycle: applies the cached decision (no lookup here).
+LocationSource resolveLocation(bool online, bool silent) {
+    uint32_t now = locationNow();
+    LocationSource source = useGpsFromSecrets ? LOCATION_SOURCE_SECRETS : locationDecide(rtc_location, now, LOCATION_CONFIG);
+    if (source == LOCATION_SOURCE_SECRETS) {
+        setDeviceCoordinates(MY_LATITUDE, MY_LONGITUDE);
+        if (useGpsFromSecrets) locationDisplayStr = "Secrets GPS";
+        else if (!online) locationDisplayStr = "Offline>Secrets";
+        else if (rtc_location.failures > 0) locationDisplayStr = "IP Fail>Secrets";
+        else locationDisplayStr = "Secrets GPS";
+    } else {
+        setDeviceCoordinates(rtc_location.ipFix.latitude, rtc_location.ipFix.longitude);
+        locationDisplayStr = rtc_location.ipFix.label;
+    }
+    locationSource = source;
+    if (!silent) Serial.printf("Location: %s (%s), IP confidence %.2f\n", locationDisplayStr.c_str(),
+                               LOCATION_SOURCE_TAGS[source], locationIpConfidence(rtc_location, now, LOCATION_CONFIG));
+    return source;
+}
+
+void dumpLocationResolver() {
+    uint32_t now = locationNow();
+    const LocationFix& fix = rtc_location.ipFix;
+    Serial.printf("Pinned to secrets: %s | in use: %s\n", useGpsFromSecrets ? "yes" : "no", LOCATION_SOURCE_TAGS[locationSource]);
+    Serial.printf("  secrets  %.4f, %.4f  confidence %.2f\n", (float)MY_LATITUDE, (float)MY_LONGITUDE, LOCATION_CONFIDENCE_SECRETS);
+    if (fix.epoch == 0) {
+        Serial.println("  ip       no fix yet");
+    } else {
+        Serial.printf("  ip       %.4f, %.4f  confidence %.2f, age %ld s (%s)\n", fix.latitude, fix.longitude,
+                      locationIpConfidence(rtc_location, now, LOCATION_CONFIG), now ? (long)(now - fix.epoch) : -1L, fix.label);
+    }
+    uint32_t dueInSec = locationLookupDueInSec(rtc_location, now, LOCATION_CONFIG);
+    Serial.printf("  lookups: %u failed in a row, ", rtc_location.failures);
+    if (dueInSec == UINT32_MAX) Serial.print("next once the time is known");
+    else Serial.printf("next in %lu s%s", (unsigned long)dueInSec, rtc_location.retryWaitSec ? " (time unknown)" : "");
+    Serial.printf(" | decision %s until %lu\n", LOCATION_SOURCE_TAGS[rtc_location.decision], (unsigned long)rtc_location.decisionUntil);
+}
+
+// --- Energy Profiler Functions ---
+void energyCycleBegin(uint8_t wakeCause, int64_t startUs) {
+    portENTER_CRITICAL(&energyMux);
+    if (!energyCycleOpen) {
+        energyCycleOpen = true;
+        energyCycleStartUs = startUs;
+        energyCycleWakeCause = wakeCause;
+        memset(energyPhaseUs, 0, sizeof(energyPhaseUs));
+    }
+    portEXIT_CRITICAL(&energyMux);
+}
+
+void onWiFiStaConnected(arduino_event_id_t event) {
+    wifiStaConnectedUs = esp_timer_get_time();
+}
+
+void energyPhaseBegin(EnergyPhase phase) {
+    energyPhaseStartUs[phase] = esp_timer_get_time();
+}
+
+void energyPhaseEnd(EnergyPhase phase) {
+    if (energyPhaseStartUs[phase] == 0) return;
+    energyPhaseAdd(phase, esp_timer_get_time() - energyPhaseStartUs[phase]);
+    energyPhaseStartUs[phase] = 0;
+}
+
+void energyPhaseAdd(EnergyPhase phase, int64_t durationUs) {
+    if (durationUs <= 0) return;
+    portENTER_CRITICAL(&energyMux);
+    if (energyCycleOpen) energyPhaseUs[phase] += (uint32_t)durationUs; // Else outside a wake/fetch cycle, e.g. a button redraw
+    portEXIT_CRITICAL(&energyMux);
+}
+
+// Closes the cycle under the lock and builds its record from the copy. Called from the loop only,
+// which also owns rtc_energyLog.
+void energyCycleCommit(uint32_t sleepSeconds) {
+    uint32_t phaseUs[ENERGY_PHASE_COUNT];
+    portENTER_CRITICAL(&energyMux);
+    bool open = energyCycleOpen;
+    int64_t startUs = energyCycleStartUs;
+    uint8_t wakeCause = energyCycleWakeCause;
+    memcpy(phaseUs, energyPhaseUs, sizeof(phaseUs));
+    energyCycleOpen = false;
+    portEXIT_CRITICAL(&energyMux);
+    if (!open) return;
+    int64_t awakeUs = esp_timer_get_time() - startUs;
+    energyAttributeOther(phaseUs, awakeUs, ENERGY_MODEL);
+
+    EnergyCycleRecord& rec = rtc_energyLog[rtc_energyLogNext];
+    rec.mAh = energyCycleMAh(phaseUs, sleepSeconds, ENERGY_MODEL, rec.phaseMs);
+    rec.sleepSeconds = sleepSeconds;
+    rec.wakeCause = wakeCause;
+    time_t nowEpoch = time(nullptr);
+    rec.startEpoch = (nowEpoch > 1600000000) ? (uint32_t)(nowEpoch - awakeUs / 1000000) : 0;
+
+    energyRingPush(rtc_energyLogNext, rtc_energyLogCount, ENERGY_LOG_CYCLES);
+}
+
+void dumpEnergyLog(int cycles) {
+    if (cycles <= 0 || cycles > rtc_energyLogCount) cycles = rtc_energyLogCount;
+    float phaseMAh[ENERGY_PHASE_COUNT] = {0};
+    float totalMAh = 0.0f;
+    Serial.printf("ENERGY: last %d of %d cycles (newest first)\n", cycles, rtc_energyLogCount);
+    for (int n = 0; n < cycles; ++n) {
+        const EnergyCycleRecord& rec = rtc_energyLog[energyRingSlot(rtc_energyLogNext, n, ENERGY_LOG_CYCLES)];
+        Serial.printf("#%d epoch=%lu cause=%u sleep=%lus mAh=%.4f |", n, (unsigned long)rec.startEpoch, rec.wakeCause,
+                      (unsigned long)rec.sleepSeconds, rec.mAh);
+        for (int i = 0; i < ENERGY_PHASE_COUNT; ++i) {
+            if (rec.phaseMs[i]) Serial.printf(" %s=%u", ENERGY_PHASE_NAMES[i], rec.phaseMs[i]);
+            phaseMAh[i] += energyPhaseMAh(rec.phaseMs[i], i, ENERGY_MODEL);
+        }
+        Serial.println();
+        totalMAh += rec.mAh;
+    }
+    int worst = 0;
+    for (int i = 1; i < ENERGY_PHASE_COUNT; ++i) if (phaseMAh[i] > phaseMAh[worst]) worst = i;
+    Serial.printf("ENERGY: total %.4f mAh, most expensive awake phase: %s (%.4f mAh)\n", totalMAh, ENERGY_PHASE_NAMES[worst], phaseMAh[worst]);
+}
+
+// --- Sleep Drift Functions ---
+void onNtpTimeSynced(struct timeval* tv) {
+    ntpSyncBootUs = esp_timer_get_time();
+    ntpSyncEpochUs = (int64_t)tv->tv_sec * 1000000LL + tv->tv_usec;
+    telemetryEpochOffsetUs = ntpSyncEpochUs - ntpSyncBootUs;
+    ntpSyncedThisBoot = true;
+}
+
+// getLocalTime() returns the RTC-kept (drifted) time immediately after a deep sleep wake, so wait for
+// the SNTP callback itself when the exact time matters.
+bool waitForNtpSync(uint32_t timeoutMs) {
+    if (WiFi.status() != WL_CONNECTED) return ntpSyncedThisBoot;
+    unsigned long startMs = millis();
+    while (!ntpSyncedThisBoot && millis() - startMs < timeoutMs) delay(20);
+    return ntpSyncedThisBoot;
+}
+
+// Compare the wake the timer was asked for with the NTP-derived one. Boot-to-app latency (~0.1-0.3 s)
+// is not counted, which is well inside the 1 s resolution of the slot epochs.
+void updateSleepDriftCalibration(esp_sleep_wakeup_cause_t wakeupReason) {
+    if (wakeupReason != ESP_SLEEP_WAKEUP_TIMER || !rtc_sleepStartVerified || !ntpSyncedThisBoot) return;
+    rtc_sleepStartVerified = false; // One measurement per sleep
+    int64_t actualWakeEpochUs = ntpSyncEpochUs - ntpSyncBootUs;
+    int64_t actualSleepUs = actualWakeEpochUs - rtc_sleepStartEpochUs;
+    if (!sleepDriftMeasurable(rtc_programmedSleepUs, actualSleepUs)) return;
+
+    float errorSec = (actualWakeEpochUs - (int64_t)rtc_targetWakeEpoch * 1000000LL) / 1000000.0f;
+    slotAccuracyRecord(slotAccuracyOn((time_t)(actualWakeEpochUs / 1000000LL)), errorSec, rtc_sleepSlotIntervalSec);
+
+    bool applied;
+    float measured = sleepDriftUpdate(rtc_sleepDriftCorrection, rtc_programmedSleepUs, actualSleepUs, &applied);
+    #if DEBUG_SCHEDULING
+    if (!applied) Serial.printf("DRIFT: Ignoring implausible factor %.4f (slot error %.1f s).\n", measured, errorSec);
+    else Serial.printf("DRIFT: Slot error %+.1f s, measured factor %.5f, correction now %.5f\n", errorSec, measured, rtc_sleepDriftCorrection);
+    #else
+    (void)measured;
+    #endif
+}
+
+// Summary entry for the local day of epoch.
+SlotAccuracyDay& slotAccuracyOn(time_t epoch) {
+    struct tm dayInfo;
+    localtime_r(&epoch, &dayInfo);
+    return slotAccuracyDay(rtc_slotAccuracy, dayInfo.tm_yday);
+}
+
+void dumpSlotAccuracy() {
+    Serial.printf("DRIFT: correction factor %.5f, hit tolerance +/-%lu s (newest day first)\n", rtc_sleepDriftCorrection, (unsigned long)SLOT_HIT_TOLERANCE_SEC);
+    for (int n = 0; n < SLOT_ACCURACY_DAYS; ++n) {
+        const SlotAccuracyDay& day = slotAccuracyNewest(rtc_slotAccuracy, n);
+        if (day.dayOfYear < 0) continue;
+        Serial.printf("yday %d: %u cycles, awake %.1f s, %u missed slots", day.dayOfYear, day.cycles, day.awakeMs / 1000.0f, day.missedSlots);
+        if (day.wakes > 0) {
+            Serial.printf(", %u/%u on slot, mean |err| %.1f s, max |err| %.1f s", day.hits, day.wakes,
+                          day.absErrorSumSec / day.wakes, day.maxAbsErrorSec);
+        }
+        Serial.println();
+    }
+}
+
+// --- Boot Pipeline Functions ---
+// WiFi.begin() only hands the credentials to the driver task; association and DHCP run on their own
+// while setup() continues. connectToWiFi() picks the attempt up instead of restarting it.
+void beginEarlyWiFiAssociation() {
+    for (int i = 0; i < WIFI_NETWORK_COUNT; ++i) {
+        if (strlen(WIFI_SSIDS[i]) == 0) continue;
+        WiFi.mode(WIFI_STA);
+        wifiStaConnectedUs = 0;
+        wifiEarlyAssocStartUs = esp_timer_get_time();
+        WiFi.begin(WIFI_SSIDS[i], WIFI_PASSWORDS[i]);
+        wifiEarlyAssocPending = true;
+        return;
+    }
+}
+
+// esp_timer starts with the app after a deep sleep wake, so its value is wake-to-now minus the bootloader.
+void recordBootToFetchTime() {
+    if (!bootFetchTimingPending) return;
+    bootFetchTimingPending = false;
+    uint32_t elapsedMs = (uint32_t)(esp_timer_get_time() / 1000);
+    int ordering = bootPipelined ? 1 : 0;
+    runningMeanAdd(rtc_bootToFetchMs[ordering], elapsedMs);
+    Serial.printf("BOOT: Wake to fetch complete in %lu ms (%s).\n", (unsigned long)elapsedMs, bootPipelined ? "pipelined" : "sequential");
+}
+
+void dumpBootTiming() {
+    const char* names[2] = {"sequential", "pipelined"};
+    for (int i = 0; i < 2; ++i) {
+        if (rtc_bootToFetchMs[i].count == 0) Serial.printf("BOOT: %s: no samples\n", names[i]);
+        else Serial.printf("BOOT: %s: mean %lu ms over %u wakes\n", names[i],
+                           (unsigned long)runningMeanValue(rtc_bootToFetchMs[i]), rtc_bootToFetchMs[i].count);
+    }
+    const char* displayNames[2] = {"display initialised", "display untouched"};
+    for (int i = 0; i < 2; ++i) {
+        if (rtc_timerWakeAwakeMs[i].count == 0) Serial.printf("BOOT: timer wakes, %s: no samples\n", displayNames[i]);
+        else Serial.printf("BOOT: timer wakes, %s: mean %lu ms awake over %u wakes\n", displayNames[i],
+                           (unsigned long)runningMeanValue(rtc_timerWakeAwakeMs[i]), rtc_timerWakeAwakeMs[i].count);
+    }
+    Serial.printf("BOOT: last display init took %.1f ms\n", rtc_displayInitUs / 1000.0f);
+}
+
+void bootProfileMark(BootStep step) {
+    if (bootProfileOpen) bootStepUs[step] = esp_timer_get_time();
+}
+
+// Prints the reached steps in the order they finished (the display may come up on any path), each
+// with its own duration since the previous one and its end time.
+void bootProfileFinish(bool sleeping) {
+    if (!bootProfileOpen) return;
+    bootProfileMark(BOOT_STEP_DONE);
+    bootProfileOpen = false;
+    esp_sleep_wakeup_cause_t wakeCause = esp_sleep_get_wakeup_cause();
+    char steps[BOOT_STEP_COUNT * 32 + 4]; // " wifi_kick +120000.0@120000.0" per step
+    bootProfileFormat(bootStepUs, BOOT_STEP_NAMES, BOOT_STEP_COUNT, steps, sizeof(steps));
+    Serial.printf("BOOT PROFILE (%s, %s):%s\n", wakeCause == ESP_SLEEP_WAKEUP_TIMER ? "timer wake" :
+                  wakeCause == ESP_SLEEP_WAKEUP_EXT0 ? "button wake" : "reset", sleeping ? "back to sleep" : "to loop", steps);
+    if (!displayReady) {
+        Serial.printf("BOOT: Display left untouched, saved ~%.1f ms of init this wake.\n", rtc_displayInitUs / 1000.0f);
+    }
+    if (sleeping && wakeCause == ESP_SLEEP_WAKEUP_TIMER) {
+        int slot = displayReady ? 0 : 1;
+        runningMeanAdd(rtc_timerWakeAwakeMs[slot], (uint32_t)(bootStepUs[BOOT_STEP_DONE] / 1000));
+    }
+}
+
+// --- Event Telemetry Functions ---
+// RTC-kept time survives deep sleep, so the offset is known from boot once NTP has ever synced.
+void telemetryClockBegin() {
+    struct timeval nowTv;
+    gettimeofday(&nowTv, nullptr);
+    if (nowTv.tv_sec > 1600000000) {
+        telemetryEpochOffsetUs = (int64_t)nowTv.tv_sec * 1000000LL + nowTv.tv_usec - esp_timer_get_time();
+    }
+}
+
+// Hot path: no libc time calls, no allocation, one short critical section (loop and network tasks both log).
+void telemetryLog(TelemetryEvent event, uint16_t payload) {
+    int64_t offsetUs = telemetryEpochOffsetUs;
+    uint32_t nowSec = offsetUs ? (uint32_t)((esp_timer_get_time() + offsetUs) / 1000000LL) : 0;
+    portENTER_CRITICAL(&telemetryMux);
+    telemetryAppend(rtc_telemetry, nowSec, event, payload);
+    portEXIT_CRITICAL(&telemetryMux);
+}
+
+// Prints the raw records as hex for archiving (telemetryParseDump() reads them back), then the same
+// records decoded with absolute times reconstructed back from the newest one.
+void dumpTelemetryLog() {
+    static TelemetryLog snapshot; // 1.3 KB: off the loop stack
+    portENTER_CRITICAL(&telemetryMux);
+    snapshot = rtc_telemetry;
+    portEXIT_CRITICAL(&telemetryMux);
+
+    char text[64];
+    telemetryFormatHeader(snapshot, text, sizeof(text));
+    Serial.println(text);
+    for (uint16_t i = 0; i < snapshot.count; ++i) {
+        if (i % 16 == 0) Serial.print("TLM ");
+        telemetryFormatRecord(telemetryRecordAt(snapshot, i), text, sizeof(text));
+        Serial.print(text);
+        Serial.print((i % 16 == 15 || i == snapshot.count - 1) ? "\n" : " ");
+    }
+
+    uint32_t epoch = telemetryOldestEpoch(snapshot);
+    Serial.println("  epoch      time (UTC)           event      payload");
+    for (uint16_t i = 0; i < snapshot.count; ++i) {
+        const TelemetryRecord& r = telemetryRecordAt(snapshot, i);
+        if (i > 0) epoch += telemetryRecordDeltaSec(r);
+        if (r.event == TELEMETRY_EVENT_TIME_GAP) continue;
+        telemetryFormatEntry(epoch, r, text, sizeof(text));
+        Serial.print("  ");
+        Serial.println(text);
+    }
+}
+
+// --- Memory Telemetry Functions ---
+MemorySample memorySample() {
+    MemorySample sample;
+    sample.freeHeap = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    sample.largestBlock = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+    sample.minFreeHeap = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+    sample.loopStackFree = loopTaskHandle ? uxTaskGetStackHighWaterMark(loopTaskHandle) : 0;
+    sample.networkStackFree = networkTaskHandle ? uxTaskGetStackHighWaterMark(networkTaskHandle) : 0;
+    return sample;
+}
+
+// Closes a before/after pair opened with memorySample() and reports trends as they appear.
+void memoryRecord(MemorySite site, const MemorySample& before) {
+    MemorySample after = memorySample();
+    portENTER_CRITICAL(&memoryTelemetryMux);
+    MemoryHistoryEntry& entry = memoryHistory[memoryHistoryNext];
+    entry.uptimeSec = (uint32_t)(esp_timer_get_time() / 1000000ULL);
+    entry.before = before;
+    entry.after = after;
+    entry.site = site;
+    memoryHistoryNext = (memoryHistoryNext + 1) % MEMORY_HISTORY_SAMPLES;
+    if (memoryHistoryCount < MEMORY_HISTORY_SAMPLES) memoryHistoryCount++;
+    memorySiteRecord(memorySiteStats[site], before, after);
+    portEXIT_CRITICAL(&memoryTelemetryMux);
+
+    float olderRatio, newerRatio, bytesPerHour;
+    uint8_t flags = memoryEvaluateTrends(&olderRatio, &newerRatio, &bytesPerHour);
+    portENTER_CRITICAL(&memoryTelemetryMux);
+    uint8_t raised = flags & ~memoryTrendFlags;
+    memoryTrendFlags = flags;
+    portEXIT_CRITICAL(&memoryTelemetryMux);
+    if (raised & MEMORY_TREND_FRAGMENTING) {
+        Serial.printf("MEM WARN: Heap fragmenting, largest block %.0f%% -> %.0f%% of free (%lu of %lu bytes).\n",
+                      olderRatio * 100.0f, newerRatio * 100.0f, (unsigned long)after.largestBlock, (unsigned long)after.freeHeap);
+    }
+    if (raised & MEMORY_TREND_LEAKING) {
+        Serial.printf("MEM WARN: Free heap shrinking by %.0f bytes/hour (min ever %lu).\n", -bytesPerHour, (unsigned long)after.minFreeHeap);
+    }
+    if (raised & MEMORY_TREND_LOW_STACK) {
+        Serial.printf("MEM WARN: Stack headroom low (loop %u, network %u bytes).\n", after.loopStackFree, after.networkStackFree);
+    }
+}
+
+// Copies the post-call samples of the history out under the lock; lib/MemoryTelemetry judges them
+// outside it.
+uint8_t memoryEvaluateTrends(float* olderRatio, float* newerRatio, float* bytesPerHour) {
+    MemoryTrendPoint points[MEMORY_HISTORY_SAMPLES]; // 576 bytes of stack
+    portENTER_CRITICAL(&memoryTelemetryMux);
+    uint8_t count = memoryHistoryCount;
+    uint8_t first = (memoryHistoryNext + MEMORY_HISTORY_SAMPLES - count) % MEMORY_HISTORY_SAMPLES;
+    MemorySample latest = memoryHistory[(memoryHistoryNext + MEMORY_HISTORY_SAMPLES - 1) % MEMORY_HISTORY_SAMPLES].after;
+    for (uint8_t i = 0; i < count; ++i) {
+        const MemoryHistoryEntry& e = memoryHistory[(first + i) % MEMORY_HISTORY_SAMPLES];
+        points[i] = { e.uptimeSec, e.after.freeHeap, e.after.largestBlock };
+    }
+    portEXIT_CRITICAL(&memoryTelemetryMux);
+
+    MemoryTrend trend = memoryTrendEvaluate(points, count, latest, MEMORY_TREND_CONFIG);
+    *olderRatio = trend.olderRatio;
+    *newerRatio = trend.newerRatio;
+    *bytesPerHour = trend.bytesPerHour;
+    return trend.flags;
+}
+
+void dumpMemoryTelemetry() {
+    MemorySample now = memorySample();
+    Serial.printf("Heap: free %lu, largest block %lu, min ever %lu | stack free: loop %u, network %u\n",
+                  (unsigned long)now.freeHeap, (unsigned long)now.largestBlock, (unsigned long)now.minFreeHeap,
+                  now.loopStackFree, now.networkStackFree);
+    for (int s = 0; s < MEMORY_SITE_COUNT; ++s) {
+        const MemorySiteStats& stats = memorySiteStats[s];
+        if (stats.calls == 0) continue;
+        Serial.printf("  %-7s calls %lu, avg heap delta %+ld, worst %+ld bytes\n", MEMORY_SITE_NAMES[s],
+                      (unsigned long)stats.calls, (long)memorySiteMeanDelta(stats), (long)stats.deltaWorst);
+    }
+    float olderRatio, newerRatio, bytesPerHour;
+    uint8_t flags = memoryEvaluateTrends(&olderRatio, &newerRatio, &bytesPerHour);
+    Serial.printf("Trend: largest/free %.2f -> %.2f, free heap %+.0f bytes/hour%s%s%s\n", olderRatio, newerRatio, bytesPerHour,
+                  (flags & MEMORY_TREND_FRAGMENTING) ? " [FRAGMENTING]" : "", (flags & MEMORY_TREND_LEAKING) ? " [LEAKING]" : "",
+                  (flags & MEMORY_TREND_LOW_STACK) ? " [LOW STACK]" : "");
+    Serial.println("  uptime_s site     free_before free_after largest  min_ever loop_stk net_stk");
+    uint8_t first = (memoryHistoryNext + MEMORY_HISTORY_SAMPLES - memoryHistoryCount) % MEMORY_HISTORY_SAMPLES;
+    for (uint8_t i = 0; i < memoryHistoryCount; ++i) {
+        MemoryHistoryEntry e;
+        portENTER_CRITICAL(&memoryTelemetryMux);
+        e = memoryHistory[(first + i) % MEMORY_HISTORY_SAMPLES];
+        portEXIT_CRITICAL(&memoryTelemetryMux);
+        Serial.printf("  %8lu %-8s %11lu %10lu %7lu %9lu %8u %7u\n", (unsigned long)e.uptimeSec, MEMORY_SITE_NAMES[e.site],
+                      (unsigned long)e.before.freeHeap, (unsigned long)e.after.freeHeap, (unsigned long)e.after.largestBlock,
+                      (unsigned long)e.after.minFreeHeap, e.after.loopStackFree, e.after.networkStackFree);
+    }
+}
+
+// --- Benchmark Functions ---
+// Open-Meteo shaped payload (hourly time + uv_index) covering the given number of days.
+String buildOpenMeteoBenchPayload(int days) {
+    String payload;
+    payload.reserve(days * 24 * 32 + 320);
+    payload = "{\"latitude\":52.52,\"longitude\":13.41,\"generationtime_ms\":0.04,\"utc_offset_seconds\":7200,"
+              "\"timezone\":\"Europe/Berlin\",\"timezone_abbreviation\":\"CEST\",\"elevation\":38.0,"
+              "\"hourly_units\":{\"time\":\"iso8601\",\"uv_index\":\"\"},\"hourly\":{\"time\":[";
+    char item[32];
+    for (int h = 0; h < days * 24; ++h) {
+        snprintf(item, sizeof(item), "%s\"2025-06-%02dT%02d:00\"", h ? "," : "", 10 + h / 24, h % 24);
+        payload += item;
+    }
+    payload += "],\"uv_index\":[";
+    for (int h = 0; h < days * 24; ++h) {
+        float uv = 8.0f * sinf(PI * ((h % 24) - 5) / 15.0f);
+        snprintf(item, sizeof(item), "%s%.2f", h ? "," : "", uv > 0.0f ? uv : 0.0f);
+        payload += item;
+    }
+    payload += "]}}";
+    return payload;
+}
+
+// One pass of each benchmarked hot path. runBenchmarks() times them on the device, the native bench
+// suite (test/test_bench) on the host against a stored baseline. Each returns a checksum that keeps
+// its results live.
+
+// Scheduler: every 15 min of a solstice, equinox and DST-change day, in both modes. The times are
+// generated as the pass goes (calculateNextUpdateTimeDetails() normalises them with mktime anyway).
+uint32_t benchSchedulerPass() {
+    static const int benchDates[][3] = { {2025, 6, 21}, {2025, 12, 21}, {2025, 3, 20}, {2025, 10, 26} };
+    uint32_t checksum = 0;
+    int i = 0;
+    for (const auto& date : benchDates) {
+        for (int q = 0; q < 96; ++q, ++i) {
+            struct tm t = {};
+            t.tm_year = date[0] - 1900; t.tm_mon = date[1] - 1; t.tm_mday = date[2];
+            t.tm_hour = q / 4; t.tm_min = (q % 4) * 15 + 1; t.tm_isdst = -1;
+            checksum += (uint32_t)calculateNextUpdateTimeDetails(t, (i & 1) ? UPDATES_PER_HOUR_NORMAL_MODE : UPDATES_PER_HOUR_LPM,
+                                                                 REFRESH_TARGET_MINUTE, i & 1).nextUpdateEpoch;
+        }
+    }
+    return checksum;
+}
+
+// Open-Meteo parse path: deserialize + hour matching + day analytics.
+uint32_t benchParsePass(const String& payload) {
+    float uv[HOURLY_FORECAST_COUNT];
+    int hours[HOURLY_FORECAST_COUNT];
+    DayForecast day;
+    JsonDocument doc;
+    deserializeJson(doc, payload);
+    uint32_t checksum = extractHourlyForecast(doc, 11, uv, hours);
+    checksum += extractDayForecast(doc, &day);
+    return checksum + hours[0] + day.uvQuarter[48] + day.peakHour;
+}
+
+// IP geolocation: same document shape and field reads as fetchLocationFromIp().
+uint32_t benchIpGeoPass() {
+    JsonDocument doc;
+    deserializeJson(doc, "{\"status\":\"success\",\"city\":\"Berlin\",\"lat\":52.5196,\"lon\":13.4069}");
+    if (doc["status"].isNull() || strcmp(doc["status"], "success") != 0) return 0;
+    const char* city = doc["city"];
+    return (uint32_t)(doc["lat"].as<float>() + doc["lon"].as<float>()) + (city ? strlen(city) : 0);
+}
+
+// Renderer: drawForecastGraph() into an off-screen sprite of the panel's size.
+void benchRenderPass(TFT_eSprite& frame) {
+    frame.fillSprite(TFT_BLACK);
+    drawForecastGraph(frame, 4);
+}
+
+// On-device timings of the hot paths, printed as one JSON line so runs of two builds can be diffed.
+// Runs on the UI loop (the renderer's core) with the CPU pinned to its maximum frequency.
+void runBenchmarks() {
+    #if CONFIG_PM_ENABLE
+    static esp_pm_lock_handle_t benchLock = NULL;
+    if (!benchLock) esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "bench", &benchLock);
+    if (benchLock) esp_pm_lock_acquire(benchLock);
+    #endif
+    Serial.println("BENCH: running...");
+
+    uint32_t checksum = 0; // Keeps results live
+    int64_t startUs = esp_timer_get_time();
+    for (int n = 0; n < BENCH_SCHEDULER_ITERATIONS; ++n) checksum += benchSchedulerPass();
+    float schedulerUs = (esp_timer_get_time() - startUs) / (float)(BENCH_SCHEDULER_ITERATIONS * BENCH_SCHEDULER_TIMES);
+
+    // Open-Meteo parse path on 1, 2 and 7 day payloads
+    const int parseDays[3] = { 1, 2, 7 };
+    float parseUs[3];
+    for (int d = 0; d < 3; ++d) {
+        String payload = buildOpenMeteoBenchPayload(parseDays[d]);
+        startUs = esp_timer_get_time();
+        for (int n = 0; n < BENCH_PARSE_ITERATIONS; ++n) checksum += benchParsePass(payload);
+        parseUs[d] = (esp_timer_get_time() - startUs) / (float)BENCH_PARSE_ITERATIONS;
+    }
+
+    startUs = esp_timer_get_time();
+    for (int n = 0; n < BENCH_PARSE_ITERATIONS; ++n) checksum += benchIpGeoPass();
+    float ipGeoUs = (esp_timer_get_time() - startUs) / (float)BENCH_PARSE_ITERATIONS;
+
+    // Event telemetry: one record write, in CPU cycles (leaves BENCH_TELEMETRY_EVENTS records in the log)
+    uint32_t startCycles = ESP.getCycleCount();
+    for (uint16_t n = 0; n < BENCH_TELEMETRY_EVENTS; ++n) telemetryLog(TELEMETRY_EVENT_BENCH, n);
+    float telemetryLogNs = (ESP.getCycleCount() - startCycles) * 1000.0f / ((float)getCpuFrequencyMhz() * BENCH_TELEMETRY_EVENTS);
+
+    // Renderer: drawForecastGraph() into the UI pages' sprite (the next page draw renders over it)
+    float renderUs = -1.0f;
+    displayBegin();
+    if (pageSpriteBegin()) {
+        startUs = esp_timer_get_time();
+        for (int n = 0; n < BENCH_RENDER_ITERATIONS; ++n) benchRenderPass(pageSprite);
+        renderUs = (esp_timer_get_time() - startUs) / (float)BENCH_RENDER_ITERATIONS;
+    }
+
+    #if CONFIG_PM_ENABLE
+    if (benchLock) esp_pm_lock_release(benchLock);
+    #endif
+    Serial.printf("{\"bench\":\"uv-monitor\",\"cpu_mhz\":%lu,\"scheduler_us\":%.2f,\"parse_1d_us\":%.1f,\"parse_2d_us\":%.1f,"
+                  "\"parse_7d_us\":%.1f,\"ipgeo_parse_us\":%.1f,\"telemetry_log_ns\":%.0f,\"render_us\":%.1f,\"checksum\":%lu}\n",
+                  (unsigned long)getCpuFrequencyMhz(), schedulerUs, parseUs[0], parseUs[1], parseUs[2], ipGeoUs, telemetryLogNs,
+                  renderUs, (unsigned long)checksum);
+}
+
+// Line-based serial console, checked once per loop() iteration. The dumps read state the network task
+// owns during a job, so input waits in the UART buffer until the job has reported back.
+void handleSerialCommands() {
+    static char line[32];
+    static uint8_t len = 0;
+    if (deviceState == STATE_FETCHING) return;
+    while (Serial.available() > 0) {
+        char c = (char)Serial.read();
+        if (c != '\n' && c != '\r') {
+            if (len < sizeof(line) - 1) line[len++] = c;
+            continue;
+        }
+        if (len == 0) continue;
+        line[len] = '\0';
+        len = 0;
+        if (strncmp(line, "energy", 6) == 0) {
+            dumpEnergyLog(atoi(line + 6));
+        } else if (strcmp(line, "drift") == 0) {
+            dumpSlotAccuracy();
+        } else if (strcmp(line, "cadence") == 0) {
+            dumpAdaptiveCadence();
+        } else if (strcmp(line, "boot") == 0) {
+            dumpBootTiming();
+        } else if (strcmp(line, "bench") == 0) {
+            runBenchmarks();
+        } else if (strcmp(line, "heap") == 0) {
+            dumpMemoryTelemetry();
+        } else if (strcmp(line, "tlm") == 0) {
+            dumpTelemetryLog();
+        } else if (strcmp(line, "dose") == 0) {
+            dumpUvDose();
+        } else if (strcmp(line, "peak") == 0) {
+            dumpDayForecast();
+        } else if (strcmp(line, "loc") == 0) {
+            dumpLocationResolver();
+        } else if (strcmp(line, "disp") == 0) {
+            dumpDisplayPower();
+        } else if (strncmp(line, "pages", 5) == 0) {
+            if (line[5] == ' ') pageCacheSetBudget(strtoul(line + 6, nullptr, 10));
+            dumpPageCache();
+        } else {
+            Serial.printf("Unknown command: %s (try: energy [N], drift, cadence, boot, bench, heap, tlm, dose, peak, loc, disp, pages [bytes])\n", line);
+        }
+    }
+}
+
 void enterDeepSleep(uint64_t duration_us, bool alsoEnableButtonWake) {
+    energyPhaseBegin(ENERGY_PHASE_SLEEP_ENTRY);
+    uvDoseTick(); // Picks up a forecast fetched this wake, so the sleep is integrated under it
     savePersistentState();
+    saveForecastState(); // No network job is in flight once the loop (or setup()) gets here
     turnScreenOff();
-    Serial.printf("Entering deep sleep for %llu us (approx %.2f minutes).\n", duration_us, (double)duration_us / 1000000.0 / 60.0);
-    esp_sleep_enable_timer_wakeup(duration_us);
+    displayPowerHoldForDeepSleep();
+    Serial.printf("Entering deep sleep for %llu us (approx %.2f minutes).\n", (unsigned long long)duration_us, (double)duration_us / 1000000.0 / 60.0);
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_GPIO); // Light-sleep button wake only; ext0 covers deep sleep
+    // Scale by the drift factor; the sleep is still recorded as aimed at now + duration_us.
+    uint64_t programmedUs = (uint64_t)((double)duration_us * rtc_sleepDriftCorrection);
+    struct timeval nowTv;
+    gettimeofday(&nowTv, nullptr);
+    rtc_sleepStartEpochUs = (int64_t)nowTv.tv_sec * 1000000LL + nowTv.tv_usec;
+    rtc_programmedSleepUs = programmedUs;
+    rtc_targetWakeEpoch = (uint32_t)((rtc_sleepStartEpochUs + (int64_t)duration_us) / 1000000LL);
+    rtc_sleepSlotIntervalSec = (60 / adaptiveUpdatesPerHour(UPDATES_PER_HOUR_LPM)) * 60;
+    rtc_sleepStartVerified = ntpSyncedThisBoot;
+    if (nowTv.tv_sec > 1600000000) { // Wall clock known
+        SlotAccuracyDay& day = slotAccuracyOn(nowTv.tv_sec);
+        day.cycles++;
+        day.awakeMs += (uint32_t)(esp_timer_get_time() / 1000);
+    }
+    esp_sleep_enable_timer_wakeup(programmedUs);
     if (alsoEnableButtonWake) {
         Serial.println("Enabling GPIO0 (BUTTON_INFO_PIN) for wake-up from deep sleep (falling edge).");
         esp_sleep_enable_ext0_wakeup(GPIO_NUM_0, 0);
     }
+    energyPhaseEnd(ENERGY_PHASE_SLEEP_ENTRY);
+    bootProfileFinish(true); // No-op unless sleeping straight from setup()
+    energyCycleCommit((uint32_t)(duration_us / 1000000ULL));
+    telemetryLog(TELEMETRY_EVENT_SLEEP, telemetrySaturate((int64_t)(duration_us / 60000000ULL)));
     Serial.flush();
     esp_deep_sleep_start();
 }
@@ -416,37 +1856,24 @@ void initializeForecastData(bool updateRTC) {
     }
 }
 
-void performDataFetchSequence(bool silent) {
+// lookupIfDue: setup()'s inline fetches and the pin toggle, which look up the IP location first when
+// one is due; scheduled fetches leave that to TIMER_IP_LOOKUP.
+void performDataFetchSequence(bool silent, bool lookupIfDue) {
+    MemorySample memoryBefore = memorySample();
+    energyCycleBegin((uint8_t)ESP_SLEEP_WAKEUP_UNDEFINED, esp_timer_get_time()); // No-op inside an LPM wake cycle
     if (!silent) displayMessage("Connecting to WiFi...", "", TFT_YELLOW, true);
     connectToWiFi(silent);
 
     if (WiFi.status() == WL_CONNECTED) {
-        if (useGpsFromSecrets) {
-            deviceLatitude = MY_LATITUDE; deviceLongitude = MY_LONGITUDE;
-            locationDisplayStr = "Secrets GPS";
-            if (!silent) Serial.println("Using GPS coordinates from secrets.h");
-        } else {
-            if (!silent) displayMessage("Fetching IP Location...", "", TFT_SKYBLUE, true);
-            if (!fetchLocationFromIp(silent)) {
-                useGpsFromSecrets = true; 
-                deviceLatitude = MY_LATITUDE; deviceLongitude = MY_LONGITUDE;
-                locationDisplayStr = "IP Fail>Secrets";
-                if (!silent) Serial.println("IP Geolocation failed. Falling back to secrets.h GPS.");
-            }
-        }
-        String currentStatusForDisplay = locationDisplayStr;
-        if (currentStatusForDisplay.length() > 18) currentStatusForDisplay = currentStatusForDisplay.substring(0,15) + "...";
-
-        if (!silent) displayMessage("Fetching UV data...", currentStatusForDisplay, TFT_CYAN, true);
-        if (fetchUVData(silent)) { 
-            if (!isLowPowerModeActive) lastDataFetchAttemptMs = millis(); 
-        } else {
+        if (lookupIfDue) locationLookupIfDue(silent);
+        resolveLocation(true, silent);
+        if (!silent) displayMessage("Fetching UV data...", locationDisplayStr, TFT_CYAN, true); // Fitted when drawn
+        if (!fetchUVData(silent)) {
             if (!silent) Serial.println("UV Data fetch failed (API did not return parsable data for any slot).");
         }
     } else { 
-        locationDisplayStr = "Offline>Secrets"; 
-        useGpsFromSecrets = true; 
-        deviceLatitude = MY_LATITUDE; deviceLongitude = MY_LONGITUDE;
+        resolveLocation(false, silent);
+        dayForecast.dayOfYear = -1;
         struct tm timeinfo_offline;
         if (getLocalTime(&timeinfo_offline, 2000)) { 
              for (int i = 0; i < HOURLY_FORECAST_COUNT; ++i) {
@@ -466,40 +1893,66 @@ void performDataFetchSequence(bool silent) {
         lastUpdateTimeStr = "Offline";
         strncpy(rtc_lastUpdateTimeStr_char, "Offline", sizeof(rtc_lastUpdateTimeStr_char)-1);
         rtc_lastUpdateTimeStr_char[sizeof(rtc_lastUpdateTimeStr_char)-1] = '\0';
+        rtc_lastFetchFromApi = false;
         
         dataJustFetched = true; 
         if (!silent) Serial.println("WiFi not connected. Displaying projected hours with 0 UV or placeholders.");
     }
     force_display_update = true;
+    recordBootToFetchTime();
     // Save state if we got new IP, new UV data, or if GPS preference changed.
-    // fetchUVData sets rtc_hasValidData, performDataFetchSequence calls savePersistentState if WiFi was connected.
+    // fetchUVData sets rtc_hasValidData, performDataFetchSequence calls saveForecastState if WiFi was connected.
     // If offline, we also want to save the projected data and "Offline" status.
-    savePersistentState(); 
+    saveForecastState();
+    publishForecastSnapshot();
+    memoryRecord(MEMORY_SITE_FETCH, memoryBefore);
 }
 
 // --- Setup ---
 void setup() {
+    // Boot sequencer: on wakes that fetch, association is kicked off first and proceeds in the WiFi
+    // driver while the serial port, display and persisted state are brought up below.
+    esp_sleep_wakeup_cause_t wakeup_reason = esp_sleep_get_wakeup_cause();
+    telemetryClockBegin();
+    bootPipelined = PIPELINED_BOOT && (wakeup_reason == ESP_SLEEP_WAKEUP_UNDEFINED || wakeup_reason == ESP_SLEEP_WAKEUP_TIMER);
+    WiFi.onEvent(onWiFiStaConnected, ARDUINO_EVENT_WIFI_STA_CONNECTED);
+    sntp_set_time_sync_notification_cb(onNtpTimeSynced);
+    if (bootPipelined) beginEarlyWiFiAssociation();
+    bootProfileMark(BOOT_STEP_WIFI_KICK);
+
     Serial.begin(115200);
-    while (!Serial && millis() < 2000); 
+    if (wakeup_reason != ESP_SLEEP_WAKEUP_TIMER) while (!Serial && millis() < 2000); // Nobody attaches for a silent wake
     Serial.println("\nUV Index Monitor Starting Up...");
+    bootProfileMark(BOOT_STEP_SERIAL);
 
     EEPROM.begin(EEPROM_SIZE);
+    bootProfileMark(BOOT_STEP_EEPROM);
 
-    pinMode(BUTTON_INFO_PIN, INPUT_PULLUP);
-    pinMode(BUTTON_LP_TOGGLE_PIN, INPUT_PULLUP);
     pinMode(TFT_BL_PIN, OUTPUT);
+    configureIdlePowerManagement(); // Also sets up the button pins via buttonEngineBegin()
+    bootProfileMark(BOOT_STEP_PINS);
 
     printWakeupReason();
-    esp_sleep_wakeup_cause_t wakeup_reason = esp_sleep_get_wakeup_cause();
+    energyCycleBegin((uint8_t)wakeup_reason, 0);
+    energyPhaseAdd(ENERGY_PHASE_BOOT, esp_timer_get_time());
+    bootProfileMark(BOOT_STEP_WAKE_LOG);
+    displayPowerBegin(wakeup_reason);
+    if (wakeup_reason == ESP_SLEEP_WAKEUP_EXT0) displayPowerWake(); // The settle overlaps the restore below
     
     loadPersistentState(); 
+    telemetryLog(TELEMETRY_EVENT_WAKE, (uint16_t)wakeup_reason); // After the load: a cold boot resets the log
+    if (wakeup_reason == ESP_SLEEP_WAKEUP_TIMER) { // A button wake cut the sleep short by an unknown amount: not counted
+        locationRetryElapse(rtc_location, (uint32_t)(rtc_programmedSleepUs / 1000000ULL), locationNow());
+    }
+    bootProfileMark(BOOT_STEP_STATE_LOAD);
+    if (rtc_hasValidData) uvDoseLoadForecast(uvDose, hourlyUV, forecastHours); // Integrates the sleep under the forecast it had
+    uvDoseTick();
+    bootProfileMark(BOOT_STEP_DOSE);
     #if DEBUG_PERSISTENCE
     Serial.printf("SETUP: After loadPersistentState(), isLowPowerModeActive = %s\n", isLowPowerModeActive ? "true" : "false");
     #endif
 
-    tft.init();
-    tft.setRotation(1); 
-    tft.setTextDatum(MC_DATUM); 
+    if (!LAZY_DISPLAY_INIT) displayBegin(); // Otherwise the first turnScreenOn()/draw brings it up
 
     bool performInitialActionsOnPowerOn = (wakeup_reason == ESP_SLEEP_WAKEUP_UNDEFINED); 
 
@@ -509,7 +1962,14 @@ void setup() {
         #endif
         turnScreenOn();
         tft.fillScreen(TFT_BLACK);
-        performDataFetchSequence(false); 
+        if (rtc_hasValidData) { // Cached frame (soft reset) stays up while association proceeds
+            publishForecastSnapshot();
+            displayInfo();
+            bootCachedFrameHeld = true;
+        }
+        performDataFetchSequence(false, true);
+        bootCachedFrameHeld = false;
+        bootProfileMark(BOOT_STEP_FETCH);
     }
 
     // Initialize schedulers and determine next actions
@@ -524,14 +1984,13 @@ void setup() {
             enterDeepSleep(15 * 60 * 1000000ULL, true);
         } else if (isLowPowerModeActive && wakeup_reason == ESP_SLEEP_WAKEUP_EXT0) {
             // Button wake, screen is on, but no time for proper LPM scheduling. Will timeout.
-            temporaryScreenWakeupActive = true; // Already set by printWakeupReason logic if ext0
-            screenActiveUntilMs = millis() + SCREEN_ON_DURATION_LPM_MS;
+            temporaryScreenWakeupActive = true; // Screen timeout is armed by deviceStateBegin()
              if (rtc_hasValidData) force_display_update = true; 
             else displayMessage("LPM: No data", "Time Error", TFT_YELLOW, true);
         }
     } else { // Time obtained successfully
         if (isLowPowerModeActive) {
-            NextUpdateTimeDetails lpm_details = calculateNextUpdateTimeDetails(timeinfo_setup, UPDATES_PER_HOUR_LPM, REFRESH_TARGET_MINUTE, false);
+            NextUpdateTimeDetails lpm_details = calculateNextUpdateTimeDetails(timeinfo_setup, adaptiveUpdatesPerHour(UPDATES_PER_HOUR_LPM), REFRESH_TARGET_MINUTE, false);
             nextUpdateEpochLpm = lpm_details.nextUpdateEpoch;
 
             if (wakeup_reason == ESP_SLEEP_WAKEUP_TIMER) { 
@@ -540,10 +1999,24 @@ void setup() {
                 #endif
                 temporaryScreenWakeupActive = false;
                 turnScreenOff(); 
-                performDataFetchSequence(true); 
+                performDataFetchSequence(true, true);
+                bootProfileMark(BOOT_STEP_FETCH);
+                waitForNtpSync(NTP_SYNC_WAIT_MS);
+                updateSleepDriftCalibration(wakeup_reason);
+                time_t fetchDoneEpoch = time(nullptr);
+                if (!rtc_lastFetchFromApi && fetchDoneEpoch > 1600000000) slotAccuracyOn(fetchDoneEpoch).missedSlots++; // Woke, but the slot got no data
                 // After fetch, get fresh time and recalculate for next sleep
                 if(getLocalTime(&timeinfo_setup, 5000)){
-                    lpm_details = calculateNextUpdateTimeDetails(timeinfo_setup, UPDATES_PER_HOUR_LPM, REFRESH_TARGET_MINUTE, false);
+                    lpm_details = calculateNextUpdateTimeDetails(timeinfo_setup, adaptiveUpdatesPerHour(UPDATES_PER_HOUR_LPM), REFRESH_TARGET_MINUTE, false);
+                    bootProfileMark(BOOT_STEP_SCHEDULE);
+                    time_t nowEpochLpm = mktime(&timeinfo_setup);
+                    if (lpm_details.nextUpdateEpoch - nowEpochLpm < (time_t)EARLY_WAKE_GUARD_SEC) {
+                        // Woke early for this slot: it was just served, so aim at the one after instead of a short extra cycle.
+                        struct tm slotInfo;
+                        localtime_r(&lpm_details.nextUpdateEpoch, &slotInfo);
+                        lpm_details = calculateNextUpdateTimeDetails(slotInfo, adaptiveUpdatesPerHour(UPDATES_PER_HOUR_LPM), REFRESH_TARGET_MINUTE, false);
+                        lpm_details.sleepDurationUs = (uint64_t)(lpm_details.nextUpdateEpoch - nowEpochLpm) * 1000000ULL;
+                    }
                     nextUpdateEpochLpm = lpm_details.nextUpdateEpoch;
                 } else { // Time failed after fetch, use old details for sleep duration
                     Serial.println("LPM Timer Wake ERR: Failed to get time post-fetch. Using pre-fetch sleep calc.");
@@ -554,7 +2027,6 @@ void setup() {
                 Serial.println("LPM: Button Wake-up (GPIO 0). Temporary screen on.");
                 #endif
                 temporaryScreenWakeupActive = true;
-                screenActiveUntilMs = millis() + SCREEN_ON_DURATION_LPM_MS;
                 turnScreenOn();
                 tft.fillScreen(TFT_BLACK);
                 if (rtc_hasValidData) force_display_update = true; 
@@ -576,230 +2048,574 @@ void setup() {
         } else { // Normal Mode
             temporaryScreenWakeupActive = false; 
             turnScreenOn(); 
-            NextUpdateTimeDetails normal_details = calculateNextUpdateTimeDetails(timeinfo_setup, UPDATES_PER_HOUR_NORMAL_MODE, REFRESH_TARGET_MINUTE, true);
+            NextUpdateTimeDetails normal_details = calculateNextUpdateTimeDetails(timeinfo_setup, adaptiveUpdatesPerHour(UPDATES_PER_HOUR_NORMAL_MODE), REFRESH_TARGET_MINUTE, true);
             if (normal_details.updateNow) {
                 #if DEBUG_SCHEDULING
                 Serial.println("Normal Mode (Setup): Initial schedule check indicates UPDATE NOW.");
                 #endif
                 if (!performInitialActionsOnPowerOn) { 
-                    performDataFetchSequence(false);
+                    performDataFetchSequence(false, true);
+                    bootProfileMark(BOOT_STEP_FETCH);
                 }
             }
             nextUpdateEpochNormalMode = normal_details.nextUpdateEpoch; 
             if (force_display_update == false && (rtc_hasValidData || performInitialActionsOnPowerOn) ) force_display_update = true;
         }
     }
+    bootFetchTimingPending = false; // Later fetches come from loop() and are not part of the boot
+    bootProfileMark(BOOT_STEP_SCHEDULE);
+    deviceStateBegin();
+    networkTaskBegin(); // After the last inline fetch: the snapshot producer moves to the network task
+    if (wifiEarlyAssocPending) { // Nothing fetched after all (e.g. time error), don't leave the radio on
+        wifiEarlyAssocPending = false;
+        if (isLowPowerModeActive) WiFi.disconnect(true, false);
+    }
+    bootProfileFinish(false);
+}
+
+
+// --- Idle / Light Sleep Functions ---
+void configureIdlePowerManagement() {
+    loopTaskHandle = xTaskGetCurrentTaskHandle();
+    buttonEngineBegin(); // Arms the buttons as wake-enabled GPIO interrupts
+    esp_sleep_enable_gpio_wakeup();
+
+    #if CONFIG_PM_ENABLE
+    esp_pm_config_esp32_t pmConfig = {};
+    pmConfig.max_freq_mhz = PM_MAX_CPU_FREQ_MHZ;
+    pmConfig.min_freq_mhz = PM_MIN_CPU_FREQ_MHZ;
+    pmConfig.light_sleep_enable = true; // Needs tickless idle; WiFi stays associated via modem sleep
+    esp_err_t err = esp_pm_configure(&pmConfig);
+    if (err != ESP_OK) { // No tickless idle in this SDK build: keep DFS only
+        pmConfig.light_sleep_enable = false;
+        err = esp_pm_configure(&pmConfig);
+    }
+    autoLightSleepEnabled = (err == ESP_OK) && pmConfig.light_sleep_enable;
+    #if DEBUG_LPM
+    Serial.printf("PM: DFS %d-%d MHz, auto light sleep: %s (%s)\n", PM_MIN_CPU_FREQ_MHZ, PM_MAX_CPU_FREQ_MHZ,
+                  autoLightSleepEnabled ? "ON" : "OFF", esp_err_to_name(err));
+    #endif
+    #endif
+}
+
+// Milliseconds until the next thing loop() has to act on without a button press.
+uint32_t msUntilNextScheduledEvent() {
+    if (statusMessages.pending() || forecastSnapshots.pending()) return 0;
+    if (deviceState == STATE_FETCHING) return networkJobDone ? 0 : IDLE_MAX_BLOCK_MS; // Deferred work waits for the job
+    if (force_display_update || dataJustFetched || wheelFiredMask) return 0;
+    uint32_t waitMs = timerWheelMsUntilNext();
+    return (waitMs < IDLE_MAX_BLOCK_MS) ? waitMs : IDLE_MAX_BLOCK_MS;
+}
+
+// Blocks the loop task until the next deadline or a button event instead of polling on a fixed delay,
+// letting the idle task drop into automatic light sleep in between.
+void idleUntilNextEvent() {
+    uint32_t waitMs = msUntilNextScheduledEvent();
+    if (waitMs == 0 || uxQueueMessagesWaiting(buttonEventQueue) > 0) return;
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(waitMs));
+}
+
+// --- Timer Wheel Functions ---
+uint32_t wheelNowTick() {
+    return (uint32_t)(esp_timer_get_time() / 1000000LL);
+}
+
+void timerWheelInit() {
+    memset(wheelSlotHead, -1, sizeof(wheelSlotHead));
+    for (int i = 0; i < TIMER_COUNT; ++i) wheelTimers[i].level = -1;
+    wheelTick = wheelNowTick();
+    wheelFiredMask = 0;
+}
+
+void wheelLink(uint8_t id) {
+    WheelTimer& t = wheelTimers[id];
+    uint32_t delta = t.expiryTick - wheelTick;
+    int8_t level = 0;
+    while (level < WHEEL_LEVELS - 1 && delta >= (1UL << (WHEEL_SLOT_BITS * (level + 1)))) level++;
+    t.level = level;
+    t.slot = (t.expiryTick >> (WHEEL_SLOT_BITS * level)) & (WHEEL_SLOTS - 1);
+    t.prev = -1;
+    t.next = wheelSlotHead[level][t.slot];
+    if (t.next >= 0) wheelTimers[t.next].prev = id;
+    wheelSlotHead[level][t.slot] = id;
+}
+
+void wheelUnlink(uint8_t id) {
+    WheelTimer& t = wheelTimers[id];
+    if (t.level < 0) return;
+    if (t.prev >= 0) wheelTimers[t.prev].next = t.next;
+    else wheelSlotHead[t.level][t.slot] = t.next;
+    if (t.next >= 0) wheelTimers[t.next].prev = t.prev;
+    t.level = -1;
+}
+
+// Re-arming an armed timer moves it; a zero delay fires on the next processed tick.
+void timerWheelSchedule(WheelTimerId id, uint32_t delayMs) {
+    wheelUnlink(id);
+    wheelFiredMask &= ~(1 << id);
+    uint32_t expiry = wheelNowTick() + (delayMs + 999) / 1000;
+    if ((int32_t)(expiry - wheelTick) <= 0) expiry = wheelTick + 1;
+    wheelTimers[id].expiryTick = expiry;
+    wheelLink(id);
+}
+
+void timerWheelCancel(WheelTimerId id) {
+    wheelUnlink(id);
+    wheelFiredMask &= ~(1 << id);
+}
+
+bool timerWheelArmed(WheelTimerId id) {
+    return wheelTimers[id].level >= 0;
+}
+
+uint32_t timerWheelRemainingMs(WheelTimerId id) {
+    if (!timerWheelArmed(id)) return UINT32_MAX;
+    int64_t remainingUs = (int64_t)wheelTimers[id].expiryTick * 1000000LL - esp_timer_get_time();
+    return (remainingUs > 0) ? (uint32_t)((remainingUs + 999) / 1000) : 0;
+}
+
+uint32_t timerWheelMsUntilNext() {
+    uint32_t nearest = UINT32_MAX;
+    for (int i = 0; i < TIMER_COUNT; ++i) {
+        uint32_t remaining = timerWheelRemainingMs((WheelTimerId)i);
+        if (remaining < nearest) nearest = remaining;
+    }
+    return nearest;
+}
+
+// Processes every tick that elapsed since the last call. Higher levels cascade first so a timer
+// landing in the current lower-level slot is cascaded again in the same tick.
+void timerWheelAdvance() {
+    uint32_t nowTick = wheelNowTick();
+    while ((int32_t)(nowTick - wheelTick) > 0) {
+        wheelTick++;
+        for (int level = WHEEL_LEVELS - 1; level >= 1; --level) {
+            if (wheelTick & ((1UL << (WHEEL_SLOT_BITS * level)) - 1)) continue;
+            uint8_t slot = (wheelTick >> (WHEEL_SLOT_BITS * level)) & (WHEEL_SLOTS - 1);
+            int8_t id = wheelSlotHead[level][slot];
+            wheelSlotHead[level][slot] = -1;
+            while (id >= 0) {
+                int8_t next = wheelTimers[id].next;
+                wheelLink(id);
+                id = next;
+            }
+        }
+        uint8_t slot = wheelTick & (WHEEL_SLOTS - 1);
+        int8_t id = wheelSlotHead[0][slot];
+        wheelSlotHead[0][slot] = -1;
+        while (id >= 0) {
+            int8_t next = wheelTimers[id].next;
+            wheelTimers[id].level = -1;
+            wheelFiredMask |= 1 << id;
+            id = next;
+        }
+    }
+}
+
+// --- Device State Machine Functions ---
+void setDeviceState(DeviceState next) {
+    if (next == deviceState) return;
+    #if DEBUG_SCHEDULING || DEBUG_LPM
+    Serial.printf("STATE: %s -> %s\n", DEVICE_STATE_NAMES[deviceState], DEVICE_STATE_NAMES[next]);
+    #endif
+    deviceState = next;
+}
+
+// Converts a slot epoch into a wheel deadline; one time() read, no localtime.
+void armFetchTimer(time_t nextEpoch) {
+    if (nextEpoch == 0) {
+        timerWheelSchedule(TIMER_FETCH, SCHEDULER_RETRY_MS); // Scheduler not ready, retry for time
+        return;
+    }
+    time_t nowEpoch = time(nullptr);
+    timerWheelSchedule(TIMER_FETCH, (nextEpoch > nowEpoch) ? (uint32_t)(nextEpoch - nowEpoch) * 1000UL : 0);
+}
+
+// The one place loop()-side code reads local time: computes the next slot for the current mode
+// and arms TIMER_FETCH for it.
+NextUpdateTimeDetails scheduleNextFetch(bool isNormalModeCheck) {
+    unsigned long& nextEpoch = isLowPowerModeActive ? nextUpdateEpochLpm : nextUpdateEpochNormalMode;
+    NextUpdateTimeDetails details = { 15 * 60 * 1000000ULL, 0, false };
+    struct tm nowInfo;
+    if (!getLocalTime(&nowInfo, 5000)) {
+        Serial.println("SCHED ERR: Failed to get time for rescheduling!");
+        nextEpoch = 0;
+        armFetchTimer(0);
+        return details;
+    }
+    byte updatesPerHour = adaptiveUpdatesPerHour(isLowPowerModeActive ? UPDATES_PER_HOUR_LPM : UPDATES_PER_HOUR_NORMAL_MODE);
+    details = calculateNextUpdateTimeDetails(nowInfo, updatesPerHour, REFRESH_TARGET_MINUTE, isNormalModeCheck);
+    nextEpoch = details.nextUpdateEpoch;
+    armFetchTimer(details.nextUpdateEpoch); // Always the next slot: a due one (updateNow) is the caller's to run
+    return details;
+}
+
+void extendLpmScreenOn() {
+    timerWheelSchedule(TIMER_SCREEN_TIMEOUT, SCREEN_ON_DURATION_LPM_MS);
+    timerWheelSchedule(TIMER_SCREEN_IDLE, SCREEN_ON_DURATION_LPM_MS - LPM_SCREEN_IDLE_LEAD_MS);
+    displayPowerIdle(false);
+}
+
+// Normal mode: NormalIdle while the link is up, Offline with a reconnect deadline otherwise.
+void settleNormalModeState() {
+    if (WiFi.status() == WL_CONNECTED) {
+        timerWheelCancel(TIMER_RECONNECT);
+        setDeviceState(STATE_NORMAL_IDLE);
+        return;
+    }
+    if (!timerWheelArmed(TIMER_RECONNECT)) timerWheelSchedule(TIMER_RECONNECT, WIFI_RECONNECT_INTERVAL_MS);
+    setDeviceState(STATE_OFFLINE);
+}
+
+// Hands a fetch to the network task; the state machine waits in Fetching until it reports back.
+// rescheduleAfter computes the next slot for the (then current) mode once the fetch is done.
+void runFetch(bool silent, bool rescheduleAfter, bool toggleLocation) {
+    if (deviceState == STATE_FETCHING) return;
+    fetchResumeState = deviceState;
+    fetchRescheduleAfter = rescheduleAfter;
+    if (postNetworkJob(NETWORK_JOB_FETCH, silent, toggleLocation)) setDeviceState(STATE_FETCHING);
+}
+
+// Sleeps until the armed fetch deadline (no wall-clock read needed), or the next slot if none is armed.
+void enterLpmSleep() {
+    setDeviceState(STATE_LPM_SLEEPING);
+    temporaryScreenWakeupActive = false;
+    uint64_t sleepDurationUs;
+    if (nextUpdateEpochLpm != 0 && timerWheelArmed(TIMER_FETCH)) {
+        sleepDurationUs = (uint64_t)timerWheelRemainingMs(TIMER_FETCH) * 1000ULL;
+    } else {
+        #if DEBUG_SCHEDULING
+        Serial.println("LPM Sleep: Recalculating next sleep slot.");
+        #endif
+        sleepDurationUs = scheduleNextFetch(false).sleepDurationUs; // 15 min when time is unavailable
+    }
+    if (sleepDurationUs < 1000000ULL) sleepDurationUs = 1000000ULL; // Slot is due: wake right away and fetch
+    enterDeepSleep(sleepDurationUs, true);
+}
+
+// Entry state once setup() has dealt with the wake cause. Timer wakes and LPM entry never get here.
+void deviceStateBegin() {
+    timerWheelInit();
+    publishForecastSnapshot(); // RTC-restored data, in case setup() did not fetch
+    timerWheelSchedule(TIMER_DOSE_TICK, UV_DOSE_TICK_MS);
+    if (QUARTER_HOUR_FORECAST) timerWheelSchedule(TIMER_QUARTER_REDRAW, msUntilNextQuarterHour());
+    armLocationLookup();
+    if (isLowPowerModeActive) {
+        if (!temporaryScreenWakeupActive) {
+            setDeviceState(STATE_LPM_SLEEPING); // Handled on the first loop() pass
+            return;
+        }
+        setDeviceState(STATE_LPM_SCREEN_ON);
+        extendLpmScreenOn();
+        armFetchTimer(nextUpdateEpochLpm);
+    } else {
+        armFetchTimer(nextUpdateEpochNormalMode);
+        settleNormalModeState();
+    }
 }
 
+void onNormalFetchDue() {
+    if (nextUpdateEpochNormalMode == 0) { // Scheduler was not ready (no time at boot), try again
+        if (scheduleNextFetch(true).updateNow) runFetch(false, false);
+        return;
+    }
+    #if DEBUG_SCHEDULING
+    Serial.println("Normal Mode: Scheduled update time reached.");
+    #endif
+    runFetch(false, true);
+}
 
-// --- Main Loop ---
-void loop() {
-    handle_buttons(); 
+// Normal mode, link up: the lookup is a job of its own; the next fetch picks up its result.
+void onLocationLookupDue() {
+    fetchResumeState = deviceState;
+    fetchRescheduleAfter = false;
+    if (postNetworkJob(NETWORK_JOB_IP_LOOKUP, true)) setDeviceState(STATE_FETCHING);
+}
+
+void onReconnectDue() {
+    fetchResumeState = STATE_OFFLINE;
+    fetchRescheduleAfter = false;
+    if (postNetworkJob(NETWORK_JOB_RECONNECT, false)) setDeviceState(STATE_FETCHING);
+}
 
+// Runs on the UI loop once the network task has finished a job.
+void onNetworkJobDone() {
+    networkJobDone = false;
+    armLocationLookup();
+    if (pendingNetworkJob == NETWORK_JOB_RECONNECT) {
+        if (WiFi.status() != WL_CONNECTED) {
+            setDeviceState(STATE_OFFLINE);
+            timerWheelSchedule(TIMER_RECONNECT, WIFI_RECONNECT_INTERVAL_MS);
+            return;
+        }
+        Serial.println("Normal Mode: WiFi reconnected. Will fetch at next scheduled time or if initial fetch needed.");
+        settleNormalModeState();
+        if (fetchOverdue) {
+            Serial.println("Normal Mode: WiFi reconnected and update is due/overdue. Fetching now.");
+            fetchOverdue = false;
+            runFetch(false, true);
+        } else if (nextUpdateEpochNormalMode == 0) {
+            onNormalFetchDue();
+        }
+        return;
+    }
     if (isLowPowerModeActive) {
-        if (temporaryScreenWakeupActive) {
-            struct tm timeinfo_lpm_loop;
-            if (getLocalTime(&timeinfo_lpm_loop, 1000)) {
-                time_t nowEpoch_lpm_loop = mktime(&timeinfo_lpm_loop);
-
-                // Check for scheduled update while screen is on
-                if (nextUpdateEpochLpm != 0 && nowEpoch_lpm_loop >= nextUpdateEpochLpm) {
-                    #if DEBUG_SCHEDULING || DEBUG_LPM
-                    Serial.println("LPM (Screen On): Scheduled update time reached.");
-                    #endif
-                    performDataFetchSequence(true); // Silent fetch
-
-                    // Reschedule next LPM update
-                    if (getLocalTime(&timeinfo_lpm_loop, 5000)) { // Get fresh time
-                        NextUpdateTimeDetails details_reschedule_lpm = calculateNextUpdateTimeDetails(timeinfo_lpm_loop, UPDATES_PER_HOUR_LPM, REFRESH_TARGET_MINUTE, false);
-                        nextUpdateEpochLpm = details_reschedule_lpm.nextUpdateEpoch;
-                    } else {
-                        Serial.println("LPM (Screen On) ERR: Failed to get time for rescheduling LPM update!");
-                        nextUpdateEpochLpm = nowEpoch_lpm_loop + (((UPDATES_PER_HOUR_LPM > 0) ? (60 / UPDATES_PER_HOUR_LPM) : 60) * 60); // Fallback
-                    }
-                    screenActiveUntilMs = millis() + SCREEN_ON_DURATION_LPM_MS; // Reset screen on time
-                    // dataJustFetched is true from performDataFetchSequence, will trigger display update
-                }
-            } // else: time failed, can't check schedule, will rely on screen timeout
+        setDeviceState(fetchResumeState);
+        if (temporaryScreenWakeupActive) extendLpmScreenOn();
+    } else {
+        settleNormalModeState();
+    }
+    if (fetchRescheduleAfter) scheduleNextFetch(false); // The slot just served must not come out as due again
+}
 
-            // Check for screen timeout
-            if (millis() >= screenActiveUntilMs) {
+// Dispatches fired deadlines to the current state. Each deadline is handled by exactly one state.
+void runStateMachine() {
+    timerWheelAdvance();
+    if (deviceState == STATE_FETCHING) {
+        if (!networkJobDone) return; // Fired deadlines stay pending until the job reports back
+        onNetworkJobDone();
+        if (deviceState == STATE_FETCHING) return; // Chained another job
+    }
+    uint8_t fired = wheelFiredMask;
+    wheelFiredMask = 0;
+    if (fired & (1 << TIMER_DOSE_TICK)) { // Any state
+        uvDoseTick();
+        timerWheelSchedule(TIMER_DOSE_TICK, UV_DOSE_TICK_MS);
+    }
+    if (fired & (1 << TIMER_QUARTER_REDRAW)) { // Advance the "now" bar from local data
+        force_display_update = true;
+        timerWheelSchedule(TIMER_QUARTER_REDRAW, msUntilNextQuarterHour());
+    }
+    switch (deviceState) {
+        case STATE_NORMAL_IDLE:
+            if (WiFi.status() != WL_CONNECTED) { // Link dropped between fetches
+                settleNormalModeState();
+                if (fired & (1 << TIMER_FETCH)) fetchOverdue = true;
+                break;
+            }
+            if (fired & (1 << TIMER_FETCH)) onNormalFetchDue();
+            else if (fired & (1 << TIMER_IP_LOOKUP)) onLocationLookupDue(); // Re-armed after the fetch otherwise
+            break;
+        case STATE_OFFLINE:
+            if (fired & (1 << TIMER_FETCH)) fetchOverdue = true;
+            if (fired & (1 << TIMER_RECONNECT)) onReconnectDue();
+            break;
+        case STATE_LPM_SCREEN_ON:
+            if (fired & (1 << TIMER_FETCH)) {
+                #if DEBUG_SCHEDULING || DEBUG_LPM
+                Serial.println("LPM (Screen On): Scheduled update time reached.");
+                #endif
+                runFetch(true, true); // Also restarts the screen timeout when done
+            }
+            if (fired & (1 << TIMER_SCREEN_IDLE)) displayPowerIdle(true); // About to time out
+            if (fired & (1 << TIMER_SCREEN_TIMEOUT)) {
                 #if DEBUG_LPM
                 Serial.println("LPM: Screen on-time expired. Going back to deep sleep.");
                 #endif
-                temporaryScreenWakeupActive = false;
-                
-                struct tm timeinfo_goto_sleep;
-                uint64_t sleep_duration_us;
-                if(!getLocalTime(&timeinfo_goto_sleep, 5000)){
-                     Serial.println("LPM Screen Timeout: Failed to obtain time for sleep calc! Sleeping 15 min.");
-                     sleep_duration_us = 15 * 60 * 1000000ULL; 
-                     nextUpdateEpochLpm = 0; // Mark as unknown
-                } else {
-                    time_t nowEpoch_for_sleep = mktime(&timeinfo_goto_sleep);
-                    if (nextUpdateEpochLpm != 0 && nextUpdateEpochLpm > nowEpoch_for_sleep) {
-                        sleep_duration_us = (nextUpdateEpochLpm - nowEpoch_for_sleep) * 1000000ULL;
-                    } else { // nextUpdateEpochLpm was missed, 0, or in the past. Recalculate.
-                        #if DEBUG_SCHEDULING
-                        Serial.println("LPM Screen Timeout: Recalculating next sleep slot.");
-                        #endif
-                        NextUpdateTimeDetails sleep_details = calculateNextUpdateTimeDetails(timeinfo_goto_sleep, UPDATES_PER_HOUR_LPM, REFRESH_TARGET_MINUTE, false);
-                        nextUpdateEpochLpm = sleep_details.nextUpdateEpoch;
-                        sleep_duration_us = sleep_details.sleepDurationUs;
-                    }
-                }
-                enterDeepSleep(sleep_duration_us, true);
-            }
-        } else { // Not temporaryScreenWakeupActive - should be in deep sleep, this is a fallback
-            #if DEBUG_LPM
-            Serial.println("LPM: Active, screen off. Fallback to deep sleep from loop (should not happen often).");
-            #endif
-            struct tm timeinfo_fallback_sleep;
-             if(!getLocalTime(&timeinfo_fallback_sleep, 5000)){
-                 Serial.println("LPM Fallback Sleep: No time! Sleeping 15 min.");
-                 enterDeepSleep(15 * 60 * 1000000ULL, true); 
-            } else {
-                NextUpdateTimeDetails details = calculateNextUpdateTimeDetails(timeinfo_fallback_sleep, UPDATES_PER_HOUR_LPM, REFRESH_TARGET_MINUTE, false);
-                nextUpdateEpochLpm = details.nextUpdateEpoch; // Set for next wake
-                enterDeepSleep(details.sleepDurationUs, true);
+                enterLpmSleep();
             }
-        }
-    } else { // Normal Mode
-        unsigned long currentMillis = millis(); 
+            break;
+        case STATE_LPM_SLEEPING:
+            enterLpmSleep();
+            break;
+        case STATE_FETCHING: // Fetch or reconnect in flight on the network task
+            break;
+    }
+}
 
-        if (WiFi.status() == WL_CONNECTED && nextUpdateEpochNormalMode > 0) { 
-            struct tm timeinfo_normal_loop;
-            if (!getLocalTime(&timeinfo_normal_loop, 1000)) { 
-                #if DEBUG_SCHEDULING
-                Serial.println("Loop Normal: Failed to get time for update check.");
-                #endif
-            } else {
-                time_t nowEpoch_normal_loop = mktime(&timeinfo_normal_loop);
-                if (nowEpoch_normal_loop >= nextUpdateEpochNormalMode) {
-                    #if DEBUG_SCHEDULING
-                    Serial.println("Normal Mode: Scheduled update time reached.");
-                    #endif
-                    performDataFetchSequence(false); 
-
-                    if (!getLocalTime(&timeinfo_normal_loop, 5000)) { 
-                        Serial.println("Normal Mode ERR: Failed to get time for rescheduling!");
-                        nextUpdateEpochNormalMode = nowEpoch_normal_loop + ( ( (UPDATES_PER_HOUR_NORMAL_MODE > 0) ? (60 / UPDATES_PER_HOUR_NORMAL_MODE) : 60 ) * 60 ); 
-                    } else {
-                        NextUpdateTimeDetails details_reschedule_normal = calculateNextUpdateTimeDetails(timeinfo_normal_loop, UPDATES_PER_HOUR_NORMAL_MODE, REFRESH_TARGET_MINUTE, true);
-                        nextUpdateEpochNormalMode = details_reschedule_normal.nextUpdateEpoch;
-                         #if DEBUG_SCHEDULING
-                         if(details_reschedule_normal.updateNow) Serial.println("Normal Mode: Rescheduler also indicated updateNow. Next slot set.");
-                         #endif
-                    }
-                }
-            }
-        } else if (WiFi.status() == WL_CONNECTED && nextUpdateEpochNormalMode == 0) { // Scheduler not ready, try to init
-            struct tm timeinfo_normal_init_sched;
-            if(getLocalTime(&timeinfo_normal_init_sched, 5000)){
-                NextUpdateTimeDetails details_init_normal = calculateNextUpdateTimeDetails(timeinfo_normal_init_sched, UPDATES_PER_HOUR_NORMAL_MODE, REFRESH_TARGET_MINUTE, true);
-                if(details_init_normal.updateNow) performDataFetchSequence(false);
-                nextUpdateEpochNormalMode = details_init_normal.nextUpdateEpoch;
-            }
+// --- Network Task Functions ---
+void publishForecastSnapshot() {
+    ForecastSnapshot& snap = forecastSnapshots.back();
+    memcpy(snap.hourlyUV, hourlyUV, sizeof(snap.hourlyUV));
+    memcpy(snap.forecastHours, forecastHours, sizeof(snap.forecastHours));
+    strncpy(snap.lastUpdateTimeStr, lastUpdateTimeStr.c_str(), sizeof(snap.lastUpdateTimeStr) - 1);
+    snap.lastUpdateTimeStr[sizeof(snap.lastUpdateTimeStr) - 1] = '\0';
+    strncpy(snap.locationDisplayStr, locationDisplayStr.c_str(), sizeof(snap.locationDisplayStr) - 1);
+    snap.locationDisplayStr[sizeof(snap.locationDisplayStr) - 1] = '\0';
+    snap.locationSource = locationSource;
+    snap.day = dayForecast;
+    snap.sequence = ++forecastSnapshotSequence;
+    forecastSnapshots.publish();
+    if (loopTaskHandle) xTaskNotifyGive(loopTaskHandle);
+}
+
+// Normal mode, reconnect failed: project the next hours with zero UV, once per outage.
+void applyOfflineForecastPlaceholder() {
+    if (lastUpdateTimeStr.equals("Offline")) return;
+    lastUpdateTimeStr = "Offline";
+    dayForecast.dayOfYear = -1;
+    struct tm timeinfo_offline_loop_normal;
+    if (getLocalTime(&timeinfo_offline_loop_normal, 1000)) {
+        for (int i = 0; i < HOURLY_FORECAST_COUNT; ++i) {
+            forecastHours[i] = (timeinfo_offline_loop_normal.tm_hour + i) % 24;
+            hourlyUV[i] = 0.0f;
         }
+    } else {
+        initializeForecastData(false);
+    }
+    rtc_lastFetchFromApi = false;
+    publishForecastSnapshot();
+}
 
-        if (WiFi.status() != WL_CONNECTED && (currentMillis - lastDataFetchAttemptMs >= 60000)) { 
-             Serial.println("Normal Mode: No WiFi. Attempting reconnect...");
-             connectToWiFi(false); 
-             if(WiFi.status() == WL_CONNECTED) {
-                Serial.println("Normal Mode: WiFi reconnected. Will fetch at next scheduled time or if initial fetch needed.");
-                lastDataFetchAttemptMs = currentMillis; 
-                if (nextUpdateEpochNormalMode == 0) { // If scheduler wasn't ready
-                    struct tm timeinfo_reconnect_sched;
-                    if(getLocalTime(&timeinfo_reconnect_sched, 5000)){
-                        NextUpdateTimeDetails details_reconnect_normal = calculateNextUpdateTimeDetails(timeinfo_reconnect_sched, UPDATES_PER_HOUR_NORMAL_MODE, REFRESH_TARGET_MINUTE, true);
-                        if(details_reconnect_normal.updateNow) performDataFetchSequence(false); 
-                        nextUpdateEpochNormalMode = details_reconnect_normal.nextUpdateEpoch;
-                    }
-                } else { // Scheduler was ready, check if update is due now that WiFi is back
-                    struct tm timeinfo_reconnect_check;
-                    if(getLocalTime(&timeinfo_reconnect_check, 1000)) {
-                        if (mktime(&timeinfo_reconnect_check) >= nextUpdateEpochNormalMode) {
-                             Serial.println("Normal Mode: WiFi reconnected and update is due/overdue. Fetching now.");
-                             performDataFetchSequence(false);
-                             if(getLocalTime(&timeinfo_reconnect_check, 5000)) { // Get fresh time for reschedule
-                                NextUpdateTimeDetails details_post_reconnect_fetch = calculateNextUpdateTimeDetails(timeinfo_reconnect_check, UPDATES_PER_HOUR_NORMAL_MODE, REFRESH_TARGET_MINUTE, true);
-                                nextUpdateEpochNormalMode = details_post_reconnect_fetch.nextUpdateEpoch;
-                             }
-                        }
-                    }
-                }
-             } else { // WiFi reconnect failed
-                lastDataFetchAttemptMs = currentMillis; 
-                if (!lastUpdateTimeStr.equals("Offline")) { 
-                    lastUpdateTimeStr = "Offline";
-                    struct tm timeinfo_offline_loop_normal;
-                    if (getLocalTime(&timeinfo_offline_loop_normal, 1000)) {
-                        for (int i = 0; i < HOURLY_FORECAST_COUNT; ++i) {
-                            forecastHours[i] = (timeinfo_offline_loop_normal.tm_hour + i) % 24;
-                            hourlyUV[i] = 0.0f;
-                        }
-                    } else {
-                        initializeForecastData(false); 
-                    }
-                    dataJustFetched = true; 
-                }
-             }
+void networkTask(void* param) {
+    NetworkJob job;
+    for (;;) {
+        if (xQueueReceive(networkJobQueue, &job, portMAX_DELAY) != pdTRUE) continue;
+        if (job.type == NETWORK_JOB_FETCH) {
+            if (job.toggleLocation) {
+                useGpsFromSecrets = !useGpsFromSecrets;
+                locationForceIpLookup = !useGpsFromSecrets; // Released: look up now rather than after the backoff
+                rtc_location.decisionUntil = 0;
+                Serial.printf("Location Mode Toggled (Long Press): %s\n", useGpsFromSecrets ? "Secrets GPS" : "IP Geolocation");
+            }
+            performDataFetchSequence(job.silent, job.toggleLocation);
+        } else if (job.type == NETWORK_JOB_IP_LOOKUP) {
+            locationForceIpLookup = false;
+            if (WiFi.status() == WL_CONNECTED && !useGpsFromSecrets) locationLookupIp(job.silent);
+        } else {
+            Serial.println("Normal Mode: No WiFi. Attempting reconnect...");
+            connectToWiFi(false);
+            if (WiFi.status() != WL_CONNECTED) applyOfflineForecastPlaceholder();
         }
+        networkJobDone = true;
+        if (loopTaskHandle) xTaskNotifyGive(loopTaskHandle);
     }
+}
+
+void networkTaskBegin() {
+    networkJobQueue = xQueueCreate(1, sizeof(NetworkJob));
+    xTaskCreatePinnedToCore(networkTask, "network", NETWORK_TASK_STACK_BYTES, NULL, 1, &networkTaskHandle, NETWORK_TASK_CORE);
+}
+
+// One job at a time: callers only post from a non-Fetching state.
+bool postNetworkJob(NetworkJobType type, bool silent, bool toggleLocation) {
+    NetworkJob job = { type, silent, toggleLocation };
+    pendingNetworkJob = type;
+    networkJobDone = false;
+    if (networkJobQueue && xQueueSend(networkJobQueue, &job, 0) == pdTRUE) return true;
+    Serial.println("NET ERR: Network task not available, job dropped.");
+    return false;
+}
 
-    if (force_display_update || dataJustFetched) {
+// --- Main Loop ---
+void loop() {
+    handleSerialCommands();
+    handle_buttons(); 
+    runStateMachine();
+
+    if (statusMessages.acquire()) { // Progress from the network task; only this core draws
+        const StatusMessage& msg = statusMessages.front();
+        displayMessage(msg.line1, msg.line2, msg.color, true);
+    }
+    if (forecastSnapshots.pending()) force_display_update = true;
+    // While a job is in flight the status message stays up; the frame is drawn from its snapshot.
+    if ((force_display_update || dataJustFetched) && deviceState != STATE_FETCHING) {
         if (!isLowPowerModeActive || temporaryScreenWakeupActive) { 
+            energyPhaseBegin(ENERGY_PHASE_RENDER);
             displayInfo();
+            energyPhaseEnd(ENERGY_PHASE_RENDER);
         }
+        if (!isLowPowerModeActive) energyCycleCommit(0); // Normal mode: a cycle ends with the rendered frame
         force_display_update = false;
         dataJustFetched = false;
     }
-    delay(50); 
+    displayPowerShow(); // Nothing drew since turnScreenOn(): GRAM still holds the previous frame
+    idleUntilNextEvent();
+}
+
+
+// --- Button Engine Functions ---
+void emitButtonEvent(uint8_t button, ButtonEventType type, uint32_t timestampMs) {
+    ButtonEvent event = { button, type, timestampMs };
+    if (xQueueSend(buttonEventQueue, &event, 0) != pdTRUE) {
+        #if DEBUG_LPM
+        Serial.println("BUTTONS: Event queue full, event dropped.");
+        #endif
+    }
+    if (loopTaskHandle) xTaskNotifyGive(loopTaskHandle);
+}
+
+// Any edge: the pin is armed on the opposite *level* rather than an edge, because only level
+// triggers can wake the chip from light sleep. Re-arming on the current level makes it edge-like.
+void IRAM_ATTR onButtonEdgeIsr(void* arg) {
+    uint8_t button = (uint8_t)(uintptr_t)arg;
+    gpio_num_t pin = (gpio_num_t)BUTTONS[button].pin;
+    gpio_set_intr_type(pin, gpio_get_level(pin) ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL);
+    buttonRuntime[button].lastEdgeMs = millis();
+    BaseType_t higherPriorityTaskWoken = pdFALSE;
+    xTimerResetFromISR(buttonRuntime[button].debounceTimer, &higherPriorityTaskWoken);
+    if (higherPriorityTaskWoken) portYIELD_FROM_ISR();
+}
+
+// Carries out a gesture step: queue its event and re-arm or stop the gesture timer.
+void applyGestureStep(uint8_t button, const GestureStep& step) {
+    ButtonRuntime& rt = buttonRuntime[button];
+    if (step.timer == GESTURE_TIMER_ARM) xTimerChangePeriod(rt.gestureTimer, pdMS_TO_TICKS(step.timerPeriodMs), 0);
+    else if (step.timer == GESTURE_TIMER_STOP) xTimerStop(rt.gestureTimer, 0);
+    if (step.emit) emitButtonEvent(button, step.type, step.timestampMs);
+}
+
+// Runs DEBOUNCE_TIME_MS after the last edge: the level is now stable.
+void onButtonDebounced(TimerHandle_t timer) {
+    uint8_t button = (uint8_t)(uintptr_t)pvTimerGetTimerID(timer);
+    bool pressed = digitalRead(BUTTONS[button].pin) == LOW;
+    applyGestureStep(button, gestureOnDebounced(buttonRuntime[button].gesture, pressed, buttonRuntime[button].lastEdgeMs,
+                                                millis(), BUTTONS[button].detectDouble, BUTTON_TIMING));
+}
+
+// Long-press threshold, hold-repeat tick or expiry of the double-click window.
+void onButtonGestureTimer(TimerHandle_t timer) {
+    uint8_t button = (uint8_t)(uintptr_t)pvTimerGetTimerID(timer);
+    applyGestureStep(button, gestureOnTimer(buttonRuntime[button].gesture, BUTTONS[button].holdRepeat, BUTTON_TIMING));
+}
+
+void buttonEngineBegin() {
+    buttonEventQueue = xQueueCreate(BUTTON_EVENT_QUEUE_LENGTH, sizeof(ButtonEvent));
+    for (uint8_t i = 0; i < BUTTON_COUNT; ++i) {
+        ButtonRuntime& rt = buttonRuntime[i];
+        pinMode(BUTTONS[i].pin, INPUT_PULLUP);
+        gestureReset(rt.gesture, digitalRead(BUTTONS[i].pin) == LOW);
+        rt.lastEdgeMs = millis();
+        rt.debounceTimer = xTimerCreate("btnDebounce", pdMS_TO_TICKS(DEBOUNCE_TIME_MS), pdFALSE, (void*)(uintptr_t)i, onButtonDebounced);
+        rt.gestureTimer = xTimerCreate("btnGesture", pdMS_TO_TICKS(LONG_PRESS_TIME_MS), pdFALSE, (void*)(uintptr_t)i, onButtonGestureTimer);
+        attachInterruptArg(BUTTONS[i].pin, onButtonEdgeIsr, (void*)(uintptr_t)i, rt.gesture.stablePressed ? ONHIGH_WE : ONLOW_WE);
+    }
+}
+
+bool buttonEngineNextEvent(ButtonEvent* event) {
+    return buttonEventQueue && xQueueReceive(buttonEventQueue, event, 0) == pdTRUE;
 }
 
 // --- Consolidated Button Handling ---
 void handle_buttons() {
-    unsigned long current_millis = millis();
-
-    bool current_info_button_state = digitalRead(BUTTON_INFO_PIN);
-    if (current_info_button_state == LOW && button_info_last_state == HIGH && (current_millis - button_info_last_press_time > DEBOUNCE_TIME_MS)) {
-        button_info_press_start_time = current_millis;
-        button_info_is_held = false;
-    } else if (current_info_button_state == LOW && !button_info_is_held) { 
-        if (current_millis - button_info_press_start_time > LONG_PRESS_TIME_MS) { 
+    ButtonEvent event;
+    while (buttonEngineNextEvent(&event)) {
+        if (deviceState == STATE_LPM_SCREEN_ON) extendLpmScreenOn(); // Any interaction keeps the screen on
+
+        if (event.button == BUTTON_ID_INFO && event.type == BUTTON_EVENT_SHORT) {
+            if (uiPage != UI_PAGE_FORECAST) { // Back to the graph first
+                uiPage = UI_PAGE_FORECAST;
+            } else {
+                showInfoOverlay = !showInfoOverlay;
+                Serial.printf("Info Button Short Press, showInfoOverlay: %s\n", showInfoOverlay ? "true" : "false");
+            }
+            force_display_update = true; 
+        } else if (event.button == BUTTON_ID_LP_TOGGLE && event.type == BUTTON_EVENT_SHORT) {
+            uiPage = (UiPage)((uiPage + 1) % UI_PAGE_COUNT);
+            Serial.printf("Page: %s\n", UI_PAGES[uiPage].name);
+            force_display_update = true;
+        } else if (deviceState == STATE_FETCHING && event.type != BUTTON_EVENT_SHORT) {
+            Serial.println("Buttons: Network job in progress, ignoring.");
+        } else if (event.button == BUTTON_ID_INFO && event.type == BUTTON_EVENT_DOUBLE) {
+            Serial.println("Info Button Double Press: Manual refresh.");
+            runFetch(false, false); // Restarts the LPM screen timeout after the fetch
+        } else if (event.button == BUTTON_ID_INFO && event.type == BUTTON_EVENT_LONG) {
             if (showInfoOverlay) { 
-                useGpsFromSecrets = !useGpsFromSecrets;
-                Serial.printf("Location Mode Toggled (Long Press): %s\n", useGpsFromSecrets ? "Secrets GPS" : "IP Geolocation");
-                performDataFetchSequence(false); 
+                runFetch(false, false, true); // The network task flips useGpsFromSecrets, it owns it
                 // savePersistentState is called within performDataFetchSequence
-                if (isLowPowerModeActive && temporaryScreenWakeupActive) {
-                    screenActiveUntilMs = current_millis + SCREEN_ON_DURATION_LPM_MS; 
-                }
                 // force_display_update is true from performDataFetchSequence
             }
-            button_info_is_held = true; 
-            button_info_last_press_time = current_millis; 
-        }
-    } else if (current_info_button_state == HIGH && button_info_last_state == LOW && (current_millis - button_info_last_press_time > DEBOUNCE_TIME_MS)) { 
-        if (!button_info_is_held) { 
-            showInfoOverlay = !showInfoOverlay;
-            Serial.printf("Info Button Short Press, showInfoOverlay: %s\n", showInfoOverlay ? "true" : "false");
-            if (isLowPowerModeActive && temporaryScreenWakeupActive) {
-                screenActiveUntilMs = current_millis + SCREEN_ON_DURATION_LPM_MS; 
-            }
-            force_display_update = true; 
-        }
-        button_info_last_press_time = current_millis; 
-        button_info_is_held = false; 
-    }
-    button_info_last_state = current_info_button_state;
-
-    bool current_lp_button_state = digitalRead(BUTTON_LP_TOGGLE_PIN);
-    if (current_lp_button_state == LOW && button_lp_last_state == HIGH && (current_millis - button_lp_last_press_time > DEBOUNCE_TIME_MS)) {
-        button_lp_press_start_time = current_millis;
-        button_lp_is_held = false;
-    } else if (current_lp_button_state == LOW && !button_lp_is_held) { 
-        if (current_millis - button_lp_press_start_time > LONG_PRESS_TIME_MS) { 
+        } else if (event.button == BUTTON_ID_LP_TOGGLE && event.type == BUTTON_EVENT_LONG) {
             isLowPowerModeActive = !isLowPowerModeActive;
             Serial.printf("LPM Toggled (Long Press): %s\n", isLowPowerModeActive ? "ON" : "OFF");
             savePersistentState(); // Save new LPM state immediately
@@ -809,46 +2625,22 @@ void handle_buttons() {
                 turnScreenOn(); 
                 displayMessage("Low Power Mode: ON", "Sleeping...", TFT_BLUE, true);
                 delay(2000);
-                struct tm timeinfo_lpm_on;
-                if(!getLocalTime(&timeinfo_lpm_on, 10000)){
-                    Serial.println("LPM Toggle ON FATAL: No time for sleep calc! Sleeping 15 min.");
-                    nextUpdateEpochLpm = 0; // Mark as unknown
-                    enterDeepSleep(15*60*1000000ULL, true); 
-                } else {
-                    NextUpdateTimeDetails details_lpm_on = calculateNextUpdateTimeDetails(timeinfo_lpm_on, UPDATES_PER_HOUR_LPM, REFRESH_TARGET_MINUTE, false);
-                    nextUpdateEpochLpm = details_lpm_on.nextUpdateEpoch;
-                    enterDeepSleep(details_lpm_on.sleepDurationUs, true);
-                }
+                timerWheelCancel(TIMER_RECONNECT);
+                nextUpdateEpochLpm = 0; // Normal-mode deadline doesn't apply, recalculate on the LPM grid
+                enterLpmSleep();
             } else { // Transitioning FROM LPM (to Normal Mode)
                 temporaryScreenWakeupActive = false;
                 nextUpdateEpochLpm = 0; // Clear LPM scheduler
+                timerWheelCancel(TIMER_SCREEN_TIMEOUT);
+                timerWheelCancel(TIMER_SCREEN_IDLE);
                 turnScreenOn();
                 displayMessage("Low Power Mode: OFF", "Refreshing...", TFT_GREEN, true);
                 Serial.println("Exiting LPM: Attempting data refresh...");
-                performDataFetchSequence(false); 
-                
-                struct tm timeinfo_lpm_off;
-                 if(!getLocalTime(&timeinfo_lpm_off, 10000)){
-                    Serial.println("LPM Toggle OFF ERR: No time for normal mode schedule!");
-                    nextUpdateEpochNormalMode = 0; 
-                } else {
-                    NextUpdateTimeDetails details_lpm_off_normal = calculateNextUpdateTimeDetails(timeinfo_lpm_off, UPDATES_PER_HOUR_NORMAL_MODE, REFRESH_TARGET_MINUTE, true);
-                    // If updateNow is true, performDataFetchSequence already handled it.
-                    nextUpdateEpochNormalMode = details_lpm_off_normal.nextUpdateEpoch;
-                     #if DEBUG_SCHEDULING
-                     if(details_lpm_off_normal.updateNow && WiFi.status() == WL_CONNECTED) Serial.println("LPM Toggle OFF: Scheduler indicates immediate update (likely just handled).");
-                     #endif
-                }
+                runFetch(false, true); // Settles into NormalIdle or Offline, then schedules the next slot
                 // force_display_update is true from performDataFetchSequence
             }
-            button_lp_is_held = true; 
-            button_lp_last_press_time = current_millis;
         }
-    } else if (current_lp_button_state == HIGH && button_lp_last_state == LOW && (current_millis - button_lp_last_press_time > DEBOUNCE_TIME_MS)) { 
-        button_lp_last_press_time = current_millis; 
-        button_lp_is_held = false; 
     }
-    button_lp_last_state = current_lp_button_state;
 }
 
 
@@ -860,6 +2652,22 @@ void displayMessage(String msg_line1, String msg_line2, int color, bool allowDis
         #endif
         return;
     }
+    if (bootCachedFrameHeld) {
+        Serial.println("Status: " + msg_line1 + " " + msg_line2); // Keep the cached frame up
+        return;
+    }
+    if (networkTaskHandle && xTaskGetCurrentTaskHandle() == networkTaskHandle) { // Only the UI core touches the TFT
+        StatusMessage& msg = statusMessages.back();
+        strncpy(msg.line1, msg_line1.c_str(), sizeof(msg.line1) - 1);
+        msg.line1[sizeof(msg.line1) - 1] = '\0';
+        strncpy(msg.line2, msg_line2.c_str(), sizeof(msg.line2) - 1);
+        msg.line2[sizeof(msg.line2) - 1] = '\0';
+        msg.color = color;
+        statusMessages.publish();
+        if (loopTaskHandle) xTaskNotifyGive(loopTaskHandle);
+        return;
+    }
+    displayBegin();
     tft.fillScreen(TFT_BLACK);
     tft.setTextColor(color, TFT_BLACK);
     tft.setTextFont(2); 
@@ -867,6 +2675,9 @@ void displayMessage(String msg_line1, String msg_line2, int color, bool allowDis
 
     int16_t width = tft.width();
     int16_t height = tft.height();
+    int line_width = overlayTextBudgets(width).line;
+    msg_line1 = fitTextToWidth(msg_line1, line_width);
+    msg_line2 = fitTextToWidth(msg_line2, line_width);
 
     if (msg_line2 != "") {
         tft.drawString(msg_line1, width / 2, height / 2 - 10);
@@ -874,6 +2685,7 @@ void displayMessage(String msg_line1, String msg_line2, int color, bool allowDis
     } else {
         tft.drawString(msg_line1, width / 2, height / 2);
     }
+    displayPowerShow();
     #if DEBUG_LPM 
     Serial.println("Displaying Message: " + msg_line1 + " " + msg_line2);
     #endif
@@ -886,124 +2698,429 @@ void displayInfo() {
         #endif
         return;
     }
+    displayBegin();
+    int64_t renderStartUs = esp_timer_get_time();
+    MemorySample memoryBefore = memorySample();
+    uvDoseTick(); // Acquires the latest complete snapshot; never waits on the network task
+    const ForecastSnapshot& view = forecastSnapshots.front();
+    uiPageDraw(uiPage, view);
+    displayPowerShow();
+    memoryRecord(MEMORY_SITE_RENDER, memoryBefore);
+    telemetryLog(TELEMETRY_EVENT_RENDER, telemetrySaturate((esp_timer_get_time() - renderStartUs) / 1000));
+}
 
-    tft.fillScreen(TFT_BLACK);
+// --- UI Page Functions ---
+// Graph page: the hourly bars, with the status overlay on top when toggled.
+void renderForecastPage(TFT_eSPI& gfx, const ForecastSnapshot& view) {
     int padding = 4;
     int top_y_offset = padding; 
 
-    tft.setTextFont(2);
-    int info_font_height = tft.fontHeight(2); 
+    gfx.setTextFont(2);
+    int info_font_height = gfx.fontHeight(2); 
     int base_top_text_line_y = padding + info_font_height / 2; 
 
     if (showInfoOverlay) {
         int current_info_y = base_top_text_line_y;
-        tft.setTextDatum(TL_DATUM); 
-
-        tft.setTextColor(isLowPowerModeActive ? TFT_ORANGE : TFT_GREEN, TFT_BLACK);
-        tft.drawString(isLowPowerModeActive ? "LPM: ON" : "LPM: OFF", padding, current_info_y);
+        gfx.setTextDatum(TL_DATUM); 
+        OverlayTextBudgets budgets = overlayTextBudgets(gfx.width());
+        int line_width = budgets.line;
+
+        String lpmText = isLowPowerModeActive ? "LPM: ON" : "LPM: OFF";
+        gfx.setTextColor(isLowPowerModeActive ? TFT_ORANGE : TFT_GREEN, TFT_BLACK);
+        gfx.drawString(lpmText, padding, current_info_y);
+        gfx.setTextDatum(TR_DATUM);
+        gfx.setTextColor(uvDoseBurnMinutes >= 0 && uvDoseBurnMinutes < 60 ? TFT_ORANGE : TFT_LIGHTGREY, TFT_BLACK);
+        gfx.drawString(fitTextToWidth(uvDoseBurnText(), overlayRemainingWidth(line_width, lpmText)), gfx.width() - padding, current_info_y);
+        gfx.setTextDatum(TL_DATUM);
         current_info_y += (info_font_height + padding);
 
+        // Update time on the right takes up to 45% of the line, the WiFi text gets the rest
+        String timeToDisplay = fitTextToWidth("Upd: " + String(view.lastUpdateTimeStr), budgets.updateTime);
+        int wifi_width = overlayRemainingWidth(line_width, timeToDisplay);
         if (WiFi.status() == WL_CONNECTED) {
-            tft.setTextColor(TFT_GREENYELLOW, TFT_BLACK);
-            String ssid_str = WiFi.SSID();
-            if (ssid_str.length() > 16) ssid_str = ssid_str.substring(0, 13) + "..."; 
-            tft.drawString("WiFi: " + ssid_str, padding, current_info_y);
+            gfx.setTextColor(TFT_GREENYELLOW, TFT_BLACK);
+            gfx.drawString(fitTextToWidth("WiFi: " + WiFi.SSID(), wifi_width), padding, current_info_y);
         } else if (isConnectingToWiFi) { 
-             tft.setTextColor(TFT_YELLOW, TFT_BLACK);
-             tft.drawString("WiFi: Connecting...", padding, current_info_y);
+             gfx.setTextColor(TFT_YELLOW, TFT_BLACK);
+             gfx.drawString(fitTextToWidth("WiFi: Connecting...", wifi_width), padding, current_info_y);
         }
          else { 
-            tft.setTextColor(TFT_RED, TFT_BLACK);
-            tft.drawString("WiFi: Offline", padding, current_info_y);
+            gfx.setTextColor(TFT_RED, TFT_BLACK);
+            gfx.drawString(fitTextToWidth("WiFi: Offline", wifi_width), padding, current_info_y);
         }
 
-        tft.setTextDatum(TR_DATUM); 
-        tft.setTextColor(TFT_LIGHTGREY, TFT_BLACK);
-        String timeToDisplay = lastUpdateTimeStr;
-        if (timeToDisplay.length() > 12) timeToDisplay = timeToDisplay.substring(0,9) + "..."; 
-        tft.drawString("Upd: " + timeToDisplay, tft.width() - padding, current_info_y);
+        gfx.setTextDatum(TR_DATUM); 
+        gfx.setTextColor(TFT_LIGHTGREY, TFT_BLACK);
+        gfx.drawString(timeToDisplay, gfx.width() - padding, current_info_y);
         current_info_y += (info_font_height + padding);
 
-        tft.setTextDatum(TL_DATUM); 
-        tft.setTextColor(TFT_SKYBLUE, TFT_BLACK);
-        String locText = "Loc: " + locationDisplayStr + (useGpsFromSecrets ? " (Sec)" : " (IP)");
-        if (locText.length() > 30) locText = locText.substring(0, 27) + "..."; 
-        tft.drawString(locText, padding, current_info_y);
+        gfx.setTextDatum(TL_DATUM); 
+        gfx.setTextColor(TFT_SKYBLUE, TFT_BLACK);
+        String locText = "Loc: " + String(view.locationDisplayStr) + " (" + LOCATION_SOURCE_TAGS[view.locationSource] + ")";
+        gfx.drawString(fitTextToWidth(locText, line_width), padding, current_info_y);
+        String peakText = dayPeakText(view.day);
+        if (peakText.length() > 0) {
+            current_info_y += (info_font_height + padding);
+            gfx.setTextColor(TFT_YELLOW, TFT_BLACK);
+            gfx.drawString(fitTextToWidth(peakText, line_width), padding, current_info_y);
+        }
         top_y_offset = current_info_y + info_font_height / 2 + padding * 2;
 
     } else { 
-        tft.setTextDatum(TR_DATUM); 
-        int status_x = tft.width() - padding;
+        gfx.setTextDatum(TR_DATUM); 
+        int status_x = gfx.width() - padding;
         int status_y = base_top_text_line_y;
         
         if (WiFi.status() != WL_CONNECTED && !isConnectingToWiFi) { 
-            tft.setTextColor(TFT_RED, TFT_BLACK);
-            tft.drawString("NoFi", status_x, status_y);
+            gfx.setTextColor(TFT_RED, TFT_BLACK);
+            gfx.drawString("NoFi", status_x, status_y);
             top_y_offset = base_top_text_line_y + info_font_height / 2 + padding * 2;
         } else if (isConnectingToWiFi) { 
-             tft.setTextColor(TFT_YELLOW, TFT_BLACK);
-             tft.drawString("WiFi?", status_x, status_y);
+             gfx.setTextColor(TFT_YELLOW, TFT_BLACK);
+             gfx.drawString("WiFi?", status_x, status_y);
              top_y_offset = base_top_text_line_y + info_font_height / 2 + padding * 2;
         }
         if (WiFi.status() == WL_CONNECTED) {
              top_y_offset = padding; 
         }
     }
-    drawForecastGraph(top_y_offset);
+    drawForecastGraph(gfx, top_y_offset);
+}
+
+// Text pages: font 2 lines from the top, each fitted to the panel width.
+void drawPageLine(TFT_eSPI& gfx, int line, const String& text, uint16_t color) {
+    const int padding = 4;
+    gfx.setTextFont(2);
+    gfx.setTextDatum(TL_DATUM);
+    gfx.setTextColor(color, TFT_BLACK);
+    gfx.drawString(fitTextToWidth(text, overlayTextBudgets(gfx.width()).line), padding, padding + line * (gfx.fontHeight(2) + padding));
+}
+
+// 24 h page: the day's quarter-hour samples as 2 px gradient columns, WHO thresholds dotted, now marked.
+void renderDayPage(TFT_eSPI& gfx, const ForecastSnapshot& view) {
+    const DayForecast& day = view.day;
+    const int padding = 4;
+    const String title = "Today";
+    drawPageLine(gfx, 0, title, TFT_WHITE);
+    if (day.dayOfYear < 0) {
+        gfx.setTextDatum(MC_DATUM);
+        gfx.setTextColor(TFT_LIGHTGREY, TFT_BLACK);
+        gfx.drawString("No day forecast yet", gfx.width() / 2, gfx.height() / 2);
+        return;
+    }
+    gfx.setTextDatum(TR_DATUM);
+    gfx.setTextColor(TFT_YELLOW, TFT_BLACK);
+    gfx.drawString(fitTextToWidth(dayPeakText(day), overlayRemainingWidth(overlayTextBudgets(gfx.width()).line, title)), gfx.width() - padding, padding);
+
+    int font_h = gfx.fontHeight(2);
+    int chart_top = padding * 2 + font_h;
+    int chart_bottom = gfx.height() - padding - font_h;
+    int chart_h = chart_bottom - chart_top;
+    int chart_x = (gfx.width() - 2 * UV_QUARTER_SAMPLES) / 2;
+    const int full_scale = UV_GRAPH_FULL_SCALE * UV_QUARTER_SCALE;
+    for (int q = 0; q < UV_QUARTER_SAMPLES; ++q) {
+        int uv = day.uvQuarter[q] < full_scale ? day.uvQuarter[q] : full_scale;
+        fillUvGradientBar(gfx, chart_x + q * 2, chart_bottom, 2, uv * chart_h / full_scale, chart_h);
+    }
+    for (int level = 0; level < WHO_UV_LEVEL_COUNT; ++level) {
+        if (WHO_UV_THRESHOLDS[level] > UV_GRAPH_FULL_SCALE) break;
+        int y = chart_bottom - (int)(WHO_UV_THRESHOLDS[level] * chart_h / UV_GRAPH_FULL_SCALE);
+        for (int x = chart_x; x < chart_x + 2 * UV_QUARTER_SAMPLES; x += 4) gfx.drawFastHLine(x, y, 2, TFT_DARKGREY);
+    }
+    int nowQuarter = currentQuarterIndex(view);
+    if (nowQuarter >= 0) gfx.drawFastVLine(chart_x + nowQuarter * 2 + 1, chart_top, chart_h, TFT_WHITE);
+    gfx.setTextDatum(TC_DATUM);
+    gfx.setTextColor(TFT_WHITE, TFT_BLACK);
+    for (int hour = 0; hour <= 24; hour += 6) gfx.drawString(String(hour), chart_x + hour * 8, chart_bottom + 2);
+}
+
+// Stats page: today's dose, burn time and how the day's hours split across the WHO bands.
+void renderStatsPage(TFT_eSPI& gfx, const ForecastSnapshot& view) {
+    const DayForecast& day = view.day;
+    char text[48];
+    drawPageLine(gfx, 0, "Today's UV", TFT_WHITE);
+    snprintf(text, sizeof(text), "Dose %.2f SED (%d%% MED)", rtc_doseTodaySed, (int)(rtc_doseTodaySed * 100.0f / uvDoseMedSed() + 0.5f));
+    drawPageLine(gfx, 1, text, TFT_SKYBLUE);
+    drawPageLine(gfx, 2, uvDoseBurnText(), uvDoseBurnMinutes >= 0 && uvDoseBurnMinutes < 60 ? TFT_ORANGE : TFT_LIGHTGREY);
+    if (day.dayOfYear < 0) {
+        drawPageLine(gfx, 3, "No day forecast yet", TFT_LIGHTGREY);
+        return;
+    }
+    snprintf(text, sizeof(text), "Peak %.1f at %dh", day.peakUV / (float)UV_QUARTER_SCALE, day.peakHour);
+    drawPageLine(gfx, 3, text, TFT_YELLOW);
+    int len = snprintf(text, sizeof(text), "Hours");
+    for (int level = 0; level < WHO_UV_LEVEL_COUNT && len < (int)sizeof(text); ++level) {
+        len += snprintf(text + len, sizeof(text) - len, " %d+:%d", (int)WHO_UV_THRESHOLDS[level], __builtin_popcount(day.hoursAtOrAbove[level]));
+    }
+    drawPageLine(gfx, 4, text, TFT_GREENYELLOW);
+    time_t now = time(nullptr);
+    struct tm localNow;
+    int high = (int)WHO_UV_THRESHOLDS[WHO_UV_LEVEL_HIGH];
+    int start = (now > 1600000000 && localtime_r(&now, &localNow)) ? uvNextHourAtOrAbove(day, WHO_UV_LEVEL_HIGH, localNow.tm_hour) : -1;
+    if (start >= 0) snprintf(text, sizeof(text), "Next %d+: %d-%dh", high, start, uvWindowEndHour(day, WHO_UV_LEVEL_HIGH, start));
+    else snprintf(text, sizeof(text), "No %d+ hours left today", high);
+    drawPageLine(gfx, 5, text, TFT_ORANGE);
+}
+
+// Network page: link, signal, last update, location source and IP lookup backoff.
+void renderNetworkPage(TFT_eSPI& gfx, const ForecastSnapshot& view) {
+    char text[48];
+    drawPageLine(gfx, 0, "Network", TFT_WHITE);
+    if (WiFi.status() == WL_CONNECTED) {
+        drawPageLine(gfx, 1, "WiFi: " + WiFi.SSID(), TFT_GREENYELLOW);
+        snprintf(text, sizeof(text), "RSSI %d dBm  IP %s", WiFi.RSSI(), WiFi.localIP().toString().c_str());
+        drawPageLine(gfx, 2, text, TFT_GREENYELLOW);
+    } else {
+        drawPageLine(gfx, 1, isConnectingToWiFi ? "WiFi: Connecting..." : "WiFi: Offline", isConnectingToWiFi ? TFT_YELLOW : TFT_RED);
+    }
+    drawPageLine(gfx, 3, "Upd: " + String(view.lastUpdateTimeStr), TFT_LIGHTGREY);
+    drawPageLine(gfx, 4, "Loc: " + String(view.locationDisplayStr) + " (" + LOCATION_SOURCE_TAGS[view.locationSource] + ")", TFT_SKYBLUE);
+    uint8_t failures = rtc_location.failures;
+    time_t retry = rtc_location.retryEpoch;
+    struct tm retryInfo;
+    if (failures > 0 && retry > 1600000000 && localtime_r(&retry, &retryInfo)) {
+        snprintf(text, sizeof(text), "IP lookup: %u failed, retry %02d:%02d", failures, retryInfo.tm_hour, retryInfo.tm_min);
+    } else {
+        snprintf(text, sizeof(text), "IP lookup: %s", failures ? "failing" : "ok");
+    }
+    drawPageLine(gfx, 5, text, failures ? TFT_ORANGE : TFT_LIGHTGREY);
+}
+
+const UiPageDef UI_PAGES[UI_PAGE_COUNT] = {
+    { "forecast", (1 << PAGE_INPUT_FORECAST) | (1 << PAGE_INPUT_QUARTER) | (1 << PAGE_INPUT_OVERLAY) | (1 << PAGE_INPUT_LINK) |
+                  (1 << PAGE_INPUT_DOSE) | (1 << PAGE_INPUT_LPM), renderForecastPage },
+    { "day",      (1 << PAGE_INPUT_FORECAST) | (1 << PAGE_INPUT_QUARTER), renderDayPage },
+    { "stats",    (1 << PAGE_INPUT_FORECAST) | (1 << PAGE_INPUT_QUARTER) | (1 << PAGE_INPUT_DOSE), renderStatsPage },
+    { "network",  (1 << PAGE_INPUT_FORECAST) | (1 << PAGE_INPUT_LINK) | (1 << PAGE_INPUT_SIGNAL), renderNetworkPage },
+};
+
+uint32_t pageInputStamp(PageInput input, const ForecastSnapshot& view) {
+    switch (input) {
+        case PAGE_INPUT_FORECAST: return view.sequence;
+        case PAGE_INPUT_QUARTER: return (uint32_t)(time(nullptr) / 900);
+        case PAGE_INPUT_OVERLAY: return showInfoOverlay;
+        case PAGE_INPUT_LINK: {
+            uint32_t stamp = (WiFi.status() == WL_CONNECTED ? 1 : 0) | (isConnectingToWiFi ? 2 : 0);
+            const uint8_t* bssid = (stamp & 1) ? WiFi.BSSID() : nullptr; // The driver's copy; another SSID is another AP
+            if (bssid) {
+                for (int i = 0; i < 6; ++i) stamp = stamp * 31 + bssid[i];
+            }
+            return stamp;
+        }
+        case PAGE_INPUT_SIGNAL: {
+            if (WiFi.status() != WL_CONNECTED) return rtc_location.failures;
+            uint32_t stamp = (uint32_t)(WiFi.RSSI() / 3) ^ ((uint32_t)rtc_location.failures << 8);
+            return stamp * 31 + (uint32_t)WiFi.localIP();
+        }
+        case PAGE_INPUT_DOSE: return (uint32_t)uvDoseBurnMinutes ^ ((uint32_t)(rtc_doseTodaySed * 100.0f) << 12);
+        case PAGE_INPUT_LPM: return isLowPowerModeActive;
+        default: return 0;
+    }
+}
+
+// FNV-1a over the stamps of the inputs the page declares.
+uint32_t pageInputKey(const UiPageDef& page, const ForecastSnapshot& view) {
+    uint32_t key = 2166136261u;
+    for (int i = 0; i < PAGE_INPUT_COUNT; ++i) {
+        if (page.inputs & (1 << i)) key = (key ^ pageInputStamp((PageInput)i, view)) * 16777619u;
+    }
+    return key;
+}
+
+size_t pageSpriteBytes() {
+    return (size_t)tft.width() * tft.height() * sizeof(uint16_t);
+}
+
+// What the render sprite leaves of the budget.
+size_t pageFrameBudgetBytes() {
+    size_t sprite = pageSpriteBytes();
+    return pageMemoryBudget > sprite ? pageMemoryBudget - sprite : 0;
+}
+
+void pageCacheDrop(PageCacheEntry& entry) {
+    if (!entry.frame.palette) return;
+    pageCacheBytes -= entry.bytes;
+    free(entry.frame.palette);
+    entry.frame = FrameRle();
+    entry.bytes = 0;
+}
+
+// Drops the least recently shown frame other than keepPage's; false if there is none.
+bool pageCacheEvictOldest(int keepPage) {
+    int oldest = -1;
+    for (int i = 0; i < UI_PAGE_COUNT; ++i) {
+        if (i != keepPage && pageCache[i].frame.palette && (oldest < 0 || pageCache[i].lastShown < pageCache[oldest].lastShown)) oldest = i;
+    }
+    if (oldest < 0) return false;
+    pageCacheDrop(pageCache[oldest]);
+    pageCacheEvictions++;
+    return true;
+}
+
+// Allocated while the heap is still whole and kept until deep sleep, so page misses don't take and
+// return 64 KB each. Should the heap have no block for it, frames are evicted oldest first, one per
+// failed allocation; uiPageDraw() retries on its next miss.
+bool pageSpriteBegin() {
+    if (pageSprite.created()) return true;
+    pageSprite.setColorDepth(16);
+    while (!pageSprite.createSprite(tft.width(), tft.height())) {
+        if (!pageCacheEvictOldest(-1)) return false;
+    }
+    return true;
+}
+
+// Lowers (or restores) the budget, evicting oldest first until the cached frames fit.
+void pageCacheSetBudget(size_t bytes) {
+    pageMemoryBudget = bytes;
+    while (pageCacheBytes > pageFrameBudgetBytes()) {
+        if (!pageCacheEvictOldest(-1)) break;
+    }
+}
+
+// Encodes the sprite into an exactly sized block, evicting older frames until it fits the frame budget.
+bool pageCacheStore(UiPage page, TFT_eSprite& frame, uint32_t inputKey) {
+    const uint16_t* pixels = (const uint16_t*)frame.getPointer();
+    if (!pixels) return false;
+    uint32_t pixelCount = (uint32_t)frame.width() * frame.height();
+    static FrameRleScan scan; // 516 B: off the loop task's stack
+    if (!frameRleScan(pixels, pixelCount, scan)) return false; // Too colourful to encode
+    size_t bytes = frameRleBytes(scan);
+    size_t budget = pageFrameBudgetBytes();
+    if (bytes > budget) return false;
+    while (pageCacheBytes + bytes > budget) {
+        if (!pageCacheEvictOldest(page)) return false;
+    }
+    void* block = malloc(bytes);
+    if (!block) return false;
+    PageCacheEntry& entry = pageCache[page];
+    entry.frame = frameRleEncode(pixels, pixelCount, scan, block, true);
+    entry.bytes = bytes;
+    entry.inputKey = inputKey;
+    pageCacheBytes += bytes;
+    return true;
+}
+
+// One address window for the whole panel, then the runs back to back.
+void pageCacheBlit(const PageCacheEntry& entry) {
+    const FrameRle& frame = entry.frame;
+    tft.startWrite();
+    tft.setAddrWindow(0, 0, tft.width(), tft.height());
+    for (uint32_t i = 0; i < frame.runCount; ++i) tft.pushBlock(frame.palette[frame.runs[i].colorIndex], frame.runs[i].length);
+    tft.endWrite();
+}
+
+// A cached frame whose inputs are unchanged is blitted. Otherwise the page is rendered into the
+// sprite, kept in the cache if its encoding fits, and pushed. Only when the sprite could not be
+// allocated is the page drawn straight to the panel.
+void uiPageDraw(UiPage page, const ForecastSnapshot& view) {
+    const UiPageDef& def = UI_PAGES[page];
+    uint32_t inputKey = pageInputKey(def, view);
+    PageCacheEntry& entry = pageCache[page];
+    entry.lastShown = ++pageCacheClock;
+    if (entry.frame.palette && entry.inputKey == inputKey) {
+        pageCacheHits++;
+        pageCacheBlit(entry);
+        return;
+    }
+    pageCacheMisses++;
+    pageCacheDrop(entry);
+    if (!pageSpriteBegin()) {
+        pageCacheUncached++;
+        tft.fillScreen(TFT_BLACK);
+        def.render(tft, view);
+        return;
+    }
+    pageSprite.fillSprite(TFT_BLACK);
+    def.render(pageSprite, view);
+    if (!pageCacheStore(page, pageSprite, inputKey)) pageCacheUncached++;
+    pageSprite.pushSprite(0, 0);
+}
+
+void dumpPageCache() {
+    Serial.printf("Page: %s | cache %u of %u bytes (+%u sprite) | hits %lu, misses %lu, evictions %lu, uncached %lu\n",
+                  UI_PAGES[uiPage].name, (unsigned)pageCacheBytes, (unsigned)pageFrameBudgetBytes(), (unsigned)pageSpriteBytes(), (unsigned long)pageCacheHits,
+                  (unsigned long)pageCacheMisses, (unsigned long)pageCacheEvictions, (unsigned long)pageCacheUncached);
+    for (int i = 0; i < UI_PAGE_COUNT; ++i) {
+        const PageCacheEntry& entry = pageCache[i];
+        if (entry.frame.palette) Serial.printf("  %-8s %5lu runs, %3u colours, %6u bytes, shown #%lu\n", UI_PAGES[i].name,
+                                               (unsigned long)entry.frame.runCount, entry.frame.paletteSize, (unsigned)entry.bytes, (unsigned long)entry.lastShown);
+        else Serial.printf("  %-8s not cached\n", UI_PAGES[i].name);
+    }
+}
+
+// One fillRect per run of equal ramp colour (see lib/UvRamp), inside one startWrite/endWrite. fillRect
+// is virtual, so the same kernel fills the panel and a TFT_eSprite.
+void fillUvGradientBar(TFT_eSPI& gfx, int x, int baselineY, int width, int height, int fullScaleHeight) {
+    if (width <= 0) return;
+    UvRampBar bar;
+    uvRampBarBegin(bar, height, fullScaleHeight);
+    gfx.startWrite(); // Hold the bus across the runs
+    for (UvRampRun run; uvRampBarNext(bar, run);) gfx.fillRect(x, baselineY - run.firstRow - run.rows, width, run.rows, run.color);
+    gfx.endWrite();
 }
 
-void drawForecastGraph(int start_y_offset) {
+// Draws into any TFT_eSPI target: the panel, or a TFT_eSprite framebuffer (see the "bench" command).
+void drawForecastGraph(TFT_eSPI& gfx, int start_y_offset) {
     int padding = 2; 
     int first_uv_val_font = 6; 
     int other_uv_val_font = 4; 
     int hour_label_font = 2;   
     const int UV_TEXT_OUTLINE_THICKNESS = 2; // User can adjust this (e.g., 1 or 2) for thicker outline
 
-    tft.setTextFont(first_uv_val_font);
-    int first_uv_text_h = tft.fontHeight();
-    tft.setTextFont(other_uv_val_font);
-    int other_uv_text_h = tft.fontHeight();
-    tft.setTextFont(hour_label_font);
-    int hour_label_text_h = tft.fontHeight();
+    gfx.setTextFont(first_uv_val_font);
+    int first_uv_text_h = gfx.fontHeight();
+    gfx.setTextFont(other_uv_val_font);
+    int other_uv_text_h = gfx.fontHeight();
+    gfx.setTextFont(hour_label_font);
+    int hour_label_text_h = gfx.fontHeight();
 
     int first_uv_value_y = start_y_offset + padding + first_uv_text_h / 2;
     int other_uv_values_line_y = first_uv_value_y + (first_uv_text_h / 2) - (other_uv_text_h / 2);
     if (HOURLY_FORECAST_COUNT <= 1) other_uv_values_line_y = first_uv_value_y; 
 
-    int hour_label_y = tft.height() - padding - hour_label_text_h / 2;
+    int hour_label_y = gfx.height() - padding - hour_label_text_h / 2;
     int graph_baseline_y = hour_label_y - hour_label_text_h / 2 - padding;
 
     int max_bar_pixel_height = graph_baseline_y - (start_y_offset + padding);
     if (max_bar_pixel_height < 10) max_bar_pixel_height = 10;
-    if (max_bar_pixel_height < 20 && tft.height() > 100) max_bar_pixel_height = 20; 
+    if (max_bar_pixel_height < 20 && gfx.height() > 100) max_bar_pixel_height = 20; 
 
-    const float MAX_UV_FOR_FULL_SCALE = 8.0f; // Changed from 10.0f
+    const float MAX_UV_FOR_FULL_SCALE = (float)UV_GRAPH_FULL_SCALE; // Changed from 10.0f
     float pixel_per_uv_unit = 0;
     if (MAX_UV_FOR_FULL_SCALE > 0) {
         pixel_per_uv_unit = (float)max_bar_pixel_height / MAX_UV_FOR_FULL_SCALE;
     }
 
-    int graph_area_total_width = tft.width() - 2 * padding; 
+    int graph_area_total_width = gfx.width() - 2 * padding; 
     int bar_slot_width = graph_area_total_width / HOURLY_FORECAST_COUNT; 
     int bar_actual_width = bar_slot_width * 0.75; 
     if (bar_actual_width < 4) bar_actual_width = 4; 
     if (bar_actual_width > 30) bar_actual_width = 30; 
 
-    int graph_area_x_start = (tft.width() - (bar_slot_width * HOURLY_FORECAST_COUNT)) / 2 + padding;
+    int graph_area_x_start = (gfx.width() - (bar_slot_width * HOURLY_FORECAST_COUNT)) / 2 + padding;
+    const ForecastSnapshot& view = forecastSnapshots.front();
+    const int* forecastHours = view.forecastHours; // Shadow the network task's working copies
+    const float* hourlyUV = view.hourlyUV;
+    int nowQuarter = currentQuarterIndex(view);
 
     for (int i = 0; i < HOURLY_FORECAST_COUNT; ++i) {
         int bar_center_x = graph_area_x_start + (i * bar_slot_width) + (bar_slot_width / 2);
 
-        tft.setTextFont(hour_label_font);
-        tft.setTextColor(TFT_WHITE); // Text color for hour label (transparent background)
-        tft.setTextDatum(MC_DATUM); 
-        if (forecastHours[i] >= 0 && forecastHours[i] <= 23) { 
-            tft.drawString(String(forecastHours[i]), bar_center_x, hour_label_y);
+        gfx.setTextFont(hour_label_font);
+        gfx.setTextColor(TFT_WHITE); // Text color for hour label (transparent background)
+        gfx.setTextDatum(MC_DATUM); 
+        if (i == 0 && nowQuarter >= 0) {
+            char quarterLabel[6];
+            unsigned quarter = (unsigned)nowQuarter % 96u; // "23:45" at most
+            snprintf(quarterLabel, sizeof(quarterLabel), "%u:%02u", quarter / 4, (quarter % 4) * 15);
+            gfx.drawString(quarterLabel, bar_center_x, hour_label_y);
+        } else if (forecastHours[i] >= 0 && forecastHours[i] <= 23) { 
+            gfx.drawString(String(forecastHours[i]), bar_center_x, hour_label_y);
         } else {
-            tft.drawString("H?", bar_center_x, hour_label_y); 
+            gfx.drawString("H?", bar_center_x, hour_label_y); 
         }
 
-        float uvVal = hourlyUV[i];
+        float uvVal = (i == 0 && nowQuarter >= 0) ? view.day.uvQuarter[nowQuarter] / (float)UV_QUARTER_SCALE : hourlyUV[i];
         int roundedUV;
 
         if (uvVal == -1.0f) { 
@@ -1038,38 +3155,40 @@ void drawForecastGraph(int start_y_offset) {
             else if (roundedUV <= 10) barColor = TFT_RED;     
             else barColor = TFT_MAGENTA;                      
 
-            if (bar_height > 0) {
-                tft.fillRect(bar_center_x - bar_actual_width / 2, bar_top_y, bar_actual_width, bar_height, barColor);
+            if (bar_height > 0 && GRADIENT_UV_BARS && barColor != TFT_DARKGREY && barColor != TFT_MAGENTA) {
+                fillUvGradientBar(gfx, bar_center_x - bar_actual_width / 2, graph_baseline_y, bar_actual_width, bar_height, max_bar_pixel_height);
+            } else if (bar_height > 0) { // Extreme (11+) stays flat magenta, off the ramp
+                gfx.fillRect(bar_center_x - bar_actual_width / 2, bar_top_y, bar_actual_width, bar_height, barColor);
             } else if (roundedUV == 0) { 
-                 tft.drawFastHLine(bar_center_x - bar_actual_width / 4, graph_baseline_y -1, bar_actual_width / 2, barColor);
+                 gfx.drawFastHLine(bar_center_x - bar_actual_width / 4, graph_baseline_y -1, bar_actual_width / 2, barColor);
             }
 
-            tft.setTextDatum(MC_DATUM); 
+            gfx.setTextDatum(MC_DATUM); 
             String uvText = String(roundedUV); // Shows actual rounded UV, e.g. "11"
             int current_uv_text_y;
             uint16_t outlineColor = TFT_BLACK; 
             uint16_t foregroundColor = TFT_WHITE; 
 
             if (i == 0) { 
-                tft.setTextFont(first_uv_val_font);
+                gfx.setTextFont(first_uv_val_font);
                 current_uv_text_y = first_uv_value_y;
             } else { 
-                tft.setTextFont(other_uv_val_font);
+                gfx.setTextFont(other_uv_val_font);
                 current_uv_text_y = other_uv_values_line_y;
             }
 
             // Draw outline
-            tft.setTextColor(outlineColor); // Set outline color (e.g., black)
+            gfx.setTextColor(outlineColor); // Set outline color (e.g., black)
             for (int ox = -UV_TEXT_OUTLINE_THICKNESS; ox <= UV_TEXT_OUTLINE_THICKNESS; ++ox) {
                 for (int oy = -UV_TEXT_OUTLINE_THICKNESS; oy <= UV_TEXT_OUTLINE_THICKNESS; ++oy) {
                     if (ox == 0 && oy == 0) continue; // Don't draw the center with the outline color
-                    tft.drawString(uvText, bar_center_x + ox, current_uv_text_y + oy);
+                    gfx.drawString(uvText, bar_center_x + ox, current_uv_text_y + oy);
                 }
             }
 
             // Draw main text with transparent background
-            tft.setTextColor(foregroundColor); // Set foreground color (e.g., white)
-            tft.drawString(uvText, bar_center_x, current_uv_text_y);
+            gfx.setTextColor(foregroundColor); // Set foreground color (e.g., white)
+            gfx.drawString(uvText, bar_center_x, current_uv_text_y);
 
 
         } else { 
@@ -1082,10 +3201,10 @@ void drawForecastGraph(int start_y_offset) {
                 placeholder_font = other_uv_val_font;
                 placeholder_y = other_uv_values_line_y;
             }
-            tft.setTextFont(placeholder_font);
-            tft.setTextColor(TFT_DARKGREY); // Transparent background for placeholder
-            tft.setTextDatum(MC_DATUM);
-            tft.drawString("-", bar_center_x, placeholder_y); 
+            gfx.setTextFont(placeholder_font);
+            gfx.setTextColor(TFT_DARKGREY); // Transparent background for placeholder
+            gfx.setTextDatum(MC_DATUM);
+            gfx.drawString("-", bar_center_x, placeholder_y); 
         }
     }
     #if DEBUG_GRAPH_DRAWING
@@ -1104,44 +3223,45 @@ void connectToWiFi(bool silent) {
     else Serial.println("LPM Silent: Connecting to WiFi...");
     #endif
 
-    WiFi.mode(WIFI_STA);
-    WiFi.disconnect(true,true); 
-    delay(100); 
+    // An association started by the boot sequencer is to the first configured SSID; resume it.
+    bool resumeEarlyAssoc = wifiEarlyAssocPending;
+    wifiEarlyAssocPending = false;
+    int64_t connectStartUs = resumeEarlyAssoc ? wifiEarlyAssocStartUs : esp_timer_get_time();
+    if (!resumeEarlyAssoc) {
+        WiFi.mode(WIFI_STA);
+        WiFi.disconnect(true,true); 
+        delay(100); 
+    }
 
     bool connected = false;
     String connected_ssid = "";
-
-    const char* ssids[] = {
-        WIFI_SSID_1, 
-        WIFI_SSID_2
-        #if defined(WIFI_SSID_3)
-        , WIFI_SSID_3
-        #endif
-        #if defined(WIFI_SSID_4)
-        , WIFI_SSID_4
-        #endif
-    };
-    const char* passwords[] = {
-        WIFI_PASS_1, 
-        WIFI_PASS_2
-        #if defined(WIFI_SSID_3) 
-        , WIFI_PASS_3
-        #endif
-        #if defined(WIFI_SSID_4) 
-        , WIFI_PASS_4
-        #endif
-    };
-    int num_networks = sizeof(ssids) / sizeof(ssids[0]);
+    const char* const* ssids = WIFI_SSIDS;
+    const char* const* passwords = WIFI_PASSWORDS;
+    int num_networks = WIFI_NETWORK_COUNT;
 
     for (int i = 0; i < num_networks; ++i) {
         if (strlen(ssids[i]) > 0) { 
             if (!silent) {Serial.print("Attempting SSID: "); Serial.println(ssids[i]);}
-            WiFi.begin(ssids[i], passwords[i]);
-            unsigned long startTime = millis();
+            int64_t attemptStartUs;
+            unsigned long startTime;
+            if (resumeEarlyAssoc) {
+                resumeEarlyAssoc = false;
+                attemptStartUs = wifiEarlyAssocStartUs;
+                startTime = millis() - (unsigned long)((esp_timer_get_time() - wifiEarlyAssocStartUs) / 1000);
+            } else {
+                wifiStaConnectedUs = 0;
+                attemptStartUs = esp_timer_get_time();
+                WiFi.begin(ssids[i], passwords[i]);
+                startTime = millis();
+            }
             while (WiFi.status() != WL_CONNECTED && (millis() - startTime) < WIFI_CONNECTION_TIMEOUT_MS) {
                 delay(100);
                 if (!silent && (millis() - startTime) % 1000 < 100) Serial.print("."); 
             }
+            int64_t attemptEndUs = esp_timer_get_time();
+            int64_t assocEndUs = (wifiStaConnectedUs > attemptStartUs) ? wifiStaConnectedUs : attemptEndUs;
+            energyPhaseAdd(ENERGY_PHASE_WIFI_ASSOC, assocEndUs - attemptStartUs);
+            energyPhaseAdd(ENERGY_PHASE_DHCP, attemptEndUs - assocEndUs);
 
             if (WiFi.status() == WL_CONNECTED) {
                 connected = true;
@@ -1157,6 +3277,7 @@ void connectToWiFi(bool silent) {
 
     isConnectingToWiFi = false; 
     force_display_update = true; 
+    telemetryLog(TELEMETRY_EVENT_WIFI_CONNECT, connected ? telemetrySaturate((esp_timer_get_time() - connectStartUs) / 1000) : 0xFFFF);
 
     if (connected) {
         if (!silent) {
@@ -1169,6 +3290,7 @@ void connectToWiFi(bool silent) {
         #endif
         
         if (!silent) Serial.println("Configuring time via NTP (UTC initial)...");
+        energyPhaseBegin(ENERGY_PHASE_NTP);
         configTime(0, 0, "pool.ntp.org", "time.nist.gov"); 
         
         struct tm timeinfo;
@@ -1177,6 +3299,7 @@ void connectToWiFi(bool silent) {
         } else {
             if (!silent) Serial.println("Initial time configured via NTP (UTC).");
         }
+        energyPhaseEnd(ENERGY_PHASE_NTP);
     } else { 
         if (!silent) {
             Serial.println("\nCould not connect to any configured WiFi network.");
@@ -1187,27 +3310,26 @@ void connectToWiFi(bool silent) {
     }
 }
 
-bool fetchLocationFromIp(bool silent) {
+// Fills fix (label "IP: <city>", epoch left to the caller) on success. Touches none of the coordinates in use.
+bool fetchLocationFromIp(bool silent, LocationFix& fix) {
     if (WiFi.status() != WL_CONNECTED) {
         if (!silent) Serial.println("Cannot fetch IP location: WiFi not connected.");
         #if DEBUG_LPM
         else Serial.println("LPM Silent: Cannot fetch IP location, no WiFi.");
         #endif
-        locationDisplayStr = "IP (NoNet)"; 
         return false;
     }
 
-    HTTPClient http;
-    String url = "http://ip-api.com/json/?fields=status,message,lat,lon,city"; 
-
-    if (!silent) {Serial.print("Fetching IP Geolocation: "); Serial.println(url);}
+    if (!silent) Serial.println("Fetching IP Geolocation from " IP_GEO_HOST);
     #if DEBUG_LPM
     else Serial.println("LPM Silent: Fetching IP Geolocation...");
     #endif
 
-    http.begin(url);
-    http.setTimeout(10000); 
-    int httpCode = http.GET();
+    WiFiClient client;
+    client.connect(IP_GEO_HOST, 80);
+    HttpResponseReader response(client);
+    int httpCode = response.get(IP_GEO_REQUEST, sizeof(IP_GEO_REQUEST) - 1, 10000);
+    telemetryLog(TELEMETRY_EVENT_HTTP_GEO, telemetrySigned(httpCode));
 
     if (!silent) {Serial.print("IP Geolocation HTTP Code: "); Serial.println(httpCode);}
     #if DEBUG_LPM
@@ -1215,54 +3337,159 @@ bool fetchLocationFromIp(bool silent) {
     #endif
 
     bool success = false;
-    if (httpCode == HTTP_CODE_OK) {
-        String payload = http.getString();
-        if (!silent) Serial.println("IP Geolocation Payload: " + payload);
-
+    if (httpCode == HTTP_STATUS_OK) {
         JsonDocument doc; 
-        DeserializationError error = deserializeJson(doc, payload);
+        DeserializationError error = response.parseJson(doc, GEO_RESPONSE_MAX_BYTES);
+        ResponseReadResult readResult = response.readResult;
+        telemetryLog(TELEMETRY_EVENT_PAYLOAD_GEO, telemetrySaturate(response.bodyBytes));
+        if (readResult != RESPONSE_READ_OK) Serial.printf("IP Geolocation response dropped: %s\n", RESPONSE_READ_RESULT_NAMES[readResult]);
+        else if (!silent) {
+            Serial.printf("IP Geolocation: %u bytes in %lu ms, %lu bytes heap\n", (unsigned)response.bodyBytes,
+                          (unsigned long)response.elapsedMs(), (unsigned long)response.heapPeakBytes());
+            if (!error) {Serial.print("IP Geolocation Payload: "); serializeJson(doc, Serial); Serial.println();}
+        }
 
         if (error) {
             if (!silent) {Serial.print(F("deserializeJson() for IP Geo failed: ")); Serial.println(error.c_str());}
             #if DEBUG_LPM
             else Serial.printf("LPM Silent: IP Geo JSON deserialize failed: %s\n", error.c_str());
             #endif
-            locationDisplayStr = "IP (JSON Err)";
         } else {
             if (!doc["status"].isNull() && strcmp(doc["status"], "success") == 0) {
-                deviceLatitude = doc["lat"].as<float>();
-                deviceLongitude = doc["lon"].as<float>();
+                fix.latitude = doc["lat"].as<float>();
+                fix.longitude = doc["lon"].as<float>();
                 const char* city = doc["city"];
-                if (city) {
-                    locationDisplayStr = String("IP: ") + city;
-                } else {
-                    locationDisplayStr = "IP: Unknown";
-                }
+                snprintf(fix.label, sizeof(fix.label), "IP: %s", city ? city : "Unknown");
                 
-                if (!silent) Serial.printf("IP Geo Location: Lat=%.4f, Lon=%.4f, City=%s\n", deviceLatitude, deviceLongitude, city ? city : "N/A");
+                if (!silent) Serial.printf("IP Geo Location: Lat=%.4f, Lon=%.4f, City=%s\n", fix.latitude, fix.longitude, city ? city : "N/A");
                 #if DEBUG_LPM
-                else Serial.printf("LPM Silent: IP Geo Success: Lat=%.2f Lon=%.2f City=%s\n", deviceLatitude, deviceLongitude, city ? city : "N/A");
+                else Serial.printf("LPM Silent: IP Geo Success: Lat=%.2f Lon=%.2f City=%s\n", fix.latitude, fix.longitude, city ? city : "N/A");
                 #endif
-                
-                rtc_deviceLatitude = deviceLatitude;
-                rtc_deviceLongitude = deviceLongitude;
-                strncpy(rtc_locationDisplayStr_char, locationDisplayStr.c_str(), sizeof(rtc_locationDisplayStr_char) - 1);
-                rtc_locationDisplayStr_char[sizeof(rtc_locationDisplayStr_char) - 1] = '\0';
                 success = true;
             } else { 
                 const char* msg = doc["message"];
                 if (!silent) Serial.printf("IP Geolocation API Error: %s\n", msg ? msg : "Unknown error");
-                locationDisplayStr = String("IP (API Err)");
             }
         }
-    } else { 
-        locationDisplayStr = String("IP (HTTP Err ") + String(httpCode) + String(")");
     }
-    http.end();
     return success;
 }
 
+// Pure part of the Open-Meteo parse: HOURLY_FORECAST_COUNT hours starting at the first entry at or
+// after currentHourLocal. Slots the payload does not cover are projected with 0 UV.
+HourlyParseResult extractHourlyForecast(JsonDocument& doc, int currentHourLocal, float* uvOut, int* hoursOut) {
+    bool hasHourly = !doc["hourly"].isNull() && !doc["hourly"]["time"].isNull() && !doc["hourly"]["uv_index"].isNull();
+    JsonArray hourly_time_list = doc["hourly"]["time"].as<JsonArray>();
+    JsonArray hourly_uv_list = doc["hourly"]["uv_index"].as<JsonArray>();
+    int startIndex = -1;
+    if (hasHourly) {
+        for (size_t k = 0; k < hourly_time_list.size(); ++k) {
+            String api_time_str = hourly_time_list[k].as<String>(); 
+            if (api_time_str.length() >= 13) { 
+                int api_hour = api_time_str.substring(11, 13).toInt();
+                if (api_hour >= currentHourLocal) {
+                    startIndex = (int)k;
+                    break;
+                }
+            }
+        }
+    }
+    for (int i = 0; i < HOURLY_FORECAST_COUNT; ++i) {
+        if (startIndex != -1 && ((size_t)(startIndex + i) < hourly_uv_list.size()) && ((size_t)(startIndex + i) < hourly_time_list.size())) {
+            JsonVariant uv_val_variant = hourly_uv_list[startIndex + i];
+            uvOut[i] = uv_val_variant.isNull() ? 0.0f : uv_val_variant.as<float>();
+            if (uvOut[i] < 0) uvOut[i] = 0.0f; 
+
+            String api_t_str = hourly_time_list[startIndex + i].as<String>();
+            hoursOut[i] = api_t_str.substring(11, 13).toInt();
+        } else {
+            hoursOut[i] = (currentHourLocal + i) % 24; 
+            uvOut[i] = 0.0f;
+        }
+    }
+    if (!hasHourly) return HOURLY_PARSE_MISSING;
+    return (startIndex == -1) ? HOURLY_PARSE_NO_START : HOURLY_PARSE_OK;
+}
+
+// Day products for the payload's first (local) day, from the same pass over the hourly arrays.
+// Hours the payload lacks are 0 UV. Leaves dayOfYear to the caller.
+bool extractDayForecast(JsonDocument& doc, DayForecast* dayOut) {
+    JsonArray timeList = doc["hourly"]["time"].as<JsonArray>();
+    JsonArray uvList = doc["hourly"]["uv_index"].as<JsonArray>();
+    if (timeList.isNull() || uvList.isNull() || timeList.size() == 0) return false;
+    float knots[24] = {};
+    int found = 0;
+    const char* firstTime = timeList[0].as<const char*>();
+    for (size_t k = 0; k < timeList.size() && k < uvList.size(); ++k) {
+        const char* isoTime = timeList[k].as<const char*>(); // "YYYY-MM-DDTHH:MM"
+        if (!isoTime || !firstTime || strlen(isoTime) < 13 || strncmp(isoTime, firstTime, 10) != 0) continue;
+        int hour = atoi(isoTime + 11);
+        if (hour < 0 || hour > 23) continue;
+        float uv = uvList[k].isNull() ? 0.0f : uvList[k].as<float>();
+        knots[hour] = uv > 0.0f ? uv : 0.0f;
+        found++;
+    }
+    if (found < 2) return false;
+    monotoneCubicQuarterHours(knots, dayOut->uvQuarter);
+    buildDayUvAnalytics(knots, dayOut);
+    return true;
+}
+
+// Overlay line: today's peak and the next window of "high" UV (WHO_UV_LEVEL_HIGH), empty if the day is unknown.
+String dayPeakText(const DayForecast& day) {
+    time_t now = time(nullptr);
+    struct tm localNow;
+    if (day.dayOfYear < 0 || now < 1600000000 || !localtime_r(&now, &localNow) || localNow.tm_yday != day.dayOfYear) return "";
+    char text[40];
+    int len = snprintf(text, sizeof(text), "Peak %.1f @%dh", day.peakUV / (float)UV_QUARTER_SCALE, day.peakHour);
+    int start = uvNextHourAtOrAbove(day, WHO_UV_LEVEL_HIGH, localNow.tm_hour);
+    if (start >= 0) snprintf(text + len, sizeof(text) - len, "  %d+ %d-%dh", (int)WHO_UV_THRESHOLDS[WHO_UV_LEVEL_HIGH], start,
+                             uvWindowEndHour(day, WHO_UV_LEVEL_HIGH, start));
+    return String(text);
+}
+
+void dumpDayForecast() {
+    uvDoseTick(); // Acquires the latest snapshot
+    const DayForecast& day = forecastSnapshots.front().day;
+    if (day.dayOfYear < 0) {
+        Serial.println("No day forecast (needs a parsed Open-Meteo payload).");
+        return;
+    }
+    Serial.printf("Day %d: peak UV %.1f at %02d:00\n", day.dayOfYear + 1, day.peakUV / (float)UV_QUARTER_SCALE, day.peakHour);
+    for (int level = 0; level < WHO_UV_LEVEL_COUNT; ++level) {
+        Serial.printf("  %-9s (>= %2.0f):", WHO_UV_LEVEL_NAMES[level], WHO_UV_THRESHOLDS[level]);
+        int h = uvNextHourAtOrAbove(day, level, 0);
+        if (h < 0) Serial.print(" none");
+        while (h >= 0) {
+            int end = uvWindowEndHour(day, level, h);
+            Serial.printf(" %02d-%02dh", h, end);
+            h = (end < 24) ? uvNextHourAtOrAbove(day, level, end) : -1;
+        }
+        Serial.println();
+    }
+    Serial.print("  by UV:");
+    for (int i = 0; i < 24 && day.uvQuarter[day.hoursByUv[i] * 4] > 0; ++i) Serial.printf(" %d", day.hoursByUv[i]);
+    Serial.println();
+}
+
+// dayQuarterIndex() for the snapshot at the current local time.
+int currentQuarterIndex(const ForecastSnapshot& view) {
+    if (!QUARTER_HOUR_FORECAST || view.day.dayOfYear < 0) return -1;
+    time_t now = time(nullptr);
+    if (now < 1600000000) return -1;
+    struct tm localNow;
+    localtime_r(&now, &localNow);
+    return dayQuarterIndex(view.day, view.forecastHours[0], localNow);
+}
+
+uint32_t msUntilNextQuarterHour() {
+    time_t now = time(nullptr);
+    if (now < 1600000000) return SCHEDULER_RETRY_MS;
+    return (uint32_t)(900 - now % 900 + 1) * 1000; // +1 s so the redraw lands inside the new quarter
+}
+
 bool fetchUVData(bool silent) {
+    dayForecast.dayOfYear = -1; // Set again only from a parsed payload
     if (WiFi.status() != WL_CONNECTED) {
         if (!silent) Serial.println("WiFi not connected, cannot fetch UV data.");
         #if DEBUG_LPM
@@ -1284,23 +3511,29 @@ bool fetchUVData(bool silent) {
         lastUpdateTimeStr = "Offline";
         strncpy(rtc_lastUpdateTimeStr_char, "Offline", sizeof(rtc_lastUpdateTimeStr_char)-1);
         rtc_lastUpdateTimeStr_char[sizeof(rtc_lastUpdateTimeStr_char)-1] = '\0';
+        rtc_lastFetchFromApi = false;
         dataJustFetched = true; 
         return false; 
     }
 
-    HTTPClient http;
-    String apiUrl = openMeteoUrl + "?latitude=" + String(deviceLatitude, 4) +
-                    "&longitude=" + String(deviceLongitude, 4) +
-                    "&hourly=uv_index&forecast_days=1&timezone=auto";
+    char request[sizeof(OPEN_METEO_REQUEST_FORMAT) + 16]; // Each %.4f grows by at most 5 characters
+    int requestLength = snprintf(request, sizeof(request), OPEN_METEO_REQUEST_FORMAT, deviceLatitude, deviceLongitude);
 
-    if (!silent) {Serial.print("Fetching UV Data from URL: "); Serial.println(apiUrl);}
+    if (!silent) Serial.printf("Fetching UV Data from " OPEN_METEO_HOST " for %.4f, %.4f\n", deviceLatitude, deviceLongitude);
     #if DEBUG_LPM
     else Serial.println("LPM Silent: Fetching UV data...");
     #endif
 
-    http.begin(apiUrl);
-    http.setTimeout(15000); 
-    int httpCode = http.GET();
+    WiFiClientSecure tlsClient;
+    tlsClient.setInsecure(); // No CA pinned, as with HTTPClient's built-in https client before
+    energyPhaseBegin(ENERGY_PHASE_TLS);
+    tlsClient.connect(OPEN_METEO_HOST, 443);
+    energyPhaseEnd(ENERGY_PHASE_TLS);
+
+    energyPhaseBegin(ENERGY_PHASE_UV_FETCH);
+    HttpResponseReader response(tlsClient);
+    int httpCode = response.get(request, requestLength, 15000);
+    telemetryLog(TELEMETRY_EVENT_HTTP_UV, telemetrySigned(httpCode));
 
     if (!silent) {Serial.print("Open-Meteo API HTTP Code: "); Serial.println(httpCode);}
     #if DEBUG_LPM
@@ -1310,10 +3543,22 @@ bool fetchUVData(bool silent) {
     bool actualDataParsedFromApi = false; 
     rtc_hasValidData = false; 
 
-    if (httpCode == HTTP_CODE_OK) {
-        String payload = http.getString();
+    float previousUV[HOURLY_FORECAST_COUNT]; // Last forecast, for the adaptive cadence revision delta
+    int previousHours[HOURLY_FORECAST_COUNT];
+    memcpy(previousUV, hourlyUV, sizeof(previousUV));
+    memcpy(previousHours, forecastHours, sizeof(previousHours));
+
+    if (httpCode == HTTP_STATUS_OK) {
+        // The body is parsed as it arrives, so deserializing counts towards the fetch phase; parse is what follows.
+        // A dropped or cut-off body fails to parse and takes the JSON error path below (projected 0 UV).
         JsonDocument doc; 
-        DeserializationError error = deserializeJson(doc, payload);
+        DeserializationError error = response.parseJson(doc, UV_RESPONSE_MAX_BYTES);
+        telemetryLog(TELEMETRY_EVENT_PAYLOAD_UV, telemetrySaturate(response.bodyBytes));
+        if (response.readResult != RESPONSE_READ_OK) Serial.printf("Open-Meteo response dropped: %s\n", RESPONSE_READ_RESULT_NAMES[response.readResult]);
+        else if (!silent) Serial.printf("Open-Meteo: %u bytes in %lu ms, %lu bytes heap\n", (unsigned)response.bodyBytes,
+                                        (unsigned long)response.elapsedMs(), (unsigned long)response.heapPeakBytes());
+        energyPhaseEnd(ENERGY_PHASE_UV_FETCH);
+        energyPhaseBegin(ENERGY_PHASE_PARSE);
 
         if (error) {
             if (!silent) {Serial.print(F("deserializeJson() for UV data failed: ")); Serial.println(error.c_str());}
@@ -1351,67 +3596,25 @@ bool fetchUVData(bool silent) {
                 #endif
                 initializeForecastData(true); 
             } else {
-                int currentHourLocal = timeinfo.tm_hour;
-                int startIndex = -1; 
-
-                if (!doc["hourly"].isNull() && !doc["hourly"]["time"].isNull() && !doc["hourly"]["uv_index"].isNull()) {
-                    JsonArray hourly_time_list = doc["hourly"]["time"].as<JsonArray>();
-                    JsonArray hourly_uv_list = doc["hourly"]["uv_index"].as<JsonArray>();
-
-                    for (int k = 0; k < hourly_time_list.size(); ++k) {
-                        String api_time_str = hourly_time_list[k].as<String>(); 
-                        if (api_time_str.length() >= 13) { 
-                            int api_hour = api_time_str.substring(11, 13).toInt();
-                            if (api_hour >= currentHourLocal) {
-                                startIndex = k;
-                                break;
-                            }
-                        }
-                    }
-
-                    if (startIndex != -1) { 
-                        for (int i = 0; i < HOURLY_FORECAST_COUNT; ++i) {
-                            if ((startIndex + i < hourly_uv_list.size()) && (startIndex + i < hourly_time_list.size())) {
-                                JsonVariant uv_val_variant = hourly_uv_list[startIndex + i];
-                                hourlyUV[i] = uv_val_variant.isNull() ? 0.0f : uv_val_variant.as<float>();
-                                if (hourlyUV[i] < 0) hourlyUV[i] = 0.0f; 
-
-                                String api_t_str = hourly_time_list[startIndex + i].as<String>();
-                                forecastHours[i] = api_t_str.substring(11, 13).toInt();
-                                actualDataParsedFromApi = true; 
-                            } else {
-                                forecastHours[i] = (currentHourLocal + i) % 24; 
-                                hourlyUV[i] = 0.0f;
-                            }
-                            rtc_hourlyUV[i] = hourlyUV[i];
-                            rtc_forecastHours[i] = forecastHours[i];
-                        }
-                        rtc_hasValidData = true; 
-                        if (!silent && actualDataParsedFromApi) Serial.println("Successfully populated forecast data (some/all from API).");
-                        else if (!silent) Serial.println("Populated forecast with projections as API data was insufficient/missing for some future slots.");
-
-                    } else { 
-                        if (!silent) Serial.println("No suitable starting forecast index in API. Projecting all hours with 0 UV.");
-                        for (int i = 0; i < HOURLY_FORECAST_COUNT; ++i) {
-                            forecastHours[i] = (currentHourLocal + i) % 24; 
-                            hourlyUV[i] = 0.0f;                             
-                            rtc_forecastHours[i] = forecastHours[i];
-                            rtc_hourlyUV[i] = hourlyUV[i];
-                        }
-                        rtc_hasValidData = true; 
-                    }
-                } else { 
-                     if (!silent) Serial.println("Hourly data structure missing/incomplete in JSON. Projecting all hours with 0 UV.");
-                     for (int i = 0; i < HOURLY_FORECAST_COUNT; ++i) {
-                        forecastHours[i] = (currentHourLocal + i) % 24;
-                        hourlyUV[i] = 0.0f;
-                        rtc_forecastHours[i] = forecastHours[i];
-                        rtc_hourlyUV[i] = hourlyUV[i];
-                    }
-                    rtc_hasValidData = true;
+                HourlyParseResult parseResult = extractHourlyForecast(doc, timeinfo.tm_hour, hourlyUV, forecastHours);
+                if (extractDayForecast(doc, &dayForecast)) dayForecast.dayOfYear = timeinfo.tm_yday;
+                for (int i = 0; i < HOURLY_FORECAST_COUNT; ++i) {
+                    rtc_hourlyUV[i] = hourlyUV[i];
+                    rtc_forecastHours[i] = forecastHours[i];
+                }
+                rtc_hasValidData = true;
+                actualDataParsedFromApi = (parseResult == HOURLY_PARSE_OK);
+                if (parseResult == HOURLY_PARSE_OK) {
+                    updateAdaptiveCadence(previousUV, previousHours, timeinfo);
+                    if (!silent) Serial.println("Successfully populated forecast data (some/all from API).");
+                } else if (parseResult == HOURLY_PARSE_NO_START) {
+                    if (!silent) Serial.println("No suitable starting forecast index in API. Projecting all hours with 0 UV.");
+                } else {
+                    if (!silent) Serial.println("Hourly data structure missing/incomplete in JSON. Projecting all hours with 0 UV.");
                 }
             }
         }
+        energyPhaseEnd(ENERGY_PHASE_PARSE);
         struct tm timeinfo_update;
         if(getLocalTime(&timeinfo_update, 1000)){ 
             char timeStrBuffer[16];
@@ -1427,6 +3630,7 @@ bool fetchUVData(bool silent) {
             lastUpdateTimeStr = "Time Err";
         }
     } else { 
+        energyPhaseEnd(ENERGY_PHASE_UV_FETCH);
         struct tm timeinfo_http_fail;
         if (getLocalTime(&timeinfo_http_fail, 1000)) {
             for (int i = 0; i < HOURLY_FORECAST_COUNT; ++i) {
@@ -1447,8 +3651,8 @@ bool fetchUVData(bool silent) {
     }
     strncpy(rtc_lastUpdateTimeStr_char, lastUpdateTimeStr.c_str(), sizeof(rtc_lastUpdateTimeStr_char)-1);
     rtc_lastUpdateTimeStr_char[sizeof(rtc_lastUpdateTimeStr_char)-1] = '\0';
+    if (!actualDataParsedFromApi) rtc_lastFetchFromApi = false; // Working data is now projected zeros
 
-    http.end();
     dataJustFetched = true; 
     return actualDataParsedFromApi; 
 }
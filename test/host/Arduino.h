@@ -0,0 +1,359 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// Host shim of the ESP32 Arduino core (2.x) for the native simulation suites: the subset src/main.cpp
+// uses, on the virtual clock of host_sim.h. Like the ESP32 core's Arduino.h it also brings in FreeRTOS,
+// esp_timer and the sleep API.
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <algorithm>
+#include <string>
+
+// ArduinoJson keys its String/Stream/Print support off ARDUINO, which the host build does not define.
+#define ARDUINOJSON_ENABLE_ARDUINO_STRING 1
+#define ARDUINOJSON_ENABLE_ARDUINO_STREAM 1
+#define ARDUINOJSON_ENABLE_ARDUINO_PRINT 1
+#define ARDUINOJSON_ENABLE_PROGMEM 0
+
+#include <host_sim.h>
+#include <esp_err.h>
+#include <esp_timer.h>
+#include <esp_sleep.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define ONLOW 0x04
+#define ONHIGH 0x05
+#define ONLOW_WE 0x0C
+#define ONHIGH_WE 0x0D
+#define DEC 10
+#define HEX 16
+#define PI 3.1415926535897932384626433832795
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define PROGMEM
+#define RTC_DATA_ATTR __attribute__((section("rtc_sim_data")))
+#define F(string) (string)
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+using std::max;
+using std::min;
+
+// --- String ---
+class String {
+public:
+    String(const char* text = "") : s(text ? text : "") {}
+    String(const std::string& text) : s(text) {}
+    explicit String(char c) : s(1, c) {}
+    explicit String(int value, unsigned char base = 10) : s(formatInteger((long long)value, base)) {}
+    explicit String(unsigned int value, unsigned char base = 10) : s(formatInteger((long long)value, base)) {}
+    explicit String(long value, unsigned char base = 10) : s(formatInteger((long long)value, base)) {}
+    explicit String(unsigned long value, unsigned char base = 10) : s(formatInteger((long long)value, base)) {}
+    explicit String(float value, unsigned int decimals = 2) : s(formatFloat(value, decimals)) {}
+    explicit String(double value, unsigned int decimals = 2) : s(formatFloat(value, decimals)) {}
+
+    const char* c_str() const { return s.c_str(); }
+    unsigned int length() const { return (unsigned int)s.size(); }
+    bool isEmpty() const { return s.empty(); }
+    bool reserve(unsigned int size) { s.reserve(size); return true; }
+    char charAt(unsigned int index) const { return index < s.size() ? s[index] : 0; }
+    char operator[](unsigned int index) const { return charAt(index); }
+    char& operator[](unsigned int index) { return s[index]; }
+    String substring(unsigned int from) const { return from < s.size() ? String(s.substr(from)) : String(); }
+    String substring(unsigned int from, unsigned int to) const {
+        if (from > to) std::swap(from, to);
+        if (from >= s.size()) return String();
+        return String(s.substr(from, std::min<size_t>(to, s.size()) - from));
+    }
+    int indexOf(char c, unsigned int from = 0) const { return position(s.find(c, from)); }
+    int indexOf(const char* text, unsigned int from = 0) const { return position(s.find(text, from)); }
+    int indexOf(const String& text, unsigned int from = 0) const { return position(s.find(text.s, from)); }
+    int lastIndexOf(char c) const { return position(s.rfind(c)); }
+    bool startsWith(const String& prefix) const { return s.compare(0, prefix.s.size(), prefix.s) == 0; }
+    bool endsWith(const String& suffix) const {
+        return s.size() >= suffix.s.size() && s.compare(s.size() - suffix.s.size(), suffix.s.size(), suffix.s) == 0;
+    }
+    bool equals(const String& other) const { return s == other.s; }
+    bool equalsIgnoreCase(const String& other) const { return strcasecmp(s.c_str(), other.s.c_str()) == 0; }
+    long toInt() const { return atol(s.c_str()); }
+    float toFloat() const { return (float)atof(s.c_str()); }
+    void trim() {
+        size_t first = s.find_first_not_of(" \t\r\n"), last = s.find_last_not_of(" \t\r\n");
+        s = (first == std::string::npos) ? std::string() : s.substr(first, last - first + 1);
+    }
+    void toLowerCase() { for (char& c : s) c = (char)tolower((unsigned char)c); }
+    void toUpperCase() { for (char& c : s) c = (char)toupper((unsigned char)c); }
+    void remove(unsigned int index, unsigned int count = (unsigned int)-1) { if (index < s.size()) s.erase(index, count); }
+    void replace(const String& from, const String& to) {
+        if (from.s.empty()) return;
+        for (size_t at = s.find(from.s); at != std::string::npos; at = s.find(from.s, at + to.s.size())) s.replace(at, from.s.size(), to.s);
+    }
+    bool concat(const String& other) { s += other.s; return true; }
+    bool concat(const char* text) { if (text) s += text; return true; }
+    bool concat(const char* text, unsigned int length) { if (text) s.append(text, length); return true; }
+    bool concat(char c) { s += c; return true; }
+
+    String& operator=(const char* text) { s = text ? text : ""; return *this; }
+    String& operator+=(const String& other) { s += other.s; return *this; }
+    String& operator+=(const char* text) { if (text) s += text; return *this; }
+    String& operator+=(char c) { s += c; return *this; }
+    String& operator+=(int value) { s += formatInteger(value, 10); return *this; }
+    String& operator+=(unsigned int value) { s += formatInteger(value, 10); return *this; }
+    String& operator+=(long value) { s += formatInteger(value, 10); return *this; }
+    String& operator+=(unsigned long value) { s += formatInteger((long long)value, 10); return *this; }
+    bool operator==(const String& other) const { return s == other.s; }
+    bool operator==(const char* text) const { return s == (text ? text : ""); }
+    bool operator!=(const String& other) const { return s != other.s; }
+    bool operator!=(const char* text) const { return !(*this == text); }
+    bool operator<(const String& other) const { return s < other.s; }
+
+    friend String operator+(const String& a, const String& b) { return String(a.s + b.s); }
+    friend String operator+(const String& a, const char* b) { return String(a.s + (b ? b : "")); }
+    friend String operator+(const char* a, const String& b) { return String(std::string(a ? a : "") + b.s); }
+    friend String operator+(const String& a, char b) { return String(a.s + b); }
+    friend String operator+(const String& a, int b) { return String(a.s + formatInteger(b, 10)); }
+    friend String operator+(const String& a, unsigned int b) { return String(a.s + formatInteger(b, 10)); }
+    friend String operator+(const String& a, long b) { return String(a.s + formatInteger(b, 10)); }
+    friend String operator+(const String& a, unsigned long b) { return String(a.s + formatInteger((long long)b, 10)); }
+    friend String operator+(const String& a, float b) { return String(a.s + formatFloat(b, 2)); }
+    friend String operator+(const String& a, double b) { return String(a.s + formatFloat(b, 2)); }
+
+private:
+    static int position(size_t at) { return at == std::string::npos ? -1 : (int)at; }
+    static std::string formatInteger(long long value, unsigned char base) {
+        char buffer[72];
+        if (base == 16) snprintf(buffer, sizeof(buffer), "%llx", (unsigned long long)value);
+        else snprintf(buffer, sizeof(buffer), "%lld", value);
+        return buffer;
+    }
+    static std::string formatFloat(double value, unsigned int decimals) {
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "%.*f", (int)decimals, value);
+        return buffer;
+    }
+    std::string s;
+};
+
+// --- Print / Stream ---
+class Print;
+class Printable {
+public:
+    virtual ~Printable() {}
+    virtual size_t printTo(Print& p) const = 0;
+};
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        size_t n = 0;
+        while (size--) n += write(*buffer++);
+        return n;
+    }
+    size_t write(const char* text) { return text ? write((const uint8_t*)text, strlen(text)) : 0; }
+    virtual void flush() {}
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        char small[256];
+        va_list args;
+        va_start(args, format);
+        int length = vsnprintf(small, sizeof(small), format, args);
+        va_end(args);
+        if (length < 0) return 0;
+        if ((size_t)length < sizeof(small)) return write((const uint8_t*)small, (size_t)length);
+        std::string large((size_t)length + 1, '\0');
+        va_start(args, format);
+        vsnprintf(&large[0], large.size(), format, args);
+        va_end(args);
+        return write((const uint8_t*)large.data(), (size_t)length);
+    }
+    size_t print(const String& s) { return write((const uint8_t*)s.c_str(), s.length()); }
+    size_t print(const char* s) { return write(s); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int value, int base = DEC) { return print((long)value, base); }
+    size_t print(unsigned int value, int base = DEC) { return print((unsigned long)value, base); }
+    size_t print(long value, int base = DEC) { return base == HEX ? printf("%lx", value) : printf("%ld", value); }
+    size_t print(unsigned long value, int base = DEC) { return base == HEX ? printf("%lx", value) : printf("%lu", value); }
+    size_t print(long long value, int base = DEC) { return base == HEX ? printf("%llx", value) : printf("%lld", value); }
+    size_t print(unsigned long long value, int base = DEC) { return base == HEX ? printf("%llx", value) : printf("%llu", value); }
+    size_t print(double value, int decimals = 2) { return printf("%.*f", decimals, value); }
+    size_t print(const Printable& p) { return p.printTo(*this); }
+    size_t println() { return write((const uint8_t*)"\r\n", 2); }
+    template <typename T> size_t println(const T& value) { size_t n = print(value); return n + println(); }
+    template <typename T> size_t println(const T& value, int format) { size_t n = print(value, format); return n + println(); }
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    void setTimeout(unsigned long timeoutMs) { timeoutMs_ = timeoutMs; }
+    size_t readBytes(char* buffer, size_t length) {
+        size_t count = 0;
+        while (count < length) {
+            int c = timedRead();
+            if (c < 0) break;
+            buffer[count++] = (char)c;
+        }
+        return count;
+    }
+    size_t readBytes(uint8_t* buffer, size_t length) { return readBytes((char*)buffer, length); }
+    String readStringUntil(char terminator) {
+        String out;
+        for (int c = timedRead(); c >= 0 && c != terminator; c = timedRead()) out += (char)c;
+        return out;
+    }
+
+protected:
+    // As in the core: retries until the timeout. The virtual clock only moves when a task blocks, so a
+    // stream that can run dry has to be read with setTimeout(0).
+    int timedRead() {
+        int64_t startUs = hostsim::nowUs();
+        do {
+            int c = read();
+            if (c >= 0) return c;
+        } while (hostsim::nowUs() - startUs < (int64_t)timeoutMs_ * 1000);
+        return -1;
+    }
+    unsigned long timeoutMs_ = 1000;
+};
+
+// Serial output goes to hostsim::serialLog(); input is whatever the test queued there.
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long) {}
+    explicit operator bool() const { return true; }
+    size_t write(uint8_t c) override { hostsim::serialWrite((const char*)&c, 1); return 1; }
+    size_t write(const uint8_t* buffer, size_t size) override { hostsim::serialWrite((const char*)buffer, size); return size; }
+    using Print::write;
+    int available() override { return (int)hostsim::serialLog().input.size(); }
+    int read() override {
+        std::string& input = hostsim::serialLog().input;
+        if (input.empty()) return -1;
+        int c = (uint8_t)input[0];
+        input.erase(0, 1);
+        return c;
+    }
+    int peek() override { return hostsim::serialLog().input.empty() ? -1 : (uint8_t)hostsim::serialLog().input[0]; }
+};
+inline HardwareSerial Serial;
+
+// --- Timing ---
+inline unsigned long millis() { return (unsigned long)(hostsim::nowUs() / 1000); }
+inline unsigned long micros() { return (unsigned long)hostsim::nowUs(); }
+inline void delay(uint32_t ms) { hostsim::sleepUs((int64_t)ms * 1000); }
+inline void delayMicroseconds(uint32_t us) { hostsim::sleepUs(us); }
+inline void yield() { hostsim::sleepUs(0); }
+
+// --- GPIO ---
+inline void pinMode(uint8_t pin, uint8_t mode) { hostsim::pins()[pin].mode = mode; }
+inline void digitalWrite(uint8_t pin, uint8_t level) { hostsim::pins()[pin].level = level ? 1 : 0; }
+inline int digitalRead(uint8_t pin) { return hostsim::pins()[pin].level; }
+// ONLOW_WE/ONHIGH_WE map to the level interrupt types, as the ESP32 core does.
+inline void attachInterruptArg(uint8_t pin, void (*isr)(void*), void* arg, int mode) {
+    hostsim::Pin& p = hostsim::pins()[pin];
+    p.isr = isr;
+    p.isrArg = arg;
+    p.intrType = ((mode & 0x07) == ONLOW) ? 4 : 5;
+    hostsim::firePinInterrupt(pin);
+}
+inline void detachInterrupt(uint8_t pin) { hostsim::pins()[pin].isr = nullptr; }
+
+// --- Chip ---
+class EspClass {
+public:
+    uint32_t getCycleCount() { return (uint32_t)(hostsim::nowUs() * 240); }
+    uint32_t getFreeHeap();
+    void restart() { abort(); }
+};
+inline EspClass ESP;
+inline uint32_t getCpuFrequencyMhz() { return 240; }
+// Deterministic, so simulation runs repeat exactly.
+inline uint32_t esp_random() {
+    static uint32_t state = 0x2545F491;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+inline long random(long howBig) { return howBig > 0 ? (long)(esp_random() % (uint32_t)howBig) : 0; }
+inline long random(long howSmall, long howBig) { return howSmall >= howBig ? howSmall : howSmall + random(howBig - howSmall); }
+
+// --- Time (esp32-hal-time.c) ---
+namespace hostsim {
+// configTime() negates the offset into a POSIX TZ string, exactly like the core.
+inline void setTimeZone(long offset, int daylight) {
+    char cst[32] = { 0 }, cdt[32] = "DST", tz[64] = { 0 }; // The core's are 17/17/33: ample for real offsets, not for -Wformat-truncation
+    if (offset % 3600) snprintf(cst, sizeof(cst), "UTC%ld:%02u:%02u", offset / 3600, abs((int)((offset % 3600) / 60)), abs((int)(offset % 60)));
+    else snprintf(cst, sizeof(cst), "UTC%ld", offset / 3600);
+    if (daylight != 3600) {
+        long tzDst = offset - daylight;
+        if (tzDst % 3600) snprintf(cdt, sizeof(cdt), "DST%ld:%02u:%02u", tzDst / 3600, abs((int)((tzDst % 3600) / 60)), abs((int)(tzDst % 60)));
+        else snprintf(cdt, sizeof(cdt), "DST%ld", tzDst / 3600);
+    }
+    snprintf(tz, sizeof(tz), "%s%s", cst, daylight ? cdt : "");
+    setenv("TZ", tz, 1);
+    tzset();
+}
+void startSntp(); // WiFi.h: needs the link state
+}
+
+inline void configTime(long gmtOffsetSec, int daylightOffsetSec, const char* server1, const char* server2 = nullptr,
+                       const char* server3 = nullptr) {
+    hostsim::startSntp();
+    hostsim::setTimeZone(-gmtOffsetSec, daylightOffsetSec);
+}
+inline void configTzTime(const char* tz, const char* server1, const char* server2 = nullptr, const char* server3 = nullptr) {
+    hostsim::startSntp();
+    setenv("TZ", tz, 1);
+    tzset();
+}
+inline bool getLocalTime(struct tm* info, uint32_t ms = 5000) {
+    uint32_t start = millis();
+    time_t now;
+    while ((millis() - start) <= ms) {
+        time(&now);
+        localtime_r(&now, info);
+        if (info->tm_year > (2016 - 1900)) return true;
+        delay(10);
+    }
+    return false;
+}
+
+// --- Sketch entry points ---
+void setup();
+void loop();
+
+namespace hostsim {
+// The core's app_main: a loop task that runs setup() once, then loop() forever.
+inline Task* startArduino() {
+    return startTask("loopTask", [] {
+        setup();
+        for (;;) {
+            loop();
+            sleepUs(1); // A pass costs at least this, so one that never blocks still lets the clock run
+        }
+    });
+}
+}
+
+#include <esp_heap_caps.h>
+inline uint32_t EspClass::getFreeHeap() { return (uint32_t)heap_caps_get_free_size(MALLOC_CAP_8BIT); }
+
+#endif // HOST_ARDUINO_H
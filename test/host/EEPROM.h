@@ -0,0 +1,27 @@
+#ifndef HOST_EEPROM_H
+#define HOST_EEPROM_H
+
+// Emulated EEPROM over hostsim::eepromFlash(), which outlives a simulated boot like flash does.
+
+#include <Arduino.h>
+
+class EEPROMClass {
+public:
+    bool begin(size_t size) {
+        data.assign(hostsim::eepromFlash().begin(), hostsim::eepromFlash().begin() + size);
+        return true;
+    }
+    uint8_t read(int address) { return (size_t)address < data.size() ? data[address] : 0xFF; }
+    void write(int address, uint8_t value) { if ((size_t)address < data.size()) data[address] = value; }
+    bool commit() {
+        std::copy(data.begin(), data.end(), hostsim::eepromFlash().begin());
+        commits++;
+        return true;
+    }
+    uint32_t commits = 0;
+private:
+    std::vector<uint8_t> data;
+};
+inline EEPROMClass EEPROM;
+
+#endif // HOST_EEPROM_H
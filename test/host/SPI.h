@@ -0,0 +1,19 @@
+#ifndef HOST_SPI_H
+#define HOST_SPI_H
+
+#include <Arduino.h>
+
+class SPIClass {
+public:
+    void begin(int8_t sck = -1, int8_t miso = -1, int8_t mosi = -1, int8_t ss = -1) {
+        begun = true;
+        sckPin = sck;
+        mosiPin = mosi;
+    }
+    void end() { begun = false; }
+    bool begun = false;
+    int8_t sckPin = -1;
+    int8_t mosiPin = -1;
+};
+
+#endif // HOST_SPI_H
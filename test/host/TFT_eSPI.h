@@ -0,0 +1,241 @@
+#ifndef HOST_TFT_ESPI_H
+#define HOST_TFT_ESPI_H
+
+// TFT_eSPI (2.5.x) public API for the host shim. Nothing is rasterised; what reaches the controller
+// is traced instead: every command with its virtual time, the pins initBus() would have set, and
+// GRAM writes (drawing calls), so a test can replay the trace through a controller model. Sprites
+// hold real pixel buffers since the page cache encodes them.
+
+#include <Arduino.h>
+#include <SPI.h>
+
+#define TFT_ESPI_VERSION "2.5.43" // The release pinned in platformio.ini, which this shim follows
+
+#ifndef TFT_WIDTH
+#define TFT_WIDTH 135
+#endif
+#ifndef TFT_HEIGHT
+#define TFT_HEIGHT 240
+#endif
+#ifndef TFT_MISO
+#define TFT_MISO -1
+#endif
+#ifndef TFT_MOSI
+#define TFT_MOSI 19
+#endif
+#ifndef TFT_SCLK
+#define TFT_SCLK 18
+#endif
+#ifndef TFT_CS
+#define TFT_CS 5
+#endif
+#ifndef TFT_DC
+#define TFT_DC 16
+#endif
+#ifndef TFT_RST
+#define TFT_RST 23
+#endif
+#ifndef TFT_BL
+#define TFT_BL 4
+#endif
+
+#define TFT_SWRST 0x01
+#define TFT_SLPIN 0x10
+#define TFT_SLPOUT 0x11
+#define TFT_INVON 0x21
+#define TFT_DISPOFF 0x28
+#define TFT_DISPON 0x29
+#define TFT_CASET 0x2A
+#define TFT_PASET 0x2B
+#define TFT_RAMWR 0x2C
+#define ST7789_NORON 0x13
+#define ST7789_IDMOFF 0x38
+#define ST7789_IDMON 0x39
+
+#define TFT_BLACK 0x0000
+#define TFT_NAVY 0x000F
+#define TFT_DARKGREEN 0x03E0
+#define TFT_BLUE 0x001F
+#define TFT_GREEN 0x07E0
+#define TFT_CYAN 0x07FF
+#define TFT_RED 0xF800
+#define TFT_MAGENTA 0xF81F
+#define TFT_YELLOW 0xFFE0
+#define TFT_WHITE 0xFFFF
+#define TFT_ORANGE 0xFDA0
+#define TFT_GREENYELLOW 0xB7E0
+#define TFT_DARKGREY 0x7BEF
+#define TFT_LIGHTGREY 0xD69A
+#define TFT_SKYBLUE 0x867D
+
+#define TL_DATUM 0
+#define TC_DATUM 1
+#define TR_DATUM 2
+#define ML_DATUM 3
+#define MC_DATUM 4
+#define MR_DATUM 5
+#define BL_DATUM 6
+#define BC_DATUM 7
+#define BR_DATUM 8
+
+namespace hostsim {
+struct DisplayCommand {
+    int64_t atUs;        // esp_timer time
+    int64_t epochUs;     // True time, to line traces up across boots
+    uint8_t command;     // TFT_RAMWR stands for the drawing calls of one instant; TFT_SWRST for the RST pulse
+    bool busReady;       // SPI started and CS/DC driven as outputs (what initBus() sets up)
+};
+struct DisplayBus {
+    SPIClass spi;
+    std::vector<DisplayCommand> trace;
+    uint32_t inits = 0;  // TFT_eSPI::init() calls
+};
+inline DisplayBus& displayBus() {
+    static DisplayBus bus;
+    return bus;
+}
+inline void recordDisplayCommand(uint8_t command) {
+    DisplayBus& bus = displayBus();
+    if (command == TFT_RAMWR && !bus.trace.empty() && bus.trace.back().command == TFT_RAMWR && bus.trace.back().atUs == nowUs()) return;
+    Pin* p = pins();
+    bool busReady = bus.spi.begun && p[TFT_CS].mode == OUTPUT && p[TFT_DC].mode == OUTPUT;
+    bus.trace.push_back({ nowUs(), trueEpochUs(), command, busReady });
+}
+}
+
+class TFT_eSPI : public Print {
+public:
+    TFT_eSPI(int16_t w = TFT_WIDTH, int16_t h = TFT_HEIGHT) : width_(w), height_(h), rotatedWidth(w), rotatedHeight(h) {}
+    virtual ~TFT_eSPI() {}
+
+    // Hardware reset and the ST7789 init sequence, with the library's delays.
+    void init(uint8_t tc = 0) {
+        initBus();
+        getSPIinstance().begin(TFT_SCLK, TFT_MISO, TFT_MOSI, -1);
+        hostsim::displayBus().inits++;
+        delay(25);
+        hostsim::recordDisplayCommand(TFT_SWRST);
+        delay(150);
+        writecommand(TFT_SLPOUT);
+        delay(120);
+        writecommand(ST7789_NORON);
+        delay(10);
+        writecommand(TFT_INVON);
+        delay(120);
+        writecommand(TFT_DISPON);
+        delay(120);
+        pinMode(TFT_BL, OUTPUT);
+        digitalWrite(TFT_BL, HIGH);
+    }
+    void begin(uint8_t tc = 0) { init(tc); }
+    static SPIClass& getSPIinstance() { return hostsim::displayBus().spi; }
+
+    void writecommand(uint8_t c) { if (!sprite) hostsim::recordDisplayCommand(c); }
+    void writedata(uint8_t) {}
+    void startWrite() {}
+    void endWrite() {}
+    void setRotation(uint8_t r) {
+        rotation = r & 3;
+        rotatedWidth = (rotation & 1) ? height_ : width_;
+        rotatedHeight = (rotation & 1) ? width_ : height_;
+    }
+    uint8_t getRotation() { return rotation; }
+    int16_t width() { return rotatedWidth; }
+    int16_t height() { return rotatedHeight; }
+
+    void setTextDatum(uint8_t datum) { textDatum = datum; }
+    void setTextColor(uint16_t color) { textColor = color; }
+    void setTextColor(uint16_t fg, uint16_t bg, bool fill = false) { textColor = fg; }
+    void setTextFont(uint8_t font) { textFont = font; }
+    void setTextSize(uint8_t) {}
+    void setTextPadding(uint16_t) {}
+    int16_t fontHeight(int16_t font) { return font == 4 ? 26 : (font == 2 ? 16 : 8); }
+    int16_t fontHeight() { return fontHeight(textFont); }
+    int16_t textWidth(const char* text, uint8_t font) { return (int16_t)(strlen(text) * (font == 4 ? 14 : (font == 2 ? 8 : 6))); }
+    int16_t textWidth(const char* text) { return textWidth(text, textFont); }
+    int16_t textWidth(const String& text, uint8_t font) { return textWidth(text.c_str(), font); }
+    int16_t textWidth(const String& text) { return textWidth(text.c_str(), textFont); }
+    int16_t drawString(const char* text, int32_t x, int32_t y, uint8_t font) { drawn(); return textWidth(text, font); }
+    int16_t drawString(const char* text, int32_t x, int32_t y) { return drawString(text, x, y, textFont); }
+    int16_t drawString(const String& text, int32_t x, int32_t y, uint8_t font) { return drawString(text.c_str(), x, y, font); }
+    int16_t drawString(const String& text, int32_t x, int32_t y) { return drawString(text.c_str(), x, y, textFont); }
+
+    virtual void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) { drawn(); }
+    void fillScreen(uint32_t color) { fillRect(0, 0, width(), height(), color); }
+    void drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color) { fillRect(x, y, w, 1, color); }
+    void drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color) { fillRect(x, y, 1, h, color); }
+    void drawPixel(int32_t x, int32_t y, uint32_t color) { fillRect(x, y, 1, 1, color); }
+    void drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) { drawn(); }
+    void drawLine(int32_t, int32_t, int32_t, int32_t, uint32_t) { drawn(); }
+    void setAddrWindow(int32_t x, int32_t y, int32_t w, int32_t h) {}
+    void pushBlock(uint16_t color, uint32_t length) { drawn(); }
+    void pushColors(uint16_t*, uint32_t, bool = true) { drawn(); }
+    void pushImage(int32_t, int32_t, int32_t, int32_t, const uint16_t*) { drawn(); }
+    void setSwapBytes(bool swap) { swapBytes = swap; }
+    bool getSwapBytes() { return swapBytes; }
+    uint16_t color565(uint8_t r, uint8_t g, uint8_t b) { return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3); }
+
+    size_t write(uint8_t) override { drawn(); return 1; }
+
+protected:
+    void drawn() { if (!sprite) hostsim::recordDisplayCommand(TFT_RAMWR); }
+    bool sprite = false;
+    int16_t width_, height_;
+    int16_t rotatedWidth, rotatedHeight;
+    uint8_t rotation = 0;
+    uint8_t textDatum = TL_DATUM;
+    uint8_t textFont = 1;
+    uint16_t textColor = TFT_WHITE;
+    bool swapBytes = false;
+
+private:
+    void initBus() { // Private in the library as well
+        pinMode(TFT_CS, OUTPUT);
+        digitalWrite(TFT_CS, HIGH);
+        pinMode(TFT_DC, OUTPUT);
+        digitalWrite(TFT_DC, HIGH);
+        pinMode(TFT_RST, OUTPUT);
+        digitalWrite(TFT_RST, HIGH);
+    }
+};
+
+class TFT_eSprite : public TFT_eSPI {
+public:
+    explicit TFT_eSprite(TFT_eSPI* display) : TFT_eSPI(0, 0), display(display) { sprite = true; }
+    ~TFT_eSprite() { deleteSprite(); }
+    void* createSprite(int16_t w, int16_t h, uint8_t frames = 1) {
+        if (pixels) return pixels;
+        pixels = (uint16_t*)calloc((size_t)w * h, bitsPerPixel == 16 ? 2 : 1);
+        if (!pixels) return nullptr;
+        width_ = rotatedWidth = w;
+        height_ = rotatedHeight = h;
+        return pixels;
+    }
+    void deleteSprite() {
+        free(pixels);
+        pixels = nullptr;
+    }
+    bool created() { return pixels != nullptr; }
+    void* getPointer() { return pixels; }
+    void* setColorDepth(int8_t bits) {
+        deleteSprite();
+        bitsPerPixel = bits;
+        return nullptr;
+    }
+    void fillSprite(uint32_t color) { fillRect(0, 0, width_, height_, color); }
+    // 16-bit sprites store pixels byte-swapped, as the library does.
+    void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) override {
+        if (!pixels || bitsPerPixel != 16) return;
+        uint16_t stored = (uint16_t)((color >> 8) | (color << 8));
+        for (int32_t row = std::max<int32_t>(y, 0); row < std::min<int32_t>(y + h, height_); ++row)
+            for (int32_t col = std::max<int32_t>(x, 0); col < std::min<int32_t>(x + w, width_); ++col) pixels[row * width_ + col] = stored;
+    }
+    void pushSprite(int32_t x, int32_t y) { if (display) hostsim::recordDisplayCommand(TFT_RAMWR); }
+
+private:
+    TFT_eSPI* display;
+    uint16_t* pixels = nullptr;
+    int8_t bitsPerPixel = 16;
+};
+
+#endif // HOST_TFT_ESPI_H
@@ -0,0 +1,224 @@
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+// Station-mode WiFi, SNTP and TCP for the host shim. Association, the SNTP reply and each HTTP
+// exchange take virtual time; the servers are request -> response functions the test registers by
+// host name (see hostsim::network().servers).
+
+#include <Arduino.h>
+#include <Client.h>
+#include <esp_sntp.h>
+
+typedef enum {
+    WL_IDLE_STATUS = 0, WL_NO_SSID_AVAIL = 1, WL_SCAN_COMPLETED = 2, WL_CONNECTED = 3, WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5, WL_DISCONNECTED = 6
+} wl_status_t;
+typedef enum { WIFI_OFF = 0, WIFI_STA = 1, WIFI_AP = 2, WIFI_AP_STA = 3 } wifi_mode_t;
+typedef enum {
+    ARDUINO_EVENT_WIFI_STA_START, ARDUINO_EVENT_WIFI_STA_CONNECTED, ARDUINO_EVENT_WIFI_STA_DISCONNECTED,
+    ARDUINO_EVENT_WIFI_STA_GOT_IP
+} arduino_event_id_t;
+typedef void (*WiFiEventCb)(arduino_event_id_t event);
+
+class IPAddress : public Printable {
+public:
+    IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) : octets{ a, b, c, d } {}
+    String toString() const {
+        char text[16];
+        snprintf(text, sizeof(text), "%u.%u.%u.%u", octets[0], octets[1], octets[2], octets[3]);
+        return String(text);
+    }
+    size_t printTo(Print& p) const override { return p.print(toString()); }
+    operator uint32_t() const { // First octet in the low byte, as on the ESP32
+        return (uint32_t)octets[0] | ((uint32_t)octets[1] << 8) | ((uint32_t)octets[2] << 16) | ((uint32_t)octets[3] << 24);
+    }
+private:
+    uint8_t octets[4];
+};
+
+namespace hostsim {
+
+struct Server {
+    std::function<std::string(const std::string& request)> respond; // Whole response, head and body
+    int64_t connectUs = 40000;   // TCP (and TLS) setup
+    int64_t responseUs = 150000; // Request complete to first response byte
+    uint32_t requests = 0;
+    std::vector<int64_t> requestEpochUs; // True time of each request...
+    std::vector<int> requestStatus;      // ...and the status it was answered with
+};
+
+struct Network {
+    bool accessPointUp = true;      // Association succeeds while this holds
+    int64_t associationUs = 1500000; // WiFi.begin() to connected (association + DHCP)
+    bool ntpReachable = true;
+    int64_t ntpReplyUs = 60000;
+    int64_t ntpResyncUs = 3600LL * 1000000; // CONFIG_LWIP_SNTP_UPDATE_DELAY
+    std::map<std::string, Server> servers;
+
+    wl_status_t status = WL_DISCONNECTED;
+    uint32_t linkGeneration = 0;     // Bumped by every begin/disconnect; stale events check it
+    uint32_t sntpGeneration = 0;
+    std::string ssid;
+    std::vector<std::pair<WiFiEventCb, arduino_event_id_t>> handlers;
+    uint32_t associations = 0;       // Successful ones
+    uint32_t beginCalls = 0;
+};
+inline Network& network() {
+    static Network net;
+    return net;
+}
+
+inline void raiseWiFiEvent(arduino_event_id_t event) {
+    for (auto& handler : network().handlers) if (handler.second == event) handler.first(event);
+}
+
+// The access point goes away (or comes back); a connected station drops at once.
+inline void setAccessPointUp(bool up) {
+    Network& net = network();
+    net.accessPointUp = up;
+    if (!up && net.status == WL_CONNECTED) {
+        net.status = WL_CONNECTION_LOST;
+        net.linkGeneration++;
+        raiseWiFiEvent(ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+    }
+}
+
+// Sets the system time from the true clock while the link is up, then again every ntpResyncUs.
+inline void scheduleSntpSync(uint32_t generation, int64_t afterUs) {
+    scheduleEvent(nowUs() + afterUs, [generation] {
+        Network& net = network();
+        if (generation != net.sntpGeneration) return;
+        if (net.status == WL_CONNECTED && net.ntpReachable) {
+            int64_t epochUs = trueEpochUs();
+            setDeviceEpochUs(epochUs);
+            struct timeval tv = { (time_t)(epochUs / 1000000LL), (suseconds_t)(epochUs % 1000000LL) };
+            if (sntpCallback()) sntpCallback()(&tv);
+        }
+        scheduleSntpSync(generation, net.ntpResyncUs);
+    });
+}
+inline void startSntp() {
+    Network& net = network();
+    scheduleSntpSync(++net.sntpGeneration, net.ntpReplyUs);
+}
+
+} // namespace hostsim
+
+class WiFiClass {
+public:
+    bool mode(wifi_mode_t) { return true; }
+    wl_status_t begin(const char* ssid, const char* passphrase = nullptr) {
+        hostsim::Network& net = hostsim::network();
+        net.ssid = ssid;
+        net.beginCalls++;
+        net.status = WL_DISCONNECTED;
+        uint32_t generation = ++net.linkGeneration;
+        hostsim::scheduleEvent(hostsim::nowUs() + net.associationUs, [generation] {
+            hostsim::Network& net = hostsim::network();
+            if (generation != net.linkGeneration) return;
+            if (!net.accessPointUp) {
+                net.status = WL_NO_SSID_AVAIL;
+                return;
+            }
+            net.status = WL_CONNECTED;
+            net.associations++;
+            hostsim::raiseWiFiEvent(ARDUINO_EVENT_WIFI_STA_CONNECTED);
+            hostsim::raiseWiFiEvent(ARDUINO_EVENT_WIFI_STA_GOT_IP);
+        });
+        return net.status;
+    }
+    bool disconnect(bool wifiOff = false, bool eraseAp = false) {
+        hostsim::Network& net = hostsim::network();
+        bool wasConnected = net.status == WL_CONNECTED;
+        net.status = WL_DISCONNECTED;
+        net.linkGeneration++;
+        if (wasConnected) hostsim::raiseWiFiEvent(ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+        return true;
+    }
+    wl_status_t status() { return hostsim::network().status; }
+    bool isConnected() { return status() == WL_CONNECTED; }
+    String SSID() { return String(hostsim::network().ssid); }
+    uint8_t* BSSID() { // Static like the core's; the access point's MAC follows from its SSID here
+        static uint8_t bssid[6];
+        if (!isConnected()) return nullptr;
+        uint32_t hash = 2166136261u;
+        for (char c : hostsim::network().ssid) hash = (hash ^ (uint8_t)c) * 16777619u;
+        bssid[0] = 0x02; // Locally administered
+        bssid[1] = 0x00;
+        memcpy(bssid + 2, &hash, 4);
+        return bssid;
+    }
+    IPAddress localIP() { return isConnected() ? IPAddress(192, 168, 1, 50) : IPAddress(); }
+    int8_t RSSI() { return isConnected() ? -61 : 0; }
+    bool setSleep(bool) { return true; }
+    bool persistent(bool) { return true; }
+    bool setAutoReconnect(bool) { return true; }
+    int onEvent(WiFiEventCb callback, arduino_event_id_t event = ARDUINO_EVENT_WIFI_STA_START) {
+        hostsim::network().handlers.emplace_back(callback, event);
+        return (int)hostsim::network().handlers.size();
+    }
+};
+inline WiFiClass WiFi;
+
+// One exchange per connection: the response is produced once the request head is complete, becomes
+// readable responseUs later, and the server closes after it ("Connection: close").
+class WiFiClient : public Client {
+public:
+    int connect(const char* host, uint16_t port) override {
+        stop();
+        hostsim::Network& net = hostsim::network();
+        auto found = net.servers.find(host);
+        if (net.status != WL_CONNECTED || found == net.servers.end()) return 0;
+        hostsim::sleepUs(found->second.connectUs);
+        if (net.status != WL_CONNECTED) return 0;
+        server = &found->second;
+        open = true;
+        return 1;
+    }
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* buffer, size_t size) override {
+        if (!open || responded) return 0;
+        request.append((const char*)buffer, size);
+        if (request.find("\r\n\r\n") != std::string::npos) {
+            responded = true;
+            server->requests++;
+            server->requestEpochUs.push_back(hostsim::trueEpochUs());
+            response = server->respond(request);
+            server->requestStatus.push_back(response.size() > 12 ? atoi(response.c_str() + 9) : 0);
+            readyUs = hostsim::nowUs() + server->responseUs;
+        }
+        return size;
+    }
+    int available() override { return (responded && hostsim::nowUs() >= readyUs) ? (int)(response.size() - offset) : 0; }
+    int read() override {
+        uint8_t c;
+        return read(&c, 1) == 1 ? c : -1;
+    }
+    int read(uint8_t* buffer, size_t size) override {
+        size_t n = std::min(size, (size_t)available());
+        memcpy(buffer, response.data() + offset, n);
+        offset += n;
+        return n ? (int)n : -1;
+    }
+    int peek() override { return available() > 0 ? (uint8_t)response[offset] : -1; }
+    void flush() override {}
+    void stop() override {
+        open = responded = false;
+        request.clear();
+        response.clear();
+        offset = 0;
+    }
+    uint8_t connected() override { return open && (!responded || offset < response.size()); }
+    void setTimeout(uint32_t) {}
+
+private:
+    hostsim::Server* server = nullptr;
+    bool open = false;
+    bool responded = false;
+    std::string request;
+    std::string response;
+    size_t offset = 0;
+    int64_t readyUs = 0;
+};
+
+#endif // HOST_WIFI_H
@@ -0,0 +1,26 @@
+#ifndef HOST_DRIVER_GPIO_H
+#define HOST_DRIVER_GPIO_H
+
+#include <esp_err.h>
+#include <host_sim.h>
+
+typedef int gpio_num_t;
+#define GPIO_NUM_0 0
+#define GPIO_NUM_4 4
+#define GPIO_NUM_35 35
+typedef enum {
+    GPIO_INTR_DISABLE, GPIO_INTR_POSEDGE, GPIO_INTR_NEGEDGE, GPIO_INTR_ANYEDGE, GPIO_INTR_LOW_LEVEL, GPIO_INTR_HIGH_LEVEL
+} gpio_int_type_t;
+
+inline esp_err_t gpio_set_intr_type(gpio_num_t pin, gpio_int_type_t type) {
+    hostsim::pins()[pin].intrType = type;
+    hostsim::firePinInterrupt(pin);
+    return ESP_OK;
+}
+inline int gpio_get_level(gpio_num_t pin) { return hostsim::pins()[pin].level; }
+inline esp_err_t gpio_hold_en(gpio_num_t) { return ESP_OK; }
+inline esp_err_t gpio_hold_dis(gpio_num_t) { return ESP_OK; }
+inline void gpio_deep_sleep_hold_en() {}
+inline void gpio_deep_sleep_hold_dis() {}
+
+#endif // HOST_DRIVER_GPIO_H
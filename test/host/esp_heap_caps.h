@@ -0,0 +1,28 @@
+#ifndef HOST_ESP_HEAP_CAPS_H
+#define HOST_ESP_HEAP_CAPS_H
+
+// A fixed ESP32-sized heap: the host allocator's numbers would mean nothing to the firmware's checks.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_DEFAULT (1 << 12)
+
+namespace hostsim {
+struct HeapModel {
+    size_t freeBytes = 180 * 1024;
+    size_t largestBlock = 110 * 1024;
+    size_t minimumFree = 150 * 1024;
+};
+inline HeapModel& heapModel() {
+    static HeapModel model;
+    return model;
+}
+}
+
+inline size_t heap_caps_get_free_size(uint32_t) { return hostsim::heapModel().freeBytes; }
+inline size_t heap_caps_get_largest_free_block(uint32_t) { return hostsim::heapModel().largestBlock; }
+inline size_t heap_caps_get_minimum_free_size(uint32_t) { return hostsim::heapModel().minimumFree; }
+
+#endif // HOST_ESP_HEAP_CAPS_H
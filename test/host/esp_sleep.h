@@ -0,0 +1,33 @@
+#ifndef HOST_ESP_SLEEP_H
+#define HOST_ESP_SLEEP_H
+
+// Deep sleep ends the simulated boot (see hostsim::deepSleep); light sleep is not modelled, the
+// kernel already skips idle time.
+
+#include <esp_err.h>
+#include <driver/gpio.h>
+
+typedef enum {
+    ESP_SLEEP_WAKEUP_UNDEFINED, ESP_SLEEP_WAKEUP_ALL, ESP_SLEEP_WAKEUP_EXT0, ESP_SLEEP_WAKEUP_EXT1,
+    ESP_SLEEP_WAKEUP_TIMER, ESP_SLEEP_WAKEUP_TOUCHPAD, ESP_SLEEP_WAKEUP_ULP, ESP_SLEEP_WAKEUP_GPIO, ESP_SLEEP_WAKEUP_UART
+} esp_sleep_wakeup_cause_t;
+typedef esp_sleep_wakeup_cause_t esp_sleep_source_t;
+
+inline esp_err_t esp_sleep_enable_timer_wakeup(uint64_t us) {
+    hostsim::kernel().deepSleepUs = us;
+    return ESP_OK;
+}
+inline esp_err_t esp_sleep_enable_ext0_wakeup(gpio_num_t, int) {
+    hostsim::kernel().ext0WakeEnabled = true;
+    return ESP_OK;
+}
+inline esp_err_t esp_sleep_enable_gpio_wakeup() { return ESP_OK; }
+inline esp_err_t esp_sleep_disable_wakeup_source(esp_sleep_source_t source) {
+    if (source == ESP_SLEEP_WAKEUP_TIMER) hostsim::kernel().deepSleepUs = 0;
+    if (source == ESP_SLEEP_WAKEUP_EXT0) hostsim::kernel().ext0WakeEnabled = false;
+    return ESP_OK;
+}
+inline esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause() { return (esp_sleep_wakeup_cause_t)hostsim::kernel().wakeCause; }
+[[noreturn]] inline void esp_deep_sleep_start() { hostsim::deepSleep(); }
+
+#endif // HOST_ESP_SLEEP_H
@@ -0,0 +1,17 @@
+#ifndef HOST_ESP_SNTP_H
+#define HOST_ESP_SNTP_H
+
+#include <sys/time.h>
+
+typedef void (*sntp_sync_time_cb_t)(struct timeval* tv);
+
+namespace hostsim {
+inline sntp_sync_time_cb_t& sntpCallback() {
+    static sntp_sync_time_cb_t callback = nullptr;
+    return callback;
+}
+}
+
+inline void sntp_set_time_sync_notification_cb(sntp_sync_time_cb_t callback) { hostsim::sntpCallback() = callback; }
+
+#endif // HOST_ESP_SNTP_H
@@ -0,0 +1,8 @@
+#ifndef HOST_ESP_TIMER_H
+#define HOST_ESP_TIMER_H
+
+#include <host_sim.h>
+
+inline int64_t esp_timer_get_time() { return hostsim::nowUs(); }
+
+#endif // HOST_ESP_TIMER_H
@@ -0,0 +1,58 @@
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+// FreeRTOS types and port macros for the host shim. Ticks are milliseconds (CONFIG_FREERTOS_HZ=1000
+// on the ESP32 Arduino core). Only one task runs at a time on the host kernel, but critical sections
+// are real (recursive) spinlocks all the same: the ThreadSanitizer suite calls into the firmware from
+// free-running threads and must see the locks the firmware takes.
+
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+#include <host_sim.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef void* TaskHandle_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define pdFAIL 0
+#define portMAX_DELAY 0xFFFFFFFFu
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+typedef struct { std::atomic<uint32_t> owner; uint32_t count; } portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED { 0, 0 }
+#define portENTER_CRITICAL(mux) hostsim::enterCritical(mux)
+#define portEXIT_CRITICAL(mux) hostsim::exitCritical(mux)
+#define portENTER_CRITICAL_ISR(mux) hostsim::enterCritical(mux)
+#define portEXIT_CRITICAL_ISR(mux) hostsim::exitCritical(mux)
+#define portYIELD_FROM_ISR() do {} while (0)
+
+namespace hostsim {
+inline int64_t ticksToUs(TickType_t ticks) { return ticks == portMAX_DELAY ? INT64_MAX : (int64_t)ticks * 1000; }
+
+inline uint32_t criticalOwnerId() {
+    static std::atomic<uint32_t> next{1};
+    thread_local uint32_t id = next++;
+    return id;
+}
+inline void enterCritical(portMUX_TYPE* mux) {
+    uint32_t self = criticalOwnerId();
+    if (mux->owner.load(std::memory_order_relaxed) == self) {
+        mux->count++;
+        return;
+    }
+    for (uint32_t unlocked = 0; !mux->owner.compare_exchange_weak(unlocked, self, std::memory_order_acquire); unlocked = 0)
+        std::this_thread::yield();
+    mux->count = 1;
+}
+inline void exitCritical(portMUX_TYPE* mux) {
+    if (--mux->count == 0) mux->owner.store(0, std::memory_order_release);
+}
+}
+
+#endif // HOST_FREERTOS_H
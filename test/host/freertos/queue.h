@@ -0,0 +1,40 @@
+#ifndef HOST_FREERTOS_QUEUE_H
+#define HOST_FREERTOS_QUEUE_H
+
+#include <freertos/FreeRTOS.h>
+#include <deque>
+
+namespace hostsim {
+struct Queue {
+    size_t length;
+    size_t itemSize;
+    std::deque<std::vector<uint8_t>> items;
+};
+}
+typedef hostsim::Queue* QueueHandle_t;
+
+inline QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) { return new hostsim::Queue{ length, itemSize, {} }; }
+
+inline BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticksToWait) {
+    if (queue->items.size() >= queue->length && ticksToWait > 0)
+        hostsim::block([queue] { return queue->items.size() < queue->length; }, hostsim::ticksToUs(ticksToWait));
+    if (queue->items.size() >= queue->length) return pdFALSE;
+    const uint8_t* bytes = (const uint8_t*)item;
+    queue->items.emplace_back(bytes, bytes + queue->itemSize);
+    return pdTRUE;
+}
+inline BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void* item, BaseType_t* woken) {
+    if (woken) *woken = pdFALSE;
+    return xQueueSend(queue, item, 0);
+}
+inline BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticksToWait) {
+    if (queue->items.empty() && ticksToWait > 0)
+        hostsim::block([queue] { return !queue->items.empty(); }, hostsim::ticksToUs(ticksToWait));
+    if (queue->items.empty()) return pdFALSE;
+    memcpy(item, queue->items.front().data(), queue->itemSize);
+    queue->items.pop_front();
+    return pdTRUE;
+}
+inline UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) { return (UBaseType_t)queue->items.size(); }
+
+#endif // HOST_FREERTOS_QUEUE_H
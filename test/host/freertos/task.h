@@ -0,0 +1,31 @@
+#ifndef HOST_FREERTOS_TASK_H
+#define HOST_FREERTOS_TASK_H
+
+#include <freertos/FreeRTOS.h>
+
+typedef void (*TaskFunction_t)(void*);
+
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char* name, uint32_t stackBytes, void* param,
+                                          UBaseType_t priority, TaskHandle_t* handle, BaseType_t core) {
+    hostsim::Task* task = hostsim::startTask(name, [code, param] { code(param); });
+    if (handle) *handle = task;
+    return pdPASS;
+}
+inline TaskHandle_t xTaskGetCurrentTaskHandle() { return hostsim::currentTask; }
+inline BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    hostsim::notifyGive((hostsim::Task*)task);
+    return pdPASS;
+}
+inline void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* woken) {
+    hostsim::notifyGive((hostsim::Task*)task);
+    if (woken) *woken = pdTRUE;
+}
+inline uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait) {
+    return hostsim::notifyTake(clearOnExit, hostsim::ticksToUs(ticksToWait));
+}
+inline void vTaskDelay(TickType_t ticks) { hostsim::sleepUs(hostsim::ticksToUs(ticks)); }
+inline TickType_t xTaskGetTickCount() { return (TickType_t)(hostsim::nowUs() / 1000); }
+inline UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t) { return 4096; } // Host stacks are not measured
+inline void vTaskDelete(TaskHandle_t) { hostsim::block(nullptr, INT64_MAX); }
+
+#endif // HOST_FREERTOS_TASK_H
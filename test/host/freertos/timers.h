@@ -0,0 +1,42 @@
+#ifndef HOST_FREERTOS_TIMERS_H
+#define HOST_FREERTOS_TIMERS_H
+
+// Software timers on the virtual clock. Callbacks run when the clock reaches their expiry, on
+// whichever task advanced it (the timer service task on the ESP32); they must not block.
+
+#include <freertos/FreeRTOS.h>
+
+typedef hostsim::Timer* TimerHandle_t;
+typedef void (*TimerCallbackFunction_t)(TimerHandle_t);
+
+inline TimerHandle_t xTimerCreate(const char* name, TickType_t period, UBaseType_t autoReload, void* id,
+                                  TimerCallbackFunction_t callback) {
+    hostsim::Timer* timer = new hostsim::Timer{ name, hostsim::ticksToUs(period), autoReload != 0, id,
+                                                (void (*)(void*))callback };
+    hostsim::Kernel& k = hostsim::kernel();
+    std::lock_guard<std::mutex> guard(k.mutex);
+    k.timers.push_back(timer);
+    return timer;
+}
+inline void* pvTimerGetTimerID(TimerHandle_t timer) { return timer->id; }
+inline BaseType_t xTimerReset(TimerHandle_t timer, TickType_t) {
+    timer->active = true;
+    timer->expiryUs = hostsim::nowUs() + timer->periodUs;
+    return pdPASS;
+}
+inline BaseType_t xTimerStart(TimerHandle_t timer, TickType_t wait) { return xTimerReset(timer, wait); }
+inline BaseType_t xTimerResetFromISR(TimerHandle_t timer, BaseType_t* woken) {
+    if (woken) *woken = pdFALSE;
+    return xTimerReset(timer, 0);
+}
+inline BaseType_t xTimerChangePeriod(TimerHandle_t timer, TickType_t period, TickType_t wait) {
+    timer->periodUs = hostsim::ticksToUs(period);
+    return xTimerReset(timer, wait); // Also starts a dormant timer, as in FreeRTOS
+}
+inline BaseType_t xTimerStop(TimerHandle_t timer, TickType_t) {
+    timer->active = false;
+    return pdPASS;
+}
+inline BaseType_t xTimerIsTimerActive(TimerHandle_t timer) { return timer->active; }
+
+#endif // HOST_FREERTOS_TIMERS_H
@@ -0,0 +1,183 @@
+#ifndef HOST_BOOT_H
+#define HOST_BOOT_H
+
+// Multi-boot runs for the native simulation suites. Each boot is a forked child that starts from the
+// untouched process image (as a reset starts from flash), gets the RTC memory, EEPROM and clocks the
+// device carried out of its last deep sleep, runs setup()/loop() on the virtual clock and reports
+// back when it enters deep sleep. The parent owns the device across boots and never runs a task, so
+// forking it stays safe.
+
+#include <sys/wait.h>
+#include <unistd.h>
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <TFT_eSPI.h>
+#include <WiFi.h>
+
+namespace hostsim {
+
+struct ServedRequest {
+    std::string host;
+    int64_t epochUs;                // True time
+    int status;
+};
+
+// What one boot did, as seen from outside the chip.
+struct BootRecord {
+    bool completed = false;         // Child reported back (false: it crashed)
+    bool slept = false;             // Entered deep sleep (false: maxAwakeUs ran out first)
+    uint64_t sleepUs = 0;           // Programmed timer wake
+    bool ext0Armed = false;
+    int64_t awakeUs = 0;            // esp_timer time at deep sleep
+    int64_t deviceEpochEndUs = 0;   // Device system time at the end (0: never set)
+    int64_t trueEpochStartUs = 0;
+    int64_t trueEpochEndUs = 0;
+    std::vector<ServedRequest> requests; // What the fake servers were asked this boot
+    std::string serial;
+    std::vector<DisplayCommand> display;
+    std::vector<uint8_t> rtc;
+    std::vector<uint8_t> eeprom;
+};
+
+// --- Report pipe (child -> parent) ---
+inline void reportBytes(std::string& out, const void* data, size_t length) {
+    uint64_t n = length;
+    out.append((const char*)&n, sizeof(n));
+    out.append((const char*)data, length);
+}
+template <typename T> inline void reportValue(std::string& out, const T& value) { reportBytes(out, &value, sizeof(T)); }
+
+inline bool takeBytes(const std::string& in, size_t& pos, std::string& out) {
+    uint64_t n;
+    if (pos + sizeof(n) > in.size()) return false;
+    memcpy(&n, in.data() + pos, sizeof(n));
+    pos += sizeof(n);
+    if (pos + n > in.size()) return false;
+    out.assign(in.data() + pos, n);
+    pos += n;
+    return true;
+}
+template <typename T> inline bool takeValue(const std::string& in, size_t& pos, T& value) {
+    std::string bytes;
+    if (!takeBytes(in, pos, bytes) || bytes.size() != sizeof(T)) return false;
+    memcpy(&value, bytes.data(), sizeof(T));
+    return true;
+}
+
+inline void reportBoot(int fd, bool slept) {
+    Kernel& k = kernel();
+    std::string requests;
+    for (auto& server : network().servers)
+        for (size_t i = 0; i < server.second.requestEpochUs.size(); ++i)
+            requests += server.first + " " + std::to_string(server.second.requestEpochUs[i]) + " " + std::to_string(server.second.requestStatus[i]) + "\n";
+    std::string out;
+    reportValue(out, slept);
+    reportValue(out, k.deepSleepUs);
+    reportValue(out, k.ext0WakeEnabled);
+    reportValue(out, k.nowUs);
+    int64_t deviceEpochUs = deviceTimeSet() ? hostsim::deviceEpochUs() : 0;
+    reportValue(out, deviceEpochUs);
+    reportValue(out, k.trueEpochBaseUs);
+    int64_t trueEpochUs = hostsim::trueEpochUs();
+    reportValue(out, trueEpochUs);
+    reportBytes(out, requests.data(), requests.size());
+    reportBytes(out, serialLog().text.data(), serialLog().text.size());
+    const std::vector<DisplayCommand>& trace = displayBus().trace;
+    reportBytes(out, trace.data(), trace.size() * sizeof(DisplayCommand));
+    reportBytes(out, rtcMemory(), rtcMemorySize());
+    reportBytes(out, eepromFlash().data(), eepromFlash().size());
+    for (size_t done = 0; done < out.size();) {
+        ssize_t n = ::write(fd, out.data() + done, out.size() - done);
+        if (n <= 0) _exit(3);
+        done += (size_t)n;
+    }
+    ::close(fd);
+}
+
+inline bool parseBoot(const std::string& in, BootRecord& boot) {
+    size_t pos = 0;
+    std::string requests, display, rtc, eeprom;
+    bool ok = takeValue(in, pos, boot.slept) && takeValue(in, pos, boot.sleepUs) && takeValue(in, pos, boot.ext0Armed) &&
+              takeValue(in, pos, boot.awakeUs) && takeValue(in, pos, boot.deviceEpochEndUs) &&
+              takeValue(in, pos, boot.trueEpochStartUs) && takeValue(in, pos, boot.trueEpochEndUs) &&
+              takeBytes(in, pos, requests) && takeBytes(in, pos, boot.serial) && takeBytes(in, pos, display) &&
+              takeBytes(in, pos, rtc) && takeBytes(in, pos, eeprom);
+    if (!ok) return false;
+    char host[64];
+    long long epochUs;
+    int status, consumed;
+    for (const char* line = requests.c_str(); sscanf(line, "%63s %lld %d\n%n", host, &epochUs, &status, &consumed) == 3; line += consumed)
+        boot.requests.push_back({ host, (int64_t)epochUs, status });
+    boot.display.resize(display.size() / sizeof(DisplayCommand));
+    memcpy(boot.display.data(), display.data(), boot.display.size() * sizeof(DisplayCommand));
+    boot.rtc.assign(rtc.begin(), rtc.end());
+    boot.eeprom.assign(eeprom.begin(), eeprom.end());
+    return true;
+}
+
+// The device between boots: what survives deep sleep, and the two clocks.
+struct Device {
+    std::vector<uint8_t> rtc;                              // Empty: power-on (RTC memory as initialised)
+    std::vector<uint8_t> eeprom = std::vector<uint8_t>(4096, 0xFF);
+    int64_t deviceEpochUs = 0;                             // System time at the next boot (0: not set)
+    int64_t trueEpochUs = 0;
+    double rtcSlowClockError = 0.0;                        // +0.01: the sleep timer runs 1 % slow
+
+    // Boots once with the given wake cause. scenario() runs in the child before setup(), e.g. to
+    // schedule button presses or take the access point away.
+    BootRecord boot(int wakeCause, int64_t maxAwakeUs, std::function<void()> scenario = nullptr) {
+        BootRecord boot;
+        int fds[2];
+        if (pipe(fds) != 0) return boot;
+        fflush(stdout);
+        pid_t pid = fork();
+        if (pid == 0) {
+            ::close(fds[0]);
+            Kernel& k = kernel();
+            k.wakeCause = wakeCause;
+            k.deviceEpochBaseUs = deviceEpochUs;
+            k.trueEpochBaseUs = trueEpochUs;
+            if (!rtc.empty() && rtc.size() == rtcMemorySize()) memcpy(rtcMemory(), rtc.data(), rtc.size());
+            eepromFlash() = eeprom;
+            int fd = fds[1];
+            k.onDeepSleep = [fd] {
+                reportBoot(fd, true);
+                _exit(0);
+            };
+            if (scenario) scenario();
+            startArduino();
+            runUntil(maxAwakeUs);
+            reportBoot(fd, false);
+            _exit(0);
+        }
+        ::close(fds[1]);
+        std::string in;
+        char buffer[65536];
+        for (;;) {
+            ssize_t n = ::read(fds[0], buffer, sizeof(buffer));
+            if (n <= 0) break;
+            in.append(buffer, (size_t)n);
+        }
+        ::close(fds[0]);
+        int status = 0;
+        waitpid(pid, &status, 0);
+        boot.completed = WIFEXITED(status) && WEXITSTATUS(status) == 0 && parseBoot(in, boot);
+        return boot;
+    }
+
+    // Deep sleep after `boot`: the timer wake, or a button wake trueUs in (trueUs < 0: timer). The
+    // device's clock and the sleep timer share the RTC slow clock, so the device sees the sleep as
+    // programmed while the true clock runs on by the slow clock's error.
+    void sleep(const BootRecord& boot, int64_t trueUs = -1) {
+        if (trueUs < 0) trueUs = (int64_t)((double)boot.sleepUs * (1.0 + rtcSlowClockError));
+        int64_t deviceUs = (int64_t)((double)trueUs / (1.0 + rtcSlowClockError));
+        deviceEpochUs = boot.deviceEpochEndUs ? boot.deviceEpochEndUs + deviceUs : 0;
+        trueEpochUs = boot.trueEpochEndUs + trueUs;
+        rtc = boot.rtc;
+        eeprom = boot.eeprom;
+    }
+};
+
+} // namespace hostsim
+
+#endif // HOST_BOOT_H
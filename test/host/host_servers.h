@@ -0,0 +1,84 @@
+#ifndef HOST_SERVERS_H
+#define HOST_SERVERS_H
+
+// Fake Open-Meteo and ip-api.com for the simulation suites. Open-Meteo answers for the true date in
+// Berlin time (CET/CEST) with a sine UV day peaking at peakUv around 13:00, as timezone=auto would.
+
+#include <math.h>
+#include <WiFi.h>
+
+namespace hostsim {
+
+struct FakeWeather {
+    float peakUv = 7.0f;
+    bool openMeteoUp = true; // false: the server answers 503
+};
+inline FakeWeather& fakeWeather() {
+    static FakeWeather weather;
+    return weather;
+}
+
+// EU rule: CEST from 01:00 UTC on the last Sunday of March to 01:00 UTC on the last Sunday of October.
+inline int berlinUtcOffsetSec(time_t utc) {
+    struct tm t;
+    gmtime_r(&utc, &t);
+    auto lastSundayUtc = [&](int month) {
+        struct tm last = {};
+        last.tm_year = t.tm_year;
+        last.tm_mon = month;
+        last.tm_mday = 31;
+        last.tm_hour = 1;
+        time_t at = timegm(&last);
+        struct tm check;
+        gmtime_r(&at, &check);
+        return at - (time_t)check.tm_wday * 86400;
+    };
+    return (utc >= lastSundayUtc(2) && utc < lastSundayUtc(9)) ? 7200 : 3600;
+}
+
+inline float fakeUvAt(int localHour) {
+    float uv = fakeWeather().peakUv * sinf((float)M_PI * (localHour - 5) / 16.0f);
+    return uv > 0.0f ? roundf(uv * 100.0f) / 100.0f : 0.0f;
+}
+
+inline std::string httpOk(const std::string& body) {
+    return "HTTP/1.1 200 OK\r\nContent-Type: application/json; charset=utf-8\r\nContent-Length: " + std::to_string(body.size()) +
+           "\r\nConnection: close\r\n\r\n" + body;
+}
+
+inline std::string openMeteoResponse(const std::string& request) {
+    if (!fakeWeather().openMeteoUp) return "HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+    time_t nowUtc = (time_t)(trueEpochUs() / 1000000LL);
+    int offset = berlinUtcOffsetSec(nowUtc);
+    time_t local = nowUtc + offset;
+    struct tm day;
+    gmtime_r(&local, &day);
+    char item[48];
+    std::string body = "{\"latitude\":52.52,\"longitude\":13.419998,\"generationtime_ms\":0.03,\"utc_offset_seconds\":" +
+                       std::to_string(offset) + ",\"timezone\":\"Europe/Berlin\",\"timezone_abbreviation\":\"" +
+                       (offset == 7200 ? "CEST" : "CET") + "\",\"elevation\":38.0,\"hourly_units\":{\"time\":\"iso8601\"," +
+                       "\"uv_index\":\"\"},\"hourly\":{\"time\":[";
+    for (int h = 0; h < 24; ++h) {
+        snprintf(item, sizeof(item), "%s\"%04d-%02d-%02dT%02d:00\"", h ? "," : "", day.tm_year + 1900, day.tm_mon + 1, day.tm_mday, h);
+        body += item;
+    }
+    body += "],\"uv_index\":[";
+    for (int h = 0; h < 24; ++h) {
+        snprintf(item, sizeof(item), "%s%.2f", h ? "," : "", fakeUvAt(h));
+        body += item;
+    }
+    return httpOk(body + "]}}");
+}
+
+inline void installFakeServers() {
+    Network& net = network();
+    net.servers["api.open-meteo.com"].respond = openMeteoResponse;
+    net.servers["api.open-meteo.com"].connectUs = 450000; // TLS handshake
+    net.servers["ip-api.com"].respond = [](const std::string&) {
+        return httpOk("{\"status\":\"success\",\"city\":\"Berlin\",\"lat\":52.5196,\"lon\":13.4069}");
+    };
+}
+
+} // namespace hostsim
+
+#endif // HOST_SERVERS_H
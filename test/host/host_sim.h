@@ -0,0 +1,332 @@
+#ifndef HOST_SIM_H
+#define HOST_SIM_H
+
+// Virtual-time kernel behind the host shim (test/host), so src/main.cpp can run unmodified in the
+// native simulation suites. Every FreeRTOS task is a host thread, but only one runs at a time: a task
+// runs until it blocks (delay, notify take, queue wait), then the next runnable one gets the baton.
+// When every task is blocked the clock jumps to the earliest deadline, timer or scheduled event, so a
+// simulated day costs only the CPU time the firmware itself spends. Runs are deterministic.
+//
+// Two clocks are kept: the one the device believes (esp_timer since boot plus its system time, which
+// is 1970 until SNTP sets it) and the true one the fake servers and the SNTP reply use.
+
+#include <stdint.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace hostsim {
+
+struct Task {
+    std::string name;
+    std::function<void()> entry;
+    std::condition_variable cv;
+    std::function<bool()> waitFor; // Blocked until this holds...
+    int64_t wakeUs = INT64_MAX;    // ...or the clock reaches this
+    bool blocked = false;
+    uint32_t notifyValue = 0;
+};
+
+struct Timer {
+    const char* name;
+    int64_t periodUs;
+    bool autoReload;
+    void* id;
+    void (*callback)(void* timer);
+    bool active = false;
+    int64_t expiryUs = 0;
+};
+
+enum StopReason : uint8_t { STOP_NONE, STOP_DEADLINE, STOP_DEEP_SLEEP };
+
+struct Kernel {
+    std::mutex mutex;
+    std::condition_variable driverCv;
+    std::vector<Task*> tasks;
+    std::vector<Timer*> timers;
+    std::multimap<int64_t, std::function<void()>> events; // External events, run like timer callbacks
+    Task* current = nullptr;
+    Task* parked = nullptr;        // Task that found nothing left to do before stopAtUs
+    int64_t nowUs = 0;             // esp_timer_get_time()
+    int64_t stopAtUs = 0;
+    bool running = false;
+    StopReason stopReason = STOP_NONE;
+
+    int64_t deviceEpochBaseUs = 0; // Device system time = base + nowUs (0: not set since power-on)
+    int64_t trueEpochBaseUs = 0;   // True time = base + nowUs
+
+    uint64_t deepSleepUs = 0;      // Timer wake programmed before esp_deep_sleep_start()
+    bool ext0WakeEnabled = false;
+    int wakeCause = 0;             // esp_sleep_wakeup_cause_t reported to this boot
+    std::function<void()> onDeepSleep; // Called on the sleeping task; the week simulation exits there
+};
+
+// Leaked on purpose: task threads never return and may still wait on it at exit.
+inline Kernel& kernel() {
+    static Kernel* k = new Kernel;
+    return *k;
+}
+inline thread_local Task* currentTask = nullptr;
+
+inline int64_t nowUs() { return kernel().nowUs; }
+inline int64_t deviceEpochUs() { return kernel().deviceEpochBaseUs + kernel().nowUs; }
+inline int64_t trueEpochUs() { return kernel().trueEpochBaseUs + kernel().nowUs; }
+inline bool deviceTimeSet() { return kernel().deviceEpochBaseUs != 0; }
+inline void setDeviceEpochUs(int64_t epochUs) { kernel().deviceEpochBaseUs = epochUs - kernel().nowUs; }
+
+// Next task to run after `me` (round robin, `me` last); nullptr if all are blocked. Lock held.
+inline Task* pickRunnable(Task* me) {
+    Kernel& k = kernel();
+    size_t count = k.tasks.size(), start = 0;
+    for (size_t i = 0; i < count; ++i) if (k.tasks[i] == me) start = i + 1;
+    for (size_t n = 0; n < count; ++n) {
+        Task* t = k.tasks[(start + n) % count];
+        if (t->blocked && !(t->waitFor && t->waitFor()) && k.nowUs < t->wakeUs) continue;
+        t->blocked = false;
+        t->waitFor = nullptr;
+        t->wakeUs = INT64_MAX;
+        return t;
+    }
+    return nullptr;
+}
+
+// Moves the clock to the earliest pending deadline and fires what is due. False once nothing is due
+// before stopAtUs (the clock is then left at stopAtUs). Lock held; released around callbacks.
+inline bool advanceClock(std::unique_lock<std::mutex>& lock) {
+    Kernel& k = kernel();
+    int64_t next = INT64_MAX;
+    for (Task* t : k.tasks) if (t->blocked && t->wakeUs < next) next = t->wakeUs;
+    for (Timer* t : k.timers) if (t->active && t->expiryUs < next) next = t->expiryUs;
+    if (!k.events.empty() && k.events.begin()->first < next) next = k.events.begin()->first;
+    if (next == INT64_MAX || next > k.stopAtUs) {
+        if (k.stopAtUs != INT64_MAX && k.nowUs < k.stopAtUs) k.nowUs = k.stopAtUs;
+        return false;
+    }
+    if (next > k.nowUs) k.nowUs = next;
+    for (Timer* t : k.timers) {
+        if (!t->active || t->expiryUs > k.nowUs) continue;
+        if (t->autoReload) t->expiryUs += t->periodUs;
+        else t->active = false;
+        lock.unlock();
+        t->callback(t);
+        lock.lock();
+    }
+    while (!k.events.empty() && k.events.begin()->first <= k.nowUs) {
+        std::function<void()> event = k.events.begin()->second;
+        k.events.erase(k.events.begin());
+        lock.unlock();
+        event();
+        lock.lock();
+    }
+    return true;
+}
+
+// Hands the baton on and returns once `me` is picked again. Lock held.
+inline void switchAway(std::unique_lock<std::mutex>& lock, Task* me) {
+    Kernel& k = kernel();
+    for (;;) {
+        Task* next = pickRunnable(me);
+        if (next == me) return;
+        if (next) {
+            k.current = next;
+            next->cv.notify_one();
+            me->cv.wait(lock, [&] { return k.current == me; });
+            return;
+        }
+        if (!advanceClock(lock)) { // Hand control back to the test until it runs the clock further
+            k.parked = me;
+            k.current = nullptr;
+            k.running = false;
+            if (k.stopReason == STOP_NONE) k.stopReason = STOP_DEADLINE;
+            k.driverCv.notify_all();
+            me->cv.wait(lock, [&] { return k.current == me; });
+        }
+    }
+}
+
+// Blocks the calling task until ready() holds or timeoutUs passes (INT64_MAX: no timeout).
+inline void block(std::function<bool()> ready, int64_t timeoutUs) {
+    Kernel& k = kernel();
+    Task* me = currentTask;
+    std::unique_lock<std::mutex> lock(k.mutex);
+    if (!me) { // Called straight from a test: run the clock (timers, events) up to the deadline
+        int64_t stopAtUs = k.stopAtUs;
+        k.stopAtUs = (timeoutUs == INT64_MAX) ? INT64_MAX : k.nowUs + timeoutUs;
+        while (!(ready && ready()) && advanceClock(lock)) {}
+        k.stopAtUs = stopAtUs;
+        return;
+    }
+    me->blocked = true;
+    me->waitFor = std::move(ready);
+    me->wakeUs = (timeoutUs == INT64_MAX) ? INT64_MAX : k.nowUs + timeoutUs;
+    switchAway(lock, me);
+}
+
+inline void sleepUs(int64_t us) { block(nullptr, us < 0 ? 0 : us); }
+
+// Creates a task; it first runs when the scheduler picks it.
+inline Task* startTask(const char* name, std::function<void()> entry) {
+    Kernel& k = kernel();
+    Task* task = new Task;
+    task->name = name;
+    task->entry = std::move(entry);
+    {
+        std::lock_guard<std::mutex> guard(k.mutex);
+        k.tasks.push_back(task);
+    }
+    std::thread([task] {
+        Kernel& k = kernel();
+        {
+            std::unique_lock<std::mutex> lock(k.mutex);
+            task->cv.wait(lock, [&] { return k.current == task; });
+        }
+        currentTask = task;
+        task->entry();
+        std::unique_lock<std::mutex> lock(k.mutex); // Returned: never runnable again
+        task->blocked = true;
+        switchAway(lock, task);
+        for (;;) task->cv.wait(lock);
+    }).detach();
+    return task;
+}
+
+// Runs the simulation until the clock reaches stopAtUs or the device enters deep sleep.
+inline StopReason runUntil(int64_t stopAtUs) {
+    Kernel& k = kernel();
+    std::unique_lock<std::mutex> lock(k.mutex);
+    if (k.stopReason == STOP_DEEP_SLEEP) return STOP_DEEP_SLEEP;
+    Task* resume = k.parked ? k.parked : (k.tasks.empty() ? nullptr : k.tasks.front());
+    if (!resume) return STOP_DEADLINE;
+    k.parked = nullptr;
+    k.stopAtUs = stopAtUs;
+    k.stopReason = STOP_NONE;
+    k.running = true;
+    k.current = resume;
+    resume->cv.notify_one();
+    k.driverCv.wait(lock, [&] { return !k.running; });
+    return k.stopReason;
+}
+
+inline StopReason runFor(int64_t us) { return runUntil(kernel().nowUs + us); }
+
+// Runs fn on the virtual clock at atUs (esp_timer time), in the context of whichever task advances it.
+inline void scheduleEvent(int64_t atUs, std::function<void()> fn) {
+    Kernel& k = kernel();
+    std::lock_guard<std::mutex> guard(k.mutex);
+    k.events.emplace(atUs, std::move(fn));
+}
+
+inline void notifyGive(Task* task) {
+    Kernel& k = kernel();
+    std::lock_guard<std::mutex> guard(k.mutex);
+    task->notifyValue++;
+}
+
+inline uint32_t notifyTake(bool clearOnExit, int64_t timeoutUs) {
+    Task* me = currentTask;
+    if (me->notifyValue == 0 && timeoutUs > 0) block([me] { return me->notifyValue > 0; }, timeoutUs);
+    Kernel& k = kernel();
+    std::lock_guard<std::mutex> guard(k.mutex);
+    uint32_t value = me->notifyValue;
+    if (value) me->notifyValue = clearOnExit ? 0 : value - 1;
+    return value;
+}
+
+// The device stops here: the week simulation's hook saves state and exits; otherwise the run ends.
+[[noreturn]] inline void deepSleep() {
+    Kernel& k = kernel();
+    if (k.onDeepSleep) k.onDeepSleep();
+    std::unique_lock<std::mutex> lock(k.mutex);
+    k.stopReason = STOP_DEEP_SLEEP;
+    k.current = nullptr;
+    k.parked = nullptr;
+    k.running = false;
+    k.driverCv.notify_all();
+    for (;;) currentTask->cv.wait(lock);
+}
+
+// --- GPIO ---
+struct Pin {
+    int level = 1;       // Pulled up
+    int mode = 0;
+    int intrType = 0;    // gpio_int_type_t; level types only (the firmware re-arms per edge)
+    void (*isr)(void*) = nullptr;
+    void* isrArg = nullptr;
+};
+inline Pin* pins() {
+    static Pin table[40];
+    return table;
+}
+
+inline void firePinInterrupt(int pin) {
+    Pin& p = pins()[pin];
+    bool lowTrigger = p.intrType == 4, highTrigger = p.intrType == 5; // GPIO_INTR_LOW_LEVEL/HIGH_LEVEL
+    if (p.isr && ((lowTrigger && p.level == 0) || (highTrigger && p.level == 1))) p.isr(p.isrArg);
+}
+
+// Drives an input pin from the test (e.g. a button); runs the ISR inline like the GPIO interrupt would.
+inline void setPinLevel(int pin, int level) {
+    pins()[pin].level = level;
+    firePinInterrupt(pin);
+}
+
+// --- Flash and RTC memory ---
+inline std::vector<uint8_t>& eepromFlash() {
+    static std::vector<uint8_t> flash(4096, 0xFF);
+    return flash;
+}
+
+// RTC_DATA_ATTR variables land in this section; the week simulation carries it across boots.
+extern "C" uint8_t __start_rtc_sim_data[] __attribute__((weak));
+extern "C" uint8_t __stop_rtc_sim_data[] __attribute__((weak));
+inline size_t rtcMemorySize() { return __start_rtc_sim_data ? (size_t)(__stop_rtc_sim_data - __start_rtc_sim_data) : 0; }
+inline uint8_t* rtcMemory() { return __start_rtc_sim_data; }
+
+// --- Serial ---
+struct SerialLog {
+    std::string text;
+    std::string input;   // Read by Serial.read()
+    bool echo = false;   // Also write to stdout
+    std::mutex writeLock; // HardwareSerial locks its TX path on the device as well
+};
+inline SerialLog& serialLog() {
+    static SerialLog log;
+    return log;
+}
+inline void serialWrite(const char* data, size_t length) {
+    SerialLog& log = serialLog();
+    std::lock_guard<std::mutex> guard(log.writeLock);
+    log.text.append(data, length);
+    if (log.echo) fwrite(data, 1, length, stdout);
+}
+
+} // namespace hostsim
+
+// Definitions that must exist once per test binary: the libc clock calls read the device's system
+// time, as they do on the ESP32 where newlib's clock is the RTC-kept time.
+#ifdef HOST_SIM_IMPLEMENTATION
+extern "C" time_t time(time_t* out) noexcept {
+    time_t now = (time_t)(hostsim::deviceEpochUs() / 1000000LL);
+    if (out) *out = now;
+    return now;
+}
+extern "C" int gettimeofday(struct timeval* __restrict tv, void* __restrict) noexcept {
+    int64_t us = hostsim::deviceEpochUs();
+    tv->tv_sec = (time_t)(us / 1000000LL);
+    tv->tv_usec = (suseconds_t)(us % 1000000LL);
+    return 0;
+}
+extern "C" int settimeofday(const struct timeval* tv, const struct timezone*) noexcept {
+    hostsim::setDeviceEpochUs((int64_t)tv->tv_sec * 1000000LL + tv->tv_usec);
+    return 0;
+}
+#endif
+
+#endif // HOST_SIM_H
@@ -0,0 +1,15 @@
+#ifndef SECRETS_H
+#define SECRETS_H
+
+// Stand-in for the untracked src/secrets.h in the native simulation suites.
+
+#define WIFI_SSID_1 "sim-ap"
+#define WIFI_PASS_1 "sim-pass"
+#define WIFI_SSID_2 ""
+#define WIFI_PASS_2 ""
+
+// Berlin
+#define MY_LATITUDE 52.5200f
+#define MY_LONGITUDE 13.4050f
+
+#endif // SECRETS_H
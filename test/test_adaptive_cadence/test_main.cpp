@@ -0,0 +1,139 @@
+// Native suite for lib/AdaptiveCadence: the interval stays within its bounds and on divisors of 60 for
+// any volatility, slope and revision come from the right hours, and the per-day fetch and shown-error
+// counters roll over at local midnight (and across a skipped day and the year end).
+#include <unity.h>
+#include <math.h>
+#include <AdaptiveCadence.h>
+
+const AdaptiveCadenceConfig CONFIG = { 15, 60, 1.0f, 0.2f }; // The firmware's ADAPTIVE_* settings
+const int HOURS = 6;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Every volatility, including nonsense, lands on a divisor of 60 inside [min, max]; the interval
+// never grows as the forecast gets more volatile.
+void test_interval_stays_on_divisors_within_bounds(void) {
+    const AdaptiveCadenceConfig configs[] = { CONFIG, { 5, 30, 1.0f, 0.2f }, { 10, 20, 2.0f, 0.5f }, { 1, 60, 1.0f, 0.0f } };
+    for (const AdaptiveCadenceConfig& config : configs) {
+        uint8_t previous = 60;
+        for (float v = -1.0f; v <= 5.0f; v += 0.01f) {
+            uint8_t interval = cadenceIntervalMinutes(v, config);
+            TEST_ASSERT_EQUAL(0, 60 % interval);
+            TEST_ASSERT_TRUE(interval >= config.minIntervalMin);
+            TEST_ASSERT_TRUE(interval <= config.maxIntervalMin);
+            TEST_ASSERT_TRUE(interval <= previous);
+            previous = interval;
+        }
+        TEST_ASSERT_EQUAL(config.minIntervalMin, cadenceIntervalMinutes(config.volatileUvPerHour + 1.0f, config));
+        TEST_ASSERT_EQUAL(config.maxIntervalMin, cadenceIntervalMinutes(config.stableUvPerHour, config));
+    }
+    TEST_ASSERT_EQUAL(CONFIG.maxIntervalMin, cadenceIntervalMinutes(NAN, CONFIG));
+}
+
+// The linear target snaps down to the longest divisor of 60 not above it.
+void test_interval_snaps_down_to_divisors_of_60(void) {
+    TEST_ASSERT_EQUAL(60, cadenceIntervalMinutes(0.2f, CONFIG));
+    TEST_ASSERT_EQUAL(30, cadenceIntervalMinutes(0.3f, CONFIG));   // Target 54.4
+    TEST_ASSERT_EQUAL(30, cadenceIntervalMinutes(0.6f, CONFIG));   // Target 37.5
+    TEST_ASSERT_EQUAL(20, cadenceIntervalMinutes(0.8f, CONFIG));   // Target 26.25
+    TEST_ASSERT_EQUAL(20, cadenceIntervalMinutes(0.9f, CONFIG));   // Target 20.6
+    TEST_ASSERT_EQUAL(15, cadenceIntervalMinutes(0.92f, CONFIG));  // Target 19.5: 20 is above it
+    TEST_ASSERT_EQUAL(15, cadenceIntervalMinutes(0.99f, CONFIG));
+}
+
+// Bounds that are not divisors themselves: never faster than min, even when nothing fits under max.
+void test_off_grid_bounds_never_go_faster_than_min(void) {
+    const AdaptiveCadenceConfig offGrid = { 7, 25, 1.0f, 0.2f };
+    TEST_ASSERT_EQUAL(20, cadenceIntervalMinutes(0.0f, offGrid));
+    TEST_ASSERT_EQUAL(10, cadenceIntervalMinutes(2.0f, offGrid));
+    const AdaptiveCadenceConfig noDivisor = { 7, 9, 1.0f, 0.2f };
+    TEST_ASSERT_EQUAL(10, cadenceIntervalMinutes(2.0f, noDivisor));
+    TEST_ASSERT_EQUAL(10, cadenceIntervalMinutes(0.0f, noDivisor));
+}
+
+// Slope over the next 3 hours only; revision and shown error from hours present in both forecasts.
+void test_decision_reads_slope_revision_and_shown_error(void) {
+    const float uv[HOURS] = { 2.0f, 2.3f, 2.5f, 2.6f, 6.0f, 8.0f }; // The jump after hour 3 is out of the window
+    const int hours[HOURS] = { 11, 12, 13, 14, 15, 16 };
+    CadenceDecision first = cadenceDecide(uv, hours, nullptr, nullptr, HOURS, CONFIG);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.3f, first.slope);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, first.revision);
+    TEST_ASSERT_EQUAL_FLOAT(-1.0f, first.shownError);
+    TEST_ASSERT_EQUAL(30, first.intervalMin);
+
+    // Previous forecast an hour older: hours 11-15 overlap, hour 10 and the placeholder do not count
+    const float previousUV[HOURS] = { 1.0f, 2.4f, 2.3f, 2.5f, 2.6f, -1.0f };
+    const int previousHours[HOURS] = { 10, 11, 12, 13, 14, 15 };
+    CadenceDecision next = cadenceDecide(uv, hours, previousUV, previousHours, HOURS, CONFIG);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.4f, next.shownError);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.4f, next.revision);
+    TEST_ASSERT_EQUAL(30, next.intervalMin);
+
+    const float revisedUV[HOURS] = { 2.0f, 2.3f, 2.5f, 2.6f, 6.0f, 8.0f };
+    const float stalePreviousUV[HOURS] = { 2.0f, 2.3f, 2.5f, 5.0f, 6.0f, 8.0f }; // Hour 14 was 5.0
+    CadenceDecision revised = cadenceDecide(revisedUV, hours, stalePreviousUV, hours, HOURS, CONFIG);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 2.4f, revised.revision);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, revised.shownError);
+    TEST_ASSERT_EQUAL(CONFIG.minIntervalMin, revised.intervalMin);
+}
+
+void test_updates_per_hour_never_exceed_the_mode(void) {
+    TEST_ASSERT_EQUAL(1, cadenceUpdatesPerHour(60, 4));
+    TEST_ASSERT_EQUAL(2, cadenceUpdatesPerHour(30, 4));
+    TEST_ASSERT_EQUAL(4, cadenceUpdatesPerHour(15, 4));
+    TEST_ASSERT_EQUAL(4, cadenceUpdatesPerHour(5, 4));  // A faster interval does not speed the mode up
+    TEST_ASSERT_EQUAL(1, cadenceUpdatesPerHour(15, 1)); // LPM
+    TEST_ASSERT_EQUAL(4, cadenceUpdatesPerHour(0, 4));  // No interval yet
+}
+
+// Fetches count per local day; the first fetch of a new day moves the count to yesterday and clears
+// the shown-error figures. A fetch without a previous value is counted but has no error.
+void test_day_counters_roll_over_at_midnight(void) {
+    CadenceDayStats stats;
+    cadenceDayReset(stats);
+    TEST_ASSERT_EQUAL(-1, stats.dayOfYear);
+    cadenceDayRecord(stats, 170, -1.0f);
+    cadenceDayRecord(stats, 170, 0.5f);
+    cadenceDayRecord(stats, 170, 0.1f);
+    TEST_ASSERT_EQUAL(3, stats.fetchesToday);
+    TEST_ASSERT_EQUAL(0, stats.fetchesYesterday); // First day: nothing before it
+    TEST_ASSERT_EQUAL(2, stats.shownErrorCount);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.6f, stats.shownErrorSum);
+    TEST_ASSERT_EQUAL_FLOAT(0.5f, stats.shownErrorMax);
+
+    cadenceDayRecord(stats, 171, 0.2f);
+    TEST_ASSERT_EQUAL(171, stats.dayOfYear);
+    TEST_ASSERT_EQUAL(1, stats.fetchesToday);
+    TEST_ASSERT_EQUAL(3, stats.fetchesYesterday);
+    TEST_ASSERT_EQUAL(1, stats.shownErrorCount);
+    TEST_ASSERT_EQUAL_FLOAT(0.2f, stats.shownErrorMax);
+
+    // A day with no fetch (device off): "yesterday" had none
+    cadenceDayRecord(stats, 173, -1.0f);
+    TEST_ASSERT_EQUAL(0, stats.fetchesYesterday);
+    TEST_ASSERT_EQUAL(1, stats.fetchesToday);
+}
+
+void test_day_counters_roll_over_at_the_year_end(void) {
+    CadenceDayStats stats;
+    cadenceDayReset(stats);
+    for (int n = 0; n < 40; ++n) cadenceDayRecord(stats, 364, -1.0f); // Dec 31 of a common year
+    cadenceDayRecord(stats, 0, -1.0f);
+    TEST_ASSERT_EQUAL(40, stats.fetchesYesterday);
+    for (int n = 0; n < 5; ++n) cadenceDayRecord(stats, 365, -1.0f); // ... and a leap year's last day
+    cadenceDayRecord(stats, 0, -1.0f);
+    TEST_ASSERT_EQUAL(5, stats.fetchesYesterday);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_interval_stays_on_divisors_within_bounds);
+    RUN_TEST(test_interval_snaps_down_to_divisors_of_60);
+    RUN_TEST(test_off_grid_bounds_never_go_faster_than_min);
+    RUN_TEST(test_decision_reads_slope_revision_and_shown_error);
+    RUN_TEST(test_updates_per_hour_never_exceed_the_mode);
+    RUN_TEST(test_day_counters_roll_over_at_midnight);
+    RUN_TEST(test_day_counters_roll_over_at_the_year_end);
+    return UNITY_END();
+}
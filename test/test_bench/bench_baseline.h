@@ -0,0 +1,41 @@
+#ifndef BENCH_BASELINE_H
+#define BENCH_BASELINE_H
+
+// Relative cost of each path (ns per operation / calibration ns), recorded with BENCH_RECORD=1 on an
+// x86-64 host, g++ 12 -O2 (env:native_bench). Re-record when a change is meant to move a number.
+struct BenchBaseline {
+    const char* name;
+    double relative;
+};
+
+#define BENCH_BASELINE_COUNT 10
+const BenchBaseline BENCH_BASELINE[BENCH_BASELINE_COUNT] = {
+    { "scheduler", 0.01283 },   // Per time
+    { "parse_1d", 0.6324 },
+    { "parse_2d", 1.625 },
+    { "parse_7d", 16.43 },
+    { "ipgeo_parse", 0.02656 },
+    { "http_get", 0.4201 },      // Loopback GET + parse, 1-day body
+    { "http_get_chunked", 0.4263 },
+    { "http_get_stock", 0.4423 }, // The HTTPClient + getString() path on the same socket
+    { "http_get_stock_chunked", 0.4043 },
+    { "render", 0.9019 },
+};
+
+// Heap of one GET + parse of the 1-day body: peak bytes held at once (operator new and the document's
+// allocator, usable sizes) and allocations made, for the lean reader and the stock path it replaced.
+struct BenchHeapBaseline {
+    const char* name;
+    uint32_t peakBytes;
+    uint32_t allocations;
+};
+
+#define BENCH_HEAP_BASELINE_COUNT 4
+const BenchHeapBaseline BENCH_HEAP_BASELINE[BENCH_HEAP_BASELINE_COUNT] = {
+    { "http_get", 6000, 79 },          // The document's pool and strings only
+    { "http_get_chunked", 6000, 79 },
+    { "http_get_stock", 7624, 124 },    // + the head Strings and the body copied into a String
+    { "http_get_stock_chunked", 7832, 127 },
+};
+
+#endif // BENCH_BASELINE_H
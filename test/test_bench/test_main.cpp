@@ -0,0 +1,422 @@
+// Native benchmark suite (pio test -e native_bench): the hot paths of the device's "bench" command and
+// an Open-Meteo GET on a loopback socket, through the lean HTTP reader and through a replay of the
+// stock HTTPClient path it replaced, timed and heap-metered on the host against the stored baseline in
+// bench_baseline.h. Times are divided by a fixed calibration workload measured in
+// the same run, so the baseline carries across machines; a path fails when its relative cost exceeds
+// the baseline by more than BENCH_REGRESSION_FACTOR.
+//
+// Results go to stdout and, as JSON, to $BENCH_RESULTS (default bench_results.json) for diffing
+// between commits. BENCH_RECORD=1 prints a new bench_baseline.h instead of checking.
+#define HOST_SIM_IMPLEMENTATION
+#include <unity.h>
+#include <Arduino.h>
+#include <WiFi.h> // configTime() starts the simulated SNTP client defined there
+#include <TFT_eSPI.h>
+#include <Client.h>
+#include <HttpResponseReader.h>
+#include <chrono>
+#include <functional>
+#include <malloc.h>
+#include <new>
+#include "bench_baseline.h"
+
+// --- Firmware internals (src/main.cpp) ---
+String buildOpenMeteoBenchPayload(int days);
+uint32_t benchSchedulerPass();
+uint32_t benchParsePass(const String& payload);
+uint32_t benchIpGeoPass();
+void benchRenderPass(TFT_eSprite& frame);
+extern TFT_eSPI tft;
+extern float hourlyUV[];
+extern int forecastHours[];
+
+const double BENCH_REGRESSION_FACTOR = 2.0; // Run-to-run spread on one machine is up to ~1.6x (render)
+const int BENCH_SCHEDULER_TIMES = 4 * 96; // Times in one benchSchedulerPass()
+const int REPEATS = 7;                    // Best of, against scheduling noise
+const double MIN_SAMPLE_NS = 20e6;        // Each sample runs the pass at least this long
+const double BENCH_HEAP_REGRESSION_FACTOR = 1.25; // Heap is deterministic for a given libstdc++; leave room for another
+const size_t UV_RESPONSE_MAX_BYTES = 8192; // As in main.cpp
+const size_t HTTP_TCP_BUFFER_SIZE = 1436;  // HTTPClient's transfer buffer
+const char OPEN_METEO_REQUEST[] = "GET /v1/forecast?latitude=52.5196&longitude=13.4069&hourly=uv_index&forecast_days=1&timezone=auto HTTP/1.1\r\n"
+                                  "Host: api.open-meteo.com\r\nUser-Agent: uv-monitor\r\nAccept: application/json\r\n"
+                                  "Accept-Encoding: identity\r\nConnection: close\r\n\r\n";
+
+struct BenchResult {
+    const char* name;
+    double ns;        // Per operation
+    double relative;  // ns / calibration ns
+};
+BenchResult results[BENCH_BASELINE_COUNT];
+int resultCount = 0;
+
+struct HeapResult {
+    const char* name;
+    uint32_t peakBytes;
+    uint32_t allocations;
+};
+HeapResult heapResults[BENCH_HEAP_BASELINE_COUNT];
+int heapResultCount = 0;
+double calibrationNs = 0.0;
+volatile uint32_t sink = 0;
+
+static double nowNs() {
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Best-of-REPEATS time of one pass, in ns. Each sample repeats the pass until MIN_SAMPLE_NS has passed.
+static double timePass(const std::function<uint32_t()>& pass) {
+    int perSample = 1;
+    for (double start = nowNs(); nowNs() - start < MIN_SAMPLE_NS / 10; perSample *= 2)
+        for (int n = 0; n < perSample; ++n) sink += pass();
+    double best = 1e30;
+    for (int r = 0; r < REPEATS; ++r) {
+        int passes = 0;
+        double start = nowNs(), elapsed;
+        do {
+            for (int n = 0; n < perSample; ++n) sink += pass();
+            passes += perSample;
+            elapsed = nowNs() - start;
+        } while (elapsed < MIN_SAMPLE_NS);
+        if (elapsed / passes < best) best = elapsed / passes;
+    }
+    return best;
+}
+
+// Integer hashing and float work over a small table, roughly the mix of the measured paths.
+static uint32_t calibrationPass() {
+    static uint32_t table[1024];
+    uint32_t hash = 2166136261u;
+    float acc = 0.0f;
+    for (int i = 0; i < 4096; ++i) {
+        uint32_t& slot = table[(hash >> 7) & 1023];
+        slot += hash;
+        hash = (hash ^ slot) * 16777619u;
+        acc += sinf((float)(hash & 0xFFFF) * 1e-4f);
+    }
+    return hash + (uint32_t)acc;
+}
+
+// --- Heap accounting ---
+// Bytes held through operator new (String, the stock path's buffers) and through the documents'
+// allocator, with the peak and the allocation count while metering.
+class HeapMeter : public ArduinoJson::Allocator {
+public:
+    void* allocate(size_t size) override { return note(malloc(size)); }
+    void deallocate(void* ptr) override {
+        forget(ptr);
+        free(ptr);
+    }
+    void* reallocate(void* ptr, size_t size) override {
+        forget(ptr);
+        return note(realloc(ptr, size));
+    }
+    void* note(void* p) {
+        if (p && metering) {
+            allocations++;
+            held += (int64_t)malloc_usable_size(p);
+            if (held > peak) peak = held;
+        }
+        return p;
+    }
+    void forget(void* p) {
+        if (p && metering) held -= (int64_t)malloc_usable_size(p);
+    }
+    void start() {
+        held = peak = 0;
+        allocations = 0;
+        metering = true;
+    }
+    void stop() { metering = false; }
+
+    bool metering = false;
+    int64_t held = 0;
+    int64_t peak = 0;
+    uint32_t allocations = 0;
+};
+HeapMeter heapMeter;
+
+void* operator new(size_t size) {
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return heapMeter.note(p);
+}
+void operator delete(void* p) noexcept {
+    heapMeter.forget(p);
+    free(p);
+}
+void operator delete(void* p, size_t) noexcept {
+    heapMeter.forget(p);
+    free(p);
+}
+
+// A server socket replaying one canned response from memory, so a GET costs only the reader and parser.
+class LoopbackClient : public Client {
+public:
+    explicit LoopbackClient(const std::string& response) : response(response) {}
+    int connect(const char*, uint16_t) override { return 1; }
+    size_t write(uint8_t c) override { return 1; }
+    size_t write(const uint8_t*, size_t size) override { return size; }
+    int available() override { return (int)(response.size() - offset); }
+    int read() override { return offset < response.size() ? (uint8_t)response[offset++] : -1; }
+    int read(uint8_t* buffer, size_t size) override {
+        size_t n = std::min(size, response.size() - offset);
+        memcpy(buffer, response.data() + offset, n);
+        offset += n;
+        return (int)n;
+    }
+    int peek() override { return offset < response.size() ? (uint8_t)response[offset] : -1; }
+    void flush() override {}
+    void stop() override { offset = response.size(); }
+    uint8_t connected() override { return offset < response.size(); }
+private:
+    const std::string& response;
+    size_t offset = 0;
+};
+
+// One Open-Meteo fetch as fetchUVData() does it: request out, head, body de-framed into the document.
+static uint32_t httpGetPass(const std::string& response) {
+    LoopbackClient client(response);
+    HttpResponseReader reader(client);
+    JsonDocument doc(&heapMeter);
+    if (reader.get(OPEN_METEO_REQUEST, sizeof(OPEN_METEO_REQUEST) - 1, 1000) != HTTP_STATUS_OK) return 0;
+    if (reader.parseJson(doc, UV_RESPONSE_MAX_BYTES)) return 0;
+    return (uint32_t)reader.bodyBytes + doc["hourly"]["uv_index"].size();
+}
+
+// The same fetch the way it went before the lean reader, through arduino-esp32 2.x HTTPClient: URL and
+// request head built as Strings, every head line read into a String and split into name and value, the
+// collected Content-Type kept, the body copied whole into a String by getString() (through the 1436-byte
+// transfer buffer, chunk sizes read as lines), then deserializeJson() from that String.
+struct RequestArgument {
+    String key;
+    String value;
+};
+
+static uint32_t httpGetStockPass(const std::string& response) {
+    LoopbackClient client(response);
+    String url = String("https://api.open-meteo.com/v1/forecast") + "?latitude=" + String(52.5196f, 4) + "&longitude=" +
+                 String(13.4069f, 4) + "&hourly=uv_index&forecast_days=1&timezone=auto";
+    int hostStart = url.indexOf("//") + 2, pathStart = url.indexOf('/', hostStart); // begin(url)
+    String host = url.substring(hostStart, pathStart);
+    String uri = url.substring(pathStart);
+    RequestArgument* currentHeaders = new RequestArgument[1]; // collectHeaders()
+    currentHeaders[0].key = "Content-Type";
+
+    String head = String("GET ") + uri + " HTTP/1.1\r\n"; // sendHeader()
+    head += "Host: ";
+    head += host;
+    head += "\r\nUser-Agent: ESP32HTTPClient\r\nConnection: close\r\nAccept-Encoding: identity;q=1,chunked;q=0.1,*;q=0\r\n\r\n";
+    client.write((const uint8_t*)head.c_str(), head.length());
+
+    int code = 0, size = -1; // handleHeaderResponse()
+    String transferEncoding;
+    while (client.connected() || client.available()) {
+        String headerLine = client.readStringUntil('\n');
+        headerLine.trim();
+        if (headerLine.startsWith("HTTP/1.")) {
+            code = headerLine.substring(9, headerLine.indexOf(' ', 9)).toInt();
+        } else if (headerLine.indexOf(':') > 0) {
+            String headerName = headerLine.substring(0, headerLine.indexOf(':'));
+            String headerValue = headerLine.substring(headerLine.indexOf(':') + 1);
+            headerValue.trim();
+            if (headerName.equalsIgnoreCase("Content-Length")) size = headerValue.toInt();
+            if (headerName.equalsIgnoreCase("Transfer-Encoding")) transferEncoding = headerValue;
+            if (headerName.equalsIgnoreCase(currentHeaders[0].key)) currentHeaders[0].value = headerValue;
+        } else if (headerLine.isEmpty()) {
+            break;
+        }
+    }
+
+    uint32_t checksum = 0;
+    if (code == HTTP_STATUS_OK && currentHeaders[0].value.indexOf("json") >= 0 && size <= (int)UV_RESPONSE_MAX_BYTES) {
+        String payload; // getString(): a StreamString the body is written into
+        if (size > 0) payload.reserve(size + 1);
+        uint8_t* buffer = new uint8_t[HTTP_TCP_BUFFER_SIZE];
+        auto copyBlock = [&](int length) { // writeToStreamDataBlock()
+            while (client.connected() && length > 0) {
+                size_t n = std::min({ (size_t)client.available(), HTTP_TCP_BUFFER_SIZE, (size_t)length });
+                n = client.readBytes(buffer, n);
+                payload.concat((const char*)buffer, n);
+                length -= (int)n;
+            }
+        };
+        if (transferEncoding.equalsIgnoreCase("chunked")) {
+            while (client.connected()) {
+                String chunkHeader = client.readStringUntil('\n');
+                chunkHeader.trim();
+                int length = (int)strtol(chunkHeader.c_str(), nullptr, 16);
+                if (length == 0) break;
+                copyBlock(length);
+                char crlf[2];
+                client.readBytes(crlf, 2);
+            }
+        } else {
+            copyBlock(size);
+        }
+        delete[] buffer;
+        JsonDocument doc(&heapMeter);
+        if (!deserializeJson(doc, payload)) checksum = payload.length() + doc["hourly"]["uv_index"].size();
+    }
+    delete[] currentHeaders;
+    return checksum;
+}
+
+static const double* baselineOf(const char* name) {
+    for (int i = 0; i < BENCH_BASELINE_COUNT; ++i)
+        if (strcmp(BENCH_BASELINE[i].name, name) == 0) return &BENCH_BASELINE[i].relative;
+    return nullptr;
+}
+
+static void measure(const char* name, int operations, const std::function<uint32_t()>& pass) {
+    double ns = timePass(pass) / operations;
+    results[resultCount++] = { name, ns, ns / calibrationNs };
+    printf("  %-22s %10.1f ns  %8.4g x calibration\n", name, ns, ns / calibrationNs);
+    if (getenv("BENCH_RECORD")) return;
+    const double* baseline = baselineOf(name);
+    TEST_ASSERT_NOT_NULL_MESSAGE(baseline, name);
+    char message[96];
+    snprintf(message, sizeof(message), "%s: %.4g x calibration, baseline %.4g", name, ns / calibrationNs, *baseline);
+    TEST_ASSERT_TRUE_MESSAGE(ns / calibrationNs <= *baseline * BENCH_REGRESSION_FACTOR, message);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_calibration(void) {
+    calibrationNs = timePass(calibrationPass);
+    printf("  calibration            %10.1f ns\n", calibrationNs);
+    TEST_ASSERT_TRUE(calibrationNs > 0.0);
+}
+
+void test_scheduler(void) {
+    configTime(7200, 0, "pool.ntp.org"); // What the first Open-Meteo answer sets
+    measure("scheduler", BENCH_SCHEDULER_TIMES, benchSchedulerPass);
+}
+
+void test_parse(void) {
+    static const String payloads[3] = { buildOpenMeteoBenchPayload(1), buildOpenMeteoBenchPayload(2), buildOpenMeteoBenchPayload(7) };
+    measure("parse_1d", 1, [] { return benchParsePass(payloads[0]); });
+    measure("parse_2d", 1, [] { return benchParsePass(payloads[1]); });
+    measure("parse_7d", 1, [] { return benchParsePass(payloads[2]); });
+}
+
+void test_ipgeo_parse(void) {
+    measure("ipgeo_parse", 1, benchIpGeoPass);
+}
+
+static const BenchHeapBaseline* heapBaselineOf(const char* name) {
+    for (int i = 0; i < BENCH_HEAP_BASELINE_COUNT; ++i)
+        if (strcmp(BENCH_HEAP_BASELINE[i].name, name) == 0) return &BENCH_HEAP_BASELINE[i];
+    return nullptr;
+}
+
+// Peak bytes held and allocations made by one pass.
+static HeapResult meterHeap(const char* name, const std::function<uint32_t()>& pass) {
+    heapMeter.start();
+    sink += pass();
+    heapMeter.stop();
+    HeapResult r = { name, (uint32_t)heapMeter.peak, heapMeter.allocations };
+    heapResults[heapResultCount++] = r;
+    printf("  %-22s %6u B peak  %4u allocations\n", name, (unsigned)r.peakBytes, (unsigned)r.allocations);
+    if (getenv("BENCH_RECORD")) return r;
+    const BenchHeapBaseline* baseline = heapBaselineOf(name);
+    TEST_ASSERT_NOT_NULL_MESSAGE(baseline, name);
+    char message[96];
+    snprintf(message, sizeof(message), "%s: %u B peak, %u allocations; baseline %u B, %u", name, (unsigned)r.peakBytes,
+             (unsigned)r.allocations, (unsigned)baseline->peakBytes, (unsigned)baseline->allocations);
+    TEST_ASSERT_TRUE_MESSAGE(r.peakBytes <= baseline->peakBytes * BENCH_HEAP_REGRESSION_FACTOR, message);
+    TEST_ASSERT_TRUE_MESSAGE(r.allocations <= baseline->allocations * BENCH_HEAP_REGRESSION_FACTOR, message);
+    return r;
+}
+
+// The 1-day Open-Meteo response, with Content-Length and with chunked framing (512-byte chunks).
+std::string sizedResponse, chunkedResponse;
+size_t responseBodyBytes = 0;
+
+// The lean reader and the stock path on the same loopback responses: same body, same document.
+void test_http_get(void) {
+    std::string body = buildOpenMeteoBenchPayload(1).c_str();
+    std::string& sized = sizedResponse;
+    std::string& chunked = chunkedResponse;
+    responseBodyBytes = body.size();
+    sized = "HTTP/1.1 200 OK\r\nContent-Type: application/json; charset=utf-8\r\nContent-Length: " + std::to_string(body.size()) +
+            "\r\nConnection: close\r\n\r\n" + body;
+    chunked = "HTTP/1.1 200 OK\r\nContent-Type: application/json; charset=utf-8\r\nTransfer-Encoding: chunked\r\nConnection: close\r\n\r\n";
+    for (size_t offset = 0; offset < body.size(); offset += 512) {
+        std::string chunk = body.substr(offset, 512);
+        char size[16];
+        snprintf(size, sizeof(size), "%zx\r\n", chunk.size());
+        chunked += size + chunk + "\r\n";
+    }
+    chunked += "0\r\n\r\n";
+    TEST_ASSERT_EQUAL_UINT32(httpGetPass(sized), httpGetPass(chunked));
+    TEST_ASSERT_TRUE(httpGetPass(sized) > body.size());
+    TEST_ASSERT_EQUAL_UINT32(httpGetPass(sized), httpGetStockPass(sized));
+    TEST_ASSERT_EQUAL_UINT32(httpGetPass(sized), httpGetStockPass(chunked));
+    measure("http_get", 1, [] { return httpGetPass(sizedResponse); });
+    measure("http_get_chunked", 1, [] { return httpGetPass(chunkedResponse); });
+    measure("http_get_stock", 1, [] { return httpGetStockPass(sizedResponse); });
+    measure("http_get_stock_chunked", 1, [] { return httpGetStockPass(chunkedResponse); });
+    printf("  stock / lean time: %.2fx Content-Length, %.2fx chunked\n", results[resultCount - 2].ns / results[resultCount - 4].ns,
+           results[resultCount - 1].ns / results[resultCount - 3].ns);
+}
+
+// What each path holds on the heap for the same fetch. The lean reader's only allocations are the
+// document's; the stock path adds the head Strings and the whole body.
+void test_http_heap(void) {
+    HeapResult lean = meterHeap("http_get", [] { return httpGetPass(sizedResponse); });
+    HeapResult leanChunked = meterHeap("http_get_chunked", [] { return httpGetPass(chunkedResponse); });
+    HeapResult stock = meterHeap("http_get_stock", [] { return httpGetStockPass(sizedResponse); });
+    HeapResult stockChunked = meterHeap("http_get_stock_chunked", [] { return httpGetStockPass(chunkedResponse); });
+    printf("  stock - lean peak: %d B Content-Length, %d B chunked, for a %u B body\n", (int)(stock.peakBytes - lean.peakBytes),
+           (int)(stockChunked.peakBytes - leanChunked.peakBytes), (unsigned)responseBodyBytes);
+    TEST_ASSERT_TRUE(lean.peakBytes + responseBodyBytes <= stock.peakBytes);
+    TEST_ASSERT_TRUE(leanChunked.peakBytes + responseBodyBytes <= stockChunked.peakBytes);
+    TEST_ASSERT_TRUE(lean.allocations < stock.allocations);
+    TEST_ASSERT_TRUE(leanChunked.allocations < stockChunked.allocations);
+}
+
+void test_render(void) {
+    for (int i = 0; i < 6; ++i) {
+        forecastHours[i] = 11 + i;
+        hourlyUV[i] = 2.0f + i * 1.3f;
+    }
+    tft.setRotation(1);
+    TFT_eSprite frame(&tft);
+    TEST_ASSERT_NOT_NULL(frame.createSprite(tft.width(), tft.height()));
+    measure("render", 1, [&frame] {
+        benchRenderPass(frame);
+        return (uint32_t)((uint16_t*)frame.getPointer())[0];
+    });
+}
+
+void test_write_results(void) {
+    const char* path = getenv("BENCH_RESULTS") ? getenv("BENCH_RESULTS") : "bench_results.json";
+    FILE* out = fopen(path, "w");
+    TEST_ASSERT_NOT_NULL_MESSAGE(out, path);
+    fprintf(out, "{\"bench\":\"uv-monitor-native\",\"calibration_ns\":%.1f", calibrationNs);
+    for (int i = 0; i < resultCount; ++i) fprintf(out, ",\"%s_ns\":%.1f,\"%s_rel\":%.4f", results[i].name, results[i].ns, results[i].name, results[i].relative);
+    for (int i = 0; i < heapResultCount; ++i)
+        fprintf(out, ",\"%s_heap_peak\":%u,\"%s_allocations\":%u", heapResults[i].name, (unsigned)heapResults[i].peakBytes, heapResults[i].name,
+                (unsigned)heapResults[i].allocations);
+    fprintf(out, "}\n");
+    fclose(out);
+    if (!getenv("BENCH_RECORD")) return;
+    printf("\n#define BENCH_BASELINE_COUNT %d\n", resultCount);
+    for (int i = 0; i < resultCount; ++i) printf("    { \"%s\", %.4g },\n", results[i].name, results[i].relative);
+    printf("\n#define BENCH_HEAP_BASELINE_COUNT %d\n", heapResultCount);
+    for (int i = 0; i < heapResultCount; ++i) printf("    { \"%s\", %u, %u },\n", heapResults[i].name, (unsigned)heapResults[i].peakBytes, (unsigned)heapResults[i].allocations);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_calibration);
+    RUN_TEST(test_scheduler);
+    RUN_TEST(test_parse);
+    RUN_TEST(test_ipgeo_parse);
+    RUN_TEST(test_http_get);
+    RUN_TEST(test_http_heap);
+    RUN_TEST(test_render);
+    RUN_TEST(test_write_results);
+    return UNITY_END();
+}
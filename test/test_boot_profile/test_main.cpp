@@ -0,0 +1,105 @@
+// Native suite for lib/BootProfile: step ordering (out-of-enum order, ties, unreached steps), the
+// printed profile line, and the RTC running means across counter and sum overflow.
+#include <unity.h>
+#include <string.h>
+#include <BootProfile.h>
+
+const char* const NAMES[] = { "wifi_kick", "serial", "display", "fetch", "done" };
+const uint8_t STEPS = 5;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_order_follows_end_times(void) {
+    const int64_t stepUs[STEPS] = { 1200, 2400, 9000, 5000, 9500 }; // Display came up after the fetch
+    uint8_t order[BOOT_PROFILE_MAX_STEPS];
+    TEST_ASSERT_EQUAL(5, bootProfileOrder(stepUs, STEPS, order));
+    const uint8_t expected[] = { 0, 1, 3, 2, 4 };
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, order, 5);
+}
+
+void test_unreached_steps_are_skipped(void) {
+    const int64_t stepUs[STEPS] = { 1200, 0, 0, 5000, 6000 }; // Silent timer wake: no serial wait, no display
+    uint8_t order[BOOT_PROFILE_MAX_STEPS];
+    TEST_ASSERT_EQUAL(3, bootProfileOrder(stepUs, STEPS, order));
+    const uint8_t expected[] = { 0, 3, 4 };
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, order, 3);
+    const int64_t none[STEPS] = {};
+    TEST_ASSERT_EQUAL(0, bootProfileOrder(none, STEPS, order));
+}
+
+// Steps stamped in the same microsecond all appear, in step order (a loop that stepped past the
+// previous stamp with ">" dropped them).
+void test_equal_stamps_keep_step_order(void) {
+    const int64_t stepUs[STEPS] = { 3000, 3000, 1000, 3000, 3000 };
+    uint8_t order[BOOT_PROFILE_MAX_STEPS];
+    TEST_ASSERT_EQUAL(5, bootProfileOrder(stepUs, STEPS, order));
+    const uint8_t expected[] = { 2, 0, 1, 3, 4 };
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, order, 5);
+}
+
+void test_format_prints_durations_and_end_times(void) {
+    const int64_t stepUs[STEPS] = { 1200, 0, 0, 5000, 6100 };
+    char out[128];
+    size_t length = bootProfileFormat(stepUs, NAMES, STEPS, out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING(" wifi_kick +1.2@1.2 fetch +3.8@5.0 done +1.1@6.1 ms", out);
+    TEST_ASSERT_EQUAL(strlen(out), length);
+}
+
+void test_format_truncates_like_snprintf(void) {
+    const int64_t stepUs[STEPS] = { 1200, 2400, 9000, 5000, 9500 };
+    char full[256];
+    size_t length = bootProfileFormat(stepUs, NAMES, STEPS, full, sizeof(full));
+    for (size_t size = 0; size < length + 2; ++size) {
+        char out[256];
+        memset(out, 'x', sizeof(out));
+        TEST_ASSERT_EQUAL(length, bootProfileFormat(stepUs, NAMES, STEPS, out, size));
+        TEST_ASSERT_EQUAL('x', out[size]); // Nothing written past size
+        if (size == 0) continue;
+        TEST_ASSERT_EQUAL(size - 1 < length ? size - 1 : length, strlen(out));
+        TEST_ASSERT_EQUAL_MEMORY(full, out, strlen(out));
+    }
+}
+
+void test_running_mean(void) {
+    RunningMean mean = {};
+    TEST_ASSERT_EQUAL(0, runningMeanValue(mean));
+    runningMeanAdd(mean, 900);
+    runningMeanAdd(mean, 1100);
+    TEST_ASSERT_EQUAL(1000, runningMeanValue(mean));
+    TEST_ASSERT_EQUAL(2, mean.count);
+}
+
+// ~65k wakes at 4 an hour is under two years: the count halves instead of wrapping to 0, and the mean
+// then moves towards new samples.
+void test_running_mean_survives_count_overflow(void) {
+    RunningMean mean = {};
+    for (uint32_t i = 0; i < 70000; ++i) runningMeanAdd(mean, 1500);
+    TEST_ASSERT_EQUAL(1500, runningMeanValue(mean));
+    TEST_ASSERT_TRUE(mean.count > 30000);
+    for (uint32_t i = 0; i < 200000; ++i) runningMeanAdd(mean, 800);
+    TEST_ASSERT_UINT32_WITHIN(10, 800, runningMeanValue(mean));
+}
+
+// Huge samples (a stamp taken across a clock jump) halve the sum before it would wrap.
+void test_running_mean_survives_sum_overflow(void) {
+    RunningMean mean = {};
+    for (int i = 0; i < 10; ++i) runningMeanAdd(mean, 1000000000u);
+    TEST_ASSERT_EQUAL(1000000000u, runningMeanValue(mean));
+    runningMeanAdd(mean, UINT32_MAX);
+    TEST_ASSERT_EQUAL(1, mean.count);
+    TEST_ASSERT_EQUAL(UINT32_MAX, runningMeanValue(mean));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_order_follows_end_times);
+    RUN_TEST(test_unreached_steps_are_skipped);
+    RUN_TEST(test_equal_stamps_keep_step_order);
+    RUN_TEST(test_format_prints_durations_and_end_times);
+    RUN_TEST(test_format_truncates_like_snprintf);
+    RUN_TEST(test_running_mean);
+    RUN_TEST(test_running_mean_survives_count_overflow);
+    RUN_TEST(test_running_mean_survives_sum_overflow);
+    return UNITY_END();
+}
@@ -0,0 +1,253 @@
+// Native suite for lib/ButtonGesture: synthetic raw edge sequences (with contact bounce) are run
+// through a model of the firmware's timers and the resulting event stream is checked.
+#include <unity.h>
+#include <stdio.h>
+#include <vector>
+#include <ButtonGesture.h>
+
+const uint32_t DEBOUNCE_MS = 50; // DEBOUNCE_TIME_MS in main.cpp
+const ButtonTiming TIMING = { 1000, 300, 300 };
+
+struct RawEdge {
+    uint32_t atMs;
+    bool pressed;
+};
+struct Emitted {
+    ButtonEventType type;
+    uint32_t timestampMs;
+    uint32_t emittedAtMs;
+};
+
+// One button as the firmware wires it: every edge (re)starts a one-shot debounce timer whose
+// callback samples the pin; the gesture timer is one-shot and re-armed by the steps themselves.
+// Matches xTimerReset/xTimerChangePeriod/xTimerStop semantics at 1 ms resolution.
+struct ButtonSim {
+    GestureState state;
+    bool detectDouble;
+    bool holdRepeat;
+    bool level = false;
+    uint32_t lastEdgeMs = 0;
+    bool debounceArmed = false;
+    uint32_t debounceDueMs = 0;
+    bool gestureArmed = false;
+    uint32_t gestureDueMs = 0;
+    std::vector<Emitted> events;
+
+    ButtonSim(bool detectDouble_, bool holdRepeat_, bool pressedAtBoot = false)
+        : detectDouble(detectDouble_), holdRepeat(holdRepeat_), level(pressedAtBoot) {
+        gestureReset(state, pressedAtBoot);
+    }
+
+    void apply(const GestureStep& step, uint32_t nowMs) {
+        if (step.timer == GESTURE_TIMER_ARM) { gestureArmed = true; gestureDueMs = nowMs + step.timerPeriodMs; }
+        else if (step.timer == GESTURE_TIMER_STOP) gestureArmed = false;
+        if (step.emit) events.push_back({ step.type, step.timestampMs, nowMs });
+    }
+
+    void run(const std::vector<RawEdge>& edges, uint32_t untilMs) {
+        size_t next = 0;
+        for (uint32_t now = 0; now <= untilMs; ++now) {
+            while (next < edges.size() && edges[next].atMs == now) {
+                if (edges[next].pressed != level) { // Level-triggered ISR only sees real changes
+                    level = edges[next].pressed;
+                    lastEdgeMs = now;
+                    debounceArmed = true;
+                    debounceDueMs = now + DEBOUNCE_MS;
+                }
+                next++;
+            }
+            if (debounceArmed && now == debounceDueMs) {
+                debounceArmed = false;
+                apply(gestureOnDebounced(state, level, lastEdgeMs, now, detectDouble, TIMING), now);
+            }
+            if (gestureArmed && now == gestureDueMs) {
+                gestureArmed = false;
+                apply(gestureOnTimer(state, holdRepeat, TIMING), now);
+            }
+        }
+    }
+};
+
+// A press from downMs to upMs with `bounces` extra chatter edges 1 ms apart on both transitions.
+static void addPress(std::vector<RawEdge>& edges, uint32_t downMs, uint32_t upMs, int bounces = 0) {
+    for (int i = 0; i < bounces; ++i) {
+        edges.push_back({ downMs + 2 * i, true });
+        edges.push_back({ downMs + 2 * i + 1, false });
+    }
+    edges.push_back({ downMs + 2 * bounces, true });
+    for (int i = 0; i < bounces; ++i) {
+        edges.push_back({ upMs + 2 * i, false });
+        edges.push_back({ upMs + 2 * i + 1, true });
+    }
+    edges.push_back({ upMs + 2 * bounces, false });
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_clean_short_press(void) {
+    ButtonSim button(false, false);
+    std::vector<RawEdge> edges;
+    addPress(edges, 100, 250);
+    button.run(edges, 2000);
+    TEST_ASSERT_EQUAL(1, button.events.size());
+    TEST_ASSERT_EQUAL(BUTTON_EVENT_SHORT, button.events[0].type);
+    TEST_ASSERT_EQUAL_UINT32(100, button.events[0].timestampMs);
+    TEST_ASSERT_EQUAL_UINT32(250 + DEBOUNCE_MS, button.events[0].emittedAtMs); // No double-click wait
+}
+
+void test_bouncy_contacts_give_one_press(void) {
+    ButtonSim button(false, false);
+    std::vector<RawEdge> edges;
+    addPress(edges, 100, 300, 6);
+    button.run(edges, 2000);
+    TEST_ASSERT_EQUAL(1, button.events.size());
+    TEST_ASSERT_EQUAL(BUTTON_EVENT_SHORT, button.events[0].type);
+    TEST_ASSERT_EQUAL_UINT32(100 + 12, button.events[0].timestampMs); // Last edge of the press burst
+}
+
+// A pulse shorter than the debounce period settles back before the pin is sampled.
+void test_glitch_shorter_than_debounce_is_ignored(void) {
+    ButtonSim button(true, true);
+    std::vector<RawEdge> edges = { { 100, true }, { 100 + DEBOUNCE_MS - 10, false } };
+    button.run(edges, 2000);
+    TEST_ASSERT_EQUAL(0, button.events.size());
+}
+
+void test_long_press(void) {
+    ButtonSim button(true, false);
+    std::vector<RawEdge> edges;
+    addPress(edges, 100, 1800, 3);
+    button.run(edges, 3000);
+    TEST_ASSERT_EQUAL(1, button.events.size());
+    TEST_ASSERT_EQUAL(BUTTON_EVENT_LONG, button.events[0].type);
+    TEST_ASSERT_EQUAL_UINT32(106 + TIMING.longPressMs, button.events[0].emittedAtMs); // Measured from the edge, not the debounce
+}
+
+void test_hold_repeat(void) {
+    ButtonSim button(false, true);
+    std::vector<RawEdge> edges;
+    addPress(edges, 0, 2050);
+    button.run(edges, 3000);
+    TEST_ASSERT_EQUAL(4, button.events.size());
+    TEST_ASSERT_EQUAL(BUTTON_EVENT_LONG, button.events[0].type);
+    const uint32_t expectedAt[] = { 1000, 1300, 1600, 1900 };
+    for (size_t i = 0; i < button.events.size(); ++i) {
+        if (i > 0) TEST_ASSERT_EQUAL(BUTTON_EVENT_HOLD_REPEAT, button.events[i].type);
+        TEST_ASSERT_EQUAL_UINT32(expectedAt[i], button.events[i].emittedAtMs);
+    }
+}
+
+void test_double_click(void) {
+    ButtonSim button(true, false);
+    std::vector<RawEdge> edges;
+    addPress(edges, 100, 180, 2);
+    addPress(edges, 330, 420, 2);
+    button.run(edges, 2000);
+    TEST_ASSERT_EQUAL(1, button.events.size());
+    TEST_ASSERT_EQUAL(BUTTON_EVENT_DOUBLE, button.events[0].type);
+}
+
+// The documented cost of double-click detection: a single short press on such a button is
+// reported DOUBLE_CLICK_WINDOW_MS after its debounced release.
+void test_single_click_waits_for_double_window(void) {
+    ButtonSim button(true, false);
+    std::vector<RawEdge> edges;
+    addPress(edges, 100, 200);
+    button.run(edges, 2000);
+    TEST_ASSERT_EQUAL(1, button.events.size());
+    TEST_ASSERT_EQUAL(BUTTON_EVENT_SHORT, button.events[0].type);
+    TEST_ASSERT_EQUAL_UINT32(200 + DEBOUNCE_MS + TIMING.doubleClickWindowMs, button.events[0].emittedAtMs);
+}
+
+void test_slow_clicks_are_two_shorts(void) {
+    ButtonSim button(true, false);
+    std::vector<RawEdge> edges;
+    addPress(edges, 100, 200);
+    addPress(edges, 700, 800);
+    button.run(edges, 2000);
+    TEST_ASSERT_EQUAL(2, button.events.size());
+    TEST_ASSERT_EQUAL(BUTTON_EVENT_SHORT, button.events[0].type);
+    TEST_ASSERT_EQUAL(BUTTON_EVENT_SHORT, button.events[1].type);
+    TEST_ASSERT_EQUAL_UINT32(700, button.events[1].timestampMs);
+}
+
+void test_triple_click_is_double_then_short(void) {
+    ButtonSim button(true, false);
+    std::vector<RawEdge> edges;
+    addPress(edges, 100, 160);
+    addPress(edges, 300, 360);
+    addPress(edges, 500, 560);
+    button.run(edges, 2000);
+    TEST_ASSERT_EQUAL(2, button.events.size());
+    TEST_ASSERT_EQUAL(BUTTON_EVENT_DOUBLE, button.events[0].type);
+    TEST_ASSERT_EQUAL(BUTTON_EVENT_SHORT, button.events[1].type);
+}
+
+// A long press cancels a pending first click instead of turning it into a SHORT later.
+void test_click_then_long_press(void) {
+    ButtonSim button(true, false);
+    std::vector<RawEdge> edges;
+    addPress(edges, 100, 160);
+    addPress(edges, 300, 1600);
+    button.run(edges, 3000);
+    TEST_ASSERT_EQUAL(1, button.events.size());
+    TEST_ASSERT_EQUAL(BUTTON_EVENT_LONG, button.events[0].type);
+    TEST_ASSERT_EQUAL_UINT32(300, button.events[0].timestampMs);
+}
+
+// Held through an ext0 wake: the release of a press that started before boot is not a click.
+void test_release_of_press_from_before_boot(void) {
+    ButtonSim button(false, false, true);
+    std::vector<RawEdge> edges = { { 400, false } };
+    button.run(edges, 2000);
+    TEST_ASSERT_EQUAL(0, button.events.size());
+}
+
+// 200 randomised sequences with bounce: never more gestures than presses, every event carries
+// the start of a real press, and the engine is idle afterwards.
+void test_random_sequences(void) {
+    uint32_t seed = 12345;
+    auto nextRandom = [&seed](uint32_t range) { seed = seed * 1103515245u + 12345u; return (seed >> 16) % range; };
+    for (int round = 0; round < 200; ++round) {
+        ButtonSim button(round & 1, round & 2);
+        std::vector<RawEdge> edges;
+        std::vector<uint32_t> pressStarts;
+        uint32_t t = 10;
+        int presses = 1 + nextRandom(5);
+        for (int p = 0; p < presses; ++p) {
+            int bounces = nextRandom(4);
+            uint32_t hold = 60 + nextRandom(1500);
+            addPress(edges, t, t + hold, bounces);
+            pressStarts.push_back(t + 2 * bounces);
+            t += hold + 2 * bounces + 70 + nextRandom(600);
+        }
+        button.run(edges, t + 3000);
+        size_t nonRepeat = 0;
+        for (const Emitted& e : button.events) {
+            bool known = false;
+            for (uint32_t start : pressStarts) known = known || (e.timestampMs == start);
+            TEST_ASSERT_TRUE(known);
+            if (e.type != BUTTON_EVENT_HOLD_REPEAT) nonRepeat++;
+        }
+        TEST_ASSERT_LESS_OR_EQUAL(presses, nonRepeat);
+        TEST_ASSERT_FALSE(button.gestureArmed); // Nothing left pending once the button is idle
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_clean_short_press);
+    RUN_TEST(test_bouncy_contacts_give_one_press);
+    RUN_TEST(test_glitch_shorter_than_debounce_is_ignored);
+    RUN_TEST(test_long_press);
+    RUN_TEST(test_hold_repeat);
+    RUN_TEST(test_double_click);
+    RUN_TEST(test_single_click_waits_for_double_window);
+    RUN_TEST(test_slow_clicks_are_two_shorts);
+    RUN_TEST(test_triple_click_is_double_then_short);
+    RUN_TEST(test_click_then_long_press);
+    RUN_TEST(test_release_of_press_from_before_boot);
+    RUN_TEST(test_random_sequences);
+    return UNITY_END();
+}
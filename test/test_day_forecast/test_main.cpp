@@ -0,0 +1,165 @@
+// Native suite for lib/DayForecast: the monotone quarter-hour samples against their knots, and the
+// peak, threshold and sorted-hour tables against brute-force scans of the same 24 values.
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <DayForecast.h>
+
+// A clear summer day, a day with a flat plateau, one with a spike, an all-zero night and random ones.
+const float CLEAR_DAY[24] = { 0, 0, 0, 0, 0, 0, 0.1f, 0.6f, 1.8f, 3.4f, 5.2f, 6.9f, 8.1f, 8.4f, 7.9f, 6.5f, 4.6f, 2.7f, 1.1f, 0.3f, 0, 0, 0, 0 };
+const float PLATEAU[24] = { 0, 0, 0, 0, 0, 0, 0, 1.0f, 3.0f, 6.0f, 6.0f, 6.0f, 6.0f, 6.0f, 3.0f, 1.0f, 0, 0, 0, 0, 0, 0, 0, 0 };
+const float SPIKE[24] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 11.5f, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+const float NIGHT[24] = {};
+
+static void randomDay(float* knots) {
+    for (int h = 0; h < 24; ++h) knots[h] = (rand() % 4) == 0 ? 0.0f : (rand() % 1400) / 100.0f;
+}
+
+static DayForecast built(const float* knots) {
+    DayForecast day = {};
+    day.dayOfYear = 200;
+    monotoneCubicQuarterHours(knots, day.uvQuarter);
+    buildDayUvAnalytics(knots, &day);
+    return day;
+}
+
+static uint8_t scaled(float uv) {
+    float s = uv * UV_QUARTER_SCALE + 0.5f;
+    return s >= 255.0f ? 255 : (uint8_t)s;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Every HH:00 sample is its knot, and each quarter in between stays within its two knots: no overshoot
+// above the peak and no negative UV before sunrise.
+void test_quarters_hit_knots_without_overshoot(void) {
+    float randomKnots[24];
+    srand(3);
+    for (int f = 0; f < 200; ++f) {
+        const float* knots = f == 0 ? CLEAR_DAY : (f == 1 ? PLATEAU : (f == 2 ? SPIKE : (f == 3 ? NIGHT : randomKnots)));
+        if (f >= 4) randomDay(randomKnots);
+        uint8_t quarters[UV_QUARTER_SAMPLES];
+        monotoneCubicQuarterHours(knots, quarters);
+        for (int q = 0; q < UV_QUARTER_SAMPLES; ++q) {
+            int h = q / 4;
+            char message[48];
+            snprintf(message, sizeof(message), "day %d, quarter %d", f, q);
+            if (q % 4 == 0) {
+                TEST_ASSERT_EQUAL_MESSAGE(scaled(knots[h]), quarters[q], message);
+                continue;
+            }
+            float next = h < 23 ? knots[h + 1] : knots[h];
+            TEST_ASSERT_TRUE_MESSAGE(quarters[q] >= scaled(fminf(knots[h], next)), message);
+            TEST_ASSERT_TRUE_MESSAGE(quarters[q] <= scaled(fmaxf(knots[h], next)), message);
+        }
+    }
+}
+
+// Flat stretches stay flat and a monotone rise never dips.
+void test_flat_and_rising_runs_stay_monotone(void) {
+    uint8_t quarters[UV_QUARTER_SAMPLES];
+    monotoneCubicQuarterHours(PLATEAU, quarters);
+    for (int q = 9 * 4; q <= 13 * 4; ++q) TEST_ASSERT_EQUAL(60, quarters[q]);
+    for (int q = 0; q < 6 * 4; ++q) TEST_ASSERT_EQUAL(0, quarters[q]);
+    for (int q = 6 * 4; q < 9 * 4; ++q) TEST_ASSERT_TRUE(quarters[q + 1] >= quarters[q]);
+    monotoneCubicQuarterHours(CLEAR_DAY, quarters);
+    for (int q = 6 * 4; q < 13 * 4; ++q) TEST_ASSERT_TRUE(quarters[q + 1] >= quarters[q]);
+    for (int q = 13 * 4; q < 20 * 4; ++q) TEST_ASSERT_TRUE(quarters[q + 1] <= quarters[q]);
+}
+
+// Threshold sets, next-hour tables, window ends and the UV order against scans of the knots.
+void test_analytics_match_brute_force(void) {
+    float randomKnots[24];
+    srand(5);
+    for (int f = 0; f < 200; ++f) {
+        const float* knots = f == 0 ? CLEAR_DAY : (f == 1 ? PLATEAU : (f == 2 ? SPIKE : (f == 3 ? NIGHT : randomKnots)));
+        if (f >= 4) randomDay(randomKnots);
+        DayForecast day = built(knots);
+        char message[48];
+        for (uint8_t level = 0; level < WHO_UV_LEVEL_COUNT; ++level) {
+            for (int h = 0; h < 24; ++h) {
+                snprintf(message, sizeof(message), "day %d, level %u, hour %d", f, level, h);
+                bool above = knots[h] >= WHO_UV_THRESHOLDS[level];
+                TEST_ASSERT_EQUAL_MESSAGE(above, (day.hoursAtOrAbove[level] >> h) & 1, message);
+                int next = -1;
+                for (int k = h; k < 24 && next < 0; ++k)
+                    if (knots[k] >= WHO_UV_THRESHOLDS[level]) next = k;
+                TEST_ASSERT_EQUAL_MESSAGE(next, uvNextHourAtOrAbove(day, level, h), message);
+                if (!above) continue;
+                int end = h;
+                while (end < 24 && knots[end] >= WHO_UV_THRESHOLDS[level]) end++;
+                TEST_ASSERT_EQUAL_MESSAGE(end, uvWindowEndHour(day, level, h), message);
+            }
+        }
+        bool seen[24] = {};
+        for (int i = 0; i < 24; ++i) {
+            snprintf(message, sizeof(message), "day %d, rank %d", f, i);
+            TEST_ASSERT_TRUE_MESSAGE(day.hoursByUv[i] < 24 && !seen[day.hoursByUv[i]], message);
+            seen[day.hoursByUv[i]] = true;
+            if (i == 0) continue;
+            float previous = knots[day.hoursByUv[i - 1]], current = knots[day.hoursByUv[i]];
+            TEST_ASSERT_TRUE_MESSAGE(previous > current || (previous == current && day.hoursByUv[i - 1] < day.hoursByUv[i]), message);
+        }
+        TEST_ASSERT_EQUAL(day.hoursByUv[0], day.peakHour);
+        TEST_ASSERT_EQUAL(scaled(knots[day.peakHour]), day.peakUV);
+    }
+}
+
+void test_peak_ties_and_saturation(void) {
+    DayForecast plateau = built(PLATEAU);
+    TEST_ASSERT_EQUAL(9, plateau.peakHour); // First of the equal hours
+    TEST_ASSERT_EQUAL(60, plateau.peakUV);
+    DayForecast night = built(NIGHT);
+    TEST_ASSERT_EQUAL(0, night.peakHour);
+    TEST_ASSERT_EQUAL(0, night.peakUV);
+    for (uint8_t level = 0; level < WHO_UV_LEVEL_COUNT; ++level) TEST_ASSERT_EQUAL(-1, uvNextHourAtOrAbove(night, level, 0));
+    float extreme[24] = {};
+    extreme[12] = 30.0f;
+    TEST_ASSERT_EQUAL(255, built(extreme).peakUV); // uint8_t saturates at 25.5
+}
+
+// A window running to midnight ends at 24; out-of-range queries and an unparsed day answer -1.
+void test_window_edges_and_guards(void) {
+    float late[24] = {};
+    for (int h = 20; h < 24; ++h) late[h] = 7.0f;
+    DayForecast day = built(late);
+    TEST_ASSERT_EQUAL(20, uvNextHourAtOrAbove(day, 1, 0));
+    TEST_ASSERT_EQUAL(24, uvWindowEndHour(day, 1, 20));
+    TEST_ASSERT_EQUAL(24, uvWindowEndHour(day, 1, 23));
+    TEST_ASSERT_EQUAL(-1, uvNextHourAtOrAbove(day, 2, 0));
+    TEST_ASSERT_EQUAL(-1, uvNextHourAtOrAbove(day, WHO_UV_LEVEL_COUNT, 0));
+    TEST_ASSERT_EQUAL_STRING("high", WHO_UV_LEVEL_NAMES[WHO_UV_LEVEL_HIGH]); // The band the display's "next window" lines name
+    TEST_ASSERT_EQUAL_FLOAT(6.0f, WHO_UV_THRESHOLDS[WHO_UV_LEVEL_HIGH]);
+    TEST_ASSERT_EQUAL(-1, uvNextHourAtOrAbove(day, 1, -1));
+    TEST_ASSERT_EQUAL(-1, uvNextHourAtOrAbove(day, 1, 24));
+    day.dayOfYear = -1;
+    TEST_ASSERT_EQUAL(-1, uvNextHourAtOrAbove(day, 1, 0));
+}
+
+void test_quarter_index_of_local_time(void) {
+    DayForecast day = built(CLEAR_DAY);
+    struct tm t = {};
+    t.tm_yday = 200; t.tm_hour = 13; t.tm_min = 44;
+    TEST_ASSERT_EQUAL(13 * 4 + 2, dayQuarterIndex(day, 13, t));
+    t.tm_min = 45;
+    TEST_ASSERT_EQUAL(13 * 4 + 3, dayQuarterIndex(day, 13, t));
+    TEST_ASSERT_EQUAL(-1, dayQuarterIndex(day, 14, t)); // Hourly forecast not starting at this hour
+    t.tm_yday = 201;
+    TEST_ASSERT_EQUAL(-1, dayQuarterIndex(day, 13, t)); // Samples from yesterday
+    day.dayOfYear = -1;
+    t.tm_yday = -1;
+    TEST_ASSERT_EQUAL(-1, dayQuarterIndex(day, 13, t));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_quarters_hit_knots_without_overshoot);
+    RUN_TEST(test_flat_and_rising_runs_stay_monotone);
+    RUN_TEST(test_analytics_match_brute_force);
+    RUN_TEST(test_peak_ties_and_saturation);
+    RUN_TEST(test_window_edges_and_guards);
+    RUN_TEST(test_quarter_index_of_local_time);
+    return UNITY_END();
+}
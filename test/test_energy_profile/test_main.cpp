@@ -0,0 +1,91 @@
+// Native suite for lib/EnergyProfile: phase time x phase current plus the deep sleep that followed,
+// the unattributed awake time, the 16-bit saturation of the kept phase times, and the ring buffer
+// walked newest first across its wrap.
+#include <unity.h>
+#include <EnergyProfile.h>
+
+const int PHASES = 4;
+const float CURRENT_MA[PHASES] = { 45.0f, 130.0f, 60.0f, 50.0f };
+const EnergyModel MODEL = { CURRENT_MA, PHASES, 3, 0.15f }; // Phase 3 is "other"
+const uint8_t RING = 32; // ENERGY_LOG_CYCLES
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_cycle_is_phase_time_times_current(void) {
+    const uint32_t phaseUs[PHASES] = { 200000, 3000000, 150000, 0 };
+    uint16_t phaseMs[PHASES];
+    float mAh = energyCycleMAh(phaseUs, 0, MODEL, phaseMs);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, (45.0f * 0.2f + 130.0f * 3.0f + 60.0f * 0.15f) / 3600.0f, mAh);
+    TEST_ASSERT_EQUAL(200, phaseMs[0]);
+    TEST_ASSERT_EQUAL(3000, phaseMs[1]);
+    TEST_ASSERT_EQUAL(150, phaseMs[2]);
+    TEST_ASSERT_EQUAL(0, phaseMs[3]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 130.0f * 3.0f / 3600.0f, energyPhaseMAh(phaseMs[1], 1, MODEL));
+}
+
+// An hour of deep sleep at 0.15 mA is 0.15 mAh, on top of the awake phases.
+void test_deep_sleep_term(void) {
+    const uint32_t none[PHASES] = { 0, 0, 0, 0 };
+    uint16_t phaseMs[PHASES];
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.15f, energyCycleMAh(none, 3600, MODEL, phaseMs));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.15f * 24, energyCycleMAh(none, 24 * 3600, MODEL, phaseMs));
+    const uint32_t awake[PHASES] = { 1000000, 0, 0, 0 };
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.15f + 45.0f / 3600.0f, energyCycleMAh(awake, 3600, MODEL, phaseMs));
+}
+
+// A phase over 65.535 s is kept as 65535 ms, but the cycle's mAh counts all of it.
+void test_phase_ms_saturate_but_the_estimate_does_not(void) {
+    const uint32_t phaseUs[PHASES] = { 0, 70000000, 65535999, 65536000 };
+    uint16_t phaseMs[PHASES];
+    float mAh = energyCycleMAh(phaseUs, 0, MODEL, phaseMs);
+    TEST_ASSERT_EQUAL(0xFFFF, phaseMs[1]);
+    TEST_ASSERT_EQUAL(0xFFFF, phaseMs[2]);
+    TEST_ASSERT_EQUAL(0xFFFF, phaseMs[3]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, (130.0f * 70.0f + 60.0f * 65.535999f + 50.0f * 65.536f) / 3600.0f, mAh);
+    TEST_ASSERT_TRUE(energyPhaseMAh(phaseMs[1], 1, MODEL) < 130.0f * 70.0f / 3600.0f); // The kept record under-reports
+}
+
+void test_other_takes_the_unattributed_awake_time(void) {
+    uint32_t phaseUs[PHASES] = { 200000, 300000, 100000, 12345 };
+    energyAttributeOther(phaseUs, 1000000, MODEL);
+    TEST_ASSERT_EQUAL(400000, phaseUs[3]);
+    TEST_ASSERT_EQUAL(200000, phaseUs[0]); // The others are left alone
+    energyAttributeOther(phaseUs, 500000, MODEL); // Phases on both cores overlap past the awake time
+    TEST_ASSERT_EQUAL(0, phaseUs[3]);
+    uint32_t longPhases[PHASES] = { 4000000000u, 4000000000u, 0, 0 }; // Summed without wrapping
+    energyAttributeOther(longPhases, 8100000000LL, MODEL);
+    TEST_ASSERT_EQUAL(100000000, longPhases[3]);
+}
+
+// (next + N - 1 - n) % N: newest first, across the wrap, while filling and once full.
+void test_ring_walks_newest_first(void) {
+    uint8_t next = 0, count = 0;
+    uint8_t written[RING];
+    for (uint8_t cycle = 0; cycle < 3; ++cycle) {
+        written[next] = cycle;
+        energyRingPush(next, count, RING);
+    }
+    TEST_ASSERT_EQUAL(3, count);
+    for (uint8_t n = 0; n < count; ++n) TEST_ASSERT_EQUAL(2 - n, written[energyRingSlot(next, n, RING)]);
+
+    for (uint8_t cycle = 3; cycle < 70; ++cycle) {
+        written[next] = cycle;
+        energyRingPush(next, count, RING);
+    }
+    TEST_ASSERT_EQUAL(RING, count);
+    TEST_ASSERT_EQUAL(70 % RING, next);
+    for (uint8_t n = 0; n < count; ++n) TEST_ASSERT_EQUAL(69 - n, written[energyRingSlot(next, n, RING)]);
+    TEST_ASSERT_EQUAL(RING - 1, energyRingSlot(0, 0, RING)); // Newest just before the wrap
+    TEST_ASSERT_EQUAL(0, energyRingSlot(0, RING - 1, RING)); // Oldest of a full ring is the next write
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_cycle_is_phase_time_times_current);
+    RUN_TEST(test_deep_sleep_term);
+    RUN_TEST(test_phase_ms_saturate_but_the_estimate_does_not);
+    RUN_TEST(test_other_takes_the_unattributed_awake_time);
+    RUN_TEST(test_ring_walks_newest_first);
+    return UNITY_END();
+}
@@ -0,0 +1,215 @@
+// Native suite for lib/EventTelemetry: the RTC ring wraps and keeps the newest records, gaps over
+// 65535 s get a TIME_GAP record, epochs are walked back from the newest record, payloads follow their
+// conventions (HTTP results as int16, so negative HttpReaderError codes survive), an archived "tlm" hex
+// dump decodes off the device, and the append path stays allocation-free and well under 1 us.
+#include <unity.h>
+#include <string.h>
+#include <string>
+#include <chrono>
+#include <new>
+#include <stdlib.h>
+#include <EventTelemetry.h>
+
+const uint32_t T0 = 1750000000; // 2025-06-15 15:06:40 UTC
+
+size_t allocations = 0;
+void* operator new(size_t size) {
+    allocations++;
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+TelemetryLog logUnderTest;
+
+// The "tlm" command's raw section, as dumpTelemetryLog() prints it.
+static std::string dumpText(const TelemetryLog& log) {
+    char text[64];
+    telemetryFormatHeader(log, text, sizeof(text));
+    std::string out = std::string(text) + "\n";
+    for (uint16_t i = 0; i < log.count; ++i) {
+        if (i % 16 == 0) out += "TLM ";
+        telemetryFormatRecord(telemetryRecordAt(log, i), text, sizeof(text));
+        out += text;
+        out += (i % 16 == 15 || i == log.count - 1) ? "\n" : " ";
+    }
+    return out;
+}
+
+void setUp(void) { telemetryReset(logUnderTest); }
+void tearDown(void) {}
+
+// Past TELEMETRY_LOG_RECORDS the oldest records go; the rest stay in order, the newest last.
+void test_ring_wraps_and_keeps_the_newest(void) {
+    const int appended = TELEMETRY_LOG_RECORDS + 44;
+    for (int n = 0; n < appended; ++n) telemetryAppend(logUnderTest, T0 + 10 * n, TELEMETRY_EVENT_BENCH, (uint16_t)n);
+    TEST_ASSERT_EQUAL(TELEMETRY_LOG_RECORDS, logUnderTest.count);
+    TEST_ASSERT_EQUAL(44, logUnderTest.next);
+    for (uint16_t i = 0; i < logUnderTest.count; ++i) TEST_ASSERT_EQUAL(44 + i, telemetryRecordAt(logUnderTest, i).payload);
+    TEST_ASSERT_EQUAL_UINT32(T0 + 10 * (appended - 1), logUnderTest.lastEpoch);
+    TEST_ASSERT_EQUAL_UINT32(T0 + 10 * 44, telemetryOldestEpoch(logUnderTest));
+}
+
+// A delta that fits 16 bits is stored as is; one over 65535 s is carried by a TIME_GAP record (low
+// bits in deltaSec, high bits in payload) and the event itself gets a delta of 0.
+void test_long_gaps_get_a_time_gap_record(void) {
+    telemetryAppend(logUnderTest, T0, TELEMETRY_EVENT_WAKE, 4);
+    telemetryAppend(logUnderTest, T0 + 65535, TELEMETRY_EVENT_WAKE, 4);
+    TEST_ASSERT_EQUAL(2, logUnderTest.count);
+    TEST_ASSERT_EQUAL(65535, telemetryRecordAt(logUnderTest, 1).deltaSec);
+
+    telemetryAppend(logUnderTest, T0 + 65535 + 200000, TELEMETRY_EVENT_SLEEP, 15);
+    TEST_ASSERT_EQUAL(4, logUnderTest.count);
+    const TelemetryRecord& gap = telemetryRecordAt(logUnderTest, 2);
+    TEST_ASSERT_EQUAL(TELEMETRY_EVENT_TIME_GAP, gap.event);
+    TEST_ASSERT_EQUAL(200000 & 0xFFFF, gap.deltaSec);
+    TEST_ASSERT_EQUAL(200000 >> 16, gap.payload);
+    TEST_ASSERT_EQUAL_UINT32(200000, telemetryRecordDeltaSec(gap));
+    TEST_ASSERT_EQUAL(0, telemetryRecordAt(logUnderTest, 3).deltaSec);
+    TEST_ASSERT_EQUAL(TELEMETRY_EVENT_SLEEP, telemetryRecordAt(logUnderTest, 3).event);
+    // Only the gap record carries high bits; another event's payload is not a time
+    TEST_ASSERT_EQUAL_UINT32(0, telemetryRecordDeltaSec(telemetryRecordAt(logUnderTest, 3)));
+}
+
+// Each record's epoch is the oldest one plus the deltas up to it, the newest landing on lastEpoch.
+// Records logged while the time was unknown (0) or after it stepped back add nothing.
+void test_walk_back_from_the_newest_epoch(void) {
+    telemetryAppend(logUnderTest, 0, TELEMETRY_EVENT_WAKE, 1);          // Cold boot, no time yet
+    telemetryAppend(logUnderTest, T0, TELEMETRY_EVENT_WIFI_CONNECT, 1500);
+    telemetryAppend(logUnderTest, T0 - 30, TELEMETRY_EVENT_HTTP_UV, 200); // Stepped back by NTP
+    telemetryAppend(logUnderTest, T0 + 7, TELEMETRY_EVENT_RENDER, 120);
+    telemetryAppend(logUnderTest, T0 + 7 + 90000, TELEMETRY_EVENT_WAKE, 4);
+    const uint32_t expected[] = { T0, T0, T0, T0 + 7, T0 + 7 + 90000, T0 + 7 + 90000 }; // Gap record before the last wake
+    TEST_ASSERT_EQUAL(6, logUnderTest.count);
+    uint32_t epoch = telemetryOldestEpoch(logUnderTest);
+    for (uint16_t i = 0; i < logUnderTest.count; ++i) {
+        if (i > 0) epoch += telemetryRecordDeltaSec(telemetryRecordAt(logUnderTest, i));
+        TEST_ASSERT_EQUAL_UINT32(expected[i], epoch);
+    }
+    TEST_ASSERT_EQUAL_UINT32(logUnderTest.lastEpoch, epoch);
+}
+
+// A TIME_GAP that has become the oldest record still leaves the walk anchored on the newest epoch.
+void test_walk_back_after_the_ring_drops_a_gap_pair(void) {
+    telemetryAppend(logUnderTest, T0, TELEMETRY_EVENT_WAKE, 4);
+    telemetryAppend(logUnderTest, T0 + 100000, TELEMETRY_EVENT_WAKE, 4); // Gap + wake
+    for (int n = 1; n < TELEMETRY_LOG_RECORDS - 1; ++n) telemetryAppend(logUnderTest, T0 + 100000 + n, TELEMETRY_EVENT_BENCH, 0);
+    TEST_ASSERT_EQUAL(TELEMETRY_EVENT_TIME_GAP, telemetryRecordAt(logUnderTest, 0).event);
+    TEST_ASSERT_EQUAL_UINT32(T0 + 100000, telemetryOldestEpoch(logUnderTest));
+}
+
+void test_payload_conventions(void) {
+    // HTTP results: status codes and negative HttpReaderError codes both round-trip through int16
+    const int32_t codes[] = { 200, 404, -1, -11 }; // HTTP_READER_ERROR_CONNECTION_REFUSED, _READ_TIMEOUT
+    for (int32_t code : codes) {
+        TelemetryRecord r = { 0, telemetrySigned(code), TELEMETRY_EVENT_HTTP_UV };
+        TEST_ASSERT_EQUAL_INT32(code, telemetryPayloadValue(r));
+        r.event = TELEMETRY_EVENT_HTTP_GEO;
+        TEST_ASSERT_EQUAL_INT32(code, telemetryPayloadValue(r));
+    }
+    TEST_ASSERT_EQUAL_HEX16(0xFFF5, telemetrySigned(-11));
+    TEST_ASSERT_EQUAL_HEX16(0x8000, telemetrySigned(-100000)); // Clamped, not wrapped
+    TEST_ASSERT_EQUAL_HEX16(0x7FFF, telemetrySigned(100000));
+    // Other events are unsigned: the same bits read as a count
+    TelemetryRecord bytes = { 0, 0xFFF5, TELEMETRY_EVENT_PAYLOAD_UV };
+    TEST_ASSERT_EQUAL_INT32(0xFFF5, telemetryPayloadValue(bytes));
+    // Counts saturate below the 0xFFFF "failed" marker and never go negative
+    TEST_ASSERT_EQUAL_HEX16(0, telemetrySaturate(-5));
+    TEST_ASSERT_EQUAL_HEX16(8192, telemetrySaturate(8192));
+    TEST_ASSERT_EQUAL_HEX16(0xFFFE, telemetrySaturate(0xFFFF));
+    TEST_ASSERT_EQUAL_HEX16(0xFFFE, telemetrySaturate(1LL << 40));
+}
+
+// A dump captured from the serial console (with other output around it) decodes to the same records.
+void test_archived_hex_dump_decodes(void) {
+    const char* capture =
+        "Sleeping for 900 s\n"
+        "TLM v1 records=6 last_epoch=1750200006\n"
+        "TLM 0000040001 0200DC0502 0100F5FF04 400D030000 0000040001 03000F0008\n"
+        "  epoch      time (UTC)           event      payload\n";
+    TelemetryLog log;
+    TEST_ASSERT_TRUE(telemetryParseDump(capture, log));
+    TEST_ASSERT_EQUAL(6, log.count);
+    TEST_ASSERT_EQUAL_UINT32(1750200006, log.lastEpoch);
+    TEST_ASSERT_EQUAL_UINT32(T0, telemetryOldestEpoch(log));
+
+    const char* expected[] = {
+        "1750000000 2025-06-15 15:06:40  wake       4",
+        "1750000002 2025-06-15 15:06:42  wifi_ms    1500",
+        "1750000003 2025-06-15 15:06:43  http_uv    -11",
+        "1750200003 2025-06-17 22:40:03  wake       4",
+        "1750200006 2025-06-17 22:40:06  sleep_min  15",
+    };
+    uint32_t epoch = telemetryOldestEpoch(log);
+    int shown = 0;
+    for (uint16_t i = 0; i < log.count; ++i) {
+        const TelemetryRecord& r = telemetryRecordAt(log, i);
+        if (i > 0) epoch += telemetryRecordDeltaSec(r);
+        if (r.event == TELEMETRY_EVENT_TIME_GAP) continue;
+        char line[64];
+        telemetryFormatEntry(epoch, r, line, sizeof(line));
+        TEST_ASSERT_EQUAL_STRING(expected[shown++], line);
+    }
+    TEST_ASSERT_EQUAL(5, shown);
+}
+
+// What the firmware prints parses back to the same ring contents, wrapped and multi-line.
+void test_dump_round_trips(void) {
+    for (int n = 0; n < TELEMETRY_LOG_RECORDS + 10; ++n)
+        telemetryAppend(logUnderTest, T0 + (n % 7 == 0 ? 70000 : 60) * n, (TelemetryEvent)(1 + n % (TELEMETRY_EVENT_COUNT - 1)), (uint16_t)(n * 257));
+    TelemetryLog parsed;
+    TEST_ASSERT_TRUE(telemetryParseDump(dumpText(logUnderTest).c_str(), parsed));
+    TEST_ASSERT_EQUAL(logUnderTest.count, parsed.count);
+    TEST_ASSERT_EQUAL_UINT32(logUnderTest.lastEpoch, parsed.lastEpoch);
+    TEST_ASSERT_EQUAL_UINT32(telemetryOldestEpoch(logUnderTest), telemetryOldestEpoch(parsed));
+    for (uint16_t i = 0; i < parsed.count; ++i) {
+        const TelemetryRecord& a = telemetryRecordAt(logUnderTest, i);
+        const TelemetryRecord& b = telemetryRecordAt(parsed, i);
+        TEST_ASSERT_EQUAL(a.deltaSec, b.deltaSec);
+        TEST_ASSERT_EQUAL(a.payload, b.payload);
+        TEST_ASSERT_EQUAL(a.event, b.event);
+    }
+    TelemetryLog empty;
+    TEST_ASSERT_TRUE(telemetryParseDump("TLM v1 records=0 last_epoch=0\n", empty));
+    TEST_ASSERT_EQUAL(0, empty.count);
+}
+
+void test_malformed_dumps_are_refused(void) {
+    TelemetryLog log;
+    TEST_ASSERT_FALSE(telemetryParseDump("TLM 0000040001\n", log));                                      // No header
+    TEST_ASSERT_FALSE(telemetryParseDump("TLM v1 records=2 last_epoch=5\nTLM 0000040001\n", log));       // Short
+    TEST_ASSERT_FALSE(telemetryParseDump("TLM v1 records=1 last_epoch=5\nTLM 0000040001 0000040001\n", log)); // Long
+    TEST_ASSERT_FALSE(telemetryParseDump("TLM v1 records=1 last_epoch=5\nTLM 00000400\n", log));         // Cut record
+    TEST_ASSERT_FALSE(telemetryParseDump("TLM v1 records=1 last_epoch=5\nTLM 00000400XY\n", log));
+    TEST_ASSERT_FALSE(telemetryParseDump("TLM v1 records=999 last_epoch=5\n", log));
+}
+
+// The firmware logs from both cores inside a critical section, so the append must stay short and must
+// not allocate. The device's "bench" command times it in CPU cycles; here the host bound is the same 1 us.
+void test_append_is_short_and_never_allocates(void) {
+    const int appends = 1000000;
+    allocations = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int n = 0; n < appends; ++n)
+        telemetryAppend(logUnderTest, T0 + (uint32_t)n * 3, (TelemetryEvent)(n & 7), (uint16_t)n);
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / appends;
+    TEST_ASSERT_EQUAL(0, allocations);
+    printf("  telemetryAppend: %.1f ns\n", ns);
+    TEST_ASSERT_TRUE(ns < 1000.0);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_ring_wraps_and_keeps_the_newest);
+    RUN_TEST(test_long_gaps_get_a_time_gap_record);
+    RUN_TEST(test_walk_back_from_the_newest_epoch);
+    RUN_TEST(test_walk_back_after_the_ring_drops_a_gap_pair);
+    RUN_TEST(test_payload_conventions);
+    RUN_TEST(test_archived_hex_dump_decodes);
+    RUN_TEST(test_dump_round_trips);
+    RUN_TEST(test_malformed_dumps_are_refused);
+    RUN_TEST(test_append_is_short_and_never_allocates);
+    return UNITY_END();
+}
@@ -0,0 +1,130 @@
+// Native suite for lib/FrameRle: frames round-trip through the palette + run encoding pixel for pixel,
+// runs split at 255 pixels, the scan's size is the encoder's, a 257th colour is refused, and the
+// palette swap leaves the run indices alone.
+#include <unity.h>
+#include <stdlib.h>
+#include <string.h>
+#include <FrameRle.h>
+
+const uint32_t PANEL_PIXELS = 240 * 135;
+
+// Expands the runs back into pixels; returns how many were written (stops at capacity).
+static uint32_t decode(const FrameRle& frame, uint16_t* pixels, uint32_t capacity) {
+    uint32_t written = 0;
+    for (uint32_t r = 0; r < frame.runCount; ++r) {
+        for (uint8_t n = 0; n < frame.runs[r].length && written < capacity; ++n) pixels[written++] = frame.palette[frame.runs[r].colorIndex];
+    }
+    return written;
+}
+
+// Scans, encodes into an exactly sized block and checks the decode equals the input.
+static void assertRoundTrip(const uint16_t* pixels, uint32_t pixelCount) {
+    static FrameRleScan scan;
+    TEST_ASSERT_TRUE(frameRleScan(pixels, pixelCount, scan));
+    size_t bytes = frameRleBytes(scan);
+    void* block = malloc(bytes);
+    FrameRle frame = frameRleEncode(pixels, pixelCount, scan, block, false);
+    TEST_ASSERT_EQUAL_UINT32(scan.runCount, frame.runCount);
+    TEST_ASSERT_EQUAL_UINT32(bytes, frame.paletteSize * sizeof(uint16_t) + frame.runCount * sizeof(FrameRleRun));
+    TEST_ASSERT_TRUE((uint8_t*)(frame.runs + frame.runCount) <= (uint8_t*)block + bytes);
+    uint16_t* decoded = (uint16_t*)malloc(pixelCount * sizeof(uint16_t));
+    TEST_ASSERT_EQUAL_UINT32(pixelCount, decode(frame, decoded, pixelCount));
+    TEST_ASSERT_EQUAL_HEX16_ARRAY(pixels, decoded, pixelCount);
+    for (uint32_t r = 0; r < frame.runCount; ++r) {
+        TEST_ASSERT_TRUE(frame.runs[r].length >= 1);
+        TEST_ASSERT_TRUE(frame.runs[r].colorIndex < frame.paletteSize);
+    }
+    free(decoded);
+    free(block);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_palette_index_appends_then_finds(void) {
+    uint16_t palette[FRAME_RLE_MAX_COLORS];
+    uint16_t size = 0;
+    TEST_ASSERT_EQUAL(0, frameRlePaletteIndex(palette, size, 0x0000));
+    TEST_ASSERT_EQUAL(1, frameRlePaletteIndex(palette, size, 0xF800));
+    TEST_ASSERT_EQUAL(0, frameRlePaletteIndex(palette, size, 0x0000));
+    TEST_ASSERT_EQUAL(2, size);
+    for (uint16_t c = 2; c < FRAME_RLE_MAX_COLORS; ++c) frameRlePaletteIndex(palette, size, (uint16_t)(0x1000 + c));
+    TEST_ASSERT_EQUAL(FRAME_RLE_MAX_COLORS, size);
+    TEST_ASSERT_EQUAL(-1, frameRlePaletteIndex(palette, size, 0x1234));
+    TEST_ASSERT_EQUAL(1, frameRlePaletteIndex(palette, size, 0xF800)); // A full palette still finds its colours
+}
+
+// A black panel: one colour, runs of 255 and the remainder.
+void test_blank_frame_splits_runs_at_255(void) {
+    static uint16_t pixels[PANEL_PIXELS];
+    memset(pixels, 0, sizeof(pixels));
+    static FrameRleScan scan;
+    TEST_ASSERT_TRUE(frameRleScan(pixels, PANEL_PIXELS, scan));
+    TEST_ASSERT_EQUAL(1, scan.paletteSize);
+    TEST_ASSERT_EQUAL_UINT32((PANEL_PIXELS + FRAME_RLE_MAX_RUN - 1) / FRAME_RLE_MAX_RUN, scan.runCount);
+    TEST_ASSERT_EQUAL_UINT32(2 + scan.runCount * 2, frameRleBytes(scan));
+    assertRoundTrip(pixels, PANEL_PIXELS);
+}
+
+// Runs break at colour changes and at 255, whichever comes first; single pixels are runs of 1.
+void test_run_boundaries(void) {
+    uint16_t pixels[600];
+    for (int i = 0; i < 600; ++i) pixels[i] = i < 300 ? 0xFFFF : (i % 2 ? 0x07E0 : 0x001F);
+    static FrameRleScan scan;
+    TEST_ASSERT_TRUE(frameRleScan(pixels, 600, scan));
+    TEST_ASSERT_EQUAL(3, scan.paletteSize);
+    TEST_ASSERT_EQUAL_UINT32(2 + 300, scan.runCount); // 255 + 45, then alternating pixels
+    assertRoundTrip(pixels, 600);
+    TEST_ASSERT_TRUE(frameRleScan(pixels, 0, scan));
+    TEST_ASSERT_EQUAL_UINT32(0, scan.runCount);
+    TEST_ASSERT_EQUAL(0, frameRleBytes(scan));
+}
+
+// A page-like frame: text glyph noise over black, a ramp bar, a few text colours.
+void test_page_like_frame_round_trips(void) {
+    static uint16_t pixels[PANEL_PIXELS];
+    const uint16_t text[] = { 0xFFFF, 0xC618, 0xFDA0, 0x07FF };
+    srand(3);
+    for (uint32_t i = 0; i < PANEL_PIXELS; ++i) {
+        uint32_t x = i % 240, y = i / 240;
+        if (x >= 100 && x < 120 && y >= 40) pixels[i] = (uint16_t)(0x07E0 + (y - 40) * 0x0800 / 96); // Ramp rows
+        else pixels[i] = (y < 20 && rand() % 3 == 0) ? text[rand() % 4] : 0x0000;
+    }
+    assertRoundTrip(pixels, PANEL_PIXELS);
+}
+
+void test_frame_with_257_colours_is_refused(void) {
+    uint16_t pixels[300];
+    for (int i = 0; i < 300; ++i) pixels[i] = (uint16_t)(i < 256 ? i : 0);
+    static FrameRleScan scan;
+    TEST_ASSERT_TRUE(frameRleScan(pixels, 256, scan));
+    TEST_ASSERT_EQUAL(256, scan.paletteSize);
+    pixels[299] = 0xFFFF;
+    TEST_ASSERT_FALSE(frameRleScan(pixels, 300, scan));
+}
+
+// Sprite pixels are in panel byte order; the swapped palette is plain RGB565 for pushBlock().
+void test_swapped_palette_keeps_runs(void) {
+    uint16_t pixels[10] = { 0x00F8, 0x00F8, 0xE007, 0xE007, 0xE007, 0x1F00, 0x00F8, 0x00F8, 0x00F8, 0x00F8 };
+    static FrameRleScan scan;
+    TEST_ASSERT_TRUE(frameRleScan(pixels, 10, scan));
+    uint16_t plainBlock[16], swappedBlock[16];
+    FrameRle plain = frameRleEncode(pixels, 10, scan, plainBlock, false);
+    FrameRle swapped = frameRleEncode(pixels, 10, scan, swappedBlock, true);
+    TEST_ASSERT_EQUAL_UINT32(4, swapped.runCount);
+    TEST_ASSERT_EQUAL_HEX16(0xF800, swapped.palette[0]);
+    TEST_ASSERT_EQUAL_HEX16(0x07E0, swapped.palette[1]);
+    TEST_ASSERT_EQUAL_HEX16(0x001F, swapped.palette[2]);
+    TEST_ASSERT_EQUAL_MEMORY(plain.runs, swapped.runs, swapped.runCount * sizeof(FrameRleRun));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_palette_index_appends_then_finds);
+    RUN_TEST(test_blank_frame_splits_runs_at_255);
+    RUN_TEST(test_run_boundaries);
+    RUN_TEST(test_page_like_frame_round_trips);
+    RUN_TEST(test_frame_with_257_colours_is_refused);
+    RUN_TEST(test_swapped_palette_keeps_runs);
+    return UNITY_END();
+}
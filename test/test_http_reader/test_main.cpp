@@ -0,0 +1,347 @@
+// Native suite for lib/HttpResponseReader: hostile response heads and bodies (random bytes, oversized,
+// truncated and dripped bodies, nesting bombs, endless or malformed heads, bogus framing) are fed through
+// get() and parseJson() from a scripted socket. Each case must stay inside the caps below: body bytes,
+// what the reader and the document hold, and how long it takes on the virtual clock and on the host.
+#define HOST_SIM_IMPLEMENTATION
+#include <unity.h>
+#include <Arduino.h>
+#include <Client.h>
+#include <HttpResponseReader.h>
+#include <chrono>
+#include <new>
+
+const size_t MAX_BODY_BYTES = 8192;    // UV_RESPONSE_MAX_BYTES in main.cpp
+const uint32_t HEAD_TIMEOUT_MS = 10000; // The fetches' get() timeout
+
+// --- Caps ---
+const size_t READER_BYTES_CAP = 512;           // The reader object, on the caller's stack
+// Densest legal body ("[0,0,...]"): one 16-byte slot per 2 body bytes on a 64-bit host, plus pool and
+// string growth. The ESP32's slots are half that size.
+const size_t DOC_PEAK_CAP = 10 * MAX_BODY_BYTES;
+const uint32_t VIRTUAL_LATENCY_CAP_MS = HEAD_TIMEOUT_MS + RESPONSE_READ_DEADLINE_MS + 10;
+const double HOST_LATENCY_CAP_MS = 50.0;       // Wall time per case; the reader stops at the caps, not the input's end
+
+// --- Allocation accounting ---
+size_t readerAllocations = 0; // operator new calls while the reader runs; it must not allocate
+bool countingAllocations = false;
+
+void* operator new(size_t size) {
+    if (countingAllocations) readerAllocations++;
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+// Document memory, with the peak of what is held at once.
+class PeakAllocator : public ArduinoJson::Allocator {
+public:
+    void* allocate(size_t size) override {
+        size_t* p = (size_t*)malloc(size + sizeof(size_t));
+        *p = size;
+        held += size;
+        if (held > peak) peak = held;
+        return p + 1;
+    }
+    void deallocate(void* ptr) override {
+        if (!ptr) return;
+        size_t* p = (size_t*)ptr - 1;
+        held -= *p;
+        free(p);
+    }
+    void* reallocate(void* ptr, size_t size) override {
+        if (!ptr) return allocate(size);
+        size_t* p = (size_t*)ptr - 1;
+        held -= *p;
+        p = (size_t*)realloc(p, size + sizeof(size_t));
+        *p = size;
+        held += size;
+        if (held > peak) peak = held;
+        return p + 1;
+    }
+    size_t held = 0;
+    size_t peak = 0;
+};
+
+// The server's side of one connection: the response becomes readable once the request head is in, at
+// bytesPerMs on the virtual clock (0: all at once), and the server closes after it unless keepOpen.
+class ScriptedClient : public Client {
+public:
+    ScriptedClient(const std::string& response, uint32_t bytesPerMs = 0, bool keepOpen = false)
+        : response(response), bytesPerMs(bytesPerMs), keepOpen(keepOpen) {
+        request.reserve(256); // Keeps the server's own buffer out of the reader's allocation count
+    }
+    int connect(const char*, uint16_t) override { return 1; }
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* buffer, size_t size) override {
+        request.append((const char*)buffer, size);
+        if (!requested && request.find("\r\n\r\n") != std::string::npos) {
+            requested = true;
+            startMs = millis();
+        }
+        return size;
+    }
+    int available() override {
+        if (!requested) return 0;
+        size_t arrived = bytesPerMs ? std::min(response.size(), (size_t)(millis() - startMs) * bytesPerMs) : response.size();
+        return (int)(arrived - offset);
+    }
+    int read() override { uint8_t c; return read(&c, 1) == 1 ? c : -1; }
+    int read(uint8_t* buffer, size_t size) override {
+        size_t n = std::min(size, (size_t)available());
+        memcpy(buffer, response.data() + offset, n);
+        offset += n;
+        return (int)n;
+    }
+    int peek() override { return available() > 0 ? (uint8_t)response[offset] : -1; }
+    void flush() override {}
+    void stop() override { offset = response.size(); }
+    uint8_t connected() override { return keepOpen || offset < response.size(); }
+    size_t consumed() const { return offset; }
+
+private:
+    std::string response;
+    std::string request;
+    uint32_t bytesPerMs;
+    bool keepOpen;
+    bool requested = false;
+    uint32_t startMs = 0;
+    size_t offset = 0;
+};
+
+struct CaseResult {
+    int status;
+    bool parsed;
+    ResponseReadResult readResult;
+    size_t bodyBytes;
+    size_t docPeak;
+    uint32_t virtualMs;
+    double hostMs;
+};
+
+const char REQUEST[] = "GET /v1/forecast HTTP/1.1\r\nHost: api.open-meteo.com\r\nConnection: close\r\n\r\n";
+
+// One GET and, on a 200, one parse; checks every cap.
+static CaseResult runCase(ScriptedClient& client, const char* label) {
+    CaseResult r = {};
+    PeakAllocator allocator;
+    uint32_t startMs = millis();
+    auto hostStart = std::chrono::steady_clock::now();
+    {
+        JsonDocument doc(&allocator);
+        HttpResponseReader response(client);
+        readerAllocations = 0;
+        countingAllocations = true;
+        r.status = response.get(REQUEST, sizeof(REQUEST) - 1, HEAD_TIMEOUT_MS);
+        if (r.status == HTTP_STATUS_OK) r.parsed = !response.parseJson(doc, MAX_BODY_BYTES);
+        countingAllocations = false;
+        r.readResult = response.readResult;
+        r.bodyBytes = response.bodyBytes;
+    }
+    r.hostMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - hostStart).count();
+    r.virtualMs = millis() - startMs;
+    r.docPeak = allocator.peak;
+
+    char message[160];
+    snprintf(message, sizeof(message), "%s: status %d, %s, body %u B, doc peak %u B, %lu ms virtual, %.2f ms host", label, r.status,
+             RESPONSE_READ_RESULT_NAMES[r.readResult], (unsigned)r.bodyBytes, (unsigned)r.docPeak, (unsigned long)r.virtualMs, r.hostMs);
+    TEST_ASSERT_EQUAL_MESSAGE(0, readerAllocations, message);
+    TEST_ASSERT_TRUE_MESSAGE(r.bodyBytes <= MAX_BODY_BYTES, message);
+    TEST_ASSERT_TRUE_MESSAGE(client.consumed() <= 4096 + MAX_BODY_BYTES + 2 * HTTP_READ_BUFFER_BYTES, message);
+    TEST_ASSERT_TRUE_MESSAGE(r.docPeak <= DOC_PEAK_CAP, message);
+    TEST_ASSERT_TRUE_MESSAGE(r.virtualMs <= VIRTUAL_LATENCY_CAP_MS, message);
+    TEST_ASSERT_TRUE_MESSAGE(r.hostMs <= HOST_LATENCY_CAP_MS, message);
+    return r;
+}
+
+static std::string jsonHead(const std::string& extra = "") {
+    return "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n" + extra + "\r\n";
+}
+
+// An Open-Meteo body with `hours` hourly entries, about 32 bytes each.
+static std::string forecastBody(int hours) {
+    std::string times, values;
+    for (int h = 0; h < hours; ++h) {
+        char item[40];
+        snprintf(item, sizeof(item), "%s\"2025-06-%02dT%02d:00\"", h ? "," : "", 1 + h / 24 % 28, h % 24);
+        times += item;
+        snprintf(item, sizeof(item), "%s%.2f", h ? "," : "", (h % 24) * 0.4);
+        values += item;
+    }
+    return "{\"hourly\":{\"time\":[" + times + "],\"uv_index\":[" + values + "]}}";
+}
+
+static std::string chunked(const std::string& body, size_t chunkBytes) {
+    std::string out;
+    for (size_t offset = 0; offset < body.size(); offset += chunkBytes) {
+        std::string chunk = body.substr(offset, chunkBytes);
+        char size[16];
+        snprintf(size, sizeof(size), "%zx\r\n", chunk.size());
+        out += size + chunk + "\r\n";
+    }
+    return out + "0\r\n\r\n";
+}
+
+uint32_t rngState = 0x9E3779B9u;
+static uint32_t nextRandom() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_reader_fits_its_stack_budget(void) {
+    TEST_ASSERT_TRUE(sizeof(HttpResponseReader) <= READER_BYTES_CAP);
+}
+
+void test_well_formed_responses_parse(void) {
+    std::string body = forecastBody(24);
+    ScriptedClient sized(jsonHead("Content-Length: " + std::to_string(body.size()) + "\r\n") + body);
+    ScriptedClient framed(jsonHead("Transfer-Encoding: chunked\r\n") + chunked(body, 100));
+    ScriptedClient toClose(jsonHead() + body, 64); // Read to close, 64 bytes/ms
+    for (ScriptedClient* client : { &sized, &framed, &toClose }) {
+        CaseResult r = runCase(*client, "well-formed");
+        TEST_ASSERT_EQUAL(HTTP_STATUS_OK, r.status);
+        TEST_ASSERT_TRUE(r.parsed);
+        TEST_ASSERT_EQUAL(RESPONSE_READ_OK, r.readResult);
+        TEST_ASSERT_EQUAL(body.size(), r.bodyBytes);
+    }
+}
+
+// Refused from the head alone: nothing of the body is read.
+void test_bodies_refused_from_the_head(void) {
+    struct { const char* head; ResponseReadResult expected; } cases[] = {
+        { "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\n\r\n", RESPONSE_READ_BAD_TYPE },
+        { "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Encoding: gzip\r\n\r\n", RESPONSE_READ_BAD_ENCODING },
+        { "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: 9000000\r\n\r\n", RESPONSE_READ_TOO_LARGE },
+        { "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: 99999999999999999999\r\n\r\n", RESPONSE_READ_TOO_LARGE },
+        { "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: -5\r\n\r\n", RESPONSE_READ_TOO_LARGE },
+    };
+    for (auto& c : cases) {
+        ScriptedClient client(std::string(c.head) + "<html>" + std::string(1 << 20, 'x'));
+        CaseResult r = runCase(client, c.head);
+        TEST_ASSERT_FALSE(r.parsed);
+        TEST_ASSERT_EQUAL_MESSAGE(c.expected, r.readResult, c.head);
+        TEST_ASSERT_EQUAL(0, r.bodyBytes);
+    }
+}
+
+// Heads that never end, or are not HTTP, fail get() within the head timeout and a bounded read.
+void test_hostile_heads_fail_within_caps(void) {
+    std::string endless = "HTTP/1.1 200 OK\r\n";
+    while (endless.size() < (1 << 20)) endless += "X-Padding: aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa\r\n";
+    std::string longLine = "HTTP/1.1 200 OK\r\nX-Long: " + std::string(1 << 20, 'a') + "\r\n\r\n{}";
+    std::string noStatus = std::string(1 << 20, 'z');
+    ScriptedClient fast(endless), line(longLine), garbage(noStatus);
+    ScriptedClient dripped("HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n", 1, true); // Stalls before the blank line
+    ScriptedClient silent("", 0, true);
+    for (ScriptedClient* client : { &fast, &line, &garbage, &dripped, &silent }) {
+        CaseResult r = runCase(*client, "hostile head");
+        TEST_ASSERT_TRUE(r.status < 0);
+    }
+}
+
+// Bodies past the cap, dripped, mis-framed or truncated are cut off and fail to parse.
+void test_hostile_bodies_are_cut_off(void) {
+    std::string huge = forecastBody(2000); // ~64 KB
+    ScriptedClient oversized(jsonHead() + huge);
+    ScriptedClient oversizedChunked(jsonHead("Transfer-Encoding: chunked\r\n") + chunked(huge, 4000));
+    ScriptedClient hugeChunk(jsonHead("Transfer-Encoding: chunked\r\n") + "ffffffffffffffff\r\n\"" + std::string(1 << 20, 'a'));
+    ScriptedClient badChunk(jsonHead("Transfer-Encoding: chunked\r\n") + "zz\r\n{}\r\n0\r\n\r\n");
+    ScriptedClient shortBody(jsonHead("Content-Length: 4000\r\n") + forecastBody(24).substr(0, 300));
+    ScriptedClient slowloris(jsonHead() + forecastBody(24), 1, true); // 1 byte/ms and never closes
+    ScriptedClient stalled(jsonHead() + "{\"hourly\":", 0, true);
+    struct { ScriptedClient* client; ResponseReadResult expected; } cases[] = {
+        { &oversized, RESPONSE_READ_TOO_LARGE }, { &oversizedChunked, RESPONSE_READ_TOO_LARGE }, { &hugeChunk, RESPONSE_READ_TOO_LARGE },
+        { &badChunk, RESPONSE_READ_FAILED }, { &shortBody, RESPONSE_READ_FAILED }, { &stalled, RESPONSE_READ_TIMEOUT },
+    };
+    for (auto& c : cases) {
+        CaseResult r = runCase(*c.client, "hostile body");
+        TEST_ASSERT_FALSE(r.parsed);
+        TEST_ASSERT_EQUAL_MESSAGE(c.expected, r.readResult, RESPONSE_READ_RESULT_NAMES[c.expected]);
+    }
+    // A whole small body at 1 byte/ms arrives well inside the deadline; the open socket is not waited on.
+    CaseResult r = runCase(slowloris, "slowloris");
+    TEST_ASSERT_TRUE(r.parsed);
+}
+
+// Random mixes of the above, each under every cap.
+void test_fuzzed_responses_stay_within_caps(void) {
+    const char* heads[] = { "", "Content-Length: 100\r\n", "Transfer-Encoding: chunked\r\n", "Content-Type: text/plain\r\n" };
+    for (int n = 0; n < 400; ++n) {
+        std::string body;
+        switch (nextRandom() % 5) {
+            case 0: // Random bytes, up to twice the cap
+                for (uint32_t i = 0, len = nextRandom() % (2 * MAX_BODY_BYTES); i < len; ++i) body += (char)(nextRandom() & 0xFF);
+                break;
+            case 1: // Valid body cut at a random point
+                body = forecastBody(24 + nextRandom() % 48);
+                body.resize(nextRandom() % (body.size() + 1));
+                break;
+            case 2: // Valid body, from normal size up to well over the cap
+                body = forecastBody(24 + nextRandom() % 600);
+                break;
+            case 3: // Densest legal array
+                body = "[";
+                for (uint32_t i = 0, len = nextRandom() % (MAX_BODY_BYTES / 2); i < len; ++i) body += i ? ",0" : "0";
+                body += "]";
+                break;
+            default: // Nesting bomb
+                body = std::string(nextRandom() % 8192, '[');
+                break;
+        }
+        const char* extra = heads[nextRandom() % 4];
+        if (strstr(extra, "chunked")) body = chunked(body, 1 + nextRandom() % 2000);
+        ScriptedClient client(jsonHead(extra) + body, nextRandom() % 3 ? 0 : 1 + nextRandom() % 512);
+        char label[32];
+        snprintf(label, sizeof(label), "fuzz case %d", n);
+        runCase(client, label);
+    }
+}
+
+// Streaming costs nothing on the heap: a well-formed body read through the reader peaks at what the
+// same document takes when parsed from a string already in memory (the old path held that string too).
+void test_streamed_parse_holds_only_the_document(void) {
+    std::string body = forecastBody(24);
+    PeakAllocator inMemory;
+    {
+        JsonDocument doc(&inMemory);
+        TEST_ASSERT_FALSE(deserializeJson(doc, body.c_str(), body.size()));
+    }
+    ScriptedClient sized(jsonHead("Content-Length: " + std::to_string(body.size()) + "\r\n") + body);
+    ScriptedClient framed(jsonHead("Transfer-Encoding: chunked\r\n") + chunked(body, 512));
+    for (ScriptedClient* client : { &sized, &framed }) {
+        CaseResult r = runCase(*client, "streamed");
+        TEST_ASSERT_TRUE(r.parsed);
+        TEST_ASSERT_EQUAL_UINT32(inMemory.peak, r.docPeak);
+    }
+    printf("  %u B body: doc peak %u B streamed and in memory, no other allocation\n", (unsigned)body.size(), (unsigned)inMemory.peak);
+}
+
+// Worst document footprint: the densest array that still fits the cap parses, under DOC_PEAK_CAP.
+void test_densest_body_under_the_memory_cap(void) {
+    std::string body = "[0";
+    while (body.size() + 3 <= MAX_BODY_BYTES) body += ",0";
+    body += "]";
+    ScriptedClient client(jsonHead() + body);
+    CaseResult r = runCase(client, "densest body");
+    TEST_ASSERT_TRUE(r.parsed);
+    printf("  densest %u B body: doc peak %u B (cap %u B)\n", (unsigned)body.size(), (unsigned)r.docPeak, (unsigned)DOC_PEAK_CAP);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_reader_fits_its_stack_budget);
+    RUN_TEST(test_well_formed_responses_parse);
+    RUN_TEST(test_bodies_refused_from_the_head);
+    RUN_TEST(test_hostile_heads_fail_within_caps);
+    RUN_TEST(test_hostile_bodies_are_cut_off);
+    RUN_TEST(test_fuzzed_responses_stay_within_caps);
+    RUN_TEST(test_streamed_parse_holds_only_the_document);
+    RUN_TEST(test_densest_body_under_the_memory_cap);
+    return UNITY_END();
+}
@@ -0,0 +1,161 @@
+// Native suite for lib/LocationResolver: the IP fix's confidence against its age and the cached
+// decision it leads to, the lookup backoff, and the backoff while the time is unknown (counted down
+// on monotonic time, then moved onto the epoch, never onto 0 + backoff).
+#include <unity.h>
+#include <math.h>
+#include <string.h>
+#include <LocationResolver.h>
+
+const LocationConfig CONFIG = { 0.5f, 0.8f, 24 * 3600, 3600, 15 * 60, 6 * 3600 }; // The firmware's LOCATION_* settings
+const uint32_t T0 = 1749549600; // 2025-06-10 10:00 UTC
+const float LATITUDE = 52.5196f;
+const float LONGITUDE = 13.4069f;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static LocationState withFixAt(uint32_t epoch) {
+    LocationState state;
+    locationReset(state);
+    locationLookupSucceeded(state, LATITUDE, LONGITUDE, "IP: Berlin", epoch);
+    return state;
+}
+
+void test_confidence_halves_per_half_life(void) {
+    LocationState state;
+    locationReset(state);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, locationIpConfidence(state, T0, CONFIG));
+    state = withFixAt(T0);
+    TEST_ASSERT_EQUAL_FLOAT(0.8f, locationIpConfidence(state, T0, CONFIG));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.4f, locationIpConfidence(state, T0 + 24 * 3600, CONFIG));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.2f, locationIpConfidence(state, T0 + 48 * 3600, CONFIG));
+    TEST_ASSERT_EQUAL_FLOAT(0.8f, locationIpConfidence(state, 0, CONFIG));      // Time unknown: age 0
+    TEST_ASSERT_EQUAL_FLOAT(0.8f, locationIpConfidence(state, T0 - 60, CONFIG)); // Clock stepped back
+}
+
+// Fresh fix: IP; older than the refresh interval: CACHED; decayed past the secrets' confidence after
+// log2(0.8 / 0.5) half-lives: SECRETS, and then until a new fix arrives.
+void test_decision_follows_the_fix_age(void) {
+    LocationState state = withFixAt(T0);
+    const uint32_t crossSec = (uint32_t)(24 * 3600 * log2f(0.8f / 0.5f)); // ~16.3 h
+    TEST_ASSERT_EQUAL(LOCATION_SOURCE_IP, locationDecide(state, T0 + 60, CONFIG));
+    TEST_ASSERT_EQUAL(T0 + crossSec, state.decisionUntil);
+    TEST_ASSERT_EQUAL(LOCATION_SOURCE_IP, locationDecide(state, T0 + 3599, CONFIG));
+    TEST_ASSERT_EQUAL(LOCATION_SOURCE_CACHED, locationDecide(state, T0 + 3600, CONFIG));
+    TEST_ASSERT_EQUAL(LOCATION_SOURCE_CACHED, locationDecide(state, T0 + crossSec - 1, CONFIG));
+    TEST_ASSERT_EQUAL(LOCATION_SOURCE_SECRETS, locationDecide(state, T0 + crossSec + 1, CONFIG));
+    TEST_ASSERT_EQUAL(UINT32_MAX, state.decisionUntil);
+    TEST_ASSERT_EQUAL(LOCATION_SOURCE_SECRETS, locationDecide(state, T0 + 30 * 24 * 3600, CONFIG));
+
+    locationLookupSucceeded(state, LATITUDE, LONGITUDE, "IP: Berlin", T0 + 31 * 24 * 3600);
+    TEST_ASSERT_EQUAL(0, state.decisionUntil); // A new fix is decided on straight away
+    TEST_ASSERT_EQUAL(LOCATION_SOURCE_IP, locationDecide(state, T0 + 31 * 24 * 3600, CONFIG));
+
+    LocationState none;
+    locationReset(none);
+    TEST_ASSERT_EQUAL(LOCATION_SOURCE_SECRETS, locationDecide(none, T0, CONFIG));
+    TEST_ASSERT_EQUAL(LOCATION_SOURCE_SECRETS, locationDecide(none, 0, CONFIG));
+}
+
+// The cached decision is only recomputed once it runs out: a changed config in between is not seen.
+void test_decision_is_cached_until_it_runs_out(void) {
+    LocationState state = withFixAt(T0);
+    locationDecide(state, T0, CONFIG);
+    const LocationConfig distrustful = { 0.9f, 0.8f, 24 * 3600, 3600, 15 * 60, 6 * 3600 };
+    TEST_ASSERT_EQUAL(LOCATION_SOURCE_IP, locationDecide(state, T0 + 10, distrustful));
+    state.decisionUntil = 0;
+    TEST_ASSERT_EQUAL(LOCATION_SOURCE_SECRETS, locationDecide(state, T0 + 10, distrustful));
+}
+
+void test_backoff_doubles_up_to_the_cap(void) {
+    const uint32_t expected[] = { 0, 900, 1800, 3600, 7200, 14400, 21600, 21600 };
+    for (uint8_t failures = 0; failures < 8; ++failures) TEST_ASSERT_EQUAL(expected[failures], locationBackoffSec(failures, CONFIG));
+    TEST_ASSERT_EQUAL(21600, locationBackoffSec(UINT8_MAX, CONFIG));
+    const LocationConfig wide = { 0.5f, 0.8f, 24 * 3600, 3600, 3600, UINT32_MAX };
+    TEST_ASSERT_EQUAL(3600u << 16, locationBackoffSec(40, wide)); // Doublings stop before the shift overflows
+}
+
+// With the time known: no lookup before the backoff has passed or while the fix is fresh; a success
+// clears the failures.
+void test_lookups_wait_for_the_backoff_and_the_refresh(void) {
+    LocationState state;
+    locationReset(state);
+    TEST_ASSERT_EQUAL(0, locationLookupDueInSec(state, T0, CONFIG)); // Never looked up
+    locationLookupFailed(state, T0, CONFIG);
+    TEST_ASSERT_EQUAL(T0 + 900, state.retryEpoch);
+    TEST_ASSERT_EQUAL(900, locationLookupDueInSec(state, T0, CONFIG));
+    TEST_ASSERT_EQUAL(1, locationLookupDueInSec(state, T0 + 899, CONFIG));
+    TEST_ASSERT_EQUAL(0, locationLookupDueInSec(state, T0 + 900, CONFIG));
+    locationLookupFailed(state, T0 + 900, CONFIG);
+    TEST_ASSERT_EQUAL(1800, locationLookupDueInSec(state, T0 + 900, CONFIG));
+
+    locationLookupSucceeded(state, LATITUDE, LONGITUDE, "IP: Berlin", T0 + 2700);
+    TEST_ASSERT_EQUAL(0, state.failures);
+    TEST_ASSERT_EQUAL(3600, locationLookupDueInSec(state, T0 + 2700, CONFIG));
+    TEST_ASSERT_EQUAL(0, locationLookupDueInSec(state, T0 + 6300, CONFIG));
+
+    // A failed refresh of a kept fix: the backoff holds even though the fix is stale
+    locationLookupFailed(state, T0 + 6300, CONFIG);
+    TEST_ASSERT_EQUAL(900, locationLookupDueInSec(state, T0 + 6300, CONFIG));
+}
+
+// Time unknown: a failure is not retried on every cycle. The backoff counts down on monotonic
+// seconds, and once the time is known what is left moves onto the epoch, not onto 0 + backoff.
+void test_backoff_is_relative_until_the_time_is_known(void) {
+    LocationState state;
+    locationReset(state);
+    locationLookupFailed(state, 0, CONFIG);
+    TEST_ASSERT_EQUAL(0, state.retryEpoch);
+    TEST_ASSERT_EQUAL(900, state.retryWaitSec);
+    TEST_ASSERT_EQUAL(900, locationLookupDueInSec(state, 0, CONFIG));
+    locationRetryElapse(state, 600, 0); // Part of a wake
+    TEST_ASSERT_EQUAL(300, locationLookupDueInSec(state, 0, CONFIG));
+    locationRetryElapse(state, 400, 0); // ...and a deep sleep
+    TEST_ASSERT_EQUAL(0, locationLookupDueInSec(state, 0, CONFIG));
+
+    locationLookupFailed(state, 0, CONFIG);
+    TEST_ASSERT_EQUAL(1800, locationLookupDueInSec(state, 0, CONFIG));
+    locationRetryElapse(state, 800, 0);
+    locationRetryElapse(state, 200, T0); // NTP synced: 800 s left from now
+    TEST_ASSERT_EQUAL(T0 + 800, state.retryEpoch);
+    TEST_ASSERT_EQUAL(0, state.retryWaitSec);
+    TEST_ASSERT_EQUAL(800, locationLookupDueInSec(state, T0, CONFIG));
+    locationRetryElapse(state, 500, T0 + 500); // An epoch deadline is left alone
+    TEST_ASSERT_EQUAL(T0 + 800, state.retryEpoch);
+    TEST_ASSERT_EQUAL(300, locationLookupDueInSec(state, T0 + 500, CONFIG));
+
+    // The time lost again with an epoch deadline pending: a full backoff rather than "due"
+    TEST_ASSERT_EQUAL(1800, locationLookupDueInSec(state, 0, CONFIG));
+}
+
+// A fix taken without the time cannot age: no refresh until the time is known, then it is stale.
+void test_fix_without_time_refreshes_once_the_time_is_known(void) {
+    LocationState state = withFixAt(0);
+    TEST_ASSERT_EQUAL(1, state.ipFix.epoch);
+    TEST_ASSERT_EQUAL(UINT32_MAX, locationLookupDueInSec(state, 0, CONFIG));
+    TEST_ASSERT_EQUAL(LOCATION_SOURCE_IP, locationDecide(state, 0, CONFIG));
+    TEST_ASSERT_EQUAL(0, locationLookupDueInSec(state, T0, CONFIG));
+    TEST_ASSERT_EQUAL(LOCATION_SOURCE_SECRETS, locationDecide(state, T0, CONFIG));
+}
+
+void test_label_fills_the_shown_line(void) {
+    LocationState state;
+    locationReset(state);
+    const char* longest = "IP: Llanfairpwllgwyngyllgogerych"; // 32 characters, one over
+    locationLookupSucceeded(state, LATITUDE, LONGITUDE, longest, T0);
+    TEST_ASSERT_EQUAL(LOCATION_LABEL_CHARS - 1, (int)strlen(state.ipFix.label));
+    TEST_ASSERT_EQUAL(0, strncmp(longest, state.ipFix.label, LOCATION_LABEL_CHARS - 1));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_confidence_halves_per_half_life);
+    RUN_TEST(test_decision_follows_the_fix_age);
+    RUN_TEST(test_decision_is_cached_until_it_runs_out);
+    RUN_TEST(test_backoff_doubles_up_to_the_cap);
+    RUN_TEST(test_lookups_wait_for_the_backoff_and_the_refresh);
+    RUN_TEST(test_backoff_is_relative_until_the_time_is_known);
+    RUN_TEST(test_fix_without_time_refreshes_once_the_time_is_known);
+    RUN_TEST(test_label_fills_the_shown_line);
+    return UNITY_END();
+}
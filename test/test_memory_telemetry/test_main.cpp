@@ -0,0 +1,114 @@
+// Native suite for lib/MemoryTelemetry: fragmentation is judged on the older half of the history
+// against the newer, the free-heap slope only over a long enough span, stack headroom per task with
+// unknown tasks ignored, and the per-site heap deltas keep their low-water mark.
+#include <unity.h>
+#include <MemoryTelemetry.h>
+
+const MemoryTrendConfig CONFIG = { 12, 0.5f, 0.1f, 512, 3600, 512 }; // The firmware's MEMORY_* settings
+const int HISTORY = 48; // MEMORY_HISTORY_SAMPLES
+const MemorySample ROOMY = { 150000, 110000, 140000, 3000, 4000 };
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_fragmentation_ratio(void) {
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, memoryFragmentationRatio(100000, 100000));
+    TEST_ASSERT_EQUAL_FLOAT(0.25f, memoryFragmentationRatio(100000, 25000));
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, memoryFragmentationRatio(0, 0));
+}
+
+// Headroom below the threshold on either task; 0 means the task was not known and is not judged.
+void test_stack_headroom(void) {
+    TEST_ASSERT_FALSE(memoryStackLow(ROOMY, CONFIG));
+    MemorySample sample = ROOMY;
+    sample.networkStackFree = 511;
+    TEST_ASSERT_TRUE(memoryStackLow(sample, CONFIG));
+    sample.networkStackFree = 512;
+    TEST_ASSERT_FALSE(memoryStackLow(sample, CONFIG));
+    sample.loopStackFree = 100;
+    TEST_ASSERT_TRUE(memoryStackLow(sample, CONFIG));
+    sample.loopStackFree = 0;
+    sample.networkStackFree = 0;
+    TEST_ASSERT_FALSE(memoryStackLow(sample, CONFIG));
+
+    MemoryTrendPoint point = { 10, 150000, 110000 };
+    sample.loopStackFree = 100;
+    TEST_ASSERT_EQUAL(MEMORY_TREND_LOW_STACK, memoryTrendEvaluate(&point, 1, sample, CONFIG).flags); // Judged from the first sample
+    TEST_ASSERT_EQUAL(0, memoryTrendEvaluate(&point, 0, sample, CONFIG).flags);
+}
+
+// A largest block that falls from 80% to 30% of free is fragmenting; one that is low throughout is not
+// a trend, and neither is anything before minSamples.
+void test_fragmentation_needs_a_drop_below_the_ratio(void) {
+    MemoryTrendPoint points[HISTORY];
+    for (int i = 0; i < HISTORY; ++i) points[i] = { (uint32_t)i * 60, 100000, i < HISTORY / 2 ? 80000u : 30000u };
+    MemoryTrend trend = memoryTrendEvaluate(points, HISTORY, ROOMY, CONFIG);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.8f, trend.olderRatio);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.3f, trend.newerRatio);
+    TEST_ASSERT_EQUAL(MEMORY_TREND_FRAGMENTING, trend.flags);
+
+    for (int i = 0; i < HISTORY; ++i) points[i].largestBlock = 30000;
+    trend = memoryTrendEvaluate(points, HISTORY, ROOMY, CONFIG);
+    TEST_ASSERT_EQUAL(0, trend.flags);
+
+    for (int i = 0; i < HISTORY; ++i) points[i].largestBlock = i < 6 ? 80000 : 30000;
+    trend = memoryTrendEvaluate(points, 11, ROOMY, CONFIG);
+    TEST_ASSERT_EQUAL(0, trend.flags);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, trend.olderRatio);
+    TEST_ASSERT_TRUE(memoryTrendEvaluate(points, 12, ROOMY, CONFIG).flags & MEMORY_TREND_FRAGMENTING);
+}
+
+// Free heap losing 1 KB an hour is a leak once the history spans an hour; the same slope over a
+// shorter span, or a heap that merely dips and recovers, is not.
+void test_leak_needs_a_slope_over_a_long_enough_span(void) {
+    MemoryTrendPoint points[HISTORY];
+    for (int i = 0; i < HISTORY; ++i) points[i] = { (uint32_t)i * 300, (uint32_t)(150000 - i * 300 * 1024 / 3600), 110000 };
+    MemoryTrend trend = memoryTrendEvaluate(points, HISTORY, ROOMY, CONFIG); // 47 x 5 min
+    TEST_ASSERT_FLOAT_WITHIN(5.0f, -1024.0f, trend.bytesPerHour);
+    TEST_ASSERT_EQUAL(MEMORY_TREND_LEAKING, trend.flags);
+
+    for (int i = 0; i < HISTORY; ++i) points[i].uptimeSec = i * 60; // Same drop per sample in 47 min: faster, but too short
+    trend = memoryTrendEvaluate(points, HISTORY, ROOMY, CONFIG);
+    TEST_ASSERT_TRUE(trend.bytesPerHour < -512.0f);
+    TEST_ASSERT_EQUAL(0, trend.flags);
+
+    for (int i = 0; i < HISTORY; ++i) points[i] = { (uint32_t)i * 300, i % 2 ? 140000u : 150000u, 110000 };
+    trend = memoryTrendEvaluate(points, HISTORY, ROOMY, CONFIG);
+    TEST_ASSERT_TRUE(trend.bytesPerHour > -512.0f);
+    TEST_ASSERT_EQUAL(0, trend.flags);
+
+    for (int i = 0; i < HISTORY; ++i) points[i].uptimeSec = 7200; // All at once: no slope to fit
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, memoryTrendEvaluate(points, HISTORY, ROOMY, CONFIG).bytesPerHour);
+}
+
+// Mean and low-water mark (largest drop) of the heap change across a call site.
+void test_site_deltas_keep_the_largest_drop(void) {
+    MemorySiteStats stats = {};
+    TEST_ASSERT_EQUAL(0, memorySiteMeanDelta(stats));
+    MemorySample before = ROOMY, after = ROOMY;
+    after.freeHeap = before.freeHeap - 4000;
+    memorySiteRecord(stats, before, after);
+    after.freeHeap = before.freeHeap + 1000;
+    memorySiteRecord(stats, before, after);
+    after.freeHeap = before.freeHeap - 600;
+    memorySiteRecord(stats, before, after);
+    TEST_ASSERT_EQUAL(3, stats.calls);
+    TEST_ASSERT_EQUAL(-3600, stats.deltaSum);
+    TEST_ASSERT_EQUAL(-1200, memorySiteMeanDelta(stats));
+    TEST_ASSERT_EQUAL(-4000, stats.deltaWorst);
+
+    MemorySiteStats growing = {};
+    after.freeHeap = before.freeHeap + 100;
+    memorySiteRecord(growing, before, after);
+    TEST_ASSERT_EQUAL(0, growing.deltaWorst); // No drop yet
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_fragmentation_ratio);
+    RUN_TEST(test_stack_headroom);
+    RUN_TEST(test_fragmentation_needs_a_drop_below_the_ratio);
+    RUN_TEST(test_leak_needs_a_slope_over_a_long_enough_span);
+    RUN_TEST(test_site_deltas_keep_the_largest_drop);
+    return UNITY_END();
+}
@@ -0,0 +1,309 @@
+// Native suite for lib/SlotScheduler: the closed-form slot search is checked against the mktime()
+// candidate loop it replaced, for every second of a simulated year, and timed against it.
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <chrono>
+#include <SlotScheduler.h>
+
+struct ReferenceDetails {
+    uint64_t sleepDurationUs;
+    time_t nextUpdateEpoch;
+    bool updateNow;
+};
+
+// calculateNextUpdateTimeDetails() as it shipped before the closed form (night skip and debug
+// output removed), kept verbatim as the oracle.
+static ReferenceDetails referenceNextUpdate(const struct tm& currentTimeInfo, uint8_t updatesPerHour, uint8_t targetStartMinute, bool isNormalModeCheck) {
+    ReferenceDetails result;
+    result.sleepDurationUs = 15 * 60 * 1000000ULL;
+    result.nextUpdateEpoch = 0;
+    result.updateNow = false;
+
+    time_t nowEpoch = mktime(const_cast<struct tm*>(&currentTimeInfo));
+
+    if (updatesPerHour == 0 || updatesPerHour > 60) updatesPerHour = 1;
+    if (targetStartMinute >= 60) targetStartMinute = 0;
+
+    int intervalMinutes = (updatesPerHour > 0) ? (60 / updatesPerHour) : 60;
+    if (intervalMinutes == 0 && updatesPerHour > 0) intervalMinutes = 1;
+
+    time_t foundNextEpoch = 0;
+
+    for (int h_offset = 0; h_offset < 2; ++h_offset) {
+        for (int i = 0; i < updatesPerHour; ++i) {
+            struct tm candidateTimeStruct = currentTimeInfo;
+            candidateTimeStruct.tm_hour = currentTimeInfo.tm_hour + h_offset;
+            candidateTimeStruct.tm_min = targetStartMinute + (i * intervalMinutes);
+            candidateTimeStruct.tm_sec = 0;
+
+            time_t candidateEpoch = mktime(&candidateTimeStruct);
+
+            if (candidateEpoch > nowEpoch) {
+                if (foundNextEpoch == 0 || candidateEpoch < foundNextEpoch) {
+                    foundNextEpoch = candidateEpoch;
+                }
+            } else if (isNormalModeCheck && (candidateEpoch == nowEpoch || (nowEpoch - candidateEpoch < intervalMinutes * 60 && nowEpoch - candidateEpoch < 30 ) )) {
+                result.updateNow = true;
+            }
+        }
+        if (foundNextEpoch != 0 && !result.updateNow) {
+            break;
+        }
+        if (foundNextEpoch != 0 && result.updateNow && foundNextEpoch > nowEpoch) {
+            break;
+        }
+    }
+
+    if (result.updateNow && isNormalModeCheck) {
+        if (foundNextEpoch == 0 || foundNextEpoch <= nowEpoch) {
+            struct tm nextSlotTimeCalc = currentTimeInfo;
+            time_t tempNowPlusInterval = nowEpoch + (intervalMinutes * 60);
+            nextSlotTimeCalc = *localtime(&tempNowPlusInterval);
+
+            bool slotFoundForNext = false;
+            for(int h_calc = 0; h_calc < 2; ++h_calc) {
+                for (int i_calc = 0; i_calc < updatesPerHour; ++i_calc) {
+                    struct tm tempCalc = currentTimeInfo;
+                    tempCalc.tm_hour = nextSlotTimeCalc.tm_hour + h_calc;
+                    tempCalc.tm_min = targetStartMinute + (i_calc * intervalMinutes);
+                    tempCalc.tm_sec = 0;
+                    time_t calcEpoch = mktime(&tempCalc);
+                    if (calcEpoch > nowEpoch) {
+                         if (foundNextEpoch == 0 || calcEpoch < foundNextEpoch || (foundNextEpoch <= nowEpoch && calcEpoch > foundNextEpoch) ){
+                            foundNextEpoch = calcEpoch;
+                            slotFoundForNext = true;
+                         }
+                    }
+                }
+                if(slotFoundForNext && (foundNextEpoch > nowEpoch)) break;
+            }
+             if (!slotFoundForNext || foundNextEpoch <= nowEpoch) {
+                struct tm fallbackNext = currentTimeInfo;
+                fallbackNext.tm_hour +=1;
+                fallbackNext.tm_min = targetStartMinute;
+                fallbackNext.tm_sec = 0;
+                foundNextEpoch = mktime(&fallbackNext);
+                if (foundNextEpoch <= nowEpoch) {
+                    fallbackNext.tm_mday +=1;
+                    mktime(&fallbackNext);
+                    foundNextEpoch = mktime(&fallbackNext);
+                }
+             }
+        }
+        result.nextUpdateEpoch = foundNextEpoch;
+        result.sleepDurationUs = 0;
+    } else if (foundNextEpoch != 0) {
+        result.nextUpdateEpoch = foundNextEpoch;
+        result.sleepDurationUs = (uint64_t)difftime(result.nextUpdateEpoch, nowEpoch) * 1000000ULL;
+    } else {
+        struct tm fallbackTime = currentTimeInfo;
+        fallbackTime.tm_hour += 1;
+        fallbackTime.tm_min = targetStartMinute;
+        fallbackTime.tm_sec = 0;
+        result.nextUpdateEpoch = mktime(&fallbackTime);
+        if (result.nextUpdateEpoch <= nowEpoch) {
+            fallbackTime.tm_mday +=1;
+            mktime(&fallbackTime);
+            result.nextUpdateEpoch = mktime(&fallbackTime);
+        }
+        result.sleepDurationUs = (uint64_t)difftime(result.nextUpdateEpoch, nowEpoch) * 1000000ULL;
+    }
+
+    if (result.sleepDurationUs == 0 && !result.updateNow && result.nextUpdateEpoch == nowEpoch) {
+        result.nextUpdateEpoch = nowEpoch + (uint64_t)intervalMinutes * 60;
+        result.sleepDurationUs = (uint64_t)intervalMinutes * 60 * 1000000ULL;
+    }
+    if (result.sleepDurationUs == 0 && !result.updateNow) {
+         result.sleepDurationUs = (uint64_t)intervalMinutes * 60 * 1000000ULL;
+         if(result.sleepDurationUs == 0) result.sleepDurationUs = 60 * 60 * 1000000ULL;
+         result.nextUpdateEpoch = nowEpoch + (result.sleepDurationUs / 1000000ULL);
+    }
+    uint64_t practicalMaxSleepUs = 3LL * 60 * 60 * 1000000;
+    if (!isNormalModeCheck && result.sleepDurationUs > practicalMaxSleepUs) {
+        result.sleepDurationUs = (uint64_t)(intervalMinutes > 0 ? intervalMinutes : 60) * 60 * 1000000ULL;
+        if(result.sleepDurationUs == 0 || result.sleepDurationUs > practicalMaxSleepUs) result.sleepDurationUs = 60*60*1000000ULL;
+        result.nextUpdateEpoch = nowEpoch + (result.sleepDurationUs / 1000000ULL);
+    }
+    return result;
+}
+
+// Same contract as the firmware wrapper with SKIP_NIGHT_UPDATES off.
+static ReferenceDetails closedFormNextUpdate(const struct tm& nowInfo, time_t nowEpoch, uint8_t updatesPerHour, uint8_t targetStartMinute, bool isNormalModeCheck) {
+    RefreshSlot slot = nextRefreshSlot(nowEpoch, localUtcOffsetSeconds(nowInfo, nowEpoch), updatesPerHour, targetStartMinute, isNormalModeCheck);
+    ReferenceDetails result;
+    result.nextUpdateEpoch = slot.nextSlotEpoch;
+    result.updateNow = slot.dueNow;
+    result.sleepDurationUs = slot.dueNow ? 0 : (uint64_t)(slot.nextSlotEpoch - nowEpoch) * 1000000ULL;
+    return result;
+}
+
+static void useTimeZone(const char* posixTz) {
+    setenv("TZ", posixTz, 1);
+    tzset();
+}
+
+const time_t YEAR_START_EPOCH = 1704067200; // 2024-01-01 00:00:00 UTC, a leap year
+const time_t YEAR_SECONDS = 366L * 86400L;
+
+// Walks [start, start + span) in steps of stepSec and fails on the first disagreement.
+static void compareRange(time_t start, time_t span, time_t stepSec, uint8_t updatesPerHour, uint8_t targetStartMinute, bool isNormalModeCheck) {
+    for (time_t t = start; t < start + span; t += stepSec) {
+        struct tm nowInfo;
+        localtime_r(&t, &nowInfo);
+        struct tm referenceInfo = nowInfo;
+        ReferenceDetails expected = referenceNextUpdate(referenceInfo, updatesPerHour, targetStartMinute, isNormalModeCheck);
+        ReferenceDetails actual = closedFormNextUpdate(nowInfo, t, updatesPerHour, targetStartMinute, isNormalModeCheck);
+        if (expected.nextUpdateEpoch != actual.nextUpdateEpoch || expected.updateNow != actual.updateNow
+            || expected.sleepDurationUs != actual.sleepDurationUs) {
+            char msg[200];
+            snprintf(msg, sizeof(msg), "t=%ld uph=%u min=%u normal=%d: reference next=%ld now=%d sleep=%llu, closed form next=%ld now=%d sleep=%llu",
+                     (long)t, updatesPerHour, targetStartMinute, isNormalModeCheck,
+                     (long)expected.nextUpdateEpoch, expected.updateNow, (unsigned long long)expected.sleepDurationUs,
+                     (long)actual.nextUpdateEpoch, actual.updateNow, (unsigned long long)actual.sleepDurationUs);
+            TEST_FAIL_MESSAGE(msg);
+        }
+    }
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Shipped configuration (LPM 1/h, normal 4/h, start minute 0) in a zone with hour DST shifts,
+// every second of 2024 including both transitions.
+void test_every_second_of_year_lpm(void) {
+    useTimeZone("CET-1CEST,M3.5.0,M10.5.0/3");
+    compareRange(YEAR_START_EPOCH, YEAR_SECONDS, 1, 1, 0, false);
+}
+
+void test_every_second_of_year_normal(void) {
+    useTimeZone("CET-1CEST,M3.5.0,M10.5.0/3");
+    compareRange(YEAR_START_EPOCH, YEAR_SECONDS, 1, 4, 0, true);
+}
+
+// A range of rates and start minutes, every second of the DST-change days. The reference only
+// looks at slots of the current and next local hour by their nominal minute, so it misses a slot
+// that wraps into the following hour (e.g. :59 + 30 min); those grids are covered by
+// test_wrapped_slot_grid instead.
+void test_dst_days_all_rates(void) {
+    useTimeZone("CET-1CEST,M3.5.0,M10.5.0/3");
+    const time_t springForward = 1711846800 - 6 * 3600; // 2024-03-31, change at 01:00 UTC
+    const time_t fallBack = 1729990800 - 6 * 3600;      // 2024-10-27, change at 01:00 UTC
+    const uint8_t rates[] = {1, 2, 3, 4, 5, 6, 7, 12};
+    const uint8_t startMinutes[] = {0, 4, 7, 29, 59};
+    int compared = 0;
+    for (uint8_t rate : rates) {
+        for (uint8_t startMinute : startMinutes) {
+            if (startMinute + (rate - 1) * (60 / rate) >= 60) continue;
+            for (int normal = 0; normal < 2; ++normal) {
+                compareRange(springForward, 12 * 3600, 1, rate, startMinute, normal != 0);
+                compareRange(fallBack, 12 * 3600, 1, rate, startMinute, normal != 0);
+                compared++;
+            }
+        }
+    }
+    TEST_ASSERT_GREATER_THAN(20, compared);
+}
+
+// Brute force over the slot set itself in UTC, including grids that wrap past the hour.
+void test_wrapped_slot_grid(void) {
+    useTimeZone("UTC0");
+    const time_t dayStart = YEAR_START_EPOCH + 40L * 86400L;
+    for (uint8_t rate = 1; rate <= 60; ++rate) {
+        const int32_t intervalSec = (60 / rate) * 60;
+        for (uint8_t startMinute = 0; startMinute < 60; startMinute += 13) {
+            for (time_t t = dayStart; t < dayStart + 3 * 3600; t += 11) {
+                time_t expectedNext = 0, lastSlot = 0;
+                for (time_t hour = (t / 3600 - 2) * 3600; hour <= (t / 3600 + 2) * 3600; hour += 3600) {
+                    for (int i = 0; i < rate; ++i) {
+                        time_t slot = hour + startMinute * 60 + i * intervalSec;
+                        if (slot > t && (expectedNext == 0 || slot < expectedNext)) expectedNext = slot;
+                        if (slot <= t && slot > lastSlot) lastSlot = slot;
+                    }
+                }
+                RefreshSlot slot = nextRefreshSlot(t, 0, rate, startMinute, true);
+                TEST_ASSERT_EQUAL_INT64((int64_t)expectedNext, (int64_t)slot.nextSlotEpoch);
+                TEST_ASSERT_EQUAL(t - lastSlot < SLOT_DUE_WINDOW_SEC, slot.dueNow);
+            }
+        }
+    }
+}
+
+// Half-hour standard offset with hour DST (Newfoundland): the minute grid is still intact.
+void test_half_hour_offset_zone(void) {
+    useTimeZone("NST3:30NDT,M3.2.0,M11.1.0");
+    compareRange(YEAR_START_EPOCH, YEAR_SECONDS, 7, 4, 0, true);
+    compareRange(YEAR_START_EPOCH, YEAR_SECONDS, 7, 2, 15, false);
+}
+
+// Southern hemisphere with DST spanning the new year.
+void test_southern_hemisphere_zone(void) {
+    useTimeZone("AEST-10AEDT,M10.1.0,M4.1.0/3");
+    compareRange(YEAR_START_EPOCH, YEAR_SECONDS, 7, 4, 0, true);
+    compareRange(YEAR_START_EPOCH, YEAR_SECONDS, 7, 2, 0, false);
+}
+
+void test_days_from_civil_matches_timegm(void) {
+    for (int year = 1970; year <= 2100; ++year) {
+        for (int month = 1; month <= 12; ++month) {
+            struct tm info = {};
+            info.tm_year = year - 1900;
+            info.tm_mon = month - 1;
+            info.tm_mday = 1;
+            TEST_ASSERT_EQUAL_INT64((int64_t)timegm(&info) / 86400, daysFromCivil(year, month, 1));
+        }
+    }
+}
+
+// Microbenchmark: the same 4 x 96 quarter-hour instants the on-device bench uses, repeated.
+void test_closed_form_is_faster(void) {
+    useTimeZone("CET-1CEST,M3.5.0,M10.5.0/3");
+    const int SAMPLE_COUNT = 4 * 96;
+    const int ROUNDS = 200;
+    static struct tm samples[SAMPLE_COUNT];
+    static time_t sampleEpochs[SAMPLE_COUNT];
+    for (int i = 0; i < SAMPLE_COUNT; ++i) {
+        sampleEpochs[i] = YEAR_START_EPOCH + (i / 96) * 91L * 86400L + (i % 96) * 900L + 7;
+        localtime_r(&sampleEpochs[i], &samples[i]);
+    }
+
+    volatile uint64_t sink = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < ROUNDS; ++r) {
+        for (int i = 0; i < SAMPLE_COUNT; ++i) {
+            struct tm info = samples[i];
+            sink += (uint64_t)referenceNextUpdate(info, (i & 1) ? 4 : 2, 0, i & 1).nextUpdateEpoch;
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (int r = 0; r < ROUNDS; ++r) {
+        for (int i = 0; i < SAMPLE_COUNT; ++i) {
+            struct tm info = samples[i];
+            time_t nowEpoch = mktime(&info); // The firmware wrapper still converts "now" once
+            sink += (uint64_t)closedFormNextUpdate(info, nowEpoch, (i & 1) ? 4 : 2, 0, i & 1).nextUpdateEpoch;
+        }
+    }
+    auto t2 = std::chrono::steady_clock::now();
+
+    double referenceNs = std::chrono::duration<double, std::nano>(t1 - t0).count() / (ROUNDS * SAMPLE_COUNT);
+    double closedFormNs = std::chrono::duration<double, std::nano>(t2 - t1).count() / (ROUNDS * SAMPLE_COUNT);
+    char msg[120];
+    snprintf(msg, sizeof(msg), "mktime loop %.0f ns/call, closed form %.0f ns/call, speedup %.1fx",
+             referenceNs, closedFormNs, referenceNs / closedFormNs);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_LESS_THAN_DOUBLE(referenceNs, closedFormNs);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_days_from_civil_matches_timegm);
+    RUN_TEST(test_dst_days_all_rates);
+    RUN_TEST(test_wrapped_slot_grid);
+    RUN_TEST(test_every_second_of_year_lpm);
+    RUN_TEST(test_every_second_of_year_normal);
+    RUN_TEST(test_half_hour_offset_zone);
+    RUN_TEST(test_southern_hemisphere_zone);
+    RUN_TEST(test_closed_form_is_faster);
+    return UNITY_END();
+}
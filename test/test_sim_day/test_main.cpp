@@ -0,0 +1,118 @@
+// Native simulation suite for normal mode: src/main.cpp runs one continuous day on the host shim,
+// powered on at local midnight in Berlin. The state machine and timer wheel are checked from the
+// outside: when the fake servers are asked, what the display is sent, and how the device rides out
+// an access point outage.
+#define HOST_SIM_IMPLEMENTATION
+#include <unity.h>
+#include <stdio.h>
+#include <host_boot.h>
+#include <host_servers.h>
+#include <SolarCalc.h>
+
+const int64_t S = 1000000;
+const int64_t START_EPOCH_US = 1749506400LL * S; // 2025-06-10 00:00 CEST
+const float LATITUDE = 52.5196f;                 // ip-api.com's answer
+const float LONGITUDE = 13.4069f;
+const NightSkipConfig SKIP_CONFIG = { 15, 30, 12 }; // SUNRISE_LEAD/SUNSET_GRACE/POLAR_NIGHT_RECHECK in main.cpp
+const int64_t SLOT_LATENESS_US = 30 * S;            // SLOT_DUE_WINDOW_SEC: association and TLS fit in it
+const int64_t OUTAGE_START_US = 12 * 3600 * S;
+const int64_t OUTAGE_END_US = OUTAGE_START_US + 10 * 60 * S;
+const int64_t DAY_US = 24 * 3600 * S;
+
+static std::vector<int64_t>& uvRequests() { return hostsim::network().servers["api.open-meteo.com"].requestEpochUs; }
+
+static time_t epochOf(int64_t trueUs) { return (time_t)(trueUs / S); }
+
+// Slots are at minute 2 of the hour plus multiples of the adaptive interval (15, 20, 30 or 60 min,
+// all multiples of 5), local time.
+static bool onSlotGrid(int64_t trueUs) {
+    int64_t localUs = trueUs + (int64_t)hostsim::berlinUtcOffsetSec(epochOf(trueUs)) * S;
+    return (localUs - 120 * S) % (300 * S) < SLOT_LATENESS_US;
+}
+
+static void runUntil(int64_t atUs) {
+    TEST_ASSERT_EQUAL(hostsim::STOP_DEADLINE, hostsim::runUntil(atUs));
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Power-on fetch, then nothing until the night ends; the first daylight fetch is at sunrise minus the lead.
+void test_night_then_first_daylight_fetch(void) {
+    hostsim::kernel().trueEpochBaseUs = START_EPOCH_US;
+    hostsim::installFakeServers();
+    hostsim::startArduino();
+    runUntil(10 * 3600 * S);
+    std::vector<int64_t>& requests = uvRequests();
+    TEST_ASSERT_TRUE(requests.size() > 2);
+    TEST_ASSERT_TRUE(requests[0] - START_EPOCH_US < 5 * S);
+    time_t daylight = nightSkipTarget(epochOf(requests[0]), LATITUDE, LONGITUDE, SKIP_CONFIG);
+    TEST_ASSERT_TRUE(daylight > epochOf(requests[0]));
+    TEST_ASSERT_TRUE(epochOf(requests[1]) >= daylight);
+    TEST_ASSERT_TRUE(epochOf(requests[1]) - daylight < SLOT_LATENESS_US / S);
+}
+
+// Link down at noon for 10 minutes: no requests, a reconnect attempt a minute, the missed slot
+// fetched as soon as the link is back.
+void test_outage_retries_then_catches_up(void) {
+    runUntil(OUTAGE_START_US);
+    size_t requestsBefore = uvRequests().size();
+    uint32_t beginsBefore = hostsim::network().beginCalls;
+    hostsim::setAccessPointUp(false);
+    runUntil(OUTAGE_END_US);
+    TEST_ASSERT_EQUAL(requestsBefore, uvRequests().size());
+    uint32_t attempts = hostsim::network().beginCalls - beginsBefore;
+    printf("  %u reconnect attempts in 10 minutes\n", attempts);
+    TEST_ASSERT_TRUE(attempts >= 8 && attempts <= 11);
+    hostsim::setAccessPointUp(true);
+    runUntil(OUTAGE_END_US + 5 * 60 * S);
+    TEST_ASSERT_EQUAL(requestsBefore + 1, uvRequests().size());
+    TEST_ASSERT_TRUE(uvRequests().back() - (START_EPOCH_US + OUTAGE_END_US) < 75 * S);
+    TEST_ASSERT_TRUE(hostsim::serialLog().text.find("WiFi reconnected and update is due/overdue") != std::string::npos);
+}
+
+// The whole day: one fetch per slot, each on the grid and in daylight, spaced by the adaptive interval.
+void test_day_fetches_once_per_slot_in_daylight(void) {
+    runUntil(DAY_US);
+    const std::vector<int64_t>& requests = uvRequests();
+    int64_t catchUpUs = START_EPOCH_US + OUTAGE_END_US;
+    int daytime = 0;
+    for (size_t i = 1; i < requests.size(); ++i) {
+        char msg[96];
+        snprintf(msg, sizeof(msg), "fetch %u at %.2f h", (unsigned)i, (requests[i] - START_EPOCH_US) / 3600.0 / S);
+        TEST_ASSERT_EQUAL_INT64_MESSAGE(0, (int64_t)nightSkipTarget(epochOf(requests[i]), LATITUDE, LONGITUDE, SKIP_CONFIG), msg);
+        bool firstOfDay = (i == 1), catchUp = requests[i] >= catchUpUs && requests[i] - catchUpUs < 75 * S;
+        if (!firstOfDay && !catchUp) TEST_ASSERT_TRUE_MESSAGE(onSlotGrid(requests[i]), msg);
+        if (i >= 2 && !catchUp) {
+            int64_t gapUs = requests[i] - requests[i - 1];
+            bool afterFirst = (i == 2), afterOutage = requests[i - 1] >= catchUpUs && requests[i - 1] - catchUpUs < 75 * S;
+            if (!afterFirst && !afterOutage) TEST_ASSERT_TRUE_MESSAGE(gapUs >= 15 * 60 * S - SLOT_LATENESS_US, msg);
+            TEST_ASSERT_TRUE_MESSAGE(gapUs <= 60 * 60 * S + SLOT_LATENESS_US, msg);
+        }
+        daytime++;
+    }
+    printf("  %d daytime fetches, %u associations\n", daytime, hostsim::network().associations);
+    TEST_ASSERT_TRUE(daytime >= 17 && daytime <= 4 * 17 + 2); // ~16.5 h of daylight window at 1..4 per hour
+}
+
+// TIMER_QUARTER_REDRAW: a frame goes out within a couple of seconds of every quarter hour.
+void test_quarter_hour_redraws(void) {
+    const std::vector<hostsim::DisplayCommand>& trace = hostsim::displayBus().trace;
+    size_t next = 0;
+    for (int64_t quarterUs = START_EPOCH_US + 900 * S; quarterUs < START_EPOCH_US + DAY_US; quarterUs += 900 * S) {
+        while (next < trace.size() && (trace[next].command != TFT_RAMWR || trace[next].epochUs < quarterUs)) next++;
+        char msg[64];
+        snprintf(msg, sizeof(msg), "no redraw for %.2f h", (quarterUs - START_EPOCH_US) / 3600.0 / S);
+        TEST_ASSERT_TRUE_MESSAGE(next < trace.size() && trace[next].epochUs - quarterUs <= 2 * S, msg);
+    }
+    TEST_ASSERT_EQUAL(1, (int)hostsim::displayBus().inits);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_night_then_first_daylight_fetch);
+    RUN_TEST(test_outage_retries_then_catches_up);
+    RUN_TEST(test_day_fetches_once_per_slot_in_daylight);
+    RUN_TEST(test_quarter_hour_redraws);
+    return UNITY_END();
+}
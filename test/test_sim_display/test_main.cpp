@@ -0,0 +1,328 @@
+// Native simulation suite for the display power path: src/main.cpp runs on the host shim across
+// several boots (power-on, timer wake, button wakes) and every command that reaches the ST7789 is
+// replayed through a model of the controller that checks ordering and the datasheet's timing. The
+// UI pages' frame cache is followed through the "pages" serial dump.
+#define HOST_SIM_IMPLEMENTATION
+#include <unity.h>
+#include <stdio.h>
+#include <host_boot.h>
+#include <host_servers.h>
+
+const int64_t MS = 1000;
+const int64_t SETTLE_US = 120 * MS; // SLPIN <-> SLPOUT, SLPOUT -> DISPON, reset -> SLPOUT
+const int64_t GUARD_US = 5 * MS;    // Any other command after SLPIN/SLPOUT/reset
+const int64_t START_EPOCH_US = 1749549600LL * 1000000LL; // 2025-06-10 10:00 UTC
+const int64_t DEBOUNCE_MS = 50;              // DEBOUNCE_TIME_MS in main.cpp
+const int64_t DOUBLE_CLICK_WINDOW_MS = 300;  // DOUBLE_CLICK_WINDOW_MS (info button only)
+const int64_t LATENCY_SLACK_US = 5 * MS;     // Loop wake-up and render on the virtual clock
+const int BUTTON_INFO_PIN = 0;
+const int BUTTON_LP_TOGGLE_PIN = 35;
+const int UI_PAGES = 4;
+const char* const PAGE_NAMES[UI_PAGES] = { "forecast", "day", "stats", "network" };
+const unsigned SPRITE_BYTES = 240 * 135 * 2;
+
+// The controller as the datasheet describes it. Fed the bus trace in order (true time across boots,
+// since the controller keeps running while the ESP32 is in deep sleep).
+struct St7789Model {
+    bool asleep = true;         // Sleep-in after reset
+    bool displayOn = false;
+    int64_t edgeUs = INT64_MIN; // Last SLPIN/SLPOUT/reset
+    uint8_t edgeCommand = 0;
+    bool wokeFromSleepIn = false;
+    bool frameSinceWake = false;
+    int resets = 0;
+    std::vector<std::string> violations;
+
+    void violation(const hostsim::DisplayCommand& c, const char* what) {
+        char text[128];
+        snprintf(text, sizeof(text), "0x%02X at %.1f ms: %s", c.command, (c.epochUs - START_EPOCH_US) / 1000.0, what);
+        violations.push_back(text);
+    }
+
+    void feed(const hostsim::DisplayCommand& c) {
+        if (!c.busReady) violation(c, "bus not set up (CS/DC outputs, SPI)");
+        if (edgeUs != INT64_MIN) {
+            bool settle = ((c.command == TFT_SLPIN || c.command == TFT_SLPOUT) && c.command != edgeCommand) ||
+                          (c.command == TFT_DISPON && edgeCommand == TFT_SLPOUT);
+            if (c.epochUs - edgeUs < (settle ? SETTLE_US : GUARD_US)) violation(c, settle ? "inside the 120 ms settle" : "inside the 5 ms guard");
+        }
+        switch (c.command) {
+            case TFT_SWRST:
+                resets++;
+                asleep = true;
+                displayOn = false;
+                edgeUs = c.epochUs;
+                edgeCommand = TFT_SLPIN; // Reset leaves it in sleep-in, with the same 120 ms before SLPOUT
+                wokeFromSleepIn = false;
+                break;
+            case TFT_SLPOUT:
+                if (!asleep) violation(c, "SLPOUT while awake");
+                wokeFromSleepIn = resets > 0 && edgeCommand == TFT_SLPIN && displayOn;
+                asleep = false;
+                frameSinceWake = false;
+                edgeUs = c.epochUs;
+                edgeCommand = TFT_SLPOUT;
+                break;
+            case TFT_SLPIN:
+                if (asleep) violation(c, "SLPIN while asleep");
+                asleep = true;
+                edgeUs = c.epochUs;
+                edgeCommand = TFT_SLPIN;
+                break;
+            case TFT_DISPON:
+                if (asleep) violation(c, "DISPON in sleep-in");
+                if (wokeFromSleepIn && !frameSinceWake) violation(c, "DISPON before a frame was written after SLPOUT");
+                displayOn = true;
+                break;
+            case TFT_DISPOFF:
+                displayOn = false;
+                break;
+            case TFT_RAMWR:
+                frameSinceWake = true;
+                break;
+        }
+    }
+};
+
+static hostsim::Device device;
+static St7789Model controller;
+
+static hostsim::BootRecord bootAndCheck(int wakeCause, int64_t maxAwakeUs, std::function<void()> scenario = nullptr) {
+    hostsim::BootRecord boot = device.boot(wakeCause, maxAwakeUs, [scenario] {
+        hostsim::installFakeServers();
+        if (scenario) scenario();
+    });
+    TEST_ASSERT_TRUE_MESSAGE(boot.completed, "boot crashed");
+    for (const hostsim::DisplayCommand& c : boot.display) controller.feed(c);
+    for (const std::string& v : controller.violations) printf("  %s\n", v.c_str());
+    if (getenv("SIM_TRACE")) // Prints the bus trace of each boot for (auto& c : boot.display) printf("   %10.3f ms 0x%02X %d\n", c.atUs / 1000.0, c.command, c.busReady);
+    TEST_ASSERT_EQUAL_MESSAGE(0, (int)controller.violations.size(), "controller model reported violations");
+    return boot;
+}
+
+static int indexOf(const std::vector<hostsim::DisplayCommand>& trace, uint8_t command, size_t from = 0) {
+    for (size_t i = from; i < trace.size(); ++i) if (trace[i].command == command) return (int)i;
+    return -1;
+}
+
+// One "pages" dump: the summary line and each page's entry (bytes 0: not cached).
+struct PageCacheDump {
+    std::string page;
+    unsigned bytes = 0, budget = 0, hits = 0, misses = 0, evictions = 0;
+    unsigned frameBytes[UI_PAGES] = {}, shown[UI_PAGES] = {};
+};
+
+static std::vector<PageCacheDump> pageCacheDumps(const std::string& serial) {
+    std::vector<PageCacheDump> dumps;
+    for (size_t at = serial.find("| cache "); at != std::string::npos; at = serial.find("| cache ", at + 1)) {
+        PageCacheDump dump;
+        char page[16];
+        unsigned sprite, uncached;
+        const char* line = serial.c_str() + serial.rfind('\n', at) + 1;
+        if (sscanf(line, "Page: %15s | cache %u of %u bytes (+%u sprite) | hits %u, misses %u, evictions %u, uncached %u", page, &dump.bytes,
+                   &dump.budget, &sprite, &dump.hits, &dump.misses, &dump.evictions, &uncached) != 8) continue;
+        dump.page = page;
+        for (int i = 0; i < UI_PAGES && (line = strchr(line, '\n')); ++i) {
+            unsigned runs, colours;
+            sscanf(++line, "%15s %u runs, %u colours, %u bytes, shown #%u", page, &runs, &colours, &dump.frameBytes[i], &dump.shown[i]);
+        }
+        dumps.push_back(dump);
+    }
+    return dumps;
+}
+
+// Presses the page button count times, one second apart from atMs, with a "pages" dump after each.
+static void pressPagesAndDump(int64_t atMs, int count, int pin = BUTTON_LP_TOGGLE_PIN) {
+    for (int n = 0; n < count; ++n) {
+        int64_t us = (atMs + n * 1000) * MS;
+        hostsim::scheduleEvent(us, [pin] { hostsim::setPinLevel(pin, 0); });
+        hostsim::scheduleEvent(us + 120 * MS, [pin] { hostsim::setPinLevel(pin, 1); });
+        hostsim::scheduleEvent(us + 800 * MS, [] { hostsim::serialLog().input += "pages\n"; }); // After the double-click window
+    }
+}
+
+static unsigned allFramesBytes = 0; // Every page cached at once, measured by the first page cache test
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_model_flags_bad_traces(void) {
+    auto run = [](std::vector<std::pair<int64_t, uint8_t>> commands, bool busReady = true) {
+        St7789Model model;
+        for (auto& c : commands) model.feed({ 0, START_EPOCH_US + c.first * MS, c.second, busReady });
+        return model.violations.size();
+    };
+    std::vector<std::pair<int64_t, uint8_t>> good = { { 0, TFT_SWRST }, { 150, TFT_SLPOUT }, { 270, TFT_DISPON }, { 300, TFT_RAMWR },
+                                                      { 400, TFT_DISPOFF }, { 400, TFT_SLPIN }, { 600, TFT_SLPOUT },
+                                                      { 610, TFT_RAMWR }, { 720, TFT_DISPON } };
+    TEST_ASSERT_EQUAL(0, run(good));
+    TEST_ASSERT_EQUAL(1, run(good, false) ? 1 : 0);
+    TEST_ASSERT_EQUAL(1, run({ { 0, TFT_SWRST }, { 100, TFT_SLPOUT } }));                         // Reset settle
+    TEST_ASSERT_EQUAL(1, run({ { 0, TFT_SWRST }, { 150, TFT_SLPOUT }, { 200, TFT_DISPON } }));    // DISPON settle
+    TEST_ASSERT_EQUAL(1, run({ { 0, TFT_SWRST }, { 150, TFT_SLPOUT }, { 250, TFT_SLPIN } }));     // SLPIN settle
+    TEST_ASSERT_EQUAL(1, run({ { 0, TFT_SWRST }, { 150, TFT_SLPOUT }, { 300, TFT_SLPIN }, { 302, TFT_RAMWR } })); // Guard
+    TEST_ASSERT_EQUAL(1, run({ { 0, TFT_SWRST }, { 150, TFT_SLPOUT }, { 300, TFT_DISPON }, { 400, TFT_SLPIN },
+                               { 600, TFT_SLPOUT }, { 800, TFT_DISPON } }));                       // No frame before DISPON
+    TEST_ASSERT_EQUAL(1, run({ { 0, TFT_SWRST }, { 150, TFT_DISPON } }));                          // On while asleep
+}
+
+// Power-on in low power mode: one reset and init, the cached/fetched frame, then sleep-in for deep sleep.
+void test_power_on_initialises_once_and_sleeps_the_panel(void) {
+    device.trueEpochUs = START_EPOCH_US;
+    device.eeprom[0] = 1; // LPM flag
+    hostsim::BootRecord boot = bootAndCheck(0, 120 * 1000 * MS);
+    TEST_ASSERT_TRUE(boot.slept);
+    TEST_ASSERT_EQUAL(1, controller.resets);
+    TEST_ASSERT_EQUAL_HEX8(TFT_SWRST, boot.display.front().command);
+    int slpout = indexOf(boot.display, TFT_SLPOUT), dispon = indexOf(boot.display, TFT_DISPON);
+    TEST_ASSERT_TRUE(slpout > 0 && dispon > slpout);
+    TEST_ASSERT_EQUAL_HEX8(TFT_SLPIN, boot.display.back().command);
+    TEST_ASSERT_TRUE(controller.asleep);
+    device.sleep(boot);
+}
+
+// A timer wake fetches silently: the controller must not hear anything, least of all a reset, and
+// the boot profile shows no display step.
+void test_timer_wake_leaves_the_panel_asleep(void) {
+    hostsim::BootRecord boot = bootAndCheck(4, 120 * 1000 * MS); // ESP_SLEEP_WAKEUP_TIMER
+    TEST_ASSERT_TRUE(boot.slept);
+    TEST_ASSERT_EQUAL(0, (int)boot.display.size());
+    TEST_ASSERT_TRUE(boot.requests.size() > 0);
+    size_t at = boot.serial.find("BOOT PROFILE (timer wake, back to sleep):");
+    TEST_ASSERT_TRUE_MESSAGE(at != std::string::npos, "no boot profile");
+    std::string profile = boot.serial.substr(at, boot.serial.find('\n', at) - at);
+    printf("  %s\n", profile.c_str());
+    TEST_ASSERT_TRUE(profile.find(" fetch +") != std::string::npos);
+    TEST_ASSERT_TRUE(profile.find(" done +") != std::string::npos);
+    TEST_ASSERT_EQUAL(std::string::npos, profile.find(" display +")); // Never brought up
+    device.sleep(boot);
+}
+
+// A button wake sends SLPOUT first thing, draws while the panel settles and turns it on no earlier
+// than 120 ms later; the screen timeout puts it back into sleep-in.
+void test_button_wake_skips_reset_and_overlaps_the_settle(void) {
+    hostsim::BootRecord previous;
+    for (int wake = 0; wake < 3; ++wake) {
+        hostsim::BootRecord boot = bootAndCheck(2, 120 * 1000 * MS); // ESP_SLEEP_WAKEUP_EXT0
+        TEST_ASSERT_TRUE(boot.slept);
+        TEST_ASSERT_EQUAL(1, controller.resets);
+        TEST_ASSERT_EQUAL(-1, indexOf(boot.display, TFT_SWRST));
+        TEST_ASSERT_EQUAL_HEX8(TFT_SLPOUT, boot.display.front().command);
+        int dispon = indexOf(boot.display, TFT_DISPON);
+        TEST_ASSERT_TRUE(dispon > 0);
+        TEST_ASSERT_TRUE(indexOf(boot.display, TFT_RAMWR) < dispon);
+        int64_t settleUs = boot.display[dispon].atUs - boot.display.front().atUs;
+        printf("  button wake %d: SLPOUT at %.1f ms, DISPON %.1f ms later\n", wake, boot.display.front().atUs / 1000.0, settleUs / 1000.0);
+        TEST_ASSERT_TRUE(settleUs >= SETTLE_US);
+        TEST_ASSERT_TRUE(settleUs < SETTLE_US + 100 * MS); // The frame is drawn inside the settle, not after it
+        TEST_ASSERT_EQUAL_HEX8(TFT_SLPIN, boot.display.back().command);
+        device.sleep(boot, (1 + wake) * 60 * 1000 * MS); // Pressed again a few minutes in
+    }
+}
+
+// A short press on each button, on a button wake with the screen on: the loop idles until the
+// event and redraws no later than debounce (+ the double-click window on the info button) after
+// the release. The info button's short press must also not come out before its window has passed.
+void test_button_edges_are_handled_within_the_gesture_window(void) {
+    const int64_t infoPressUs = 3000 * MS, lpPressUs = 6000 * MS, holdUs = 120 * MS;
+    hostsim::BootRecord boot = bootAndCheck(2, 120 * 1000 * MS, [=] {
+        hostsim::scheduleEvent(infoPressUs, [] { hostsim::setPinLevel(BUTTON_INFO_PIN, 0); });
+        hostsim::scheduleEvent(infoPressUs + holdUs, [] { hostsim::setPinLevel(BUTTON_INFO_PIN, 1); });
+        hostsim::scheduleEvent(lpPressUs, [] { hostsim::setPinLevel(BUTTON_LP_TOGGLE_PIN, 0); });
+        hostsim::scheduleEvent(lpPressUs + holdUs, [] { hostsim::setPinLevel(BUTTON_LP_TOGGLE_PIN, 1); });
+    });
+    auto firstFrameAfter = [&boot](int64_t us) {
+        for (const hostsim::DisplayCommand& c : boot.display) if (c.command == TFT_RAMWR && c.atUs > us) return c.atUs;
+        return INT64_MAX;
+    };
+    int64_t infoLatencyUs = firstFrameAfter(infoPressUs) - (infoPressUs + holdUs);
+    int64_t lpLatencyUs = firstFrameAfter(lpPressUs) - (lpPressUs + holdUs);
+    printf("  release to redraw: info %.1f ms, page %.1f ms\n", infoLatencyUs / 1000.0, lpLatencyUs / 1000.0);
+    TEST_ASSERT_TRUE(infoLatencyUs >= (DEBOUNCE_MS + DOUBLE_CLICK_WINDOW_MS) * MS);
+    TEST_ASSERT_TRUE(infoLatencyUs <= (DEBOUNCE_MS + DOUBLE_CLICK_WINDOW_MS) * MS + LATENCY_SLACK_US);
+    TEST_ASSERT_TRUE(lpLatencyUs >= DEBOUNCE_MS * MS);
+    TEST_ASSERT_TRUE(lpLatencyUs <= DEBOUNCE_MS * MS + LATENCY_SLACK_US);
+    TEST_ASSERT_EQUAL_HEX8(TFT_SLPIN, boot.display.back().command);
+    device.sleep(boot, 60 * 1000 * MS);
+}
+
+// Paging through all four pages caches each; the second visit is a blit. Toggling the info overlay
+// changes an input of the forecast page only: that page is rendered again, the others stay cached
+// and are blitted on the next round.
+void test_page_cache_invalidates_only_the_affected_page(void) {
+    hostsim::BootRecord boot = bootAndCheck(2, 120 * 1000 * MS, [] {
+        pressPagesAndDump(3000, 4);                     // day, stats, network, forecast
+        pressPagesAndDump(7000, 1, BUTTON_INFO_PIN);    // Overlay on
+        pressPagesAndDump(8000, 3);                     // day, stats, network
+    });
+    std::vector<PageCacheDump> dumps = pageCacheDumps(boot.serial);
+    TEST_ASSERT_EQUAL(8, (int)dumps.size());
+    const PageCacheDump &cycled = dumps[3], &overlay = dumps[4], &last = dumps[7];
+    TEST_ASSERT_EQUAL_STRING("forecast", cycled.page.c_str());
+    TEST_ASSERT_EQUAL(1, cycled.hits);
+    TEST_ASSERT_EQUAL(0, last.evictions);
+    for (int i = 0; i < UI_PAGES; ++i) {
+        TEST_ASSERT_TRUE(cycled.frameBytes[i] > 0);
+        allFramesBytes += cycled.frameBytes[i];
+    }
+    TEST_ASSERT_EQUAL_STRING("forecast", overlay.page.c_str());
+    TEST_ASSERT_EQUAL(cycled.misses + 1, overlay.misses);
+    TEST_ASSERT_EQUAL(cycled.hits, overlay.hits);
+    for (int i = 1; i < UI_PAGES; ++i) {
+        TEST_ASSERT_EQUAL(cycled.frameBytes[i], overlay.frameBytes[i]);
+        TEST_ASSERT_EQUAL(cycled.shown[i], overlay.shown[i]);
+    }
+    TEST_ASSERT_EQUAL(overlay.misses, last.misses);
+    TEST_ASSERT_EQUAL(overlay.hits + 3, last.hits);
+    device.sleep(boot, 60 * 1000 * MS);
+}
+
+// Under a budget that holds three quarters of the frames, two rounds through the pages keep the
+// cache within it, and every eviction takes the least recently shown frames first and stops once
+// the new frame fits.
+void test_page_cache_evicts_least_recently_shown_under_budget(void) {
+    TEST_ASSERT_TRUE(allFramesBytes > 0);
+    static char command[32];
+    snprintf(command, sizeof(command), "pages %u\n", SPRITE_BYTES + allFramesBytes * 3 / 4);
+    hostsim::BootRecord boot = bootAndCheck(2, 120 * 1000 * MS, [] {
+        hostsim::scheduleEvent(2000 * MS, [] { hostsim::serialLog().input += command; });
+        pressPagesAndDump(3000, 2 * UI_PAGES);
+    });
+    std::vector<PageCacheDump> dumps = pageCacheDumps(boot.serial);
+    TEST_ASSERT_EQUAL(1 + 2 * UI_PAGES, (int)dumps.size());
+    TEST_ASSERT_TRUE(dumps[0].budget < allFramesBytes);
+    for (const PageCacheDump& dump : dumps) TEST_ASSERT_TRUE(dump.bytes <= dump.budget);
+    for (size_t n = 1; n < dumps.size(); ++n) {
+        const PageCacheDump &before = dumps[n - 1], &after = dumps[n];
+        unsigned newestEvicted = 0, newestEvictedBytes = 0, oldestKept = UINT32_MAX;
+        for (int i = 0; i < UI_PAGES; ++i) {
+            if (!before.frameBytes[i] || after.page == PAGE_NAMES[i]) continue; // The page just drawn replaces its own frame
+            if (after.frameBytes[i]) {
+                oldestKept = std::min(oldestKept, before.shown[i]);
+            } else if (before.shown[i] > newestEvicted) {
+                newestEvicted = before.shown[i];
+                newestEvictedBytes = before.frameBytes[i];
+            }
+        }
+        TEST_ASSERT_TRUE_MESSAGE(newestEvicted < oldestKept, "a more recently shown frame was evicted first");
+        if (after.evictions == before.evictions) continue;
+        TEST_ASSERT_TRUE(newestEvicted > 0);
+        TEST_ASSERT_TRUE_MESSAGE(after.bytes + newestEvictedBytes > after.budget, "evicted more than the budget needed");
+    }
+    printf("  %u of %u frame bytes: %u evictions, %u hits, %u misses\n", dumps.back().budget, allFramesBytes, dumps.back().evictions,
+           dumps.back().hits, dumps.back().misses);
+    TEST_ASSERT_TRUE(dumps.back().evictions > 0);
+    device.sleep(boot, 60 * 1000 * MS);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_model_flags_bad_traces);
+    RUN_TEST(test_power_on_initialises_once_and_sleeps_the_panel);
+    RUN_TEST(test_timer_wake_leaves_the_panel_asleep);
+    RUN_TEST(test_button_wake_skips_reset_and_overlaps_the_settle);
+    RUN_TEST(test_button_edges_are_handled_within_the_gesture_window);
+    RUN_TEST(test_page_cache_invalidates_only_the_affected_page);
+    RUN_TEST(test_page_cache_evicts_least_recently_shown_under_budget);
+    return UNITY_END();
+}
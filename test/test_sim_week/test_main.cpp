@@ -0,0 +1,179 @@
+// Native simulation suite for low power mode: a week of deep-sleep cycles, one forked boot per wake,
+// with a sleep timer that runs 2 % slow, a three-hour Open-Meteo outage and one badly overslept
+// wake. Wake counts, awake time and missed slots are worked out from outside (fake server log and
+// the slot grid/night skip from lib/) and compared with the per-day summary the device keeps in RTC
+// memory ("drift" command).
+#define HOST_SIM_IMPLEMENTATION
+#include <unity.h>
+#include <stdio.h>
+#include <host_boot.h>
+#include <host_servers.h>
+#include <SlotScheduler.h>
+#include <SolarCalc.h>
+
+const int64_t S = 1000000;
+const int64_t START_EPOCH_US = 1749506400LL * S; // 2025-06-10 00:00 CEST
+const int DAYS = 7;
+const float LATITUDE = 52.5196f;
+const float LONGITUDE = 13.4069f;
+const NightSkipConfig SKIP_CONFIG = { 15, 30, 12 }; // As in main.cpp
+const uint8_t REFRESH_TARGET_MINUTE = 2;
+const int64_t EARLY_WAKE_GUARD_US = 120 * S;
+const int64_t OUTAGE_START_US = START_EPOCH_US + (2 * 24 + 10) * 3600 * S; // Day 3, 10:00-13:00
+const int64_t OUTAGE_END_US = OUTAGE_START_US + 3 * 3600 * S;
+const int64_t OVERSLEEP_AFTER_US = START_EPOCH_US + (4 * 24 + 14) * 3600 * S; // Day 5: first sleep after 14:00...
+const double OVERSLEEP_FACTOR = 2.5;                                         // ...lasts 2.5x as long
+
+struct DaySummary {
+    int wakes = 0;
+    double awakeSec = 0;
+    int expectedSlots = 0;
+    int missedSlots = 0;
+    int deviceCycles = -1;     // From the device's "drift" report
+    double deviceAwakeSec = 0;
+    int deviceMissed = -1;
+};
+
+static hostsim::Device device;
+static std::vector<hostsim::BootRecord> boots;
+static std::vector<int64_t> uvFetchesOk;
+static DaySummary days[DAYS];
+static std::string driftReport;
+
+static int dayIndex(int64_t trueUs) { return (int)((trueUs - START_EPOCH_US) / (24 * 3600 * S)); }
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_week_of_deep_sleep_cycles(void) {
+    device.trueEpochUs = START_EPOCH_US;
+    device.eeprom[0] = 1; // LPM flag
+    device.rtcSlowClockError = 0.02;
+    int cause = 0;        // Power-on
+    bool oversleptOnce = false;
+    while (device.trueEpochUs < START_EPOCH_US + DAYS * 24 * 3600 * S) {
+        int64_t bootStartUs = device.trueEpochUs;
+        bool outage = bootStartUs >= OUTAGE_START_US && bootStartUs < OUTAGE_END_US;
+        hostsim::BootRecord boot = device.boot(cause, 120 * S, [outage] {
+            hostsim::installFakeServers();
+            hostsim::fakeWeather().openMeteoUp = !outage;
+        });
+        TEST_ASSERT_TRUE_MESSAGE(boot.completed, "boot crashed");
+        TEST_ASSERT_TRUE_MESSAGE(boot.slept, "timer wake did not go back to sleep");
+        for (const hostsim::ServedRequest& r : boot.requests)
+            if (r.host == "api.open-meteo.com" && r.status == 200) uvFetchesOk.push_back(r.epochUs);
+        int day = dayIndex(boot.trueEpochEndUs);
+        if (day < DAYS) {
+            days[day].wakes++;
+            days[day].awakeSec += boot.awakeUs / 1e6;
+        }
+        boots.push_back(boot);
+        double clockError = device.rtcSlowClockError;
+        if (!oversleptOnce && boot.trueEpochEndUs >= OVERSLEEP_AFTER_US) {
+            device.rtcSlowClockError = OVERSLEEP_FACTOR - 1.0;
+            oversleptOnce = true;
+        }
+        device.sleep(boot);
+        device.rtcSlowClockError = clockError;
+        cause = 4; // ESP_SLEEP_WAKEUP_TIMER
+    }
+    printf("  %u boots simulated\n", (unsigned)boots.size());
+    TEST_ASSERT_TRUE(boots.size() > DAYS * 16);
+}
+
+// A slot counts as served by a successful fetch from EARLY_WAKE_GUARD before it up to the same point
+// before the next expected slot, so a late wake still serves the slot it lands in.
+void test_missed_slots_from_outside(void) {
+    std::vector<time_t> slots;
+    time_t t = (time_t)(START_EPOCH_US / S);
+    time_t end = (time_t)(START_EPOCH_US / S) + DAYS * 24 * 3600;
+    while (t < end) {
+        time_t slot = nextRefreshSlot(t, hostsim::berlinUtcOffsetSec(t), 1, REFRESH_TARGET_MINUTE, false).nextSlotEpoch;
+        time_t daylight = nightSkipTarget(slot, LATITUDE, LONGITUDE, SKIP_CONFIG);
+        if (daylight > slot) slot = daylight;
+        if (slot >= end) break;
+        slots.push_back(slot);
+        t = slot;
+    }
+    size_t next = 0;
+    for (size_t i = 0; i < slots.size(); ++i) {
+        int64_t fromUs = slots[i] * S - EARLY_WAKE_GUARD_US;
+        int64_t toUs = (i + 1 < slots.size()) ? slots[i + 1] * S - EARLY_WAKE_GUARD_US : INT64_MAX;
+        while (next < uvFetchesOk.size() && uvFetchesOk[next] < fromUs) next++;
+        bool served = next < uvFetchesOk.size() && uvFetchesOk[next] < toUs;
+        int day = dayIndex(slots[i] * S);
+        days[day].expectedSlots++;
+        if (!served) days[day].missedSlots++;
+    }
+    TEST_ASSERT_EQUAL(0, days[0].missedSlots + days[1].missedSlots + days[3].missedSlots + days[5].missedSlots + days[6].missedSlots);
+    TEST_ASSERT_EQUAL(3, days[2].missedSlots); // 10:02, 11:02, 12:02 answered 503
+    TEST_ASSERT_TRUE(days[4].missedSlots >= 1 && days[4].missedSlots <= 2); // The oversleep
+}
+
+// The device's own RTC summary, read back over serial on a button wake, must agree. The location
+// tag ("loc") must come back from RTC memory with its label, not fall back to the secrets.
+void test_device_summary_matches(void) {
+    device.sleep(boots.back(), 10 * 60 * S);
+    hostsim::BootRecord boot = device.boot(2, 120 * S, [] { // ESP_SLEEP_WAKEUP_EXT0
+        hostsim::installFakeServers();
+        hostsim::serialLog().input = "drift\nloc\n";
+    });
+    TEST_ASSERT_TRUE(boot.completed);
+    size_t at = boot.serial.find("DRIFT: correction factor");
+    TEST_ASSERT_TRUE_MESSAGE(at != std::string::npos, "no drift report");
+    driftReport = boot.serial.substr(at, boot.serial.find("\n\n", at) - at);
+    size_t inUse = boot.serial.find("in use: ");
+    TEST_ASSERT_TRUE_MESSAGE(inUse != std::string::npos, "no location report");
+    std::string source = boot.serial.substr(inUse + 8, boot.serial.find('\n', inUse) - inUse - 8);
+    TEST_ASSERT_TRUE_MESSAGE(source == "IP" || source == "Cached", source.c_str());
+    int firstYday = 160; // 2025-06-10
+    for (const char* line = driftReport.c_str(); (line = strstr(line, "yday ")); ++line) {
+        int yday, cycles, missed;
+        float awake;
+        if (sscanf(line, "yday %d: %d cycles, awake %f s, %d missed slots", &yday, &cycles, &awake, &missed) != 4) continue;
+        int day = yday - firstYday;
+        if (day < 0 || day >= DAYS) continue;
+        days[day].deviceCycles = cycles;
+        days[day].deviceAwakeSec = awake;
+        days[day].deviceMissed = missed;
+    }
+    printf("  day  wakes  awake s  slots  missed | device: cycles  awake s  missed\n");
+    for (int d = 0; d < DAYS; ++d) {
+        const DaySummary& s = days[d];
+        printf("  %3d  %5d  %7.1f  %5d  %6d | %14d  %7.1f  %6d\n", d + 1, s.wakes, s.awakeSec, s.expectedSlots, s.missedSlots,
+               s.deviceCycles, s.deviceAwakeSec, s.deviceMissed);
+    }
+    // Day 7's summary also holds the button wake above, and day 1 the power-on cycle; compare the others.
+    for (int d = 1; d < DAYS - 1; ++d) {
+        TEST_ASSERT_EQUAL_MESSAGE(days[d].wakes, days[d].deviceCycles, "cycles");
+        TEST_ASSERT_EQUAL_MESSAGE(days[d].missedSlots, days[d].deviceMissed, "missed slots");
+        TEST_ASSERT_TRUE(fabs(days[d].awakeSec - days[d].deviceAwakeSec) < 0.1 * days[d].wakes + 0.5);
+    }
+}
+
+// The slow clock's 2 % is learned: after the first day timer wakes land within a few seconds of their slot.
+void test_drift_correction_converges(void) {
+    int late = 0, counted = 0;
+    for (const hostsim::BootRecord& boot : boots) {
+        if (boot.trueEpochStartUs < START_EPOCH_US + 24 * 3600 * S || boot.requests.empty()) continue;
+        if (boot.trueEpochStartUs >= OVERSLEEP_AFTER_US && boot.trueEpochStartUs < OVERSLEEP_AFTER_US + 6 * 3600 * S) continue;
+        time_t wake = (time_t)(boot.trueEpochStartUs / S);
+        time_t slot = nextRefreshSlot(wake - 300, hostsim::berlinUtcOffsetSec(wake), 1, REFRESH_TARGET_MINUTE, false).nextSlotEpoch;
+        time_t daylight = nightSkipTarget(wake - 300, LATITUDE, LONGITUDE, SKIP_CONFIG);
+        if (daylight && llabs((long long)(daylight - wake)) < llabs((long long)(slot - wake))) slot = daylight;
+        counted++;
+        if (llabs((long long)(wake - slot)) > 10) late++;
+    }
+    printf("  %d of %d timer wakes after day 1 more than 10 s off their slot\n", late, counted);
+    TEST_ASSERT_TRUE(counted > 0);
+    TEST_ASSERT_TRUE(late * 20 <= counted);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_week_of_deep_sleep_cycles);
+    RUN_TEST(test_missed_slots_from_outside);
+    RUN_TEST(test_device_summary_matches);
+    RUN_TEST(test_drift_correction_converges);
+    return UNITY_END();
+}
@@ -0,0 +1,110 @@
+// Native suite for lib/SleepDrift: the correction factor converges on a slow clock's true ratio and
+// brings the wake back onto the slot, stays clamped, ignores implausible and too-short sleeps; the
+// slot accuracy ring rolls over by day and counts hits, errors and overslept slots.
+#include <unity.h>
+#include <math.h>
+#include <SleepDrift.h>
+
+const uint64_t S = 1000000ULL;
+const uint64_t SLOT_US = 15 * 60 * S;
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_short_or_backward_sleeps_are_not_measured(void) {
+    TEST_ASSERT_TRUE(sleepDriftMeasurable(SLEEP_DRIFT_MIN_SLEEP_SEC * S, (int64_t)(SLEEP_DRIFT_MIN_SLEEP_SEC * S)));
+    TEST_ASSERT_FALSE(sleepDriftMeasurable(SLEEP_DRIFT_MIN_SLEEP_SEC * S - 1, (int64_t)(SLEEP_DRIFT_MIN_SLEEP_SEC * S)));
+    TEST_ASSERT_FALSE(sleepDriftMeasurable(SLOT_US, 0));
+    TEST_ASSERT_FALSE(sleepDriftMeasurable(SLOT_US, -5 * (int64_t)S));
+}
+
+// A timer running 2 % slow: each sleep is programmed as slot * correction and lasts 1.02 times that.
+// The correction settles at 1/1.02 and the wake error drops under a second.
+void test_correction_converges_on_a_slow_clock(void) {
+    float correction = 1.0f;
+    const double slowBy = 1.02;
+    double errorSec = 0.0;
+    for (int n = 0; n < 30; ++n) {
+        uint64_t programmedUs = (uint64_t)(SLOT_US * (double)correction);
+        int64_t actualUs = (int64_t)(programmedUs * slowBy);
+        errorSec = (actualUs - (double)SLOT_US) / S;
+        bool applied = false;
+        float measured = sleepDriftUpdate(correction, programmedUs, actualUs, &applied);
+        TEST_ASSERT_TRUE(applied);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f, (float)(1.0 / slowBy), measured);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, (float)(1.0 / 1.02), correction);
+    TEST_ASSERT_TRUE(fabs(errorSec) < 1.0);
+}
+
+// The first step moves by SLEEP_DRIFT_EMA_ALPHA of the gap, not all of it.
+void test_first_step_is_the_ema_weight(void) {
+    float correction = 1.0f;
+    sleepDriftUpdate(correction, SLOT_US, (int64_t)(SLOT_US * 1.05));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.0f + SLEEP_DRIFT_EMA_ALPHA * (float)(1.0 / 1.05 - 1.0), correction);
+}
+
+// A sleep 30 % off (clock set by hand, a missed sync) leaves the factor alone; the factor never
+// leaves 1 +/- SLEEP_DRIFT_MAX_CORRECTION however many extreme-but-plausible samples arrive.
+void test_implausible_samples_are_ignored_and_factor_is_clamped(void) {
+    float correction = 0.98f;
+    bool applied = true;
+    sleepDriftUpdate(correction, SLOT_US, (int64_t)(SLOT_US * 1.3), &applied);
+    TEST_ASSERT_FALSE(applied);
+    TEST_ASSERT_EQUAL_FLOAT(0.98f, correction);
+    for (int n = 0; n < 100; ++n) sleepDriftUpdate(correction, SLOT_US, (int64_t)(SLOT_US / (1.0 + SLEEP_DRIFT_MAX_CORRECTION * 0.999)));
+    TEST_ASSERT_TRUE(correction <= 1.0f + SLEEP_DRIFT_MAX_CORRECTION);
+    TEST_ASSERT_TRUE(correction > 1.09f);
+    for (int n = 0; n < 100; ++n) sleepDriftUpdate(correction, SLOT_US, (int64_t)(SLOT_US / (1.0 - SLEEP_DRIFT_MAX_CORRECTION * 0.999)));
+    TEST_ASSERT_TRUE(correction >= 1.0f - SLEEP_DRIFT_MAX_CORRECTION);
+    TEST_ASSERT_TRUE(correction < 0.91f);
+}
+
+void test_record_counts_hits_errors_and_overslept_slots(void) {
+    SlotAccuracyLog log;
+    slotAccuracyReset(log);
+    SlotAccuracyDay& day = slotAccuracyDay(log, 160);
+    slotAccuracyRecord(day, 3.0f, 900);
+    slotAccuracyRecord(day, -(float)SLOT_HIT_TOLERANCE_SEC, 900);
+    slotAccuracyRecord(day, 25.0f, 900);
+    slotAccuracyRecord(day, 2000.0f, 900); // Overslept two whole slots
+    slotAccuracyRecord(day, 2000.0f, 0);   // Interval unknown: no slots counted
+    TEST_ASSERT_EQUAL(5, day.wakes);
+    TEST_ASSERT_EQUAL(2, day.hits);
+    TEST_ASSERT_EQUAL(2, day.missedSlots);
+    TEST_ASSERT_EQUAL_FLOAT(4038.0f, day.absErrorSumSec);
+    TEST_ASSERT_EQUAL_FLOAT(2000.0f, day.maxAbsErrorSec);
+}
+
+// Same day: same entry. A new day takes the next slot; after SLOT_ACCURACY_DAYS + 2 days the two
+// oldest are gone and the newest-first walk sees the last seven in order.
+void test_ring_rolls_over_by_day(void) {
+    SlotAccuracyLog log;
+    slotAccuracyReset(log);
+    for (int n = 0; n < SLOT_ACCURACY_DAYS; ++n) TEST_ASSERT_EQUAL(-1, slotAccuracyNewest(log, n).dayOfYear);
+    SlotAccuracyDay* first = &slotAccuracyDay(log, 100);
+    first->cycles = 3;
+    TEST_ASSERT_EQUAL_PTR(first, &slotAccuracyDay(log, 100));
+    TEST_ASSERT_EQUAL(3, slotAccuracyDay(log, 100).cycles);
+    for (int d = 101; d < 100 + SLOT_ACCURACY_DAYS + 2; ++d) slotAccuracyDay(log, d).cycles = (uint16_t)d;
+    for (int n = 0; n < SLOT_ACCURACY_DAYS; ++n) {
+        const SlotAccuracyDay& day = slotAccuracyNewest(log, n);
+        TEST_ASSERT_EQUAL(100 + SLOT_ACCURACY_DAYS + 1 - n, day.dayOfYear);
+        TEST_ASSERT_EQUAL(day.dayOfYear, day.cycles);
+    }
+    // Year wrap: yday 0 after 364 is a new day, not a match for an old entry
+    slotAccuracyDay(log, 364).wakes = 1;
+    TEST_ASSERT_EQUAL(0, slotAccuracyDay(log, 0).wakes);
+    TEST_ASSERT_EQUAL(364, slotAccuracyNewest(log, 1).dayOfYear);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_short_or_backward_sleeps_are_not_measured);
+    RUN_TEST(test_correction_converges_on_a_slow_clock);
+    RUN_TEST(test_first_step_is_the_ema_weight);
+    RUN_TEST(test_implausible_samples_are_ignored_and_factor_is_clamped);
+    RUN_TEST(test_record_counts_hits_errors_and_overslept_slots);
+    RUN_TEST(test_ring_rolls_over_by_day);
+    return UNITY_END();
+}
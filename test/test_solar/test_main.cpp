@@ -0,0 +1,149 @@
+// Native suite for lib/SolarCalc: sunrise equation at the equator, mid-latitudes and both polar
+// regimes, and the night-skip target the scheduler derives from it.
+#include <unity.h>
+#include <stdio.h>
+#include <SolarCalc.h>
+
+const NightSkipConfig SKIP_CONFIG = {15, 30, 12}; // The firmware defaults
+const time_t DAY = 86400;
+
+const time_t EQUINOX_2024 = 1710892800;  // 2024-03-20 00:00 UTC
+const time_t SOLSTICE_JUN_2024 = 1718928000; // 2024-06-21 00:00 UTC
+const time_t SOLSTICE_DEC_2024 = 1734739200; // 2024-12-21 00:00 UTC
+const time_t YEAR_START_2024 = 1704067200;
+
+static int minutesOfDayUtc(time_t epoch) {
+    return (int)(((epoch % DAY) + DAY) % DAY) / 60;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// On the equator day length stays within a few minutes of 12 h all year (refraction adds ~7 min)
+// and sunrise at longitude 0 only moves with the equation of time (+-17 min around 06:00 UTC).
+void test_equator_all_year(void) {
+    for (int d = 0; d < 366; ++d) {
+        time_t noon = YEAR_START_2024 + d * DAY + 12 * 3600;
+        SolarEvents events = calculateSolarEvents(noon, 0.0f, 0.0f);
+        TEST_ASSERT_EQUAL(SOLAR_DAY_NORMAL, events.dayType);
+        long dayLength = (long)(events.sunsetEpoch - events.sunriseEpoch);
+        TEST_ASSERT_INT_WITHIN(5 * 60, 12 * 3600 + 7 * 60, dayLength);
+        TEST_ASSERT_INT_WITHIN(20, 6 * 60, minutesOfDayUtc(events.sunriseEpoch));
+    }
+}
+
+void test_equator_equinox_times(void) {
+    SolarEvents events = calculateSolarEvents(EQUINOX_2024 + 12 * 3600, 0.0f, 0.0f);
+    TEST_ASSERT_INT_WITHIN(3, 6 * 60 + 4, minutesOfDayUtc(events.sunriseEpoch));  // 06:04 UTC
+    TEST_ASSERT_INT_WITHIN(3, 18 * 60 + 11, minutesOfDayUtc(events.sunsetEpoch)); // 18:11 UTC
+}
+
+// Berlin, 21 June 2024: sunrise 04:43 CEST, sunset 21:33 CEST (almanac values).
+void test_mid_latitude_solstice(void) {
+    SolarEvents events = calculateSolarEvents(SOLSTICE_JUN_2024 + 11 * 3600, 52.52f, 13.405f);
+    TEST_ASSERT_EQUAL(SOLAR_DAY_NORMAL, events.dayType);
+    TEST_ASSERT_INT_WITHIN(3, 2 * 60 + 43, minutesOfDayUtc(events.sunriseEpoch));
+    TEST_ASSERT_INT_WITHIN(3, 19 * 60 + 33, minutesOfDayUtc(events.sunsetEpoch));
+}
+
+// Longyearbyen (78.2 N) and McMurdo (77.8 S) around both solstices.
+void test_polar_day_and_night(void) {
+    TEST_ASSERT_EQUAL(SOLAR_DAY_POLAR_DAY, calculateSolarEvents(SOLSTICE_JUN_2024 + 12 * 3600, 78.22f, 15.65f).dayType);
+    TEST_ASSERT_EQUAL(SOLAR_DAY_POLAR_NIGHT, calculateSolarEvents(SOLSTICE_DEC_2024 + 12 * 3600, 78.22f, 15.65f).dayType);
+    TEST_ASSERT_EQUAL(SOLAR_DAY_POLAR_NIGHT, calculateSolarEvents(SOLSTICE_JUN_2024 + 12 * 3600, -77.85f, 166.67f).dayType);
+    TEST_ASSERT_EQUAL(SOLAR_DAY_POLAR_DAY, calculateSolarEvents(SOLSTICE_DEC_2024 + 12 * 3600, -77.85f, 166.67f).dayType);
+}
+
+// Tromso (69.65 N): the polar night ends mid-January and the midnight sun runs roughly
+// 20 May - 22 July. The model is simplified, so only assert a day either side of each edge.
+void test_polar_transitions(void) {
+    const float lat = 69.65f, lon = 18.96f;
+    TEST_ASSERT_EQUAL(SOLAR_DAY_POLAR_NIGHT, calculateSolarEvents(YEAR_START_2024 + 4 * DAY + 11 * 3600, lat, lon).dayType);  // 5 Jan
+    TEST_ASSERT_EQUAL(SOLAR_DAY_NORMAL, calculateSolarEvents(YEAR_START_2024 + 20 * DAY + 11 * 3600, lat, lon).dayType);      // 21 Jan
+    TEST_ASSERT_EQUAL(SOLAR_DAY_NORMAL, calculateSolarEvents(YEAR_START_2024 + 134 * DAY + 11 * 3600, lat, lon).dayType);     // 14 May
+    TEST_ASSERT_EQUAL(SOLAR_DAY_POLAR_DAY, calculateSolarEvents(YEAR_START_2024 + 145 * DAY + 11 * 3600, lat, lon).dayType);   // 25 May
+    TEST_ASSERT_EQUAL(SOLAR_DAY_POLAR_DAY, calculateSolarEvents(YEAR_START_2024 + 200 * DAY + 11 * 3600, lat, lon).dayType);   // 19 Jul
+    TEST_ASSERT_EQUAL(SOLAR_DAY_NORMAL, calculateSolarEvents(YEAR_START_2024 + 210 * DAY + 11 * 3600, lat, lon).dayType);     // 29 Jul
+}
+
+void test_night_skip_polar_day_never_skips(void) {
+    for (time_t t = SOLSTICE_JUN_2024; t < SOLSTICE_JUN_2024 + 2 * DAY; t += 600) {
+        TEST_ASSERT_EQUAL_INT64(0, (int64_t)nightSkipTarget(t, 78.22f, 15.65f, SKIP_CONFIG));
+    }
+}
+
+void test_night_skip_polar_night_rechecks(void) {
+    for (time_t t = SOLSTICE_DEC_2024; t < SOLSTICE_DEC_2024 + 2 * DAY; t += 600) {
+        TEST_ASSERT_EQUAL_INT64((int64_t)(t + SKIP_CONFIG.polarNightRecheckHours * 3600L),
+                                (int64_t)nightSkipTarget(t, 78.22f, 15.65f, SKIP_CONFIG));
+    }
+}
+
+// Last polar night at Tromso (15/16 Jan 2024): the 12 h recheck would land ten minutes into the
+// first, short daylight window, so the skip stops at that dawn instead.
+void test_night_skip_polar_night_ends_at_first_dawn(void) {
+    const float lat = 69.65f, lon = 10.0f;
+    const time_t lastPolarEvening = 1705359600; // 2024-01-15 23:00 UTC
+    TEST_ASSERT_EQUAL(SOLAR_DAY_POLAR_NIGHT, calculateSolarEvents(lastPolarEvening, lat, lon).dayType);
+    SolarEvents firstDay = calculateSolarEvents(lastPolarEvening + DAY, lat, lon);
+    TEST_ASSERT_EQUAL(SOLAR_DAY_NORMAL, firstDay.dayType);
+    time_t dawn = firstDay.sunriseEpoch - SKIP_CONFIG.sunriseLeadMinutes * 60L;
+    TEST_ASSERT_LESS_THAN(lastPolarEvening + SKIP_CONFIG.polarNightRecheckHours * 3600L, dawn);
+    TEST_ASSERT_EQUAL_INT64((int64_t)dawn, (int64_t)nightSkipTarget(lastPolarEvening, lat, lon, SKIP_CONFIG));
+}
+
+void test_night_skip_equator(void) {
+    SolarEvents today = calculateSolarEvents(EQUINOX_2024 + 12 * 3600, 0.0f, 0.0f);
+    SolarEvents tomorrow = calculateSolarEvents(EQUINOX_2024 + DAY + 12 * 3600, 0.0f, 0.0f);
+    time_t todayStart = today.sunriseEpoch - SKIP_CONFIG.sunriseLeadMinutes * 60L;
+    time_t todayEnd = today.sunsetEpoch + SKIP_CONFIG.sunsetGraceMinutes * 60L;
+
+    // Before dawn: wake at sunrise minus lead. In daylight, including both edges: no skip.
+    TEST_ASSERT_EQUAL_INT64((int64_t)todayStart, (int64_t)nightSkipTarget(EQUINOX_2024 + 3 * 3600, 0.0f, 0.0f, SKIP_CONFIG));
+    TEST_ASSERT_EQUAL_INT64(0, (int64_t)nightSkipTarget(todayStart, 0.0f, 0.0f, SKIP_CONFIG));
+    TEST_ASSERT_EQUAL_INT64(0, (int64_t)nightSkipTarget(EQUINOX_2024 + 12 * 3600, 0.0f, 0.0f, SKIP_CONFIG));
+    TEST_ASSERT_EQUAL_INT64(0, (int64_t)nightSkipTarget(todayEnd, 0.0f, 0.0f, SKIP_CONFIG));
+    // After the grace window: skip to tomorrow's dawn.
+    TEST_ASSERT_EQUAL_INT64((int64_t)(tomorrow.sunriseEpoch - SKIP_CONFIG.sunriseLeadMinutes * 60L),
+                            (int64_t)nightSkipTarget(todayEnd + 1, 0.0f, 0.0f, SKIP_CONFIG));
+    TEST_ASSERT_EQUAL_INT64((int64_t)(tomorrow.sunriseEpoch - SKIP_CONFIG.sunriseLeadMinutes * 60L),
+                            (int64_t)nightSkipTarget(EQUINOX_2024 + 23 * 3600, 0.0f, 0.0f, SKIP_CONFIG));
+}
+
+// Whole-year sweep at several latitudes: a skip always lands in the future, on a moment that is
+// itself daylight unless it is a polar-night recheck, and never jumps over a daylight sample.
+void test_night_skip_never_skips_daylight(void) {
+    const float latitudes[] = {0.0f, 35.0f, 52.5f, 66.0f, 69.65f, -45.0f};
+    for (float lat : latitudes) {
+        for (time_t t = YEAR_START_2024; t < YEAR_START_2024 + 366 * DAY; t += 1800) {
+            time_t target = nightSkipTarget(t, lat, 10.0f, SKIP_CONFIG);
+            if (target == 0) continue;
+            TEST_ASSERT_GREATER_THAN(t, target);
+            TEST_ASSERT_LESS_OR_EQUAL(t + 24 * 3600, target);
+            bool polarRecheck = (target == t + SKIP_CONFIG.polarNightRecheckHours * 3600L);
+            if (!polarRecheck) TEST_ASSERT_EQUAL_INT64(0, (int64_t)nightSkipTarget(target, lat, 10.0f, SKIP_CONFIG));
+            for (time_t probe = t + 600; probe < target; probe += 600) {
+                if (nightSkipTarget(probe, lat, 10.0f, SKIP_CONFIG) == 0) {
+                    char msg[160];
+                    snprintf(msg, sizeof(msg), "lat %.2f: skip from %ld to %ld jumps over daylight at %ld", lat, (long)t, (long)target, (long)probe);
+                    TEST_FAIL_MESSAGE(msg);
+                }
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_equator_all_year);
+    RUN_TEST(test_equator_equinox_times);
+    RUN_TEST(test_mid_latitude_solstice);
+    RUN_TEST(test_polar_day_and_night);
+    RUN_TEST(test_polar_transitions);
+    RUN_TEST(test_night_skip_polar_day_never_skips);
+    RUN_TEST(test_night_skip_polar_night_rechecks);
+    RUN_TEST(test_night_skip_polar_night_ends_at_first_dawn);
+    RUN_TEST(test_night_skip_equator);
+    RUN_TEST(test_night_skip_never_skips_daylight);
+    return UNITY_END();
+}
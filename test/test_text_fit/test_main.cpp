@@ -0,0 +1,164 @@
+// Native suite for lib/TextFit: fitTextToWidth() itself (fits unchanged, longest prefix with "...",
+// empty below the ellipsis), then every field of the info overlay, the status screen and the day page
+// with realistic and worst-case contents against its budget on the panel, checking that texts sharing
+// a line never meet.
+#include <unity.h>
+#include <stdio.h>
+#include <TextFit.h>
+#include <UvDose.h>
+
+const int PANEL_WIDTHS[] = { 240, 135 };                 // Rotation 1 as in setup(), and portrait
+const char* const LOCATION_SOURCE_TAGS[] = { "Sec", "IP", "Cached" }; // As in main.cpp
+const String WIDEST_15 = "WWWWWWWWWWWWWWW";               // rtc_lastUpdateTimeStr_char holds 15 chars
+const String WIDEST_31 = "WWWWWWWWWWWWWWWWWWWWWWWWWWWWWWW";
+
+// The fitted text is within budget, is the text itself when that fits, and otherwise is the longest
+// prefix that fits with "..." after it.
+static String checkField(const String& text, int budget, const char* field) {
+    char message[96];
+    snprintf(message, sizeof(message), "%s: \"%s\" in %d px", field, text.c_str(), budget);
+    String fitted = fitTextToWidth(text, budget);
+    TEST_ASSERT_TRUE_MESSAGE(font2TextWidth(fitted) <= budget, message);
+    if (font2TextWidth(text) <= budget) {
+        TEST_ASSERT_TRUE_MESSAGE(fitted == text, message);
+        return fitted;
+    }
+    if (fitted.length() == 0) {
+        TEST_ASSERT_TRUE_MESSAGE(budget < FONT2_ELLIPSIS_WIDTH, message);
+        return fitted;
+    }
+    unsigned int prefix = fitted.length() - 3;
+    TEST_ASSERT_TRUE_MESSAGE(fitted.endsWith("..."), message);
+    TEST_ASSERT_TRUE_MESSAGE(text.startsWith(fitted.substring(0, prefix)), message);
+    TEST_ASSERT_TRUE_MESSAGE(font2TextWidth(text.substring(0, prefix + 1)) + FONT2_ELLIPSIS_WIDTH > budget, message);
+    return fitted;
+}
+
+// Two texts on one line, the left one at the padding and the right one right-aligned at the padding.
+static void checkSharedLine(const String& left, const String& right, int lineWidth, const char* field) {
+    char message[96];
+    snprintf(message, sizeof(message), "%s: \"%s\" | \"%s\"", field, left.c_str(), right.c_str());
+    TEST_ASSERT_TRUE_MESSAGE(font2TextWidth(left) + 2 * OVERLAY_TEXT_PADDING + font2TextWidth(right) <= lineWidth, message);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_fit_keeps_text_that_fits(void) {
+    TEST_ASSERT_EQUAL(0, font2TextWidth(""));
+    TEST_ASSERT_TRUE(fitTextToWidth("", 0) == "");
+    String text = "Loc: Berlin (IP)";
+    int width = font2TextWidth(text);
+    TEST_ASSERT_TRUE(fitTextToWidth(text, width) == text); // Exactly at the budget
+    TEST_ASSERT_TRUE(fitTextToWidth(text, width - 1) != text);
+}
+
+void test_fit_cuts_to_the_longest_prefix(void) {
+    const String text = "Loc: Frankfurt am Main (Cached)";
+    for (int budget = 0; budget <= font2TextWidth(text) + 5; ++budget) checkField(text, budget, "sweep");
+    TEST_ASSERT_TRUE(fitTextToWidth("WWWW", 30) == "W..."); // 10 + 15 fits, 20 + 15 does not
+    TEST_ASSERT_TRUE(fitTextToWidth("WWWW", 14) == "");     // Not even the ellipsis
+    TEST_ASSERT_TRUE(fitTextToWidth("WWWW", 15) == "...");
+}
+
+// Bytes outside 32-127 (UTF-8 city names, SSIDs) measure as the space they draw as.
+void test_non_ascii_measures_as_space(void) {
+    TEST_ASSERT_EQUAL(font2Advance(' '), font2Advance('\x7f' + 1));
+    TEST_ASSERT_EQUAL(font2Advance(' '), font2Advance('\n'));
+    TEST_ASSERT_EQUAL(2 * font2Advance(' '), font2TextWidth("\xc3\xbc")); // "ü"
+    checkField("Loc: IP: M\xc3\xbc" "nchen (IP)", 60, "utf-8");
+}
+
+// Line 0: the LPM state on the left, the time to burn on the right.
+void test_overlay_line_lpm_and_burn(void) {
+    const char* lpm[] = { "LPM: ON", "LPM: OFF" };
+    for (int panel : PANEL_WIDTHS) {
+        OverlayTextBudgets budgets = overlayTextBudgets(panel);
+        for (const char* state : lpm) {
+            for (int skin = 0; skin < 6; ++skin) {
+                String type = String("(") + FITZPATRICK_TYPE_NAMES[skin] + ")";
+                String burns[] = { "Burn 5m " + type, "Burn 9999m " + type, "Burn >5h " + type, "Burn -- " + type };
+                for (const String& burn : burns) {
+                    String fitted = checkField(burn, overlayRemainingWidth(budgets.line, state), "burn");
+                    checkSharedLine(state, fitted, budgets.line, "line 0");
+                    if (panel == 240) TEST_ASSERT_TRUE_MESSAGE(fitted == burn, burn.c_str());
+                }
+            }
+        }
+    }
+}
+
+// Line 1: WiFi on the left, the update time (up to 45 %) on the right.
+void test_overlay_line_wifi_and_update_time(void) {
+    const String times[] = { "Never", "Offline", "12:34", "Initializing...", WIDEST_15 };
+    const String wifi[] = { "WiFi: Connecting...", "WiFi: Offline", "WiFi: ", "WiFi: MyHome-5G", "WiFi: " + WIDEST_31 + "W",
+                            "WiFi: iiiiiiiiiiiiiiiiiiiiiiiiiiiiiiii", "WiFi: Caf\xc3\xa9 Gast" };
+    for (int panel : PANEL_WIDTHS) {
+        OverlayTextBudgets budgets = overlayTextBudgets(panel);
+        for (const String& time : times) {
+            String fittedTime = checkField("Upd: " + time, budgets.updateTime, "update time");
+            for (const String& text : wifi) {
+                String fitted = checkField(text, overlayRemainingWidth(budgets.line, fittedTime), "wifi");
+                checkSharedLine(fitted, fittedTime, budgets.line, "line 1");
+            }
+        }
+    }
+    // The usual contents fit whole on the landscape panel
+    OverlayTextBudgets budgets = overlayTextBudgets(240);
+    TEST_ASSERT_TRUE(fitTextToWidth("Upd: 12:34", budgets.updateTime) == "Upd: 12:34");
+    TEST_ASSERT_TRUE(fitTextToWidth("WiFi: Connecting...", overlayRemainingWidth(budgets.line, "Upd: 12:34")) == "WiFi: Connecting...");
+}
+
+// Line 2: every location label the firmware sets, with every source tag.
+void test_overlay_line_location(void) {
+    const String labels[] = { "Initializing...", "Secrets GPS", "Offline>Secrets", "IP Fail>Secrets", "IP: Unknown",
+                              "IP (API Err)", "IP: Berlin", "IP: Llanfairpwllgwyngyll", WIDEST_31 };
+    for (int panel : PANEL_WIDTHS) {
+        OverlayTextBudgets budgets = overlayTextBudgets(panel);
+        for (const String& label : labels) {
+            for (const char* tag : LOCATION_SOURCE_TAGS) {
+                String text = "Loc: " + label + " (" + tag + ")";
+                String fitted = checkField(text, budgets.line, "location");
+                if (panel == 240 && label.length() <= 15) TEST_ASSERT_TRUE_MESSAGE(fitted == text, text.c_str());
+            }
+        }
+    }
+}
+
+// Line 3, and the day page's title line: the day peak text at its widest.
+void test_overlay_and_day_page_peak(void) {
+    const String peaks[] = { "Peak 0.0 @0h", "Peak 8.4 @13h  6+ 11-16h", "Peak 25.5 @23h  6+ 23-24h" };
+    for (int panel : PANEL_WIDTHS) {
+        OverlayTextBudgets budgets = overlayTextBudgets(panel);
+        for (const String& peak : peaks) {
+            String overlay = checkField(peak, budgets.line, "overlay peak");
+            String page = checkField(peak, overlayRemainingWidth(budgets.line, "Today"), "day page peak");
+            checkSharedLine("Today", page, budgets.line, "day page title");
+            if (panel == 240) TEST_ASSERT_TRUE_MESSAGE(overlay == peak && page == peak, peak.c_str());
+        }
+    }
+}
+
+// displayMessage() and the text pages: one full-width line each.
+void test_status_and_page_lines(void) {
+    const String lines[] = { "Fetching IP Location...", "Fetching UV data...", "Loc: " + WIDEST_31 + " (Cached)",
+                             "UV fetch failed: HTTP -11 (read timeout)", "Connecting to WiFi: " + WIDEST_31 + "W" };
+    for (int panel : PANEL_WIDTHS) {
+        OverlayTextBudgets budgets = overlayTextBudgets(panel);
+        TEST_ASSERT_EQUAL(panel - 2 * OVERLAY_TEXT_PADDING, budgets.line);
+        for (const String& line : lines) checkField(line, budgets.line, "status");
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_fit_keeps_text_that_fits);
+    RUN_TEST(test_fit_cuts_to_the_longest_prefix);
+    RUN_TEST(test_non_ascii_measures_as_space);
+    RUN_TEST(test_overlay_line_lpm_and_burn);
+    RUN_TEST(test_overlay_line_wifi_and_update_time);
+    RUN_TEST(test_overlay_line_location);
+    RUN_TEST(test_overlay_and_day_page_peak);
+    RUN_TEST(test_status_and_page_lines);
+    return UNITY_END();
+}
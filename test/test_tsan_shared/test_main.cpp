@@ -0,0 +1,203 @@
+// ThreadSanitizer suite (pio test -e native_tsan): the state the network task (core 0) and the loop
+// (core 1) share is driven from two free-running host threads, outside the cooperative kernel, so the
+// accesses really overlap. TSan fails the run on any data race; the tests also check that each side
+// only ever reads whole values.
+#define HOST_SIM_IMPLEMENTATION
+#include <unity.h>
+#include <Arduino.h>
+#include <TripleBuffer.h>
+#include <MemoryTelemetry.h>
+#include <functional>
+#include <thread>
+
+// --- Firmware internals (src/main.cpp) ---
+enum EnergyPhase : uint8_t;
+const EnergyPhase PHASE_TLS = (EnergyPhase)6;     // ENERGY_PHASE_TLS, timed on the network task
+const EnergyPhase PHASE_RENDER = (EnergyPhase)9;  // ENERGY_PHASE_RENDER, timed on the loop
+struct NextUpdateTimeDetails {
+    uint64_t sleepDurationUs;
+    time_t nextUpdateEpoch;
+    bool updateNow;
+};
+void energyCycleBegin(uint8_t wakeCause, int64_t startUs);
+void energyPhaseAdd(EnergyPhase phase, int64_t durationUs);
+void energyCycleCommit(uint32_t sleepSeconds);
+extern uint8_t rtc_energyLogCount;
+void setDeviceCoordinates(float latitude, float longitude);
+void readDeviceCoordinates(float& latitude, float& longitude);
+NextUpdateTimeDetails calculateNextUpdateTimeDetails(const struct tm& currentTimeInfo, byte updatesPerHour, byte targetStartMinute, bool isNormalModeCheck);
+byte adaptiveUpdatesPerHour(byte configuredUpdatesPerHour);
+void updateAdaptiveCadence(const float* previousUV, const int* previousHours, const struct tm& nowInfo);
+extern float hourlyUV[];
+extern int forecastHours[];
+extern std::atomic<bool> isLowPowerModeActive;
+extern std::atomic<bool> networkJobDone;
+extern String lastUpdateTimeStr;
+extern bool rtc_hasValidData;
+extern char rtc_lastUpdateTimeStr_char[16];
+void saveForecastState();
+enum MemorySite : uint8_t { SITE_FETCH, SITE_RENDER };
+MemorySample memorySample();
+void memoryRecord(MemorySite site, const MemorySample& before);
+uint8_t memoryEvaluateTrends(float* olderRatio, float* newerRatio, float* bytesPerHour);
+
+const int ROUNDS = 20000;
+const int HOURS = 6; // HOURLY_FORECAST_COUNT
+
+// Runs the two sides at once, each for `rounds` iterations.
+static void runConcurrently(int rounds, std::function<void(int)> networkSide, std::function<void(int)> loopSide) {
+    std::atomic<bool> go{false};
+    std::thread network([&] {
+        while (!go) std::this_thread::yield();
+        for (int i = 0; i < rounds; ++i) networkSide(i);
+    });
+    go = true;
+    for (int i = 0; i < rounds; ++i) loopSide(i);
+    network.join();
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// The network task opens cycles and adds fetch phases while the loop adds render time and commits.
+void test_energy_profiler_shared_between_tasks(void) {
+    runConcurrently(ROUNDS,
+        [](int i) {
+            energyCycleBegin(0, 0);
+            energyPhaseAdd(PHASE_TLS, 1000 + i % 7);
+            if (isLowPowerModeActive) energyPhaseAdd(PHASE_TLS, 1);
+        },
+        [](int i) {
+            energyPhaseAdd(PHASE_RENDER, 2000);
+            if (i % 3 == 0) energyCycleCommit(0);
+            if (i % 100 == 0) isLowPowerModeActive = !isLowPowerModeActive;
+        });
+    energyCycleCommit(0);
+    TEST_ASSERT_TRUE(rtc_energyLogCount > 0);
+}
+
+// The resolver moves the device between two places; the night skip must see one or the other.
+void test_night_skip_reads_whole_coordinates(void) {
+    const float places[2][2] = { { 52.5196f, 13.4069f }, { -33.8688f, 151.2093f } };
+    struct tm noon = {};
+    noon.tm_year = 125;
+    noon.tm_mon = 5;
+    noon.tm_mday = 10;
+    noon.tm_hour = 12;
+    noon.tm_isdst = -1;
+    int torn = 0;
+    setDeviceCoordinates(places[1][0], places[1][1]);
+    runConcurrently(ROUNDS,
+        [&](int i) { setDeviceCoordinates(places[i & 1][0], places[i & 1][1]); },
+        [&](int i) {
+            float latitude, longitude;
+            readDeviceCoordinates(latitude, longitude);
+            bool whole = (latitude == places[0][0] && longitude == places[0][1]) || (latitude == places[1][0] && longitude == places[1][1]);
+            if (!whole) torn++;
+            if (i % 50 == 0) calculateNextUpdateTimeDetails(noon, 4, 2, true);
+        });
+    TEST_ASSERT_EQUAL(0, torn);
+}
+
+// Fetches re-derive the interval while the loop schedules from it.
+void test_adaptive_interval_read_while_fetches_update_it(void) {
+    struct tm day = {};
+    day.tm_year = 125;
+    day.tm_yday = 160;
+    day.tm_hour = 11;
+    float previousUV[HOURS];
+    int previousHours[HOURS];
+    int outOfRange = 0;
+    runConcurrently(ROUNDS / 10,
+        [&](int i) {
+            memcpy(previousUV, hourlyUV, sizeof(previousUV));
+            memcpy(previousHours, forecastHours, sizeof(previousHours));
+            for (int h = 0; h < HOURS; ++h) {
+                forecastHours[h] = 11 + h;
+                hourlyUV[h] = (i & 1) ? 1.0f + h * 2.0f : 3.0f; // Volatile and flat days in turn
+            }
+            updateAdaptiveCadence(previousUV, previousHours, day);
+        },
+        [&](int) {
+            byte perHour = adaptiveUpdatesPerHour(4);
+            if (perHour < 1 || perHour > 4) outOfRange++;
+        });
+    TEST_ASSERT_EQUAL(0, outOfRange);
+}
+
+// The job handoff: the network task owns the fetch results until it reports back; the loop then
+// persists them (deep sleep entry) before posting the next job.
+void test_fetch_results_handed_over_with_the_job(void) {
+    std::atomic<int> posted{0};
+    rtc_hasValidData = true;
+    int mismatches = 0;
+    runConcurrently(ROUNDS / 10,
+        [&](int i) {
+            while (posted.load() != i + 1) std::this_thread::yield(); // xQueueReceive
+            lastUpdateTimeStr = "J" + String(i);
+            networkJobDone = true;
+        },
+        [&](int i) {
+            networkJobDone = false; // postNetworkJob()
+            posted = i + 1;
+            while (!networkJobDone) std::this_thread::yield(); // runStateMachine() polls for it
+            saveForecastState();
+            if (strcmp(rtc_lastUpdateTimeStr_char, ("J" + String(i)).c_str()) != 0) mismatches++;
+        });
+    TEST_ASSERT_EQUAL(0, mismatches);
+}
+
+// Fetches (network task) and renders (loop) both record heap samples and judge the trends.
+void test_memory_history_recorded_from_both_tasks(void) {
+    int badRatios = 0;
+    runConcurrently(ROUNDS / 10,
+        [](int) { memoryRecord(SITE_FETCH, memorySample()); },
+        [&](int) {
+            memoryRecord(SITE_RENDER, memorySample());
+            float olderRatio, newerRatio, bytesPerHour;
+            memoryEvaluateTrends(&olderRatio, &newerRatio, &bytesPerHour);
+            if (olderRatio < 0.0f || olderRatio > 1.0f || newerRatio < 0.0f || newerRatio > 1.0f) badRatios++;
+        });
+    TEST_ASSERT_EQUAL(0, badRatios);
+}
+
+// Forecast snapshots and status messages: the reader sees complete, in-order buffers only.
+struct StressSnapshot {
+    uint32_t sequence;
+    uint32_t words[64];
+};
+
+void test_triple_buffer_delivers_whole_snapshots_in_order(void) {
+    static TripleBuffer<StressSnapshot> buffer;
+    int torn = 0, backwards = 0, received = 0;
+    uint32_t lastSequence = 0;
+    runConcurrently(ROUNDS * 10,
+        [&](int i) {
+            StressSnapshot& snap = buffer.back();
+            snap.sequence = (uint32_t)i + 1;
+            for (uint32_t& word : snap.words) word = snap.sequence * 2654435761u;
+            buffer.publish();
+        },
+        [&](int) {
+            if (!buffer.acquire()) return;
+            const StressSnapshot& snap = buffer.front();
+            received++;
+            for (uint32_t word : snap.words) if (word != snap.sequence * 2654435761u) { torn++; break; }
+            if (snap.sequence <= lastSequence) backwards++;
+            lastSequence = snap.sequence;
+        });
+    TEST_ASSERT_EQUAL(0, torn);
+    TEST_ASSERT_EQUAL(0, backwards);
+    TEST_ASSERT_TRUE(received > 0);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_energy_profiler_shared_between_tasks);
+    RUN_TEST(test_night_skip_reads_whole_coordinates);
+    RUN_TEST(test_adaptive_interval_read_while_fetches_update_it);
+    RUN_TEST(test_fetch_results_handed_over_with_the_job);
+    RUN_TEST(test_memory_history_recorded_from_both_tasks);
+    RUN_TEST(test_triple_buffer_delivers_whole_snapshots_in_order);
+    return UNITY_END();
+}
@@ -0,0 +1,187 @@
+// Native suite for lib/UvDose: the closed-form dose against a reference integration of the same
+// piecewise-linear UV curve, the per-minute ticks against the whole-day total, and the two-pointer
+// time-to-burn search against a brute-force scan for every skin type.
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <UvDose.h>
+
+const int HORIZON_MINUTES = 60 * (UV_DOSE_KNOTS - 1);
+
+// Forecasts: a clear summer midday, a rising morning, a dull day, one with placeholders, and random ones.
+const float CLEAR_MIDDAY[UV_DOSE_KNOTS] = { 6.5f, 8.0f, 8.7f, 8.2f, 6.9f, 5.0f };
+const float RISING[UV_DOSE_KNOTS] = { 0.0f, 0.4f, 1.5f, 3.1f, 4.8f, 6.2f };
+const float DULL[UV_DOSE_KNOTS] = { 0.3f, 0.5f, 0.6f, 0.6f, 0.4f, 0.2f };
+const int HOURS_FROM_11[UV_DOSE_KNOTS] = { 11, 12, 13, 14, 15, 16 };
+const int HOURS_WITH_PLACEHOLDERS[UV_DOSE_KNOTS] = { 21, 22, 23, -1, -1, -1 };
+
+// Trapezoid-free reference: UV interpolated linearly between knots and summed at 1 s steps (midpoint
+// rule, double precision). Independent of the prefix sums and the closed-form partial segment.
+static double referenceUv(const float* uv, const int* hours, double minute) {
+    if (minute < 0.0 || minute >= HORIZON_MINUTES) return 0.0;
+    int k = (int)(minute / 60.0);
+    double x = (minute - 60.0 * k) / 60.0;
+    double a = (uv[k] > 0.0f && hours[k] >= 0) ? uv[k] : 0.0;
+    double b = (uv[k + 1] > 0.0f && hours[k + 1] >= 0) ? uv[k + 1] : 0.0;
+    return a + (b - a) * x;
+}
+static double referenceSed(const float* uv, const int* hours, double fromMinute, double toMinute) {
+    double sum = 0.0;
+    const double step = 1.0 / 60.0;
+    for (double t = fromMinute; t < toMinute; t += step) {
+        double width = (t + step <= toMinute) ? step : toMinute - t;
+        sum += referenceUv(uv, hours, t + width / 2) * width;
+    }
+    return sum * SED_PER_UVI_MINUTE;
+}
+
+static void randomForecast(float* uv) {
+    for (int i = 0; i < UV_DOSE_KNOTS; ++i) uv[i] = (rand() % 1200) / 100.0f;
+}
+
+// Smallest whole minute m >= ceil(now) with D(m) >= D(now) + MED, scanning from scratch; -1 if none.
+static int32_t bruteForceBurnEnd(const UvDoseModel& model, float now, float medSed) {
+    float target = uvDoseSedAt(model, now) + medSed;
+    for (int32_t m = (int32_t)ceilf(now); m <= HORIZON_MINUTES; ++m)
+        if (uvDoseSedAt(model, m) >= target) return m;
+    return -1;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_med_by_skin_type_clamps(void) {
+    TEST_ASSERT_EQUAL_FLOAT(2.0f, uvDoseMedSed(0));
+    TEST_ASSERT_EQUAL_FLOAT(2.0f, uvDoseMedSed(1));
+    TEST_ASSERT_EQUAL_FLOAT(4.5f, uvDoseMedSed(4));
+    TEST_ASSERT_EQUAL_FLOAT(10.0f, uvDoseMedSed(6));
+    TEST_ASSERT_EQUAL_FLOAT(10.0f, uvDoseMedSed(9));
+}
+
+// D(minute) against the reference at every minute and at odd fractions of a minute.
+void test_sed_matches_reference_integration(void) {
+    const float* forecasts[] = { CLEAR_MIDDAY, RISING, DULL };
+    for (const float* uv : forecasts) {
+        UvDoseModel model;
+        uvDoseLoadForecast(model, uv, HOURS_FROM_11);
+        TEST_ASSERT_TRUE(model.loaded);
+        double reference = 0.0;
+        for (int m = 0; m < HORIZON_MINUTES; ++m) {
+            TEST_ASSERT_FLOAT_WITHIN(1e-3f + 1e-4f * (float)reference, (float)reference, uvDoseSedAt(model, (float)m));
+            reference += referenceSed(uv, HOURS_FROM_11, m, m + 1);
+        }
+        for (float m = 0.37f; m < HORIZON_MINUTES; m += 7.61f)
+            TEST_ASSERT_FLOAT_WITHIN(2e-3f, (float)referenceSed(uv, HOURS_FROM_11, 0.0, m), uvDoseSedAt(model, m));
+    }
+}
+
+void test_sed_is_flat_outside_the_forecast(void) {
+    UvDoseModel model;
+    uvDoseLoadForecast(model, CLEAR_MIDDAY, HOURS_FROM_11);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, uvDoseSedAt(model, -30.0f));
+    TEST_ASSERT_EQUAL_FLOAT(uvDoseSedAt(model, (float)HORIZON_MINUTES), uvDoseSedAt(model, HORIZON_MINUTES + 500.0f));
+    TEST_ASSERT_FLOAT_WITHIN(2e-3f, (float)referenceSed(CLEAR_MIDDAY, HOURS_FROM_11, 0.0, HORIZON_MINUTES),
+                             uvDoseSedAt(model, (float)HORIZON_MINUTES));
+}
+
+// The firmware's tick adds D(t) - D(t - elapsed); a day of 1-minute ticks, and of irregular ones
+// (deep sleeps), must add up to the whole-forecast dose.
+void test_incremental_ticks_add_up_to_the_day(void) {
+    UvDoseModel model;
+    uvDoseLoadForecast(model, CLEAR_MIDDAY, HOURS_FROM_11);
+    float total = uvDoseSedAt(model, (float)HORIZON_MINUTES);
+    float perMinute = 0.0f;
+    for (int m = 1; m <= HORIZON_MINUTES; ++m) perMinute += uvDoseSedAt(model, (float)m) - uvDoseSedAt(model, m - 1.0f);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, total, perMinute);
+    float irregular = 0.0f;
+    srand(7);
+    for (float t = 0.0f, previous = 0.0f; previous < HORIZON_MINUTES; previous = t) {
+        t = previous + 1.0f + rand() % 45 + (rand() % 60) / 60.0f;
+        irregular += uvDoseSedAt(model, t) - uvDoseSedAt(model, previous);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, total, irregular);
+}
+
+// Placeholder hours (-1) count as no UV, and a forecast without a valid first hour is not loaded.
+void test_placeholders_count_as_no_uv(void) {
+    UvDoseModel model;
+    const float uv[UV_DOSE_KNOTS] = { 3.0f, 2.0f, 1.0f, 9.0f, 9.0f, 9.0f };
+    uvDoseLoadForecast(model, uv, HOURS_WITH_PLACEHOLDERS);
+    TEST_ASSERT_TRUE(model.loaded);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, (float)referenceSed(uv, HOURS_WITH_PLACEHOLDERS, 0.0, HORIZON_MINUTES),
+                             uvDoseSedAt(model, (float)HORIZON_MINUTES));
+    const int noHours[UV_DOSE_KNOTS] = { -1, -1, -1, -1, -1, -1 };
+    uvDoseLoadForecast(model, uv, noHours);
+    TEST_ASSERT_FALSE(model.loaded);
+    TEST_ASSERT_EQUAL(-1, uvDoseTimeToBurn(model, 10.0f, 2.0f).burnMinutes);
+}
+
+void test_minute_of_local_time(void) {
+    UvDoseModel model;
+    uvDoseLoadForecast(model, CLEAR_MIDDAY, HOURS_FROM_11);
+    struct tm t = {};
+    t.tm_hour = 12; t.tm_min = 30; t.tm_sec = 30;
+    TEST_ASSERT_EQUAL_FLOAT(90.5f, uvDoseMinuteOf(model, t));
+    t.tm_hour = 10; t.tm_min = 0; t.tm_sec = 0;
+    TEST_ASSERT_EQUAL_FLOAT(-60.0f, uvDoseMinuteOf(model, t)); // Knot 0 still ahead
+    int lateHours[UV_DOSE_KNOTS] = { 23, 0, 1, 2, 3, 4 };
+    uvDoseLoadForecast(model, CLEAR_MIDDAY, lateHours);
+    t.tm_hour = 1; t.tm_min = 15;
+    TEST_ASSERT_EQUAL_FLOAT(135.0f, uvDoseMinuteOf(model, t)); // Across midnight
+}
+
+// Ticks every minute (and at odd seconds) through the forecast: the two-pointer answer equals the
+// brute-force scan each time for every skin type, and its end only moves forward, never scanning past
+// the forecast (past it, the end just follows now).
+void test_two_pointer_burn_search_matches_brute_force(void) {
+    float randomUv[UV_DOSE_KNOTS];
+    srand(11);
+    for (int f = 0; f < 40; ++f) {
+        const float* uv = f == 0 ? CLEAR_MIDDAY : (f == 1 ? RISING : (f == 2 ? DULL : randomUv));
+        if (f >= 3) randomForecast(randomUv);
+        for (uint8_t skin = 1; skin <= 6; ++skin) {
+            UvDoseModel model;
+            uvDoseLoadForecast(model, uv, HOURS_FROM_11);
+            float med = uvDoseMedSed(skin);
+            int32_t lastEnd = 0;
+            for (float now = -20.0f; now < HORIZON_MINUTES + 10; now += (f & 1) ? 1.0f : 0.75f) {
+                UvBurnEstimate estimate = uvDoseTimeToBurn(model, now, med);
+                int32_t expectedEnd = bruteForceBurnEnd(model, now, med);
+                char message[64];
+                snprintf(message, sizeof(message), "forecast %d, type %u, minute %.2f", f, skin, now);
+                if (expectedEnd < 0) TEST_ASSERT_EQUAL_MESSAGE(-1, estimate.burnMinutes, message);
+                else TEST_ASSERT_EQUAL_MESSAGE((int32_t)(expectedEnd - now + 0.5f), estimate.burnMinutes, message);
+                TEST_ASSERT_EQUAL_MESSAGE(now < HORIZON_MINUTES ? (int32_t)(HORIZON_MINUTES - now) : 0, estimate.horizonMinutes, message);
+                TEST_ASSERT_TRUE_MESSAGE(model.burnEndMinute >= lastEnd, message);
+                TEST_ASSERT_TRUE_MESSAGE(model.burnEndMinute <= HORIZON_MINUTES || model.burnEndMinute == (int32_t)ceilf(now), message);
+                lastEnd = model.burnEndMinute;
+            }
+        }
+    }
+}
+
+// A new forecast restarts the search; a lower one can push the burn time out again.
+void test_new_forecast_restarts_the_search(void) {
+    UvDoseModel model;
+    uvDoseLoadForecast(model, CLEAR_MIDDAY, HOURS_FROM_11);
+    UvBurnEstimate clear = uvDoseTimeToBurn(model, 30.0f, uvDoseMedSed(2));
+    uvDoseLoadForecast(model, DULL, HOURS_FROM_11);
+    UvBurnEstimate dull = uvDoseTimeToBurn(model, 30.0f, uvDoseMedSed(2));
+    TEST_ASSERT_TRUE(clear.burnMinutes > 0);
+    TEST_ASSERT_EQUAL(-1, dull.burnMinutes);
+    TEST_ASSERT_EQUAL(HORIZON_MINUTES - 30, dull.horizonMinutes);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_med_by_skin_type_clamps);
+    RUN_TEST(test_sed_matches_reference_integration);
+    RUN_TEST(test_sed_is_flat_outside_the_forecast);
+    RUN_TEST(test_incremental_ticks_add_up_to_the_day);
+    RUN_TEST(test_placeholders_count_as_no_uv);
+    RUN_TEST(test_minute_of_local_time);
+    RUN_TEST(test_two_pointer_burn_search_matches_brute_force);
+    RUN_TEST(test_new_forecast_restarts_the_search);
+    return UNITY_END();
+}
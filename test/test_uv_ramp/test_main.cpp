@@ -0,0 +1,147 @@
+// Native suite for lib/UvRamp: the compile-time table against a float reference of the WHO-scale
+// blend, and the bar runs against drawing the same bar one row at a time.
+#include <unity.h>
+#include <stdio.h>
+#include <math.h>
+#include <UvRamp.h>
+
+// Reference colour at a UV, blended per channel in float between the same stops.
+static void rgb565Split(uint16_t c, float* rgb) {
+    rgb[0] = (c >> 11) & 0x1F;
+    rgb[1] = (c >> 5) & 0x3F;
+    rgb[2] = c & 0x1F;
+}
+static void referenceRgb(float uv, float* rgb) {
+    const float stops[] = { 1.0f, 4.0f, 6.5f, (float)UV_GRAPH_FULL_SCALE };
+    const uint16_t colors[] = { UV_RAMP_GREEN, UV_RAMP_YELLOW, UV_RAMP_ORANGE, UV_RAMP_RED };
+    if (uv <= stops[0]) { rgb565Split(colors[0], rgb); return; }
+    for (int s = 1; s < 4; ++s) {
+        if (uv > stops[s]) continue;
+        float a[3], b[3], t = (uv - stops[s - 1]) / (stops[s] - stops[s - 1]);
+        rgb565Split(colors[s - 1], a);
+        rgb565Split(colors[s], b);
+        for (int c = 0; c < 3; ++c) rgb[c] = a[c] + (b[c] - a[c]) * t;
+        return;
+    }
+    rgb565Split(colors[3], rgb);
+}
+
+// Row r's colour by the definition, for comparing the runs against.
+static uint16_t rowColor(int row, int fullScaleHeight) {
+    uint32_t stepPerRow = ((uint32_t)(UV_RAMP_STEPS - 1) << 16) / (uint32_t)fullScaleHeight;
+    uint64_t index = ((uint64_t)row * stepPerRow) >> 16;
+    return UV_RAMP[index < UV_RAMP_STEPS ? index : UV_RAMP_STEPS - 1];
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_table_is_the_constexpr_ramp(void) {
+    for (uint32_t i = 0; i < UV_RAMP_STEPS; ++i) TEST_ASSERT_EQUAL_HEX16(uvRampEntry(i), UV_RAMP[i]);
+    static_assert(uvRampEntry(0) == UV_RAMP_GREEN, "evaluated at compile time");
+    TEST_ASSERT_EQUAL_HEX16(UV_RAMP_GREEN, UV_RAMP[0]);
+    TEST_ASSERT_EQUAL_HEX16(UV_RAMP_RED, UV_RAMP[UV_RAMP_STEPS - 1]);
+}
+
+// Each channel is within a little over one step of the float blend: the integer blend truncates both
+// the blend weight (up to 1/256 of the span) and the blended value.
+void test_table_matches_float_blend(void) {
+    for (uint32_t i = 0; i < UV_RAMP_STEPS; ++i) {
+        float uv = (float)(i * UV_GRAPH_FULL_SCALE * 256 / (UV_RAMP_STEPS - 1)) / 256.0f;
+        float expected[3], actual[3];
+        referenceRgb(uv, expected);
+        rgb565Split(UV_RAMP[i], actual);
+        char message[48];
+        snprintf(message, sizeof(message), "entry %u (UV %.2f)", i, uv);
+        for (int c = 0; c < 3; ++c) TEST_ASSERT_FLOAT_WITHIN_MESSAGE(1.25f, expected[c], actual[c], message);
+    }
+}
+
+// Green -> yellow -> orange -> red: red never falls, and green never rises, going up the bar.
+void test_table_runs_one_way_through_the_scale(void) {
+    for (uint32_t i = 1; i < UV_RAMP_STEPS; ++i) {
+        float previous[3], current[3];
+        rgb565Split(UV_RAMP[i - 1], previous);
+        rgb565Split(UV_RAMP[i], current);
+        TEST_ASSERT_TRUE(current[0] >= previous[0]);
+        if (i > UV_RAMP_STEPS / 2) TEST_ASSERT_TRUE(current[1] <= previous[1]);
+        TEST_ASSERT_EQUAL(0, current[2]);
+    }
+}
+
+// Runs cover every row once, from the baseline up, each in its rows' colour, and neighbours differ.
+void test_runs_match_per_row_drawing(void) {
+    const int fullScales[] = { 1, 7, 20, 57, 100, 127, 128, 200, 240 };
+    for (int fullScale : fullScales) {
+        for (int height = 0; height <= fullScale + 40; ++height) {
+            char message[48];
+            snprintf(message, sizeof(message), "height %d of %d", height, fullScale);
+            UvRampBar bar;
+            uvRampBarBegin(bar, height, fullScale);
+            int nextRow = 0, runs = 0;
+            uint16_t previousColor = 0;
+            for (UvRampRun run; uvRampBarNext(bar, run); ++runs) {
+                TEST_ASSERT_EQUAL_MESSAGE(nextRow, run.firstRow, message);
+                TEST_ASSERT_TRUE_MESSAGE(run.rows > 0, message);
+                if (runs > 0) TEST_ASSERT_TRUE_MESSAGE(run.color != previousColor, message);
+                for (int r = run.firstRow; r < run.firstRow + run.rows; ++r)
+                    TEST_ASSERT_EQUAL_HEX16_MESSAGE(rowColor(r, fullScale), run.color, message);
+                nextRow = run.firstRow + run.rows;
+                previousColor = run.color;
+            }
+            TEST_ASSERT_EQUAL_MESSAGE(height, nextRow, message);
+            TEST_ASSERT_TRUE_MESSAGE(runs <= UV_RAMP_STEPS, message);
+        }
+    }
+}
+
+// The green base and the red cap are one fill each; the blend between them takes one per colour.
+void test_base_and_cap_are_single_fills(void) {
+    UvRampBar bar;
+    uvRampBarBegin(bar, 90, 60); // 60 px full scale, bar at UV 12
+    UvRampRun runs[UV_RAMP_STEPS];
+    int count = 0;
+    for (UvRampRun run; uvRampBarNext(bar, run);) runs[count++] = run;
+    printf("  90 px bar over a 60 px full scale: %d fills\n", count);
+    int greenRows = 0, redRows = 0;
+    for (int r = 0; r < 90; ++r) {
+        greenRows += rowColor(r, 60) == UV_RAMP_GREEN;
+        redRows += rowColor(r, 60) == UV_RAMP_RED;
+    }
+    TEST_ASSERT_TRUE(greenRows >= 8 && redRows >= 25);
+    TEST_ASSERT_EQUAL_HEX16(UV_RAMP_GREEN, runs[0].color);
+    TEST_ASSERT_EQUAL(greenRows, runs[0].rows);
+    TEST_ASSERT_EQUAL_HEX16(UV_RAMP_RED, runs[count - 1].color);
+    TEST_ASSERT_EQUAL(redRows, runs[count - 1].rows);
+    TEST_ASSERT_TRUE(count <= 90 - greenRows - redRows + 2);
+}
+
+void test_empty_and_degenerate_bars(void) {
+    UvRampBar bar;
+    UvRampRun run;
+    uvRampBarBegin(bar, 0, 60);
+    TEST_ASSERT_FALSE(uvRampBarNext(bar, run));
+    uvRampBarBegin(bar, -5, 60);
+    TEST_ASSERT_FALSE(uvRampBarNext(bar, run));
+    uvRampBarBegin(bar, 10, 0);
+    TEST_ASSERT_FALSE(uvRampBarNext(bar, run));
+    uvRampBarBegin(bar, 1000, 1); // Far over full scale: one red run above the green baseline row
+    TEST_ASSERT_TRUE(uvRampBarNext(bar, run));
+    TEST_ASSERT_EQUAL_HEX16(UV_RAMP_GREEN, run.color);
+    TEST_ASSERT_TRUE(uvRampBarNext(bar, run));
+    TEST_ASSERT_EQUAL(1, run.firstRow);
+    TEST_ASSERT_EQUAL(999, run.rows);
+    TEST_ASSERT_EQUAL_HEX16(UV_RAMP_RED, run.color);
+    TEST_ASSERT_FALSE(uvRampBarNext(bar, run));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_table_is_the_constexpr_ramp);
+    RUN_TEST(test_table_matches_float_blend);
+    RUN_TEST(test_table_runs_one_way_through_the_scale);
+    RUN_TEST(test_runs_match_per_row_drawing);
+    RUN_TEST(test_base_and_cap_are_single_fills);
+    RUN_TEST(test_empty_and_degenerate_bars);
+    return UNITY_END();
+}